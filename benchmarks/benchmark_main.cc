@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "gmock/gmock.h"
+#include "src/valkey_search.h"
+#include "src/vector_externalizer.h"
+#include "testing/common.h"
+#include "vmsdk/src/testing_infra/module.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+// Shared main of the benchmarks. It sets up the same module mocks as
+// ValkeySearchTest, so the benchmarked code runs as it does in the unit tests.
+//
+// Results are written as JSON with the standard Google Benchmark flags, e.g.
+//   vector_benchmark --benchmark_out=vector.json --benchmark_out_format=json
+// and build.sh --run-benchmarks stores them per commit.
+int main(int argc, char **argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  TestValkeyModule_Init();
+  valkey_search::ValkeySearch::InitInstance(
+      std::make_unique<valkey_search::TestableValkeySearch>());
+  ValkeyModuleCtx registry_ctx;
+  ON_CALL(*kMockValkeyModule, GetDetachedThreadSafeContext(testing::_))
+      .WillByDefault([&](ValkeyModuleCtx *ctx) {
+        return ctx == &registry_ctx ? ctx : nullptr;
+      });
+  valkey_search::VectorExternalizer::Instance().Init(&registry_ctx);
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  valkey_search::VectorExternalizer::Instance().Reset();
+  valkey_search::ValkeySearch::InitInstance(nullptr);
+  TestValkeyModule_Teardown();
+  return 0;
+}
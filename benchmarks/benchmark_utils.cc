@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "benchmarks/benchmark_utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "src/utils/cancel.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search::benchmarks {
+
+std::vector<InternedStringPtr> MakeKeys(size_t count,
+                                        absl::string_view prefix) {
+  std::vector<InternedStringPtr> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    keys.push_back(StringInternStore::Intern(absl::StrCat(prefix, i)));
+  }
+  return keys;
+}
+
+std::vector<std::string> MakeVectors(size_t count, int dimensions,
+                                     uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  std::vector<std::string> vectors;
+  vectors.reserve(count);
+  std::vector<float> vector(dimensions);
+  for (size_t i = 0; i < count; ++i) {
+    for (auto &value : vector) {
+      value = dist(gen);
+    }
+    vectors.emplace_back(reinterpret_cast<const char *>(vector.data()),
+                         vector.size() * sizeof(float));
+  }
+  return vectors;
+}
+
+std::vector<std::string> MakeWords(size_t count, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> length(3, 10);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  absl::flat_hash_set<std::string> seen;
+  std::vector<std::string> words;
+  words.reserve(count);
+  while (words.size() < count) {
+    std::string word(length(gen), ' ');
+    for (auto &c : word) {
+      c = static_cast<char>(letter(gen));
+    }
+    if (seen.insert(word).second) {
+      words.push_back(std::move(word));
+    }
+  }
+  return words;
+}
+
+std::vector<std::string> MakeDocuments(
+    size_t count, size_t words_per_doc,
+    const std::vector<std::string> &vocabulary, uint32_t seed) {
+  std::mt19937 gen(seed);
+  // Approximates the Zipf-like frequencies of words in natural text.
+  std::geometric_distribution<size_t> rank(8.0 / vocabulary.size());
+  std::vector<std::string> documents;
+  documents.reserve(count);
+  std::vector<absl::string_view> words(words_per_doc);
+  for (size_t i = 0; i < count; ++i) {
+    for (auto &word : words) {
+      word = vocabulary[rank(gen) % vocabulary.size()];
+    }
+    documents.push_back(absl::StrJoin(words, " "));
+  }
+  return documents;
+}
+
+cancel::Token &CancelNever() {
+  static cancel::Token cancel_never = cancel::Make(1000000, nullptr);
+  return cancel_never;
+}
+
+}  // namespace valkey_search::benchmarks
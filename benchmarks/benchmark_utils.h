@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_BENCHMARKS_BENCHMARK_UTILS_H_
+#define VALKEYSEARCH_BENCHMARKS_BENCHMARK_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/utils/cancel.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search::benchmarks {
+
+// Fixed seed, so that every run and every commit benchmarks the same data.
+constexpr uint32_t kSeed = 1234;
+
+// Interned keys "<prefix>0" .. "<prefix><count - 1>".
+std::vector<InternedStringPtr> MakeKeys(size_t count,
+                                        absl::string_view prefix = "doc:");
+
+// Random float vectors in [0, 1), each serialized the way it is stored in a
+// hash field.
+std::vector<std::string> MakeVectors(size_t count, int dimensions,
+                                     uint32_t seed = kSeed);
+
+// Distinct random lowercase words of 3 to 10 letters.
+std::vector<std::string> MakeWords(size_t count, uint32_t seed = kSeed);
+
+// Documents of words_per_doc words drawn from vocabulary, with a skewed
+// distribution so that some words are much more frequent than others.
+std::vector<std::string> MakeDocuments(
+    size_t count, size_t words_per_doc,
+    const std::vector<std::string> &vocabulary, uint32_t seed = kSeed);
+
+// A token which is never cancelled during a benchmark.
+cancel::Token &CancelNever();
+
+}  // namespace valkey_search::benchmarks
+
+#endif  // VALKEYSEARCH_BENCHMARKS_BENCHMARK_UTILS_H_
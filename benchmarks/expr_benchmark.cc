@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "src/expr/expr.h"
+#include "src/expr/value.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+using expr::Expression;
+using expr::Value;
+
+constexpr size_t kNumRecords = 1024;
+
+// A record holds the values of the attributes by position, as the records of
+// FT.AGGREGATE do.
+struct Record : public Expression::Record {
+  std::vector<Value> values;
+};
+
+struct Reference : public Expression::AttributeReference {
+  Reference(absl::string_view name, size_t index)
+      : name(name), index(index) {}
+  Value GetValue(Expression::EvalContext &ctx,
+                 const Expression::Record &record) const override {
+    return static_cast<const Record &>(record).values[index];
+  }
+  void Dump(std::ostream &os) const override { os << name; }
+  std::string name;
+  size_t index;
+};
+
+struct CompileContext : public Expression::CompileContext {
+  absl::flat_hash_map<std::string, size_t> attributes{
+      {"price", 0}, {"quantity", 1}, {"name", 2}};
+  absl::StatusOr<std::unique_ptr<Expression::AttributeReference>>
+  MakeReference(const absl::string_view s, bool create) override {
+    auto itr = attributes.find(s);
+    if (itr == attributes.end()) {
+      return absl::NotFoundError(absl::StrCat("Unknown attribute ", s));
+    }
+    return std::make_unique<Reference>(s, itr->second);
+  }
+  absl::StatusOr<Value> GetParam(const absl::string_view s) const override {
+    return absl::NotFoundError(absl::StrCat("Unknown parameter ", s));
+  }
+};
+
+const std::vector<std::string> &Names() {
+  static const auto *names =
+      new std::vector<std::string>(MakeWords(kNumRecords));
+  return *names;
+}
+
+std::vector<Record> MakeRecords() {
+  std::mt19937 gen(kSeed);
+  std::uniform_real_distribution<double> price(0, 1000);
+  std::uniform_int_distribution<int> quantity(0, 100);
+  std::vector<Record> records(kNumRecords);
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    records[i].values = {Value(price(gen)), Value(quantity(gen)),
+                         Value(absl::string_view(Names()[i]))};
+  }
+  return records;
+}
+
+// The expressions of the APPLY and FILTER clauses of typical aggregations.
+const std::vector<std::string> kExpressions = {
+    "@price * @quantity",
+    "floor(@price * 1.2 + 0.5) / 100",
+    "@price > 100 && @quantity < 50 || @price < 10",
+    "upper(substr(@name, 0, 3))",
+    "concat(@name, '-', @quantity)",
+    "startswith(@name, 'ab') && strlen(@name) > 5",
+};
+
+void BM_Expression_Compile(benchmark::State &state) {
+  const auto &text = kExpressions[state.range(0)];
+  CompileContext compile_ctx;
+  for (auto _ : state) {
+    auto expression = Expression::Compile(compile_ctx, text);
+    benchmark::DoNotOptimize(expression);
+  }
+  state.SetLabel(text);
+}
+
+void BM_Expression_Evaluate(benchmark::State &state) {
+  const auto &text = kExpressions[state.range(0)];
+  CompileContext compile_ctx;
+  auto expression = Expression::Compile(compile_ctx, text).value();
+  auto records = MakeRecords();
+  Expression::EvalContext eval_ctx;
+  size_t i = 0;
+  for (auto _ : state) {
+    auto value = expression->Evaluate(eval_ctx, records[i++ % kNumRecords]);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(text);
+}
+
+// The argument is the index of the expression in kExpressions.
+BENCHMARK(BM_Expression_Compile)
+    ->ArgName("expr")
+    ->DenseRange(0, kExpressions.size() - 1);
+BENCHMARK(BM_Expression_Evaluate)
+    ->ArgName("expr")
+    ->DenseRange(0, kExpressions.size() - 1);
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
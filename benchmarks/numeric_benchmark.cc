@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "src/index_schema.pb.h"
+#include "src/indexes/numeric.h"
+#include "src/query/predicate.h"
+#include "testing/common.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+constexpr size_t kIndexSize = 100000;
+constexpr double kMaxValue = 1000000;
+constexpr size_t kNumRanges = 1000;
+
+std::vector<std::string> MakeValues(size_t count) {
+  std::mt19937 gen(kSeed);
+  std::uniform_real_distribution<double> dist(0, kMaxValue);
+  std::vector<std::string> values;
+  values.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    values.push_back(absl::StrCat(dist(gen)));
+  }
+  return values;
+}
+
+std::unique_ptr<indexes::Numeric> CreateNumeric() {
+  return std::make_unique<indexes::Numeric>(CreateNumericIndexProto());
+}
+
+// The searched index is built once and kept for the whole run.
+const indexes::Numeric &SearchIndex() {
+  static const indexes::Numeric *index = [] {
+    auto *index = CreateNumeric().release();
+    auto keys = MakeKeys(kIndexSize);
+    auto values = MakeValues(kIndexSize);
+    for (size_t i = 0; i < kIndexSize; ++i) {
+      index->AddRecord(keys[i], values[i]).IgnoreError();
+    }
+    return index;
+  }();
+  return *index;
+}
+
+// Inclusive ranges covering selectivity_percent of the values, at random
+// offsets.
+std::vector<std::unique_ptr<query::NumericPredicate>> MakePredicates(
+    const indexes::Numeric &index, int selectivity_percent) {
+  std::mt19937 gen(kSeed + 1);
+  const double width = kMaxValue * selectivity_percent / 100;
+  std::uniform_real_distribution<double> start(0, kMaxValue - width);
+  std::vector<std::unique_ptr<query::NumericPredicate>> predicates;
+  predicates.reserve(kNumRanges);
+  for (size_t i = 0; i < kNumRanges; ++i) {
+    double from = start(gen);
+    predicates.push_back(std::make_unique<query::NumericPredicate>(
+        &index, "price", "price", from, true, from + width, true));
+  }
+  return predicates;
+}
+
+void BM_Numeric_Add(benchmark::State &state) {
+  auto keys = MakeKeys(kIndexSize);
+  auto values = MakeValues(kIndexSize);
+  std::unique_ptr<indexes::Numeric> index;
+  size_t i = kIndexSize;
+  for (auto _ : state) {
+    if (i == kIndexSize) {
+      state.PauseTiming();
+      index = CreateNumeric();
+      i = 0;
+      state.ResumeTiming();
+    }
+    auto added = index->AddRecord(keys[i], values[i]);
+    benchmark::DoNotOptimize(added);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Fetches and iterates over all the keys in the range.
+void BM_Numeric_Search(benchmark::State &state) {
+  const auto &index = SearchIndex();
+  auto predicates = MakePredicates(index, state.range(0));
+  size_t i = 0;
+  size_t keys = 0;
+  for (auto _ : state) {
+    auto fetcher = index.Search(*predicates[i++ % kNumRanges], false);
+    for (auto it = fetcher->Begin(); !it->Done(); it->Next()) {
+      benchmark::DoNotOptimize(**it);
+      ++keys;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["keys_per_query"] =
+      benchmark::Counter(keys, benchmark::Counter::kAvgIterations);
+}
+
+// Only counts the keys in the range, as done to plan queries.
+void BM_Numeric_RangeCount(benchmark::State &state) {
+  const auto &index = SearchIndex();
+  auto predicates = MakePredicates(index, state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    auto fetcher = index.Search(*predicates[i++ % kNumRanges], false);
+    benchmark::DoNotOptimize(fetcher->Size());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Numeric_Add);
+// The argument is the percentage of the values selected by the range.
+BENCHMARK(BM_Numeric_Search)->ArgName("percent")->Arg(1)->Arg(10)->Arg(50);
+BENCHMARK(BM_Numeric_RangeCount)->ArgName("percent")->Arg(1)->Arg(10)->Arg(50);
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search {
+
+namespace {
+
+constexpr size_t kNumKeys = 1 << 16;
+
+const std::vector<std::string>& Keys() {
+  static const std::vector<std::string>* keys = [] {
+    auto* keys = new std::vector<std::string>();
+    keys->reserve(kNumKeys);
+    for (size_t i = 0; i < kNumKeys; ++i) {
+      keys->push_back(absl::StrCat("doc:", i));
+    }
+    return keys;
+  }();
+  return *keys;
+}
+
+// Each iteration interns a string which is already held by another reference,
+// i.e. the read-mostly path taken for keyspace notifications and repeated
+// tokens.
+static void BM_Intern_Existing(benchmark::State& state) {
+  static std::vector<InternedStringPtr>* held = nullptr;
+  if (state.thread_index() == 0) {
+    held = new std::vector<InternedStringPtr>();
+    for (const auto& key : Keys()) {
+      held->push_back(StringInternStore::Intern(key));
+    }
+  }
+  const auto& keys = Keys();
+  size_t i = state.thread_index() * 7919;
+  for (auto _ : state) {
+    auto ptr = StringInternStore::Intern(keys[i++ % kNumKeys]);
+    benchmark::DoNotOptimize(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete held;
+    held = nullptr;
+  }
+}
+
+// Each iteration creates and releases a new interned string, exercising the
+// insert and the 1->0 release paths.
+static void BM_Intern_Release(benchmark::State& state) {
+  const auto& keys = Keys();
+  size_t i = state.thread_index() * (kNumKeys / 64);
+  for (auto _ : state) {
+    auto ptr = StringInternStore::Intern(keys[i++ % kNumKeys]);
+    benchmark::DoNotOptimize(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Mixed workload: most lookups hit strings held elsewhere, with a fraction of
+// short-lived strings, similar to backfill of documents with shared tag
+// values.
+static void BM_Intern_Mixed(benchmark::State& state) {
+  static std::vector<InternedStringPtr>* held = nullptr;
+  if (state.thread_index() == 0) {
+    held = new std::vector<InternedStringPtr>();
+    for (size_t i = 0; i < kNumKeys / 2; ++i) {
+      held->push_back(StringInternStore::Intern(Keys()[i]));
+    }
+  }
+  const auto& keys = Keys();
+  size_t i = state.thread_index() * 7919;
+  for (auto _ : state) {
+    InternedStringPtr ptr;
+    if (i % 10 == 0) {
+      ptr =
+          StringInternStore::Intern(keys[kNumKeys / 2 + (i % (kNumKeys / 2))]);
+    } else {
+      ptr = StringInternStore::Intern(keys[i % (kNumKeys / 2)]);
+    }
+    ++i;
+    benchmark::DoNotOptimize(ptr);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    delete held;
+    held = nullptr;
+  }
+}
+
+BENCHMARK(BM_Intern_Existing)
+    ->ThreadRange(1, std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+BENCHMARK(BM_Intern_Release)
+    ->ThreadRange(1, std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+BENCHMARK(BM_Intern_Mixed)
+    ->ThreadRange(1, std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace valkey_search
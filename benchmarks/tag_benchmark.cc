@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "src/commands/filter_parser.h"
+#include "src/index_schema.pb.h"
+#include "src/indexes/tag.h"
+#include "src/query/predicate.h"
+#include "testing/common.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+constexpr size_t kIndexSize = 100000;
+constexpr size_t kNumTagValues = 1000;
+constexpr size_t kTagsPerKey = 3;
+constexpr size_t kNumQueries = 1000;
+
+const std::vector<std::string> &TagValues() {
+  static const auto *values =
+      new std::vector<std::string>(MakeWords(kNumTagValues));
+  return *values;
+}
+
+// Comma separated tags of each key, drawn from TagValues.
+std::vector<std::string> MakeRecords(size_t count) {
+  std::mt19937 gen(kSeed);
+  std::uniform_int_distribution<size_t> value(0, kNumTagValues - 1);
+  std::vector<std::string> records;
+  records.reserve(count);
+  std::vector<absl::string_view> tags(kTagsPerKey);
+  for (size_t i = 0; i < count; ++i) {
+    for (auto &tag : tags) {
+      tag = TagValues()[value(gen)];
+    }
+    records.push_back(absl::StrJoin(tags, ","));
+  }
+  return records;
+}
+
+std::unique_ptr<indexes::Tag> CreateTag() {
+  return std::make_unique<indexes::Tag>(CreateTagIndexProto());
+}
+
+// The searched index is built once and kept for the whole run.
+const indexes::Tag &SearchIndex() {
+  static const indexes::Tag *index = [] {
+    auto *index = CreateTag().release();
+    auto keys = MakeKeys(kIndexSize);
+    auto records = MakeRecords(kIndexSize);
+    for (size_t i = 0; i < kIndexSize; ++i) {
+      index->AddRecord(keys[i], records[i]).IgnoreError();
+    }
+    return index;
+  }();
+  return *index;
+}
+
+enum class QueryKind { kSingle = 0, kUnion = 1, kPrefix = 2 };
+
+// A single tag, the union of 4 tags or a 3 letter prefix, e.g. {abc*}.
+std::vector<std::unique_ptr<query::TagPredicate>> MakePredicates(
+    const indexes::Tag &index, QueryKind kind) {
+  std::mt19937 gen(kSeed + 1);
+  std::uniform_int_distribution<size_t> value(0, kNumTagValues - 1);
+  std::vector<std::unique_ptr<query::TagPredicate>> predicates;
+  predicates.reserve(kNumQueries);
+  for (size_t i = 0; i < kNumQueries; ++i) {
+    std::string tag_string;
+    switch (kind) {
+      case QueryKind::kSingle:
+        tag_string = TagValues()[value(gen)];
+        break;
+      case QueryKind::kUnion:
+        tag_string = absl::StrJoin(
+            {TagValues()[value(gen)], TagValues()[value(gen)],
+             TagValues()[value(gen)], TagValues()[value(gen)]},
+            "|");
+        break;
+      case QueryKind::kPrefix:
+        tag_string = absl::StrCat(TagValues()[value(gen)].substr(0, 3), "*");
+        break;
+    }
+    auto tags = FilterParser::ParseQueryTags(tag_string).value();
+    predicates.push_back(std::make_unique<query::TagPredicate>(
+        &index, "tags", "tags", tag_string, tags));
+  }
+  return predicates;
+}
+
+void BM_Tag_Add(benchmark::State &state) {
+  auto keys = MakeKeys(kIndexSize);
+  auto records = MakeRecords(kIndexSize);
+  std::unique_ptr<indexes::Tag> index;
+  size_t i = kIndexSize;
+  for (auto _ : state) {
+    if (i == kIndexSize) {
+      state.PauseTiming();
+      index = CreateTag();
+      i = 0;
+      state.ResumeTiming();
+    }
+    auto added = index->AddRecord(keys[i], records[i]);
+    benchmark::DoNotOptimize(added);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Fetches and iterates over all the matching keys.
+void BM_Tag_Search(benchmark::State &state) {
+  const auto &index = SearchIndex();
+  auto predicates =
+      MakePredicates(index, static_cast<QueryKind>(state.range(0)));
+  size_t i = 0;
+  size_t keys = 0;
+  for (auto _ : state) {
+    auto fetcher = index.Search(*predicates[i++ % kNumQueries], false);
+    for (auto it = fetcher->Begin(); !it->Done(); it->Next()) {
+      benchmark::DoNotOptimize(**it);
+      ++keys;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["keys_per_query"] =
+      benchmark::Counter(keys, benchmark::Counter::kAvgIterations);
+}
+
+// Only counts the matching keys, as done to plan queries.
+void BM_Tag_Count(benchmark::State &state) {
+  const auto &index = SearchIndex();
+  auto predicates =
+      MakePredicates(index, static_cast<QueryKind>(state.range(0)));
+  size_t i = 0;
+  for (auto _ : state) {
+    auto fetcher = index.Search(*predicates[i++ % kNumQueries], false);
+    benchmark::DoNotOptimize(fetcher->Size());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Tag_Add);
+// The argument is the QueryKind: 0 single tag, 1 union, 2 prefix.
+BENCHMARK(BM_Tag_Search)->ArgName("kind")->DenseRange(0, 2);
+BENCHMARK(BM_Tag_Count)->ArgName("kind")->DenseRange(0, 2);
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "src/commands/ft_create_parser.h"
+#include "src/index_schema.pb.h"
+#include "src/indexes/text.h"
+#include "src/indexes/text/flat_position_map.h"
+#include "src/indexes/text/fuzzy.h"
+#include "src/indexes/text/lexer.h"
+#include "src/indexes/text/posting.h"
+#include "src/indexes/text/text_index.h"
+#include "src/valkey_search_options.h"
+#include "testing/common.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+using indexes::text::FlatPositionMap;
+using indexes::text::FlatPositionMapBuilder;
+using indexes::text::Position;
+using indexes::text::PositionIterator;
+using indexes::text::Postings;
+
+constexpr size_t kNumTextFields = 2;
+constexpr size_t kVocabularySize = 20000;
+constexpr size_t kNumDocuments = 20000;
+constexpr size_t kWordsPerDocument = 50;
+constexpr size_t kNumQueries = 1000;
+
+// Positions of a term in a document, with gaps similar to natural text, in
+// one of the text fields.
+FlatPositionMap *BuildPositionMap(size_t num_positions, std::mt19937 &gen) {
+  std::uniform_int_distribution<Position> gap(1, 20);
+  std::uniform_int_distribution<uint64_t> field(0, kNumTextFields - 1);
+  FlatPositionMapBuilder builder(kNumTextFields);
+  Position position = 0;
+  for (size_t i = 0; i < num_positions; ++i) {
+    position += gap(gen);
+    builder.AddPosition(position, 1ull << field(gen));
+  }
+  return builder.Build();
+}
+
+void BM_FlatPositionMap_Encode(benchmark::State &state) {
+  const size_t num_positions = state.range(0);
+  for (auto _ : state) {
+    std::mt19937 gen(kSeed);
+    auto *map = BuildPositionMap(num_positions, gen);
+    benchmark::DoNotOptimize(map);
+    FlatPositionMap::Destroy(map);
+  }
+  state.SetItemsProcessed(state.iterations() * num_positions);
+}
+
+void BM_FlatPositionMap_Iterate(benchmark::State &state) {
+  const size_t num_positions = state.range(0);
+  std::mt19937 gen(kSeed);
+  auto *map = BuildPositionMap(num_positions, gen);
+  for (auto _ : state) {
+    for (PositionIterator it(*map); it.IsValid(); it.NextPosition()) {
+      benchmark::DoNotOptimize(it.GetPosition());
+      benchmark::DoNotOptimize(it.GetFieldMask());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_positions);
+  FlatPositionMap::Destroy(map);
+}
+
+// Inserts keys into the postings of a term, with a few positions each.
+void BM_Postings_Insert(benchmark::State &state) {
+  const size_t num_keys = state.range(0);
+  auto keys = MakeKeys(num_keys);
+  std::mt19937 gen(kSeed);
+  std::vector<FlatPositionMap *> maps(num_keys);
+  std::unique_ptr<Postings> postings;
+  size_t i = num_keys;
+  for (auto _ : state) {
+    if (i == num_keys) {
+      state.PauseTiming();
+      // The postings own the inserted maps and destroy them.
+      postings = std::make_unique<Postings>();
+      for (auto &map : maps) {
+        map = BuildPositionMap(4, gen);
+      }
+      i = 0;
+      state.ResumeTiming();
+    }
+    postings->InsertKey(keys[i], maps[i]);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+  // Destroys the maps which were not inserted.
+  for (; i < num_keys; ++i) {
+    FlatPositionMap::Destroy(maps[i]);
+  }
+}
+
+// Iterates over all keys of a term, and over the positions of each key as
+// phrase and proximity queries do.
+void BM_Postings_Iterate(benchmark::State &state) {
+  const size_t num_keys = state.range(0);
+  auto keys = MakeKeys(num_keys);
+  std::mt19937 gen(kSeed);
+  Postings postings;
+  for (const auto &key : keys) {
+    postings.InsertKey(key, BuildPositionMap(4, gen));
+  }
+  for (auto _ : state) {
+    for (auto key_it = postings.GetKeyIterator(); key_it.IsValid();
+         key_it.NextKey()) {
+      benchmark::DoNotOptimize(key_it.GetKey());
+      for (auto pos_it = key_it.GetPositionIterator(); pos_it.IsValid();
+           pos_it.NextPosition()) {
+        benchmark::DoNotOptimize(pos_it.GetPosition());
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+
+const std::vector<std::string> &Vocabulary() {
+  static const auto *vocabulary =
+      new std::vector<std::string>(MakeWords(kVocabularySize));
+  return *vocabulary;
+}
+
+const std::vector<std::string> &Documents() {
+  static const auto *documents = new std::vector<std::string>(
+      MakeDocuments(kNumDocuments, kWordsPerDocument, Vocabulary()));
+  return *documents;
+}
+
+void BM_Lexer_Tokenize(benchmark::State &state) {
+  const bool stemming = state.range(0);
+  indexes::text::Lexer lexer(data_model::LANGUAGE_ENGLISH,
+                             std::string(kDefaultPunctuation),
+                             kDefaultStopWords);
+  const auto &documents = Documents();
+  size_t i = 0;
+  size_t bytes = 0;
+  for (auto _ : state) {
+    const auto &document = documents[i++ % documents.size()];
+    indexes::text::InProgressStemMap stem_mappings;
+    auto tokens = lexer.Tokenize(document, stemming, kDefaultMinStemSize,
+                                 stemming ? &stem_mappings : nullptr);
+    benchmark::DoNotOptimize(tokens);
+    bytes += document.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(bytes);
+}
+
+// The text index of all the documents is built once and kept for the whole
+// run.
+const indexes::text::TextIndexSchema &FuzzyIndex() {
+  static const indexes::Text *text = [] {
+    auto schema = std::make_shared<indexes::text::TextIndexSchema>(
+        data_model::LANGUAGE_ENGLISH, std::string(kDefaultPunctuation), true,
+        kDefaultStopWords, kDefaultMinStemSize);
+    auto *text =
+        new indexes::Text(CreateTextIndexProto(false, true, 1.0), schema);
+    auto keys = MakeKeys(kNumDocuments);
+    const auto &documents = Documents();
+    for (size_t i = 0; i < kNumDocuments; ++i) {
+      schema->StageAttributeData(keys[i], documents[i], 0, false, false)
+          .IgnoreError();
+      schema->CommitKeyData(keys[i]);
+    }
+    return text;
+  }();
+  return *text->GetTextIndexSchema();
+}
+
+// Words of the vocabulary with one letter replaced, as mistyped in queries.
+std::vector<std::string> MakeFuzzyPatterns() {
+  std::mt19937 gen(kSeed + 1);
+  std::uniform_int_distribution<size_t> word(0, kVocabularySize - 1);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::vector<std::string> patterns;
+  patterns.reserve(kNumQueries);
+  for (size_t i = 0; i < kNumQueries; ++i) {
+    std::string pattern = Vocabulary()[word(gen)];
+    std::uniform_int_distribution<size_t> offset(0, pattern.size() - 1);
+    pattern[offset(gen)] = static_cast<char>(letter(gen));
+    patterns.push_back(std::move(pattern));
+  }
+  return patterns;
+}
+
+void BM_FuzzySearch(benchmark::State &state) {
+  const size_t distance = state.range(0);
+  const auto &prefix_tree = FuzzyIndex().GetTextIndex()->GetPrefix();
+  auto patterns = MakeFuzzyPatterns();
+  uint32_t max_words = options::GetMaxTermExpansions().GetValue();
+  size_t i = 0;
+  size_t words = 0;
+  for (auto _ : state) {
+    auto key_iterators = indexes::text::FuzzySearch::Search(
+        prefix_tree, patterns[i++ % kNumQueries], distance, max_words);
+    words += key_iterators.size();
+    benchmark::DoNotOptimize(key_iterators);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["words_per_query"] =
+      benchmark::Counter(words, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_FlatPositionMap_Encode)
+    ->ArgName("positions")
+    ->RangeMultiplier(8)
+    ->Range(1, 4096);
+BENCHMARK(BM_FlatPositionMap_Iterate)
+    ->ArgName("positions")
+    ->RangeMultiplier(8)
+    ->Range(1, 4096);
+BENCHMARK(BM_Postings_Insert)->ArgName("keys")->Arg(1000)->Arg(100000);
+BENCHMARK(BM_Postings_Iterate)->ArgName("keys")->Arg(1000)->Arg(100000);
+BENCHMARK(BM_Lexer_Tokenize)->ArgName("stemming")->Arg(0)->Arg(1);
+BENCHMARK(BM_FuzzySearch)->ArgName("distance")->Arg(1)->Arg(2);
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
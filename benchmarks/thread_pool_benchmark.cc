@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <thread>
+
+#include "absl/synchronization/blocking_counter.h"
+#include "benchmark/benchmark.h"
+#include "vmsdk/src/thread_pool.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+// Tasks scheduled by each producer per iteration, before waiting for them.
+constexpr size_t kBatch = 1000;
+
+// Throughput of scheduling empty tasks and running them, i.e. the cost of the
+// queue, its lock and the wakeups, with several producers scheduling into the
+// same pool as the main thread and the coordinator threads do.
+void BM_ThreadPool_Schedule(benchmark::State &state) {
+  static vmsdk::ThreadPool *pool = nullptr;
+  if (state.thread_index() == 0) {
+    pool = new vmsdk::ThreadPool("benchmark-pool", state.range(0));
+    pool->StartWorkers();
+  }
+  for (auto _ : state) {
+    absl::BlockingCounter pending(kBatch);
+    for (size_t i = 0; i < kBatch; ++i) {
+      pool->Schedule([&pending] { pending.DecrementCount(); },
+                     vmsdk::ThreadPool::Priority::kHigh);
+    }
+    pending.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kBatch);
+  if (state.thread_index() == 0) {
+    delete pool;
+    pool = nullptr;
+  }
+}
+
+BENCHMARK(BM_ThreadPool_Schedule)
+    ->ArgName("workers")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->ThreadRange(1, std::thread::hardware_concurrency())
+    ->UseRealTime();
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "benchmark/benchmark.h"
+#include "benchmarks/benchmark_utils.h"
+#include "src/index_schema.pb.h"
+#include "src/indexes/vector_flat.h"
+#include "src/indexes/vector_hnsw.h"
+#include "testing/common.h"
+
+namespace valkey_search::benchmarks {
+
+namespace {
+
+// Number of vectors added to an index before a new one is created, so that
+// the add benchmarks measure inserts into an index of a realistic size.
+constexpr size_t kAddBatch = 10000;
+// Number of vectors in the index searched by the search benchmarks.
+constexpr size_t kIndexSize = 10000;
+constexpr size_t kNumQueries = 1000;
+constexpr uint64_t kK = 10;
+constexpr int kEfConstruction = 100;
+constexpr size_t kEfRuntime = 100;
+constexpr uint32_t kBlockSize = 1024;
+
+std::shared_ptr<indexes::VectorHNSW<float>> CreateHNSW(int dimensions, int m,
+                                                       size_t capacity) {
+  return indexes::VectorHNSW<float>::Create(
+             CreateHNSWVectorIndexProto(dimensions,
+                                        data_model::DISTANCE_METRIC_L2,
+                                        capacity, m, kEfConstruction,
+                                        kEfRuntime),
+             "vector", data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH)
+      .value();
+}
+
+std::shared_ptr<indexes::VectorFlat<float>> CreateFlat(int dimensions,
+                                                       size_t capacity) {
+  return indexes::VectorFlat<float>::Create(
+             CreateFlatVectorIndexProto(dimensions,
+                                        data_model::DISTANCE_METRIC_L2,
+                                        capacity, kBlockSize),
+             "vector", data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH)
+      .value();
+}
+
+// Adds vectors to a fresh index, recreating it every kAddBatch vectors outside
+// of the timed region.
+template <typename CreateFn>
+void RunAddBenchmark(benchmark::State &state, int dimensions,
+                     CreateFn create) {
+  auto keys = MakeKeys(kAddBatch);
+  auto vectors = MakeVectors(kAddBatch, dimensions);
+  decltype(create()) index;
+  size_t i = kAddBatch;
+  for (auto _ : state) {
+    if (i == kAddBatch) {
+      state.PauseTiming();
+      index = create();
+      i = 0;
+      state.ResumeTiming();
+    }
+    auto added = index->AddRecord(keys[i], vectors[i]);
+    benchmark::DoNotOptimize(added);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Indexes are expensive to build, so the searched indexes are built once per
+// set of parameters and kept for the whole run.
+template <typename Index>
+std::shared_ptr<Index> &CachedIndex(int dimensions, int m) {
+  static auto *cache =
+      new absl::flat_hash_map<std::tuple<int, int>, std::shared_ptr<Index>>();
+  return (*cache)[{dimensions, m}];
+}
+
+template <typename Index>
+void RunSearchBenchmark(benchmark::State &state, int dimensions,
+                        const std::shared_ptr<Index> &index) {
+  auto queries = MakeVectors(kNumQueries, dimensions, kSeed + 1);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto neighbors = index->Search(queries[i++ % kNumQueries], kK,
+                                   CancelNever());
+    benchmark::DoNotOptimize(neighbors);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_VectorHNSW_Add(benchmark::State &state) {
+  const int dimensions = state.range(0);
+  const int m = state.range(1);
+  RunAddBenchmark(state, dimensions,
+                  [&] { return CreateHNSW(dimensions, m, kAddBatch); });
+}
+
+void BM_VectorHNSW_Search(benchmark::State &state) {
+  const int dimensions = state.range(0);
+  const int m = state.range(1);
+  auto &index = CachedIndex<indexes::VectorHNSW<float>>(dimensions, m);
+  if (!index) {
+    index = CreateHNSW(dimensions, m, kIndexSize);
+    auto keys = MakeKeys(kIndexSize);
+    auto vectors = MakeVectors(kIndexSize, dimensions);
+    for (size_t i = 0; i < kIndexSize; ++i) {
+      index->AddRecord(keys[i], vectors[i]).IgnoreError();
+    }
+  }
+  RunSearchBenchmark(state, dimensions, index);
+}
+
+void BM_VectorFlat_Add(benchmark::State &state) {
+  const int dimensions = state.range(0);
+  RunAddBenchmark(state, dimensions,
+                  [&] { return CreateFlat(dimensions, kAddBatch); });
+}
+
+void BM_VectorFlat_Search(benchmark::State &state) {
+  const int dimensions = state.range(0);
+  auto &index = CachedIndex<indexes::VectorFlat<float>>(dimensions, 0);
+  if (!index) {
+    index = CreateFlat(dimensions, kIndexSize);
+    auto keys = MakeKeys(kIndexSize);
+    auto vectors = MakeVectors(kIndexSize, dimensions);
+    for (size_t i = 0; i < kIndexSize; ++i) {
+      index->AddRecord(keys[i], vectors[i]).IgnoreError();
+    }
+  }
+  RunSearchBenchmark(state, dimensions, index);
+}
+
+// Arguments are {dimensions, M}.
+BENCHMARK(BM_VectorHNSW_Add)
+    ->ArgNames({"dim", "M"})
+    ->ArgsProduct({{32, 128, 768}, {8, 16, 32}});
+BENCHMARK(BM_VectorHNSW_Search)
+    ->ArgNames({"dim", "M"})
+    ->ArgsProduct({{32, 128, 768}, {8, 16, 32}});
+BENCHMARK(BM_VectorFlat_Add)->ArgName("dim")->Arg(32)->Arg(128)->Arg(768);
+BENCHMARK(BM_VectorFlat_Search)->ArgName("dim")->Arg(32)->Arg(128)->Arg(768);
+
+}  // namespace
+
+}  // namespace valkey_search::benchmarks
@@ -8,6 +8,8 @@ CMAKE_TARGET=""
 CMAKE_EXTRA_ARGS="${CMAKE_EXTRA_ARGS:-}"
 FORMAT="no"
 RUN_TEST=""
+RUN_BENCHMARKS="no"
+BENCHMARK_FILTER="."
 RUN_BUILD="yes"
 DUMP_TEST_ERRORS_STDOUT="no"
 INTEGRATION_TEST="no"
@@ -31,6 +33,7 @@ Usage: build.sh [options...]
     --clean                           Clean the current build configuration (debug or release).
     --format                          Applies clang-format. (Run in dev container environment to ensure correct clang-format version)
     --run-tests                       Run all tests. Optionally, pass a test name to run: "--run-tests=<test-name>".
+    --run-benchmarks[=regex]          Run the micro-benchmarks, optionally only those matching the regex, and store the JSON results per commit.
     --no-build                        By default, build.sh always triggers a build. This option disables this behavior.
     --test-errors-stdout              When a test fails, dump the captured tests output to stdout.
     --run-integration-tests[=pattern] Run integration tests.
@@ -89,6 +92,17 @@ while [ $# -gt 0 ]; do
         shift || true
         echo "Running test ${RUN_TEST}"
         ;;
+    --run-benchmarks)
+        RUN_BENCHMARKS="yes"
+        shift || true
+        echo "Running all benchmarks"
+        ;;
+    --run-benchmarks=*)
+        RUN_BENCHMARKS="yes"
+        BENCHMARK_FILTER=${1#*=}
+        shift || true
+        echo "Running benchmarks matching ${BENCHMARK_FILTER}"
+        ;;
     --unittest-output=*)
         UNITTEST_OUTPUT="${arg#*=}"
         shift || true
@@ -295,10 +309,30 @@ function build() {
 function format() {
     cd "${ROOT_DIR}"
     printf "Formatting...\n"
-    find src testing vmsdk/src vmsdk/testing -name "*.h" -o -name "*.cc" | grep -v '^src/indexes/text/rax/' | xargs clang-format -i
+    find src testing benchmarks vmsdk/src vmsdk/testing -name "*.h" -o -name "*.cc" | grep -v '^src/indexes/text/rax/' | xargs clang-format -i
     printf "Applied clang-format\n"
 }
 
+# Runs every benchmark executable, the JSON results are kept under a directory
+# named after the commit, so that runs of different commits can be compared
+# with Google Benchmark's tools/compare.py.
+function run_benchmarks() {
+    if [[ "${SAN_BUILD}" != "no" ]]; then
+        LOG_WARNING "Benchmarks are not built with sanitizers, skipping"
+        return
+    fi
+    local revision=$(git -C "${ROOT_DIR}" describe --always --dirty 2>/dev/null || echo "unknown")
+    local results_dir=${BENCHMARKS_DIR}/results/${revision}
+    mkdir -p "${results_dir}"
+    while read -r benchmark; do
+        printf "${BOLD_PINK}Running:${RESET} ${benchmark}\n"
+        "${benchmark}" --benchmark_filter="${BENCHMARK_FILTER}" \
+            --benchmark_out="${results_dir}/$(basename ${benchmark}).json" \
+            --benchmark_out_format=json || EXIT_CODE=1
+    done < <(find "${BENCHMARKS_DIR}" -maxdepth 1 -name "*_benchmark" -type f | sort)
+    printf "${BLUE}Benchmark results can be found here:${RESET} ${results_dir}\n"
+}
+
 function print_test_prefix() {
     printf "${BOLD_PINK}Running:${RESET} $1"
 }
@@ -433,6 +467,7 @@ if [[ "${SAN_BUILD}" != "no" ]]; then
 fi
 
 TESTS_DIR=${BUILD_DIR}/tests
+BENCHMARKS_DIR=${BUILD_DIR}/benchmarks
 TEST_OUTPUT_FILE=${BUILD_DIR}/tests.out
 
 printf "Checking if configure is required..."
@@ -525,6 +560,10 @@ elif [[ "${INTEGRATION_TEST}" == "yes" ]]; then
     popd >/dev/null
 fi
 
+if [[ "${RUN_BENCHMARKS}" == "yes" ]]; then
+    run_benchmarks
+fi
+
 END_TIME=$(date +%s)
 TEST_RUNTIME=$((END_TIME - START_TIME))
 exit ${EXIT_CODE}
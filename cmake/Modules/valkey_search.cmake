@@ -202,3 +202,32 @@ macro(finalize_test_flags __TARGET)
 
   endif()
 endmacro()
+
+# Same as finalize_test_flags, but keeps the optimization level of the build
+# configuration and does not link a main, benchmarks provide their own.
+macro(finalize_benchmark_flags __TARGET)
+  if(UNIX AND NOT APPLE)
+    target_link_options(${__TARGET} PRIVATE "LINKER:--start-group")
+  endif()
+  foreach(__lib ${THIRD_PARTY_LIBS})
+    target_link_libraries(${__TARGET} PRIVATE ${__lib})
+  endforeach()
+
+  if(UNIX AND NOT APPLE)
+    target_link_options(${__TARGET} PRIVATE
+                        "LINKER:--allow-multiple-definition")
+  endif()
+
+  valkey_search_target_update_compile_flags(${__TARGET})
+  set_target_properties(${__TARGET} PROPERTIES RUNTIME_OUTPUT_DIRECTORY
+                                               "${CMAKE_BINARY_DIR}/benchmarks")
+  if(UNIX AND NOT APPLE)
+    target_link_libraries(${__TARGET} PRIVATE lib_to_add_end_group_flag)
+  endif()
+
+  if(VALKEY_SEARCH_IS_ARM)
+    target_link_libraries(${__TARGET} PRIVATE pthread)
+  endif()
+  target_link_libraries(${__TARGET} PRIVATE benchmark::benchmark GTest::gtest
+                                            GTest::gmock)
+endmacro()
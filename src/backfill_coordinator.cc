@@ -0,0 +1,421 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/backfill_coordinator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/time/time.h"
+#include "src/index_schema.h"
+#include "src/keyspace_event_manager.h"
+#include "src/utils/patricia_tree.h"
+#include "src/valkey_search_options.h"
+#include "vmsdk/src/debug.h"
+#include "vmsdk/src/log.h"
+#include "vmsdk/src/managed_pointers.h"
+#include "vmsdk/src/module_config.h"
+#include "vmsdk/src/thread_pool.h"
+#include "vmsdk/src/type_conversions.h"
+#include "vmsdk/src/utils.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+CONTROLLED_BOOLEAN(StopBackfill, false);
+
+namespace {
+
+// The smallest number of keys scanned per call once the batch size adapts.
+constexpr uint32_t kMinAdaptiveBatchSize = 16;
+// How long an extraction task holds the server lock before yielding it.
+constexpr absl::Duration kExtractionLockWindow = absl::Microseconds(500);
+// How long an extraction task backs off when the server lock is contended,
+// doubling on each consecutive failure.
+constexpr mstime_t kExtractionMinRetryDelayMs = 1;
+constexpr mstime_t kExtractionMaxRetryDelayMs = 64;
+// Scanning pauses while this many batches of keys wait for extraction.
+constexpr uint64_t kMaxPendingBatches = 2;
+
+}  // namespace
+
+// Keys collected by the main thread whose fields are read on the extraction
+// thread pool.
+struct BackfillCoordinator::Extraction {
+  struct Entry {
+    std::string key;
+    // Positions in `schemas` of the schemas interested in the key.
+    absl::InlinedVector<uint32_t, 4> schemas;
+  };
+
+  ~Extraction() {
+    // Release the keys that were never extracted, e.g. if the thread pool was
+    // stopped.
+    for (; next < entries.size(); ++next) {
+      for (auto position : entries[next].schemas) {
+        if (auto index_schema = schemas[position].lock()) {
+          --index_schema->stats_.backfill_inqueue_tasks;
+        }
+      }
+      --scan_ctx->pending_keys;
+    }
+  }
+
+  vmsdk::ThreadPool *thread_pool{nullptr};
+  std::shared_ptr<ScanContext> scan_ctx;
+  std::vector<std::weak_ptr<IndexSchema>> schemas;
+  std::vector<Entry> entries;
+  size_t next{0};
+  // The current backoff, zero unless the last attempt found the server lock
+  // contended.
+  mstime_t retry_delay_ms{0};
+};
+
+struct BackfillCoordinator::ScanBatch {
+  // Key prefixes of the schemas taking part in the scan round.
+  PatriciaTree<IndexSchema *> prefix_trie{true};
+  std::vector<IndexSchema *> members;
+  uint64_t scanned_key_count{0};
+  // Set when the fields are read off the main thread.
+  std::unique_ptr<Extraction> extraction;
+};
+
+void BackfillCoordinator::BackfillScanCallback(ValkeyModuleCtx *ctx,
+                                               ValkeyModuleString *keyname,
+                                               ValkeyModuleKey *key,
+                                               void *privdata) {
+  auto *batch = reinterpret_cast<ScanBatch *>(privdata);
+  ++batch->scanned_key_count;
+  auto key_view = vmsdk::ToStringView(keyname);
+  // A schema with nested prefixes matches the same key more than once.
+  absl::InlinedVector<IndexSchema *, 4> interested;
+  for (auto match_itr = batch->prefix_trie.PathIterator(key_view);
+       !match_itr.Done(); match_itr.Next()) {
+    for (auto *index_schema : *match_itr.Value().value) {
+      if (std::find(interested.begin(), interested.end(), index_schema) ==
+          interested.end()) {
+        interested.push_back(index_schema);
+      }
+    }
+  }
+  if (interested.empty()) {
+    return;
+  }
+  if (batch->extraction) {
+    auto &entry = batch->extraction->entries.emplace_back();
+    entry.key = std::string(key_view);
+    for (auto *index_schema : interested) {
+      auto position = std::find(batch->members.begin(), batch->members.end(),
+                                index_schema) -
+                      batch->members.begin();
+      entry.schemas.push_back(position);
+      ++index_schema->stats_.backfill_inqueue_tasks;
+    }
+    return;
+  }
+  // Open the key and read each record once for all the interested schemas.
+  absl::InlinedVector<KeyspaceEventSubscription *, 4> consumers(
+      interested.begin(), interested.end());
+  KeyRecordCache cache(ctx, keyname, consumers);
+  for (auto *index_schema : interested) {
+    index_schema->ProcessKeyspaceNotification(cache, true);
+  }
+}
+
+void BackfillCoordinator::ScheduleExtraction(
+    std::unique_ptr<Extraction> extraction) {
+  auto *thread_pool = extraction->thread_pool;
+  thread_pool->Schedule(
+      [extraction = std::move(extraction)]() mutable {
+        RunExtraction(std::move(extraction));
+      },
+      vmsdk::ThreadPool::Priority::kLow);
+}
+
+void BackfillCoordinator::OnExtractionRetryTimer(
+    [[maybe_unused]] ValkeyModuleCtx *ctx, void *data) {
+  ScheduleExtraction(
+      std::unique_ptr<Extraction>(reinterpret_cast<Extraction *>(data)));
+}
+
+void BackfillCoordinator::RunExtraction(
+    std::unique_ptr<Extraction> extraction) {
+  auto *ctx = extraction->scan_ctx->ctx.get();
+  bool owns_lock;
+  {
+    // Never block on the server lock: the main thread may be waiting for the
+    // writer threads while holding it.
+    vmsdk::ThreadSafeContextTryLockGuard lock(ctx);
+    owns_lock = lock.OwnsLock();
+    if (owns_lock) {
+      // Held only while the server lock is, so a dropped schema is never
+      // destructed outside of it.
+      std::vector<std::shared_ptr<IndexSchema>> schemas;
+      schemas.reserve(extraction->schemas.size());
+      for (const auto &weak_index_schema : extraction->schemas) {
+        schemas.push_back(weak_index_schema.lock());
+      }
+      vmsdk::StopWatch window;
+      auto &entries = extraction->entries;
+      while (extraction->next < entries.size() &&
+             window.Duration() < kExtractionLockWindow) {
+        const auto &entry = entries[extraction->next++];
+        auto keyname = vmsdk::MakeUniqueValkeyString(entry.key);
+        absl::InlinedVector<KeyspaceEventSubscription *, 4> consumers;
+        for (auto position : entry.schemas) {
+          if (schemas[position]) {
+            consumers.push_back(schemas[position].get());
+          }
+        }
+        KeyRecordCache cache(ctx, keyname.get(), consumers);
+        --extraction->scan_ctx->pending_keys;
+        for (auto position : entry.schemas) {
+          auto &index_schema = schemas[position];
+          if (!index_schema) {
+            continue;
+          }
+          index_schema->ProcessKeyspaceNotification(cache, true);
+          --index_schema->stats_.backfill_inqueue_tasks;
+        }
+      }
+      auto window_us = absl::ToInt64Microseconds(window.Duration());
+      for (const auto &index_schema : schemas) {
+        if (index_schema) {
+          index_schema->stats_.backfill_stall_us += window_us;
+        }
+      }
+    }
+  }
+  if (extraction->next == extraction->entries.size()) {
+    return;
+  }
+  if (owns_lock) {
+    extraction->retry_delay_ms = 0;
+    ScheduleExtraction(std::move(extraction));
+    return;
+  }
+  // Back off on a main thread timer rather than by sleeping, which would hold
+  // up a thread of the pool.
+  extraction->retry_delay_ms =
+      extraction->retry_delay_ms == 0
+          ? kExtractionMinRetryDelayMs
+          : std::min(extraction->retry_delay_ms * 2,
+                     kExtractionMaxRetryDelayMs);
+  auto retry_delay_ms = extraction->retry_delay_ms;
+  vmsdk::StartTimerFromBackgroundThread(ctx, retry_delay_ms,
+                                        OnExtractionRetryTimer,
+                                        extraction.release());
+}
+
+bool BackfillCoordinator::ShouldExtractOffMainThread() const {
+  return options::GetBackfillOffMainThread().GetValue() &&
+         extraction_thread_pool_ && extraction_thread_pool_->Size() > 0;
+}
+
+uint32_t BackfillCoordinator::AdaptBatchSize(uint32_t current,
+                                             uint32_t max_batch_size,
+                                             uint64_t scanned,
+                                             absl::Duration elapsed,
+                                             absl::Duration max_stall) {
+  if (max_stall <= absl::ZeroDuration()) {
+    return max_batch_size;
+  }
+  uint64_t upper = std::min<uint64_t>(max_batch_size, uint64_t{current} * 2);
+  uint64_t lower = std::min<uint64_t>(kMinAdaptiveBatchSize, upper);
+  if (scanned == 0 || elapsed <= absl::ZeroDuration()) {
+    return upper;
+  }
+  double ideal = scanned * absl::FDivDuration(max_stall, elapsed);
+  if (ideal >= upper) {
+    return upper;
+  }
+  return std::max<uint64_t>(ideal, lower);
+}
+
+uint32_t BackfillCoordinator::PerformBackfill(
+    ValkeyModuleCtx *ctx, uint32_t db_num,
+    const std::vector<std::shared_ptr<IndexSchema>> &schemas,
+    uint32_t batch_size) {
+  auto &db_scans = db_scans_.Get();
+  std::vector<IndexSchema *> pending;
+  for (const auto &index_schema : schemas) {
+    auto &backfill_job = index_schema->backfill_job_.Get();
+    if (backfill_job.has_value() && !backfill_job->IsScanDone()) {
+      pending.push_back(index_schema.get());
+    }
+  }
+  if (pending.empty()) {
+    // The scan context stays selected on the DB until all of the keys it
+    // collected were extracted.
+    auto itr = db_scans.find(db_num);
+    if (itr != db_scans.end() && itr->second.scan_ctx->pending_keys == 0) {
+      db_scans.erase(itr);
+    }
+    return 0;
+  }
+
+  if (StopBackfill.GetValue()) {
+    VMSDK_LOG_EVERY_N_SEC(NOTICE, ctx, 1) << "Backfill stopped by request";
+    return 0;
+  }
+
+  auto [itr, inserted] = db_scans.try_emplace(db_num);
+  auto &db_scan = itr->second;
+  if (inserted) {
+    db_scan.scan_ctx = std::make_shared<ScanContext>();
+    db_scan.scan_ctx->ctx =
+        vmsdk::MakeUniqueValkeyDetachedThreadSafeContext(ctx);
+    ValkeyModule_SelectDb(db_scan.scan_ctx->ctx.get(), db_num);
+    db_scan.cursor = vmsdk::MakeUniqueValkeyScanCursor();
+    db_scan.batch_size = batch_size;
+  }
+  // Schemas can only join a round before its first key was scanned. If every
+  // schema of the round was dropped or is done, restart the round for the
+  // waiting ones.
+  bool has_members = std::any_of(
+      pending.begin(), pending.end(), [](IndexSchema *index_schema) {
+        return index_schema->backfill_job_.Get()->joined_scan;
+      });
+  if (!has_members && db_scan.scanned_key_count > 0) {
+    db_scan.cursor = vmsdk::MakeUniqueValkeyScanCursor();
+    db_scan.scanned_key_count = 0;
+    db_scan.stopwatch.Reset();
+  }
+  ScanBatch batch;
+  for (auto *index_schema : pending) {
+    auto &backfill_job = index_schema->backfill_job_.Get();
+    if (db_scan.scanned_key_count == 0) {
+      backfill_job->joined_scan = true;
+    }
+    if (backfill_job->joined_scan) {
+      batch.members.push_back(index_schema);
+    }
+  }
+
+  // Let the extraction catch up before collecting more keys.
+  if (db_scan.scan_ctx->pending_keys >= kMaxPendingBatches * batch_size) {
+    return 0;
+  }
+  if (ShouldExtractOffMainThread()) {
+    batch.extraction = std::make_unique<Extraction>();
+    batch.extraction->thread_pool = extraction_thread_pool_;
+    batch.extraction->scan_ctx = db_scan.scan_ctx;
+    for (auto *index_schema : batch.members) {
+      batch.extraction->schemas.push_back(index_schema->GetWeakPtr());
+    }
+  }
+
+  // We need to ensure the DB size is monotonically increasing, since it could
+  // change during the backfill, in which case we may show incorrect progress.
+  uint64_t db_size = ValkeyModule_DbSize(db_scan.scan_ctx->ctx.get());
+  for (auto *index_schema : batch.members) {
+    auto &backfill_job = index_schema->backfill_job_.Get();
+    backfill_job->paused_by_oom = false;
+    backfill_job->db_size = std::max(backfill_job->db_size, db_size);
+    for (const auto &prefix : index_schema->GetKeyPrefixes()) {
+      batch.prefix_trie.AddKeyValue(prefix, index_schema);
+    }
+  }
+
+  const uint32_t scan_limit = std::min(db_scan.batch_size, batch_size);
+  vmsdk::StopWatch scan_time;
+  bool scan_done = false;
+  while (batch.scanned_key_count < scan_limit) {
+    auto ctx_flags = ValkeyModule_GetContextFlags(ctx);
+    if (ctx_flags & VALKEYMODULE_CTX_FLAGS_OOM) {
+      for (auto *index_schema : batch.members) {
+        index_schema->backfill_job_.Get()->paused_by_oom = true;
+      }
+      break;
+    }
+
+    // Scan will return zero if there are no more keys to scan. This could be
+    // the case either if there are no keys at all or if we have reached the
+    // end of the current iteration. Because of this, we use the scanned key
+    // count to know how many keys we have scanned in total (either zero or
+    // one).
+    if (!ValkeyModule_Scan(db_scan.scan_ctx->ctx.get(), db_scan.cursor.get(),
+                           BackfillScanCallback, (void *)&batch)) {
+      scan_done = true;
+      break;
+    }
+  }
+  auto elapsed = scan_time.Duration();
+  // Only a full batch tells how long a batch of this size takes.
+  if (batch.scanned_key_count >= scan_limit) {
+    db_scan.batch_size = AdaptBatchSize(
+        db_scan.batch_size, batch_size, batch.scanned_key_count, elapsed,
+        absl::Microseconds(options::GetBackfillMaxStallUs().GetValue()));
+  }
+  if (batch.extraction && !batch.extraction->entries.empty()) {
+    db_scan.scan_ctx->pending_keys += batch.extraction->entries.size();
+    ScheduleExtraction(std::move(batch.extraction));
+  }
+
+  db_scan.scanned_key_count += batch.scanned_key_count;
+  auto elapsed_us = absl::ToInt64Microseconds(elapsed);
+  for (auto *index_schema : batch.members) {
+    index_schema->stats_.backfill_stall_us += elapsed_us;
+    auto &backfill_job = index_schema->backfill_job_.Get();
+    backfill_job->scanned_key_count += batch.scanned_key_count;
+    if (scan_done) {
+      VMSDK_LOG(NOTICE, ctx)
+          << "Index schema "
+          << vmsdk::config::RedactIfNeeded(index_schema->GetName())
+          << " finished backfill scan. Scanned "
+          << backfill_job->scanned_key_count << " keys in "
+          << absl::FormatDuration(backfill_job->stopwatch.Duration());
+      backfill_job->MarkScanAsDone();
+    }
+  }
+  if (scan_done) {
+    VMSDK_LOG(NOTICE, ctx) << "Backfill scan of DB " << db_num
+                           << " finished for " << batch.members.size()
+                           << " index schema(s). Scanned "
+                           << db_scan.scanned_key_count << " keys in "
+                           << absl::FormatDuration(
+                                  db_scan.stopwatch.Duration());
+    // Schemas that were waiting for this round start the next one.
+    if (db_scan.scan_ctx->pending_keys == 0) {
+      db_scans.erase(db_num);
+    }
+  }
+  return batch.scanned_key_count;
+}
+
+void BackfillCoordinator::OnSwapDB(ValkeyModuleSwapDbInfo *swap_db_info) {
+  auto &db_scans = db_scans_.Get();
+  uint32_t first = swap_db_info->dbnum_first;
+  uint32_t second = swap_db_info->dbnum_second;
+  if (first == second) {
+    return;
+  }
+  // The scans follow the data, as the schemas do. Pending extractions share
+  // the scan context, so they follow it too.
+  absl::flat_hash_map<uint32_t, DbScan> swapped;
+  for (auto &[db_num, db_scan] : db_scans) {
+    uint32_t new_db_num = db_num;
+    if (db_num == first) {
+      new_db_num = second;
+    } else if (db_num == second) {
+      new_db_num = first;
+    }
+    if (new_db_num != db_num) {
+      ValkeyModule_SelectDb(db_scan.scan_ctx->ctx.get(), new_db_num);
+    }
+    swapped.emplace(new_db_num, std::move(db_scan));
+  }
+  db_scans = std::move(swapped);
+}
+
+}  // namespace valkey_search
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_BACKFILL_COORDINATOR_H_
+#define VALKEYSEARCH_SRC_BACKFILL_COORDINATOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "src/index_schema.h"
+#include "vmsdk/src/managed_pointers.h"
+#include "vmsdk/src/thread_pool.h"
+#include "vmsdk/src/utils.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+//
+// Drives the backfill of all index schemas with a single keyspace scan per DB.
+//
+// Each scanned key is matched against the key prefixes of the schemas taking
+// part in the scan and handed to every schema that is interested in it, with
+// the key opened only once. The cost of a backfill is therefore proportional
+// to the number of keys in the DB rather than to keys times indexes.
+//
+// A scan round starts when a DB has schemas waiting to be backfilled. Schemas
+// created while a round is in progress wait for the next round, since the
+// keys already visited by the cursor would otherwise be missed.
+//
+// The number of keys scanned per call adapts to the time the main thread
+// spends scanning, bounded by `search.backfill-max-stall-us`. When
+// `search.backfill-off-main-thread` is set, the main thread only collects the
+// names of the matching keys; the fields are read on the extraction thread
+// pool, which takes the server lock for short windows and yields it whenever
+// it is contended, retrying from a main thread timer with an exponential
+// backoff. All other access is from the main thread.
+//
+class BackfillCoordinator {
+ public:
+  explicit BackfillCoordinator(
+      vmsdk::ThreadPool *extraction_thread_pool = nullptr)
+      : extraction_thread_pool_(extraction_thread_pool) {}
+  BackfillCoordinator(const BackfillCoordinator &) = delete;
+  BackfillCoordinator &operator=(const BackfillCoordinator &) = delete;
+
+  // Scans up to `batch_size` keys of the DB of the given schemas, which must
+  // all belong to `db_num`. Returns the number of keys scanned.
+  uint32_t PerformBackfill(
+      ValkeyModuleCtx *ctx, uint32_t db_num,
+      const std::vector<std::shared_ptr<IndexSchema>> &schemas,
+      uint32_t batch_size);
+
+  void OnSwapDB(ValkeyModuleSwapDbInfo *swap_db_info);
+
+  bool IsScanInProgress(uint32_t db_num) const {
+    return db_scans_.Get().contains(db_num);
+  }
+
+  // Returns the number of keys to scan in the next call, given that the last
+  // call scanned `scanned` keys in `elapsed`. The size moves towards the one
+  // that would have taken `max_stall`, growing at most twofold per call.
+  static uint32_t AdaptBatchSize(uint32_t current, uint32_t max_batch_size,
+                                 uint64_t scanned, absl::Duration elapsed,
+                                 absl::Duration max_stall);
+
+ private:
+  struct ScanBatch;
+  struct Extraction;
+  static void BackfillScanCallback(ValkeyModuleCtx *ctx,
+                                   ValkeyModuleString *keyname,
+                                   ValkeyModuleKey *key, void *privdata);
+  static void ScheduleExtraction(std::unique_ptr<Extraction> extraction);
+  static void RunExtraction(std::unique_ptr<Extraction> extraction);
+  static void OnExtractionRetryTimer(ValkeyModuleCtx *ctx, void *data);
+  bool ShouldExtractOffMainThread() const;
+
+  // Shared with the extraction tasks, which outlive neither the context nor
+  // the count of the keys they still hold.
+  struct ScanContext {
+    vmsdk::UniqueValkeyDetachedThreadSafeContext ctx;
+    std::atomic<uint64_t> pending_keys{0};
+  };
+
+  struct DbScan {
+    std::shared_ptr<ScanContext> scan_ctx;
+    vmsdk::UniqueValkeyScanCursor cursor;
+    uint64_t scanned_key_count{0};
+    uint32_t batch_size{0};
+    vmsdk::StopWatch stopwatch;
+  };
+
+  vmsdk::ThreadPool *extraction_thread_pool_;
+  vmsdk::MainThreadAccessGuard<absl::flat_hash_map<uint32_t, DbScan>>
+      db_scans_;
+};
+
+}  // namespace valkey_search
+
+#endif  // VALKEYSEARCH_SRC_BACKFILL_COORDINATOR_H_
@@ -8,8 +8,10 @@
 #include "src/commands/commands.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "fanout.h"
 #include "ft_create_parser.h"
 #include "src/acl.h"
@@ -17,6 +19,7 @@
 #include "src/metrics.h"
 #include "src/query/fanout.h"
 #include "src/query/search.h"
+#include "src/query/slowlog.h"
 #include "src/schema_manager.h"
 #include "src/valkey_search.h"
 #include "vmsdk/src/blocked_client.h"
@@ -58,7 +61,7 @@ int Reply(ValkeyModuleCtx *ctx, ValkeyModuleString **argv, int argc) {
     return ValkeyModule_ReplyWithError(
         ctx, "Search operation cancelled due to timeout");
   }
-  parameters->SendReply(ctx, parameters->search_result);
+  parameters->SendReplyMaybeProfiled(ctx);
   return VALKEYMODULE_OK;
 }
 
@@ -111,6 +114,9 @@ CONTROLLED_BOOLEAN(ForceInvalidIndexFingerprint, false);
 absl::Status QueryCommand::Execute(ValkeyModuleCtx *ctx,
                                    ValkeyModuleString **argv, int argc,
                                    std::unique_ptr<QueryCommand> parameters) {
+  if (!parameters->timings && query::SlowLog::IsEnabled()) {
+    parameters->timings.emplace();
+  }
   auto status = [&]() -> absl::Status {
     auto &schema_manager = SchemaManager::Instance();
     vmsdk::ArgsIterator itr{argv + 1, argc - 1};
@@ -124,10 +130,21 @@ absl::Status QueryCommand::Execute(ValkeyModuleCtx *ctx,
     VMSDK_ASSIGN_OR_RETURN(
         parameters->index_schema,
         schema_manager.GetIndexSchema(db_num, parameters->index_schema_name));
+    if (parameters->index_schema->IsBulkLoadInProgress()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Index ", parameters->index_schema_name, " is being bulk loaded"));
+    }
     VMSDK_RETURN_IF_ERROR(
         vmsdk::ParseParamValue(itr, parameters->parse_vars.query_string));
     VMSDK_RETURN_IF_ERROR(parameters->ParseCommand(itr));
+    if (query::SlowLog::IsEnabled()) {
+      parameters->query_text = parameters->parse_vars.query_string;
+    }
     parameters->parse_vars.ClearAtEndOfParse();
+    if (parameters->timings) {
+      // The latency timer starts when the command is received.
+      parameters->timings->parse_time = parameters->latency_timer.Duration();
+    }
     parameters->cancellation_token =
         cancel::Make(parameters->timeout_ms, nullptr);
     VMSDK_RETURN_IF_ERROR(
@@ -165,7 +182,7 @@ absl::Status QueryCommand::Execute(ValkeyModuleCtx *ctx,
         ++Metrics::GetStats().query_failed_requests_cnt;
         return absl::OkStatus();
       }
-      parameters->SendReply(ctx, parameters->search_result);
+      parameters->SendReplyMaybeProfiled(ctx);
       ValkeySearch::Instance().ScheduleSearchResultCleanup(
           [neighbors =
                std::move(parameters->search_result.neighbors)]() mutable {
@@ -216,6 +233,30 @@ absl::Status QueryCommand::Execute(ValkeyModuleCtx *ctx,
   return status;
 }
 
+void QueryCommand::SendReplyMaybeProfiled(ValkeyModuleCtx *ctx) {
+  if (!reply_with_profile) {
+    std::optional<vmsdk::StopWatch> reply_time;
+    if (timings) {
+      reply_time.emplace();
+    }
+    SendReply(ctx, search_result);
+    auto latency = latency_timer.Duration();
+    GetLatencySampler().SubmitSample(latency);
+    if (timings) {
+      query::SlowLog::Instance().MaybeRecord(
+          latency, GetCommandName(), index_schema_name, query_text, *timings,
+          reply_time->Duration());
+    }
+    return;
+  }
+  // Profiled commands are left out of the latency statistics and the slow log,
+  // their reply carries their timing.
+  ValkeyModule_ReplyWithArray(ctx, 2);
+  vmsdk::StopWatch reply_time;
+  SendReply(ctx, search_result);
+  ReplyWithQueryProfile(ctx, *this, reply_time.Duration());
+}
+
 void QueryCommand::QueryCompleteImpl(
     std::unique_ptr<SearchParameters> parameters) {
   blocked_client->SetReplyPrivateData(parameters.release());
@@ -11,8 +11,11 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "src/query/search.h"
 #include "vmsdk/src/command_parser.h"
+#include "vmsdk/src/latency_sampler.h"
+#include "vmsdk/src/utils.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
 namespace valkey_search {
@@ -41,11 +44,16 @@ constexpr absl::string_view kSearchCommand{"FT.SEARCH"};
 constexpr absl::string_view kDebugCommand{"FT._DEBUG"};
 constexpr absl::string_view kAggregateCommand{"FT.AGGREGATE"};
 constexpr absl::string_view kInternalUpdateCommand{"FT.INTERNAL_UPDATE"};
+constexpr absl::string_view kBulkLoadCommand{"FT.BULKLOAD"};
+constexpr absl::string_view kProfileCommand{"FT.PROFILE"};
+constexpr absl::string_view kSlowLogCommand{"FT.SLOWLOG"};
 
 const absl::flat_hash_set<absl::string_view> kCreateCmdPermissions{
     kSearchCategory, kWriteCategory, kFastCategory};
 const absl::flat_hash_set<absl::string_view> kDropIndexCmdPermissions{
     kSearchCategory, kWriteCategory, kFastCategory};
+const absl::flat_hash_set<absl::string_view> kBulkLoadCmdPermissions{
+    kSearchCategory, kWriteCategory, kFastCategory};
 const absl::flat_hash_set<absl::string_view> kInternalUpdateCmdPermissions{
     kAdminCategory, kSearchCategory, kWriteCategory, kFastCategory};
 const absl::flat_hash_set<absl::string_view> kSearchCmdPermissions{
@@ -56,6 +64,8 @@ const absl::flat_hash_set<absl::string_view> kListCmdPermissions{
     kSearchCategory, kReadCategory, kSlowCategory, kAdminCategory};
 const absl::flat_hash_set<absl::string_view> kDebugCmdPermissions{
     kSearchCategory, kReadCategory, kSlowCategory, kAdminCategory};
+const absl::flat_hash_set<absl::string_view> kSlowLogCmdPermissions{
+    kSearchCategory, kSlowCategory, kAdminCategory};
 
 inline absl::flat_hash_set<absl::string_view> PrefixACLPermissions(
     const absl::flat_hash_set<absl::string_view> &cmd_permissions,
@@ -81,6 +91,12 @@ absl::Status FTAggregateCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
                             int argc);
 absl::Status FTInternalUpdateCmd(ValkeyModuleCtx *ctx,
                                  ValkeyModuleString **argv, int argc);
+absl::Status FTBulkLoadCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                           int argc);
+absl::Status FTProfileCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                          int argc);
+absl::Status FTSlowLogCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                          int argc);
 
 //
 // Common stuff for FT.SEARCH and FT.AGGREGATE command
@@ -114,10 +130,38 @@ struct QueryCommand : public query::SearchParameters {
 
   std::optional<vmsdk::BlockedClient> blocked_client;
 
+  //
+  // Sends the reply of the command, wrapped together with the execution
+  // statistics when running under FT.PROFILE.
+  //
+  void SendReplyMaybeProfiled(ValkeyModuleCtx *ctx);
+  //
+  // The sampler of the end to end latency of the command.
+  //
+  virtual vmsdk::LatencySampler &GetLatencySampler() const = 0;
+  //
+  // The name of the command, as recorded in the slow log.
+  //
+  virtual absl::string_view GetCommandName() const = 0;
+
+  // Started when the command is created, before it is parsed.
+  vmsdk::StopWatch latency_timer;
+  // Set by FT.PROFILE to send the profile along with the reply.
+  bool reply_with_profile{false};
+  // The query string, kept for the slow log while it is enabled.
+  std::string query_text;
+
  private:
   void QueryCompleteImpl(std::unique_ptr<SearchParameters> parameters);
 };
 
+//
+// Replies with the execution statistics collected by FT.PROFILE, reply_time
+// is the time taken to send the reply of the profiled command.
+//
+void ReplyWithQueryProfile(ValkeyModuleCtx *ctx, const QueryCommand &command,
+                           absl::Duration reply_time);
+
 namespace async {
 
 int Reply(ValkeyModuleCtx *ctx, [[maybe_unused]] ValkeyModuleString **argv,
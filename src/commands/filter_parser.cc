@@ -13,22 +13,27 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "src/index_schema.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
 #include "src/indexes/text.h"
 #include "src/indexes/text/lexer.h"
 #include "src/query/predicate.h"
+#include "src/utils/geohash.h"
 #include "src/valkey_search_options.h"
 #include "vmsdk/src/status/status_macros.h"
 
@@ -145,6 +150,11 @@ std::string PrintPredicateTree(const query::Predicate* predicate, int indent) {
       result += indent_str + "TAG(" + std::string(tag->GetAlias()) + ")\n";
       break;
     }
+    case query::PredicateType::kGeo: {
+      const auto* geo = static_cast<const query::GeoPredicate*>(predicate);
+      result += indent_str + "GEO(" + std::string(geo->GetAlias()) + ")\n";
+      break;
+    }
     case query::PredicateType::kText: {
       const auto* text = static_cast<const query::TextPredicate*>(predicate);
       std::string field_mask_str = std::to_string(text->GetFieldMask());
@@ -344,11 +354,72 @@ FilterParser::ParseTagPredicate(const std::string& attribute_alias) {
   auto tag_index = dynamic_cast<indexes::Tag*>(index.value().get());
   VMSDK_ASSIGN_OR_RETURN(auto tag_string, ParseTagString());
   VMSDK_ASSIGN_OR_RETURN(auto parsed_tags, ParseQueryTags(tag_string));
+  if (!tag_index->HasWildcardIndex()) {
+    for (const auto& tag : parsed_tags) {
+      if (indexes::Tag::IsWildcardPattern(tag)) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Tag string `", tag, "` needs `", attribute_alias,
+                         "` to be created WITHSUFFIXTRIE"));
+      }
+    }
+  }
   query_operations_ |= QueryOperations::kContainsTag;
   return std::make_unique<query::TagPredicate>(
       tag_index, attribute_alias, identifier, tag_string, parsed_tags);
 }
 
+// Accepts `[lon lat radius unit]` and `[WITHIN POLYGON((lon lat, ...))]`. The
+// opening bracket has already been consumed.
+absl::StatusOr<std::unique_ptr<query::GeoPredicate>>
+FilterParser::ParseGeoPredicate(const std::string& attribute_alias) {
+  auto index = index_schema_.GetIndex(attribute_alias);
+  if (!index.ok() ||
+      index.value()->GetIndexerType() != indexes::IndexerType::kGeo) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("`", attribute_alias, "` is not indexed as a geo field"));
+  }
+  auto identifier = index_schema_.GetIdentifier(attribute_alias).value();
+  filter_identifiers_.insert(identifier);
+  auto stop_pos = expression_.substr(pos_).find(']');
+  if (stop_pos == std::string::npos) {
+    return absl::InvalidArgumentError("Missing closing GEO bracket, ']'");
+  }
+  absl::string_view body =
+      absl::StripAsciiWhitespace(expression_.substr(pos_, stop_pos));
+  pos_ += stop_pos + 1;
+  auto geo_index = dynamic_cast<const indexes::Geo*>(index.value().get());
+  query_operations_ |= QueryOperations::kContainsGeo;
+  if (absl::StartsWithIgnoreCase(body, "WITHIN")) {
+    body = absl::StripAsciiWhitespace(body.substr(6));
+    if (body.size() >= 2 && (body.front() == '"' || body.front() == '\'') &&
+        body.back() == body.front()) {
+      body = body.substr(1, body.size() - 2);
+    }
+    VMSDK_ASSIGN_OR_RETURN(auto polygon, utils::ParseWktPolygon(body));
+    return std::make_unique<query::GeoPredicate>(
+        geo_index, attribute_alias, identifier, std::move(polygon));
+  }
+  std::vector<absl::string_view> parts =
+      absl::StrSplit(body, ' ', absl::SkipEmpty());
+  if (parts.size() != 4) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected `[lon lat radius unit]` or `[WITHIN <polygon>]` "
+                     "for geo field `",
+                     attribute_alias, "`"));
+  }
+  VMSDK_ASSIGN_OR_RETURN(auto center,
+                         utils::ParseGeoPoint(absl::StrCat(parts[0], ",",
+                                                           parts[1])));
+  double radius;
+  if (!absl::SimpleAtod(parts[2], &radius) || !(radius >= 0)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid radius `", parts[2], "`"));
+  }
+  VMSDK_ASSIGN_OR_RETURN(auto unit, utils::ParseGeoUnit(parts[3]));
+  return std::make_unique<query::GeoPredicate>(
+      geo_index, attribute_alias, identifier, center, radius * unit);
+}
+
 absl::Status UnexpectedChar(absl::string_view expression, size_t pos) {
   return absl::InvalidArgumentError(
       absl::StrCat("Unexpected character at position ", pos + 1, ": `",
@@ -983,7 +1054,14 @@ absl::StatusOr<FilterParser::ParseResult> FilterParser::ParseExpression(
         field_name = parsed_field;
         if (Match('[')) {
           node_count_++;
-          VMSDK_ASSIGN_OR_RETURN(predicate, ParseNumericPredicate(*field_name));
+          auto index = index_schema_.GetIndex(*field_name);
+          if (index.ok() && index.value()->GetIndexerType() ==
+                                indexes::IndexerType::kGeo) {
+            VMSDK_ASSIGN_OR_RETURN(predicate, ParseGeoPredicate(*field_name));
+          } else {
+            VMSDK_ASSIGN_OR_RETURN(predicate,
+                                   ParseNumericPredicate(*field_name));
+          }
           non_text = true;
         } else if (Match('{')) {
           node_count_++;
@@ -5,6 +5,7 @@
  */
 
 #include <ranges>
+#include <sstream>
 
 #include "absl/log/check.h"
 #include "absl/status/status.h"
@@ -18,6 +19,7 @@
 #include "src/metrics.h"
 #include "src/query/response_generator.h"
 #include "vmsdk/src/info.h"
+#include "vmsdk/src/utils.h"
 
 namespace valkey_search {
 namespace aggregate {
@@ -143,6 +145,7 @@ bool ReplyWithValue(ValkeyModuleCtx *ctx,
     } else {
       switch (indexer_type) {
         case indexes::IndexerType::kTag:
+        case indexes::IndexerType::kGeo:
         case indexes::IndexerType::kNone: {
           value_view = value.AsStringView();
           break;
@@ -320,7 +323,21 @@ absl::Status ExecuteAggregationStages(AggregateParameters &parameters,
       return absl::CancelledError(
           "Aggregate operation cancelled due to timeout");
     }
+    if (!parameters.profile) {
+      VMSDK_RETURN_IF_ERROR(stage->Execute(records));
+      continue;
+    }
+    std::ostringstream name;
+    name << *stage;
+    size_t input_records = records.size();
+    vmsdk::StopWatch stage_time;
     VMSDK_RETURN_IF_ERROR(stage->Execute(records));
+    parameters.profile->stages.push_back(query::QueryProfile::Stage{
+        .name = name.str(),
+        .input_records = input_records,
+        .output_records = records.size(),
+        .time = stage_time.Duration(),
+    });
   }
   agg_output_records.Increment(records.size());
   return absl::OkStatus();
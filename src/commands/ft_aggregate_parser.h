@@ -13,6 +13,7 @@
 #include "src/commands/commands.h"
 #include "src/expr/expr.h"
 #include "src/expr/value.h"
+#include "src/metrics.h"
 #include "src/query/search.h"
 #include "src/schema_manager.h"
 #include "vmsdk/src/command_parser.h"
@@ -49,6 +50,12 @@ struct AggregateParameters : public expr::Expression::CompileContext,
   AggregateParameters(int db_num) : QueryCommand(db_num){};
   absl::Status ParseCommand(vmsdk::ArgsIterator& itr) override;
   void SendReply(ValkeyModuleCtx* ctx, query::SearchResult& result) override;
+  vmsdk::LatencySampler& GetLatencySampler() const override {
+    return Metrics::GetStats().ft_aggregate_latency;
+  }
+  absl::string_view GetCommandName() const override {
+    return kAggregateCommand;
+  }
   bool loadall_{false};
   std::vector<std::string> loads_;
   bool load_key{false};
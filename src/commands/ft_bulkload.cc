@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "src/acl.h"
+#include "src/commands/commands.h"
+#include "src/schema_manager.h"
+#include "vmsdk/src/status/status_macros.h"
+#include "vmsdk/src/type_conversions.h"
+#include "vmsdk/src/utils.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+absl::Status FTBulkLoadCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                           int argc) {
+  if (argc != 3) {
+    return absl::InvalidArgumentError(vmsdk::WrongArity(kBulkLoadCommand));
+  }
+  auto index_schema_name = vmsdk::ToStringView(argv[1]);
+  auto action = vmsdk::ToStringView(argv[2]);
+
+  VMSDK_ASSIGN_OR_RETURN(
+      auto index_schema,
+      SchemaManager::Instance().GetIndexSchema(ValkeyModule_GetSelectedDb(ctx),
+                                               index_schema_name));
+  VMSDK_RETURN_IF_ERROR(AclPrefixCheck(ctx, acl::KeyAccess::kWrite,
+                                       index_schema->GetKeyPrefixes()));
+
+  if (absl::EqualsIgnoreCase(action, "BEGIN")) {
+    VMSDK_RETURN_IF_ERROR(index_schema->BeginBulkLoad());
+  } else if (absl::EqualsIgnoreCase(action, "END")) {
+    VMSDK_RETURN_IF_ERROR(index_schema->EndBulkLoad(ctx));
+  } else {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unknown argument `", action, "`, expected BEGIN or END"));
+  }
+  ValkeyModule_ReplyWithSimpleString(ctx, "OK");
+
+  // Replicas index the same keys, so they defer and rebuild alike. Unlike
+  // FT.CREATE, the command is not fanned out to the other shards: each shard
+  // is bulk loaded on its own.
+  ValkeyModule_ReplicateVerbatim(ctx);
+  return absl::OkStatus();
+}
+
+}  // namespace valkey_search
@@ -42,6 +42,7 @@ constexpr absl::string_view kBlockSizeParam{"BLOCK_SIZE"};
 constexpr absl::string_view kMParam{"M"};
 constexpr absl::string_view kEfConstructionParam{"EF_CONSTRUCTION"};
 constexpr absl::string_view kEfRuntimeParam{"EF_RUNTIME"};
+constexpr absl::string_view kMultiVectorParam{"MULTIVECTOR"};
 constexpr absl::string_view kDimensionsParam{"DIM"};
 constexpr absl::string_view kDistanceMetricParam{"DISTANCE_METRIC"};
 constexpr absl::string_view kDataTypeParam{"TYPE"};
@@ -318,6 +319,8 @@ vmsdk::KeyValueParser<HNSWParameters> CreateHNSWParser() {
                         GENERATE_VALUE_PARSER(HNSWParameters, ef_construction));
   parser.AddParamParser(kEfRuntimeParam,
                         GENERATE_VALUE_PARSER(HNSWParameters, ef_runtime));
+  parser.AddParamParser(kMultiVectorParam,
+                        GENERATE_FLAG_PARSER(HNSWParameters, multi_vector));
   return parser;
 }
 vmsdk::KeyValueParser<FlatParameters> CreateFlatParamParser() {
@@ -382,6 +385,11 @@ absl::Status ParseNumeric(vmsdk::ArgsIterator &itr,
   index_proto.set_allocated_numeric_index(numeric_index_proto.release());
   return absl::OkStatus();
 }
+absl::Status ParseGeo(data_model::Index &index_proto) {
+  auto geo_index_proto = std::make_unique<data_model::GeoIndex>();
+  index_proto.set_allocated_geo_index(geo_index_proto.release());
+  return absl::OkStatus();
+}
 vmsdk::KeyValueParser<FTCreateTagParameters> CreateTagParser() {
   vmsdk::KeyValueParser<FTCreateTagParameters> parser;
   parser.AddParamParser(
@@ -389,6 +397,9 @@ vmsdk::KeyValueParser<FTCreateTagParameters> CreateTagParser() {
   parser.AddParamParser(
       kCaseSensitiveParam,
       GENERATE_FLAG_PARSER(FTCreateTagParameters, case_sensitive));
+  parser.AddParamParser(
+      kWithSuffixTrieParam,
+      GENERATE_FLAG_PARSER(FTCreateTagParameters, with_suffix_trie));
   return parser;
 }
 absl::Status ParseTag(vmsdk::ArgsIterator &itr, data_model::Index &index_proto,
@@ -409,6 +420,7 @@ absl::Status ParseTag(vmsdk::ArgsIterator &itr, data_model::Index &index_proto,
   }
   tag_index_proto->set_separator(parameters.separator);
   tag_index_proto->set_case_sensitive(parameters.case_sensitive);
+  tag_index_proto->set_with_suffix_trie(parameters.with_suffix_trie);
   index_proto.set_allocated_tag_index(tag_index_proto.release());
   return absl::OkStatus();
 }
@@ -575,6 +587,9 @@ absl::StatusOr<data_model::Attribute *> ParseAttributeArgs(
     case indexes::IndexerType::kText:
       VMSDK_RETURN_IF_ERROR(ParseText(itr, *index_proto, schema_text_defaults));
       break;
+    case indexes::IndexerType::kGeo:
+      VMSDK_RETURN_IF_ERROR(ParseGeo(*index_proto));
+      break;
     default:
       CHECK(false);
       break;
@@ -798,6 +813,7 @@ std::unique_ptr<data_model::VectorIndex> HNSWParameters::ToProto() const {
   hnsw_algorithm_proto->set_ef_runtime(ef_runtime);
   vector_index_proto->set_allocated_hnsw_algorithm(
       hnsw_algorithm_proto.release());
+  vector_index_proto->set_multi_vector(multi_vector);
   return vector_index_proto;
 }
 absl::Status HNSWParameters::Verify() const {
@@ -38,6 +38,7 @@ const std::vector<std::string> kDefaultStopWords{
 struct FTCreateTagParameters {
   absl::string_view separator{","};
   bool case_sensitive{false};
+  bool with_suffix_trie{false};
 };
 
 constexpr int kDefaultInitialCap{10 * 1024};
@@ -114,6 +115,8 @@ struct HNSWParameters : public FTCreateVectorParameters {
   int m{kDefaultM};
   int ef_construction{kDefaultEFConstruction};
   size_t ef_runtime{kDefaultEFRuntime};
+  // Every record holds a set of vectors rather than a single one.
+  bool multi_vector{false};
   absl::Status Verify() const;
   std::unique_ptr<data_model::VectorIndex> ToProto() const;
 };
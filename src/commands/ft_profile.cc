@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "src/commands/commands.h"
+#include "src/commands/ft_aggregate_parser.h"
+#include "src/commands/ft_search_parser.h"
+#include "src/query/search.h"
+#include "vmsdk/src/type_conversions.h"
+#include "vmsdk/src/utils.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+namespace {
+
+constexpr absl::string_view kSearchParam{"SEARCH"};
+constexpr absl::string_view kAggregateParam{"AGGREGATE"};
+constexpr absl::string_view kLimitedParam{"LIMITED"};
+constexpr absl::string_view kQueryParam{"QUERY"};
+
+void ReplyWithTime(ValkeyModuleCtx *ctx, const char *name,
+                   absl::Duration time) {
+  ValkeyModule_ReplyWithSimpleString(ctx, name);
+  ValkeyModule_ReplyWithDouble(ctx, absl::ToDoubleMilliseconds(time));
+}
+
+void ReplyWithCount(ValkeyModuleCtx *ctx, const char *name, size_t count) {
+  ValkeyModule_ReplyWithSimpleString(ctx, name);
+  ValkeyModule_ReplyWithLongLong(ctx, static_cast<long long>(count));
+}
+
+void ReplyWithString(ValkeyModuleCtx *ctx, absl::string_view value) {
+  ValkeyModule_ReplyWithStringBuffer(ctx, value.data(), value.size());
+}
+
+}  // namespace
+
+// The profile is a flat array of name / value pairs, times are in
+// milliseconds. Shards and stages are arrays of such arrays.
+void ReplyWithQueryProfile(ValkeyModuleCtx *ctx, const QueryCommand &command,
+                           absl::Duration reply_time) {
+  const auto &timings = *command.timings;
+  const auto &profile = *command.profile;
+  ValkeyModule_ReplyWithArray(ctx, 2 * 16);
+  ReplyWithTime(ctx, "parse_time", timings.parse_time);
+  ReplyWithTime(ctx, "queue_wait_time", timings.queue_wait_time);
+  ReplyWithTime(ctx, "search_time", timings.search_time);
+  ReplyWithTime(ctx, "content_fetch_time", timings.content_fetch_time);
+  ReplyWithTime(ctx, "reply_time", reply_time);
+  ValkeyModule_ReplyWithSimpleString(ctx, "plan");
+  ReplyWithString(ctx, timings.plan);
+  ReplyWithCount(ctx, "estimated_entries", profile.estimated_entries);
+  ReplyWithCount(ctx, "fetchers", profile.fetchers);
+  ReplyWithCount(ctx, "keys_evaluated", profile.keys_evaluated);
+  ReplyWithCount(ctx, "keys_matched", profile.keys_matched);
+  ReplyWithCount(ctx, "hnsw_hops", profile.hnsw.hops);
+  ReplyWithCount(ctx, "hnsw_distance_computations",
+                 profile.hnsw.distance_computations);
+  ReplyWithCount(ctx, "results", timings.results);
+  ReplyWithCount(ctx, "content_resolution_requeues",
+                 command.content_resolution_blocked_);
+
+  ValkeyModule_ReplyWithSimpleString(ctx, "shards");
+  ValkeyModule_ReplyWithArray(ctx, timings.shards.size());
+  for (const auto &shard : timings.shards) {
+    ValkeyModule_ReplyWithArray(ctx, 2 * 4);
+    ValkeyModule_ReplyWithSimpleString(ctx, "address");
+    ReplyWithString(ctx, shard.address);
+    ReplyWithTime(ctx, "time", shard.time);
+    ValkeyModule_ReplyWithSimpleString(ctx, "status");
+    ReplyWithString(ctx, shard.status.ok() ? "OK" : shard.status.message());
+    ReplyWithCount(ctx, "results", shard.results);
+  }
+
+  ValkeyModule_ReplyWithSimpleString(ctx, "stages");
+  ValkeyModule_ReplyWithArray(ctx, profile.stages.size());
+  for (const auto &stage : profile.stages) {
+    ValkeyModule_ReplyWithArray(ctx, 2 * 4);
+    ValkeyModule_ReplyWithSimpleString(ctx, "stage");
+    ReplyWithString(ctx, stage.name);
+    ReplyWithCount(ctx, "input_records", stage.input_records);
+    ReplyWithCount(ctx, "output_records", stage.output_records);
+    ReplyWithTime(ctx, "time", stage.time);
+  }
+}
+
+// FT.PROFILE <index> SEARCH | AGGREGATE [LIMITED] QUERY <query> [args...]
+//
+// Runs the FT.SEARCH or FT.AGGREGATE command with the query and arguments, and
+// replies with its reply followed by the execution statistics of the query.
+absl::Status FTProfileCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                          int argc) {
+  if (argc < 5) {
+    return absl::InvalidArgumentError(vmsdk::WrongArity(kProfileCommand));
+  }
+  auto command_type = vmsdk::ToStringView(argv[2]);
+  int query_pos = 3;
+  // LIMITED is accepted for compatibility, the profile has no per-result
+  // detail to limit.
+  if (absl::EqualsIgnoreCase(vmsdk::ToStringView(argv[query_pos]),
+                             kLimitedParam)) {
+    ++query_pos;
+  }
+  if (query_pos + 1 >= argc ||
+      !absl::EqualsIgnoreCase(vmsdk::ToStringView(argv[query_pos]),
+                              kQueryParam)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected `", kQueryParam, "` at position ", query_pos));
+  }
+  std::unique_ptr<QueryCommand> command;
+  const int db_num = ValkeyModule_GetSelectedDb(ctx);
+  if (absl::EqualsIgnoreCase(command_type, kSearchParam)) {
+    command = std::make_unique<SearchCommand>(db_num);
+  } else if (absl::EqualsIgnoreCase(command_type, kAggregateParam)) {
+    command = std::make_unique<aggregate::AggregateParameters>(db_num);
+  } else {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unknown argument `", command_type, "`, expected ",
+                     kSearchParam, " or ", kAggregateParam));
+  }
+  command->timings.emplace();
+  command->profile = std::make_unique<query::QueryProfile>();
+  command->reply_with_profile = true;
+  // Rewrite the arguments into those of the profiled command: the index, the
+  // query and the remaining arguments.
+  std::vector<ValkeyModuleString *> command_argv{argv[0], argv[1]};
+  command_argv.insert(command_argv.end(), argv + query_pos + 1, argv + argc);
+  return QueryCommand::Execute(ctx, command_argv.data(), command_argv.size(),
+                               std::move(command));
+}
+
+}  // namespace valkey_search
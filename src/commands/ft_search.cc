@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <optional>
 #include <string>
 #include <utility>
@@ -24,8 +25,10 @@
 #include "src/indexes/index_base.h"
 #include "src/indexes/vector_base.h"
 #include "src/metrics.h"
+#include "src/query/predicate.h"
 #include "src/query/response_generator.h"
 #include "src/query/search.h"
+#include "src/utils/geohash.h"
 #include "value.h"
 #include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/type_conversions.h"
@@ -63,10 +66,13 @@ void SendReplyNoContent(ValkeyModuleCtx *ctx,
   }
 }
 
-void ReplyScore(ValkeyModuleCtx *ctx, ValkeyModuleString &score_as,
+void ReplyScore(ValkeyModuleCtx *ctx, const query::SearchParameters &parameters,
                 const indexes::Neighbor &neighbor) {
-  ValkeyModule_ReplyWithString(ctx, &score_as);
-  auto score_value = absl::StrFormat("%.12g", neighbor.distance);
+  ValkeyModule_ReplyWithString(ctx, parameters.score_as.get());
+  // Fused neighbors carry the negated fused score as their distance.
+  auto score_value = absl::StrFormat(
+      "%.12g", parameters.fusion.has_value() ? -neighbor.distance
+                                             : neighbor.distance);
   ValkeyModule_ReplyWithString(
       ctx, vmsdk::MakeUniqueValkeyString(score_value).get());
 }
@@ -87,7 +93,7 @@ void SerializeNeighbors(ValkeyModuleCtx *ctx,
     if (parameters.return_attributes.empty()) {
       ValkeyModule_ReplyWithArray(
           ctx, 2 * neighbors[i].attribute_contents.value().size() + 2);
-      ReplyScore(ctx, *parameters.score_as, neighbors[i]);
+      ReplyScore(ctx, parameters, neighbors[i]);
       for (auto &attribute_content : neighbors[i].attribute_contents.value()) {
         ValkeyModule_ReplyWithString(ctx,
                                      attribute_content.second.GetIdentifier());
@@ -99,7 +105,7 @@ void SerializeNeighbors(ValkeyModuleCtx *ctx,
       for (const auto &return_attribute : parameters.return_attributes) {
         if (vmsdk::ToStringView(parameters.score_as.get()) ==
             vmsdk::ToStringView(return_attribute.identifier.get())) {
-          ReplyScore(ctx, *parameters.score_as, neighbors[i]);
+          ReplyScore(ctx, parameters, neighbors[i]);
           ++cnt;
           continue;
         }
@@ -184,6 +190,49 @@ void SerializeNonVectorNeighbors(ValkeyModuleCtx *ctx,
   }
 }
 
+// Collects the centers of the radius filters on the given field that every
+// match must satisfy, i.e. the root filter or filters reached through ANDs.
+void CollectGeoSortCenters(const query::Predicate *predicate,
+                           absl::string_view field,
+                           std::vector<utils::GeoPoint> &centers) {
+  switch (predicate->GetType()) {
+    case query::PredicateType::kGeo: {
+      auto geo = static_cast<const query::GeoPredicate *>(predicate);
+      if (geo->GetShape() == query::GeoPredicate::Shape::kRadius &&
+          (geo->GetAlias() == field || geo->GetIdentifier() == field)) {
+        centers.push_back(geo->GetCenter());
+      }
+      break;
+    }
+    case query::PredicateType::kComposedAnd: {
+      auto composed = static_cast<const query::ComposedPredicate *>(predicate);
+      for (const auto &child : composed->GetChildren()) {
+        CollectGeoSortCenters(child.get(), field, centers);
+      }
+      break;
+    }
+    default:
+      // A radius filter under an OR or a negation need not hold for a match.
+      break;
+  }
+}
+
+// Returns the reference point for sorting by distance on the given field: the
+// center of its radius filter, if the filter has exactly one that every match
+// satisfies. Otherwise the reference point is ambiguous and there is none.
+std::optional<utils::GeoPoint> FindGeoSortCenter(
+    const query::Predicate *predicate, absl::string_view field) {
+  if (predicate == nullptr) {
+    return std::nullopt;
+  }
+  std::vector<utils::GeoPoint> centers;
+  CollectGeoSortCenters(predicate, field, centers);
+  if (centers.size() != 1) {
+    return std::nullopt;
+  }
+  return centers.front();
+}
+
 }  // namespace
 // Apply sorting to neighbors based on attribute values in attribute_contents
 void ApplySorting(std::vector<indexes::Neighbor> &neighbors,
@@ -199,6 +248,14 @@ void ApplySorting(std::vector<indexes::Neighbor> &neighbors,
   bool is_numeric =
       index_result.ok() &&
       index_result.value()->GetIndexerType() == indexes::IndexerType::kNumeric;
+  // GEO fields sort by distance from the center of the radius filter on the
+  // same field, if any.
+  std::optional<utils::GeoPoint> geo_center;
+  if (index_result.ok() &&
+      index_result.value()->GetIndexerType() == indexes::IndexerType::kGeo) {
+    geo_center = FindGeoSortCenter(
+        parameters.filter_parse_results.root_predicate.get(), sortby.field);
+  }
   auto compare = [&](const indexes::Neighbor &a,
                      const indexes::Neighbor &b) -> bool {
     if (!a.attribute_contents.has_value() ||
@@ -220,7 +277,16 @@ void ApplySorting(std::vector<indexes::Neighbor> &neighbors,
     auto str_b = vmsdk::ToStringView(it_b->second.value.get());
 
     expr::Value val_a, val_b;
-    if (is_numeric) {
+    if (geo_center.has_value()) {
+      auto point_a = utils::ParseGeoPoint(str_a);
+      auto point_b = utils::ParseGeoPoint(str_b);
+      val_a = expr::Value(point_a.ok()
+                              ? utils::GeoDistance(*geo_center, *point_a)
+                              : std::numeric_limits<double>::infinity());
+      val_b = expr::Value(point_b.ok()
+                              ? utils::GeoDistance(*geo_center, *point_b)
+                              : std::numeric_limits<double>::infinity());
+    } else if (is_numeric) {
       auto num_a = vmsdk::To<double>(str_a).value_or(0.0);
       auto num_b = vmsdk::To<double>(str_b).value_or(0.0);
       val_a = expr::Value(num_a);
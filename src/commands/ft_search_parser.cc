@@ -201,6 +201,41 @@ std::unique_ptr<vmsdk::ParamParser<SearchCommand>> ConstructReturnParser() {
       });
 }
 
+std::unique_ptr<vmsdk::ParamParser<SearchCommand>> ConstructFusionParser() {
+  return std::make_unique<vmsdk::ParamParser<SearchCommand>>(
+      [](SearchCommand &parameters, vmsdk::ArgsIterator &itr) -> absl::Status {
+        vmsdk::UniqueValkeyString method;
+        VMSDK_RETURN_IF_ERROR(vmsdk::ParseParamValue(itr, method));
+        absl::string_view method_str = vmsdk::ToStringView(method.get());
+        query::FusionParameter fusion;
+        if (absl::EqualsIgnoreCase(method_str, query::kFusionRRF)) {
+          fusion.method = query::FusionMethod::kRRF;
+          // Check for the optional K parameter
+          VMSDK_RETURN_IF_ERROR(vmsdk::ParseParam(query::kFusionRRFConstant,
+                                                  false, itr,
+                                                  fusion.rrf_constant)
+                                    .status());
+        } else if (absl::EqualsIgnoreCase(method_str, query::kFusionWeights)) {
+          fusion.method = query::FusionMethod::kWeighted;
+          VMSDK_RETURN_IF_ERROR(
+              vmsdk::ParseParamValue(itr, fusion.text_weight));
+          VMSDK_RETURN_IF_ERROR(
+              vmsdk::ParseParamValue(itr, fusion.vector_weight));
+          if (fusion.text_weight < 0 || fusion.vector_weight < 0 ||
+              fusion.text_weight + fusion.vector_weight <= 0) {
+            return absl::InvalidArgumentError(
+                "FUSION WEIGHTS must be non negative and not both zero.");
+          }
+        } else {
+          return absl::InvalidArgumentError(
+              absl::StrCat("Unknown FUSION method `", method_str,
+                           "`, expected RRF or WEIGHTS."));
+        }
+        parameters.fusion = fusion;
+        return absl::OkStatus();
+      });
+}
+
 vmsdk::KeyValueParser<SearchCommand> CreateSearchParser() {
   vmsdk::KeyValueParser<SearchCommand> parser;
   parser.AddParamParser(query::kDialectParam,
@@ -235,6 +270,7 @@ vmsdk::KeyValueParser<SearchCommand> CreateSearchParser() {
                         GENERATE_FLAG_PARSER(SearchCommand, verbatim));
   parser.AddParamParser(query::kSlop,
                         GENERATE_VALUE_PARSER(SearchCommand, slop));
+  parser.AddParamParser(query::kFusionParam, ConstructFusionParser());
 
   return parser;
 }
@@ -251,6 +287,16 @@ absl::Status SearchCommand::PostParseQueryString() {
     VMSDK_RETURN_IF_ERROR(
         index_schema->GetIdentifier(sortby_parameter->field).status());
   }
+  if (fusion.has_value()) {
+    if (IsNonVectorQuery()) {
+      return absl::InvalidArgumentError("FUSION requires a KNN vector query.");
+    }
+    if (!(filter_parse_results.query_operations &
+          QueryOperations::kContainsText)) {
+      return absl::InvalidArgumentError(
+          "FUSION requires a text filter in the query.");
+    }
+  }
 
   return absl::OkStatus();
 }
@@ -11,6 +11,7 @@
 #include <optional>
 
 #include "src/commands/commands.h"
+#include "src/metrics.h"
 #include "src/query/search.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
@@ -35,6 +36,10 @@ struct SearchCommand : public QueryCommand {
   // return true when those clauses are present.
   bool RequiresCompleteResults() const override { return sortby.has_value(); }
   query::SerializationRange GetSerializationRange() const;
+  vmsdk::LatencySampler &GetLatencySampler() const override {
+    return Metrics::GetStats().ft_search_latency;
+  }
+  absl::string_view GetCommandName() const override { return kSearchCommand; }
 
   std::optional<query::SortByParameter> sortby;
   bool with_sort_keys{false};
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cstddef>
+#include <limits>
+
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "src/commands/commands.h"
+#include "src/query/slowlog.h"
+#include "vmsdk/src/status/status_macros.h"
+#include "vmsdk/src/type_conversions.h"
+#include "vmsdk/src/utils.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+namespace {
+
+constexpr absl::string_view kGetParam{"GET"};
+constexpr absl::string_view kLenParam{"LEN"};
+constexpr absl::string_view kResetParam{"RESET"};
+constexpr int kDefaultGetCount{10};
+
+void ReplyWithString(ValkeyModuleCtx *ctx, absl::string_view value) {
+  ValkeyModule_ReplyWithStringBuffer(ctx, value.data(), value.size());
+}
+
+void ReplyWithMicros(ValkeyModuleCtx *ctx, const char *name,
+                     absl::Duration time) {
+  ValkeyModule_ReplyWithSimpleString(ctx, name);
+  ValkeyModule_ReplyWithLongLong(ctx, absl::ToInt64Microseconds(time));
+}
+
+// Each entry is a flat array of name / value pairs, times are in microseconds.
+void ReplyWithEntry(ValkeyModuleCtx *ctx, const query::SlowLog::Entry &entry) {
+  ValkeyModule_ReplyWithArray(ctx, 2 * 14);
+  ValkeyModule_ReplyWithSimpleString(ctx, "id");
+  ValkeyModule_ReplyWithLongLong(ctx, static_cast<long long>(entry.id));
+  ValkeyModule_ReplyWithSimpleString(ctx, "timestamp");
+  ValkeyModule_ReplyWithLongLong(ctx, absl::ToUnixSeconds(entry.time));
+  ReplyWithMicros(ctx, "duration", entry.duration);
+  ValkeyModule_ReplyWithSimpleString(ctx, "command");
+  ReplyWithString(ctx, entry.command);
+  ValkeyModule_ReplyWithSimpleString(ctx, "index");
+  ReplyWithString(ctx, entry.index_name);
+  ValkeyModule_ReplyWithSimpleString(ctx, "query");
+  ReplyWithString(ctx, entry.query);
+  ValkeyModule_ReplyWithSimpleString(ctx, "plan");
+  ReplyWithString(ctx, entry.plan);
+  ValkeyModule_ReplyWithSimpleString(ctx, "results");
+  ValkeyModule_ReplyWithLongLong(ctx, static_cast<long long>(entry.results));
+  ReplyWithMicros(ctx, "parse_time", entry.parse_time);
+  ReplyWithMicros(ctx, "queue_wait_time", entry.queue_wait_time);
+  ReplyWithMicros(ctx, "search_time", entry.search_time);
+  ReplyWithMicros(ctx, "content_fetch_time", entry.content_fetch_time);
+  ReplyWithMicros(ctx, "reply_time", entry.reply_time);
+  ValkeyModule_ReplyWithSimpleString(ctx, "shards");
+  ValkeyModule_ReplyWithArray(ctx, entry.shards.size());
+  for (const auto &shard : entry.shards) {
+    ValkeyModule_ReplyWithArray(ctx, 2 * 4);
+    ValkeyModule_ReplyWithSimpleString(ctx, "address");
+    ReplyWithString(ctx, shard.address);
+    ReplyWithMicros(ctx, "time", shard.time);
+    ValkeyModule_ReplyWithSimpleString(ctx, "status");
+    ReplyWithString(ctx, shard.status.ok() ? "OK" : shard.status.message());
+    ValkeyModule_ReplyWithSimpleString(ctx, "results");
+    ValkeyModule_ReplyWithLongLong(ctx, static_cast<long long>(shard.results));
+  }
+}
+
+}  // namespace
+
+// FT.SLOWLOG GET [count] | LEN | RESET
+//
+// Reads or clears the queries recorded in the slow log of this node. GET
+// returns the most recent entries first, 10 by default, all of them when count
+// is negative.
+absl::Status FTSlowLogCmd(ValkeyModuleCtx *ctx, ValkeyModuleString **argv,
+                          int argc) {
+  if (argc < 2) {
+    return absl::InvalidArgumentError(vmsdk::WrongArity(kSlowLogCommand));
+  }
+  auto &slowlog = query::SlowLog::Instance();
+  auto subcommand = vmsdk::ToStringView(argv[1]);
+  if (absl::EqualsIgnoreCase(subcommand, kGetParam) && argc <= 3) {
+    int count = kDefaultGetCount;
+    if (argc == 3) {
+      VMSDK_ASSIGN_OR_RETURN(count, vmsdk::To<int>(argv[2]));
+    }
+    auto entries = slowlog.Get(count < 0 ? std::numeric_limits<size_t>::max()
+                                         : static_cast<size_t>(count));
+    ValkeyModule_ReplyWithArray(ctx, entries.size());
+    for (const auto *entry : entries) {
+      ReplyWithEntry(ctx, *entry);
+    }
+    return absl::OkStatus();
+  }
+  if (absl::EqualsIgnoreCase(subcommand, kLenParam) && argc == 2) {
+    ValkeyModule_ReplyWithLongLong(ctx, static_cast<long long>(slowlog.Len()));
+    return absl::OkStatus();
+  }
+  if (absl::EqualsIgnoreCase(subcommand, kResetParam) && argc == 2) {
+    slowlog.Reset();
+    ValkeyModule_ReplyWithSimpleString(ctx, "OK");
+    return absl::OkStatus();
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unknown subcommand or wrong number of arguments for `",
+                   subcommand, "`, expected ", kGetParam, " [count], ",
+                   kLenParam, " or ", kResetParam));
+}
+
+}  // namespace valkey_search
@@ -111,7 +111,7 @@ void ClientImpl::GetGlobalMetadata(GetGlobalMetadataCallback done) {
   args->context.set_deadline(
       absl::ToChronoTime(absl::Now() + absl::Seconds(60)));
   args->callback = std::move(done);
-  args->latency_sample = SAMPLE_EVERY_N(100);
+  args->latency_sample = std::make_unique<vmsdk::StopWatch>();
   auto args_raw = args.release();
   stub_->async()->GetGlobalMetadata(
       &args_raw->context, &args_raw->request, &args_raw->response,
@@ -151,7 +151,7 @@ void ClientImpl::SearchIndexPartition(
       absl::Now() + absl::Seconds(query_connection_timeout->GetValue())));
   args->callback = std::move(done);
   args->request = std::move(request);
-  args->latency_sample = SAMPLE_EVERY_N(100);
+  args->latency_sample = std::make_unique<vmsdk::StopWatch>();
   auto args_raw = args.release();
   Metrics::GetStats().coordinator_bytes_out.fetch_add(
       args_raw->request->ByteSizeLong(), std::memory_order_relaxed);
@@ -197,7 +197,7 @@ void ClientImpl::InfoIndexPartition(
       absl::Milliseconds(options::GetFTInfoRpcTimeoutMs().GetValue())));
   args->callback = std::move(done);
   args->request = std::move(request);
-  args->latency_sample = SAMPLE_EVERY_N(100);
+  args->latency_sample = std::make_unique<vmsdk::StopWatch>();
   auto args_raw = args.release();
   Metrics::GetStats().coordinator_bytes_out.fetch_add(
       args_raw->request->ByteSizeLong(), std::memory_order_relaxed);
@@ -19,12 +19,14 @@
 #include "src/commands/filter_parser.h"
 #include "src/coordinator/coordinator.pb.h"
 #include "src/index_schema.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
 #include "src/query/predicate.h"
 #include "src/query/search.h"
 #include "src/schema_manager.h"
+#include "src/utils/geohash.h"
 #include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/status/status_macros.h"
 #include "vmsdk/src/type_conversions.h"
@@ -56,6 +58,35 @@ std::optional<query::SortByParameter> SortByFromGRPC(
   return sortby;
 }
 
+void FusionToGRPC(const std::optional<query::FusionParameter>& fusion,
+                  SearchIndexPartitionRequest* request) {
+  if (!fusion.has_value()) {
+    return;
+  }
+  auto* proto = request->mutable_fusion();
+  proto->set_method(fusion->method == query::FusionMethod::kRRF
+                        ? coordinator::FUSION_METHOD_RRF
+                        : coordinator::FUSION_METHOD_WEIGHTED);
+  proto->set_rrf_constant(fusion->rrf_constant);
+  proto->set_text_weight(fusion->text_weight);
+  proto->set_vector_weight(fusion->vector_weight);
+}
+
+std::optional<query::FusionParameter> FusionFromGRPC(
+    const SearchIndexPartitionRequest& request) {
+  if (!request.has_fusion()) {
+    return std::nullopt;
+  }
+  query::FusionParameter fusion;
+  fusion.method = request.fusion().method() == coordinator::FUSION_METHOD_RRF
+                      ? query::FusionMethod::kRRF
+                      : query::FusionMethod::kWeighted;
+  fusion.rrf_constant = request.fusion().rrf_constant();
+  fusion.text_weight = request.fusion().text_weight();
+  fusion.vector_weight = request.fusion().vector_weight();
+  return fusion;
+}
+
 absl::StatusOr<std::unique_ptr<query::Predicate>> GRPCPredicateToPredicate(
     const Predicate& predicate, std::shared_ptr<IndexSchema> index_schema,
     absl::flat_hash_set<std::string>& attribute_identifiers) {
@@ -106,6 +137,35 @@ absl::StatusOr<std::unique_ptr<query::Predicate>> GRPCPredicateToPredicate(
           predicate.numeric().end(), predicate.numeric().is_inclusive_end());
       return numeric_predicate;
     }
+    case Predicate::kGeo: {
+      const auto& geo = predicate.geo();
+      VMSDK_ASSIGN_OR_RETURN(auto index,
+                             index_schema->GetIndex(geo.attribute_alias()));
+      if (index->GetIndexerType() != indexes::IndexerType::kGeo) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "`", geo.attribute_alias(), "` is not indexed as a geo field"));
+      }
+      VMSDK_ASSIGN_OR_RETURN(auto identifier, index_schema->GetIdentifier(
+                                                  geo.attribute_alias()));
+      attribute_identifiers.insert(identifier);
+      auto geo_index = dynamic_cast<indexes::Geo*>(index.get());
+      if (geo.polygon_size() == 0) {
+        return std::make_unique<query::GeoPredicate>(
+            geo_index, geo.attribute_alias(), identifier,
+            utils::GeoPoint{geo.lon(), geo.lat()}, geo.radius_meters());
+      }
+      if (geo.polygon_size() % 2 != 0 || geo.polygon_size() < 6) {
+        return absl::InvalidArgumentError("Malformed geo polygon");
+      }
+      std::vector<utils::GeoPoint> polygon;
+      polygon.reserve(geo.polygon_size() / 2);
+      for (int i = 0; i < geo.polygon_size(); i += 2) {
+        polygon.push_back(
+            utils::GeoPoint{geo.polygon(i), geo.polygon(i + 1)});
+      }
+      return std::make_unique<query::GeoPredicate>(
+          geo_index, geo.attribute_alias(), identifier, std::move(polygon));
+    }
     case Predicate::kAnd: {
       std::vector<std::unique_ptr<query::Predicate>> children;
       children.reserve(predicate.and_().children_size());
@@ -255,6 +315,7 @@ absl::Status GRPCSearchRequestToParameters(
   parameters->filter_parse_results.query_operations =
       static_cast<QueryOperations>(request.query_operations());
   parameters->sortby_parameter = SortByFromGRPC(request);
+  parameters->fusion = FusionFromGRPC(request);
   return absl::OkStatus();
 }
 
@@ -287,6 +348,23 @@ std::unique_ptr<Predicate> PredicateToGRPCPredicate(
           numeric_predicate->IsEndInclusive());
       return numeric_predicate_proto;
     }
+    case query::PredicateType::kGeo: {
+      auto geo_predicate = dynamic_cast<const query::GeoPredicate*>(&predicate);
+      auto geo_predicate_proto = std::make_unique<Predicate>();
+      auto* geo = geo_predicate_proto->mutable_geo();
+      geo->set_attribute_alias(std::string(geo_predicate->GetAlias()));
+      if (geo_predicate->GetShape() == query::GeoPredicate::Shape::kRadius) {
+        geo->set_lon(geo_predicate->GetCenter().lon);
+        geo->set_lat(geo_predicate->GetCenter().lat);
+        geo->set_radius_meters(geo_predicate->GetRadiusMeters());
+      } else {
+        for (const auto& vertex : geo_predicate->GetPolygon()) {
+          geo->add_polygon(vertex.lon);
+          geo->add_polygon(vertex.lat);
+        }
+      }
+      return geo_predicate_proto;
+    }
     case query::PredicateType::kComposedAnd: {
       auto and_predicate_proto = std::make_unique<Predicate>();
       auto composed_and_predicate =
@@ -412,6 +490,7 @@ std::unique_ptr<SearchIndexPartitionRequest> ParametersToGRPCSearchRequest(
   request->set_query_operations(
       static_cast<uint64_t>(parameters.filter_parse_results.query_operations));
   SortByToGRPC(parameters.sortby_parameter, request.get());
+  FusionToGRPC(parameters.fusion, request.get());
   return request;
 }
 
@@ -30,6 +30,12 @@ std::optional<query::SortByParameter> SortByFromGRPC(
 void SortByToGRPC(const std::optional<query::SortByParameter>& sortby,
                   SearchIndexPartitionRequest* request);
 
+std::optional<query::FusionParameter> FusionFromGRPC(
+    const SearchIndexPartitionRequest& request);
+
+void FusionToGRPC(const std::optional<query::FusionParameter>& fusion,
+                  SearchIndexPartitionRequest* request);
+
 }  // namespace valkey_search::coordinator
 
 #endif  // VALKEYSEARCH_SRC_COORDINATOR_SEARCH_CONVERTER_H_
@@ -55,7 +55,7 @@ grpc::ServerUnaryReactor* Service::GetGlobalMetadata(
     const GetGlobalMetadataRequest* request,
     GetGlobalMetadataResponse* response) {
   GRPCSuspensionGuard guard(GRPCSuspender::Instance());
-  auto latency_sample = SAMPLE_EVERY_N(100);
+  auto latency_sample = std::make_unique<vmsdk::StopWatch>();
   grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
   if (!MetadataManager::IsInitialized()) {
     reactor->Finish(grpc::Status(grpc::StatusCode::INTERNAL,
@@ -210,7 +210,7 @@ grpc::ServerUnaryReactor* Service::SearchIndexPartition(
     SearchIndexPartitionResponse* response) {
   search_index_rpc_requests.Increment();
   GRPCSuspensionGuard guard(GRPCSuspender::Instance());
-  auto latency_sample = SAMPLE_EVERY_N(100);
+  auto latency_sample = std::make_unique<vmsdk::StopWatch>();
   grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
   auto StatusWrapper = [&]() -> absl::Status {
     auto search_operation = std::make_unique<RemoteResponderSearch>();
@@ -224,6 +224,11 @@ grpc::ServerUnaryReactor* Service::SearchIndexPartition(
                       .value();
     VMSDK_RETURN_IF_ERROR(ToAbslStatus(PerformIndexConsistencyCheck(
         request->index_fingerprint_version(), schema)));
+    if (schema->IsBulkLoadInProgress()) {
+      return absl::FailedPreconditionError(absl::StrCat(
+          "Index ", search_operation->index_schema_name,
+          " is being bulk loaded"));
+    }
 
     if (request->enable_consistency()) {
       // Perform consistency checks on main thread, then enqueue search
@@ -344,7 +349,7 @@ grpc::ServerUnaryReactor* Service::InfoIndexPartition(
     const InfoIndexPartitionRequest* request,
     InfoIndexPartitionResponse* response) {
   GRPCSuspensionGuard guard(GRPCSuspender::Instance());
-  auto latency_sample = SAMPLE_EVERY_N(100);
+  auto latency_sample = std::make_unique<vmsdk::StopWatch>();
   grpc::ServerUnaryReactor* reactor = context->DefaultReactor();
   // simulate grpc failure for testing only
   if (ForceRemoteFailCount.GetValue() > 0) {
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/expiry_tracker.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search {
+
+namespace {
+
+constexpr size_t kMinCompactionSize = 1024;
+
+}  // namespace
+
+void ExpiryTracker::Set(const InternedStringPtr &key, int64_t expire_at_ms) {
+  absl::MutexLock lock(&mutex_);
+  auto [itr, inserted] = expire_at_.try_emplace(key, expire_at_ms);
+  if (!inserted) {
+    if (itr->second == expire_at_ms) {
+      return;
+    }
+    itr->second = expire_at_ms;
+  }
+  queue_.emplace(expire_at_ms, key);
+  size_.store(expire_at_.size(), std::memory_order_relaxed);
+  // Keys whose time keeps being pushed back, such as sessions, leave stale
+  // entries behind. Rebuild once they outnumber the live ones.
+  if (queue_.size() > 2 * expire_at_.size() + kMinCompactionSize) {
+    std::vector<Entry> entries;
+    entries.reserve(expire_at_.size());
+    for (const auto &[tracked_key, tracked_expire_at_ms] : expire_at_) {
+      entries.emplace_back(tracked_expire_at_ms, tracked_key);
+    }
+    queue_ = decltype(queue_)(LaterFirst(), std::move(entries));
+  }
+}
+
+void ExpiryTracker::Remove(const InternedStringPtr &key) {
+  if (IsEmpty()) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  expire_at_.erase(key);
+  size_.store(expire_at_.size(), std::memory_order_relaxed);
+  if (expire_at_.empty()) {
+    queue_ = {};
+  }
+}
+
+bool ExpiryTracker::IsExpired(const InternedStringPtr &key,
+                              int64_t now_ms) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto itr = expire_at_.find(key);
+  return itr != expire_at_.end() && itr->second <= now_ms;
+}
+
+std::vector<InternedStringPtr> ExpiryTracker::PopExpired(int64_t now_ms,
+                                                         size_t max_keys) {
+  std::vector<InternedStringPtr> expired;
+  if (IsEmpty()) {
+    return expired;
+  }
+  absl::MutexLock lock(&mutex_);
+  while (!queue_.empty() && expired.size() < max_keys &&
+         queue_.top().first <= now_ms) {
+    auto [expire_at_ms, key] = queue_.top();
+    queue_.pop();
+    auto itr = expire_at_.find(key);
+    if (itr == expire_at_.end() || itr->second != expire_at_ms) {
+      continue;
+    }
+    expire_at_.erase(itr);
+    expired.push_back(std::move(key));
+  }
+  size_.store(expire_at_.size(), std::memory_order_relaxed);
+  return expired;
+}
+
+}  // namespace valkey_search
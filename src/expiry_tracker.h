@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_EXPIRY_TRACKER_H_
+#define VALKEYSEARCH_SRC_EXPIRY_TRACKER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search {
+
+//
+// Tracks the expiration time of the indexed keys which have one.
+//
+// Times are absolute, in milliseconds since the unix epoch. They are recorded
+// on the main thread whenever a key is indexed, and read by the reader threads
+// to leave expired keys out of search results without opening them. Keys
+// whose time has passed are popped in expiration order, so that they can be
+// removed from the index before the server deletes them.
+//
+class ExpiryTracker {
+ public:
+  // Records the expiration time of `key`, replacing any earlier one.
+  void Set(const InternedStringPtr &key, int64_t expire_at_ms)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Forgets `key`, when it was deleted or made persistent.
+  void Remove(const InternedStringPtr &key) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  bool IsEmpty() const { return size_.load(std::memory_order_relaxed) == 0; }
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  bool IsExpired(const InternedStringPtr &key, int64_t now_ms) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Erases the items whose key, as returned by `key_of`, expired by `now_ms`,
+  // keeping the order of the others. The lock is taken once for all of them.
+  // Returns the number of erased items.
+  template <typename T, typename KeyOf>
+  size_t EraseExpired(std::vector<T> &items, int64_t now_ms,
+                      KeyOf key_of) const ABSL_LOCKS_EXCLUDED(mutex_) {
+    if (IsEmpty()) {
+      return 0;
+    }
+    absl::ReaderMutexLock lock(&mutex_);
+    // No tracked key expires before the top of the queue.
+    if (queue_.empty() || queue_.top().first > now_ms) {
+      return 0;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      auto itr = expire_at_.find(key_of(items[i]));
+      if (itr != expire_at_.end() && itr->second <= now_ms) {
+        continue;
+      }
+      if (kept != i) {
+        items[kept] = std::move(items[i]);
+      }
+      ++kept;
+    }
+    size_t erased = items.size() - kept;
+    items.erase(items.begin() + kept, items.end());
+    return erased;
+  }
+
+  // Forgets and returns up to `max_keys` keys which expired by `now_ms`, the
+  // earliest first.
+  std::vector<InternedStringPtr> PopExpired(int64_t now_ms, size_t max_keys)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  using Entry = std::pair<int64_t, InternedStringPtr>;
+  struct LaterFirst {
+    bool operator()(const Entry &a, const Entry &b) const {
+      return a.first > b.first;
+    }
+  };
+
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<InternedStringPtr, int64_t> expire_at_
+      ABSL_GUARDED_BY(mutex_);
+  // Holds an entry per Set. Entries which no longer match expire_at_ are
+  // dropped when they reach the top.
+  std::priority_queue<Entry, std::vector<Entry>, LaterFirst> queue_
+      ABSL_GUARDED_BY(mutex_);
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace valkey_search
+
+#endif  // VALKEYSEARCH_SRC_EXPIRY_TRACKER_H_
@@ -34,6 +34,7 @@
 #include "src/attribute.h"
 #include "src/attribute_data_type.h"
 #include "src/index_schema.pb.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
@@ -53,6 +54,7 @@
 #include "vmsdk/src/blocked_client.h"
 #include "vmsdk/src/debug.h"
 #include "vmsdk/src/info.h"
+#include "vmsdk/src/latency_sampler.h"
 #include "vmsdk/src/log.h"
 #include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/module_config.h"
@@ -72,6 +74,24 @@ namespace valkey_search {
 
 namespace {
 constexpr size_t kMaxTextFieldsCount{64};
+// One in this many mutations of an index is timed to measure its cost.
+constexpr uint64_t kMutationCostSampleInterval{16};
+constexpr double kMaxMeasuredMutationWeight{10000};
+
+// Weight of an index's mutations: the static weight of the index type, or,
+// when mutation-weight-ns-per-byte is set, derived from their measured cost
+// once sampled. A measured weight is at least 1 so that cheap mutations still
+// count towards the buffer.
+uint32_t GetEffectiveMutationWeight(const indexes::IndexBase &index) {
+  const auto ns_per_weight_unit =
+      options::GetMutationWeightNsPerByte().GetValue();
+  const double cost = index.GetMutationCost();
+  if (ns_per_weight_unit == 0 || cost == 0) {
+    return index.GetMutationWeight();
+  }
+  return static_cast<uint32_t>(std::clamp(cost * 100 / ns_per_weight_unit, 1.0,
+                                          kMaxMeasuredMutationWeight));
+}
 }  // namespace
 
 LogLevel GetLogSeverity(bool ok) { return ok ? DEBUG : WARNING; }
@@ -123,11 +143,10 @@ DEV_INTEGER_COUNTER(rdb_stats, rdb_save_backfilling_indexes);
 DEV_INTEGER_COUNTER(rdb_stats, rdb_load_backfilling_indexes);
 
 IndexSchema::BackfillJob::BackfillJob(ValkeyModuleCtx *ctx,
-                                      absl::string_view name, int db_num)
-    : cursor(vmsdk::MakeUniqueValkeyScanCursor()) {
-  scan_ctx = vmsdk::MakeUniqueValkeyDetachedThreadSafeContext(ctx);
-  ValkeyModule_SelectDb(scan_ctx.get(), db_num);
-  db_size = ValkeyModule_DbSize(scan_ctx.get());
+                                      absl::string_view name, int db_num) {
+  auto size_ctx = vmsdk::MakeUniqueValkeyDetachedThreadSafeContext(ctx);
+  ValkeyModule_SelectDb(size_ctx.get(), db_num);
+  db_size = ValkeyModule_DbSize(size_ctx.get());
   VMSDK_LOG_EVERY_N_SEC(NOTICE, ctx, 1)
       << "Starting backfill for index schema in DB " << db_num << ": "
       << vmsdk::config::RedactIfNeeded(name) << " (size: " << db_size << ")";
@@ -145,6 +164,9 @@ absl::StatusOr<std::shared_ptr<indexes::IndexBase>> IndexFactory(
     case data_model::Index::IndexTypeCase::kNumericIndex: {
       return std::make_shared<indexes::Numeric>(index.numeric_index());
     }
+    case data_model::Index::IndexTypeCase::kGeoIndex: {
+      return std::make_shared<indexes::Geo>(index.geo_index());
+    }
     case data_model::Index::IndexTypeCase::kTextIndex: {
       // Create the TextIndexSchema if this is the first Text index we're seeing
       if (!index_schema->GetTextIndexSchema()) {
@@ -168,8 +190,12 @@ absl::StatusOr<std::shared_ptr<indexes::IndexBase>> IndexFactory(
                       : indexes::VectorHNSW<float>::Create(
                             index.vector_index(), attribute.identifier(),
                             index_schema->GetAttributeDataType().ToProto()));
-              index_schema->SubscribeToVectorExternalizer(
-                  attribute.identifier(), index.get());
+              // The externalizer shares a single interned vector with the
+              // keyspace, which doesn't apply to multi-vector records.
+              if (!index->IsMultiVector()) {
+                index_schema->SubscribeToVectorExternalizer(
+                    attribute.identifier(), index.get());
+              }
               return index;
             }
             default: {
@@ -513,10 +539,24 @@ void TrackResults(
 void IndexSchema::OnKeyspaceNotification(ValkeyModuleCtx *ctx, int type,
                                          const char *event,
                                          ValkeyModuleString *key) {
+  KeyRecordCache cache(ctx, key);
+  OnKeyspaceNotification(ctx, type, event, key, cache);
+}
+
+void IndexSchema::OnKeyspaceNotification(ValkeyModuleCtx *ctx,
+                                         [[maybe_unused]] int type,
+                                         [[maybe_unused]] const char *event,
+                                         ValkeyModuleString *key,
+                                         KeyRecordCache &cache) {
   if (ABSL_PREDICT_FALSE(!IsInCurrentDB(ctx))) {
     return;
   }
-  ProcessKeyspaceNotification(ctx, key, false);
+  // Writes during a bulk load are picked up by the scan that ends it.
+  // Deletions are still processed, as the scan only visits existing keys.
+  if (bulk_load_state_ == BulkLoadState::kLoading && cache.GetOpenKey()) {
+    return;
+  }
+  ProcessKeyspaceNotification(cache, false);
 }
 
 bool AddAttributeData(IndexSchema::MutatedAttributes &mutated_attributes,
@@ -544,14 +584,20 @@ bool AddAttributeData(IndexSchema::MutatedAttributes &mutated_attributes,
 void IndexSchema::ProcessKeyspaceNotification(ValkeyModuleCtx *ctx,
                                               ValkeyModuleString *key,
                                               bool from_backfill) {
-  auto key_cstr = vmsdk::ToStringView(key);
+  KeyRecordCache cache(ctx, key);
+  ProcessKeyspaceNotification(cache, from_backfill);
+}
+
+void IndexSchema::ProcessKeyspaceNotification(KeyRecordCache &cache,
+                                              bool from_backfill) {
+  auto *ctx = cache.GetCtx();
+  auto key_cstr = vmsdk::ToStringView(cache.GetKey());
   if (key_cstr.empty()) {
     return;
   }
-  auto key_obj = vmsdk::MakeUniqueValkeyOpenKey(
-      ctx, key, VALKEYMODULE_OPEN_KEY_NOEFFECTS | VALKEYMODULE_READ);
+  auto *key_obj = cache.GetOpenKey();
   // Fail fast if the key type does not match the data type.
-  if (key_obj && !GetAttributeDataType().IsProperType(key_obj.get())) {
+  if (key_obj && !GetAttributeDataType().IsProperType(key_obj)) {
     return;
   }
   MutatedAttributes mutated_attributes;
@@ -566,9 +612,8 @@ void IndexSchema::ProcessKeyspaceNotification(ValkeyModuleCtx *ctx,
       continue;
     }
     bool is_module_owned;
-    vmsdk::UniqueValkeyString record = VectorExternalizer::Instance().GetRecord(
-        ctx, attribute_data_type_.get(), key_obj.get(), key_cstr,
-        attribute.GetIdentifier(), is_module_owned);
+    vmsdk::UniqueValkeyString record = cache.GetRecord(
+        *attribute_data_type_, attribute.GetIdentifier(), is_module_owned);
     // Early return on record not found just if the record not tracked.
     // Otherwise, it will be processed as a delete
     if (!record && !attribute.GetIndex()->IsTracked(interned_key) &&
@@ -587,6 +632,15 @@ void IndexSchema::ProcessKeyspaceNotification(ValkeyModuleCtx *ctx,
     }
   }
   if (added) {
+    mstime_t ttl =
+        key_obj ? ValkeyModule_GetExpire(key_obj) : VALKEYMODULE_NO_EXPIRE;
+    if (ttl == VALKEYMODULE_NO_EXPIRE) {
+      expiry_tracker_.Remove(interned_key);
+    } else {
+      int64_t expire_at_ms =
+          absl::ToUnixMillis(absl::Now()) + std::max<mstime_t>(ttl, 0);
+      expiry_tracker_.Set(interned_key, expire_at_ms);
+    }
     switch (attribute_data_type_->ToProto()) {
       case data_model::ATTRIBUTE_DATA_TYPE_HASH:
         if (from_backfill) {
@@ -613,12 +667,14 @@ void IndexSchema::ProcessKeyspaceNotification(ValkeyModuleCtx *ctx,
 void IndexSchema::SyncProcessMutation(ValkeyModuleCtx *ctx,
                                       MutatedAttributes &mutated_attributes,
                                       const Key &key) {
+  vmsdk::StopWatch apply_time;
   if (text_index_schema_) {
     // Always clean up indexed words from all text attributes of the key up
     // front
     text_index_schema_->DeleteKeyData(key);
   }
   bool all_deletes = true;
+  bool numeric_or_vector_mutated = false;
   for (auto &attribute_data_itr : mutated_attributes) {
     const auto itr = attributes_.find(attribute_data_itr.first);
     if (itr == attributes_.end()) {
@@ -628,10 +684,22 @@ void IndexSchema::SyncProcessMutation(ValkeyModuleCtx *ctx,
         indexes::DeletionType::kNone) {
       all_deletes = false;
     }
+    switch (itr->second.GetIndex()->GetIndexerType()) {
+      case indexes::IndexerType::kNumeric:
+      case indexes::IndexerType::kHNSW:
+      case indexes::IndexerType::kFlat:
+        numeric_or_vector_mutated = true;
+        break;
+      default:
+        break;
+    }
     ProcessAttributeMutation(ctx, itr->second, key,
                              std::move(attribute_data_itr.second.data),
                              attribute_data_itr.second.deletion_type);
   }
+  if (numeric_or_vector_mutated) {
+    UpdateNumericColumns(key);
+  }
   if (all_deletes) {
     // If all attributes are deletes, we can remove the key from the tracked
     // mutation records.
@@ -643,6 +711,34 @@ void IndexSchema::SyncProcessMutation(ValkeyModuleCtx *ctx,
     // updates to all Text attributes in one operation for efficiency
     text_index_schema_->CommitKeyData(key);
   }
+  Metrics::GetStats().mutation_apply_latency.SubmitSample(
+      apply_time.Duration());
+}
+
+// Refreshes the numeric columns kept by the vector indexes for this key. This
+// runs after all attributes of the mutation were applied, so the vector index
+// already knows whether the key is tracked and the numeric indexes hold the
+// final values.
+void IndexSchema::UpdateNumericColumns(const Key &key) const {
+  for (const auto &[vector_alias, vector_attribute] : attributes_) {
+    auto vector_type = vector_attribute.GetIndex()->GetIndexerType();
+    if (vector_type != indexes::IndexerType::kHNSW &&
+        vector_type != indexes::IndexerType::kFlat) {
+      continue;
+    }
+    auto vector_index = dynamic_cast<indexes::VectorBase *>(
+        vector_attribute.GetIndex().get());
+    for (const auto &[numeric_alias, numeric_attribute] : attributes_) {
+      if (numeric_attribute.GetIndex()->GetIndexerType() !=
+          indexes::IndexerType::kNumeric) {
+        continue;
+      }
+      auto numeric_index =
+          dynamic_cast<indexes::Numeric *>(numeric_attribute.GetIndex().get());
+      vector_index->UpdateNumericColumn(key, numeric_index,
+                                        numeric_index->GetValueLocked(key));
+    }
+  }
 }
 
 void IndexSchema::ProcessAttributeMutation(
@@ -652,8 +748,12 @@ void IndexSchema::ProcessAttributeMutation(
   if (data) {
     DCHECK(deletion_type == indexes::DeletionType::kNone);
     auto data_view = vmsdk::ToStringView(data.get());
+    auto cost_sample = SAMPLE_EVERY_N(kMutationCostSampleInterval);
     if (index->IsTracked(key)) {
       auto res = index->ModifyRecord(key, data_view);
+      if (cost_sample) {
+        index->RecordMutationCost(cost_sample->Duration(), data_view.size());
+      }
       TrackResults(ctx, res, "Modify", stats_.subscription_modify);
       if (res.ok() && res.value()) {
         ++Metrics::GetStats().time_slice_upserts;
@@ -661,6 +761,9 @@ void IndexSchema::ProcessAttributeMutation(
       return;
     }
     auto res = index->AddRecord(key, data_view);
+    if (cost_sample) {
+      index->RecordMutationCost(cost_sample->Duration(), data_view.size());
+    }
     TrackResults(ctx, res, "Add", stats_.subscription_add);
 
     if (res.ok() && res.value()) {
@@ -681,6 +784,9 @@ void IndexSchema::ProcessAttributeMutation(
         case indexes::IndexerType::kText:
           Metrics::GetStats().ingest_field_text++;
           break;
+        case indexes::IndexerType::kGeo:
+          Metrics::GetStats().ingest_field_geo++;
+          break;
         default:
           // Shouldn't happen
           break;
@@ -922,73 +1028,6 @@ void IndexSchema::ProcessSingleMutationAsync(ValkeyModuleCtx *ctx,
   }
 }
 
-void IndexSchema::BackfillScanCallback(ValkeyModuleCtx *ctx,
-                                       ValkeyModuleString *keyname,
-                                       ValkeyModuleKey *key, void *privdata) {
-  IndexSchema *index_schema = reinterpret_cast<IndexSchema *>(privdata);
-  index_schema->backfill_job_.Get()->scanned_key_count++;
-  auto key_prefixes = index_schema->GetKeyPrefixes();
-  auto key_cstr = vmsdk::ToStringView(keyname);
-  if (std::any_of(key_prefixes.begin(), key_prefixes.end(),
-                  [&key_cstr](const auto &key_prefix) {
-                    return key_cstr.starts_with(key_prefix);
-                  })) {
-    index_schema->ProcessKeyspaceNotification(ctx, keyname, true);
-  }
-}
-
-CONTROLLED_BOOLEAN(StopBackfill, false);
-
-uint32_t IndexSchema::PerformBackfill(ValkeyModuleCtx *ctx,
-                                      uint32_t batch_size) {
-  auto &backfill_job = backfill_job_.Get();
-  if (!backfill_job.has_value() || backfill_job->IsScanDone()) {
-    return 0;
-  }
-
-  if (StopBackfill.GetValue()) {
-    VMSDK_LOG_EVERY_N_SEC(NOTICE, ctx, 1) << "Backfill stopped by request";
-    return 0;
-  }
-
-  backfill_job->paused_by_oom = false;
-
-  // We need to ensure the DB size is monotonically increasing, since it could
-  // change during the backfill, in which case we may show incorrect progress.
-  backfill_job->db_size =
-      std::max(backfill_job->db_size,
-               (uint64_t)ValkeyModule_DbSize(backfill_job->scan_ctx.get()));
-
-  uint64_t start_scan_count = backfill_job->scanned_key_count;
-  uint64_t &current_scan_count = backfill_job->scanned_key_count;
-  while (current_scan_count - start_scan_count < batch_size) {
-    auto ctx_flags = ValkeyModule_GetContextFlags(ctx);
-    if (ctx_flags & VALKEYMODULE_CTX_FLAGS_OOM) {
-      backfill_job->paused_by_oom = true;
-      return 0;
-    }
-
-    // Scan will return zero if there are no more keys to scan. This could be
-    // the case either if there are no keys at all or if we have reached the
-    // end of the current iteration. Because of this, we use the scanned key
-    // count to know how many keys we have scanned in total (either zero or
-    // one).
-    if (!ValkeyModule_Scan(backfill_job->scan_ctx.get(),
-                           backfill_job->cursor.get(), BackfillScanCallback,
-                           (void *)this)) {
-      VMSDK_LOG_EVERY_N_SEC(NOTICE, ctx, 1)
-          << "Index schema " << vmsdk::config::RedactIfNeeded(name_)
-          << " finished backfill. Scanned " << backfill_job->scanned_key_count
-          << " keys in "
-          << absl::FormatDuration(backfill_job->stopwatch.Duration());
-      uint32_t res = current_scan_count - start_scan_count;
-      backfill_job->MarkScanAsDone();
-      return res;
-    }
-  }
-  return current_scan_count - start_scan_count;
-}
-
 float IndexSchema::GetBackfillPercent() const {
   const auto &backfill_job = backfill_job_.Get();
   if (!IsBackfillInProgress() || (backfill_job->db_size == 0)) {
@@ -1010,7 +1049,117 @@ float IndexSchema::GetBackfillPercent() const {
   return (float)processed_keys / backfill_job->db_size;
 }
 
+void IndexSchema::RemoveExpiredNeighbors(
+    std::vector<indexes::Neighbor> &neighbors) const {
+  if (expiry_tracker_.IsEmpty()) {
+    return;
+  }
+  size_t removed = expiry_tracker_.EraseExpired(
+      neighbors, absl::ToUnixMillis(absl::Now()),
+      [](const indexes::Neighbor &neighbor) -> const InternedStringPtr & {
+        return neighbor.external_id;
+      });
+  Metrics::GetStats().query_expired_keys_skipped_cnt += removed;
+}
+
+size_t IndexSchema::RemoveExpiredKeys(ValkeyModuleCtx *ctx, size_t max_keys) {
+  vmsdk::VerifyMainThread();
+  auto expired = expiry_tracker_.PopExpired(absl::ToUnixMillis(absl::Now()),
+                                            max_keys);
+  for (const auto &key : expired) {
+    MutatedAttributes mutated_attributes;
+    for (const auto &[alias, _] : attributes_) {
+      mutated_attributes[alias] = {nullptr, indexes::DeletionType::kRecord};
+    }
+    ProcessMutation(ctx, mutated_attributes, key, false, true);
+  }
+  Metrics::GetStats().expired_keys_removed_cnt += expired.size();
+  return expired.size();
+}
+
+bool IndexSchema::Defrag(indexes::DefragContext &ctx,
+                         DefragCursor &cursor) {
+  vmsdk::VerifyMainThread();
+  std::vector<std::pair<absl::string_view, indexes::IndexBase *>> indexes;
+  for (const auto &[alias, attribute] : attributes_) {
+    indexes.emplace_back(alias, attribute.GetIndex().get());
+  }
+  std::sort(indexes.begin(), indexes.end());
+  auto resume_at = [&]() {
+    return std::lower_bound(
+        indexes.begin(), indexes.end(), cursor.attribute,
+        [](const auto &index, const std::string &attribute) {
+          return index.first < attribute;
+        });
+  };
+  // Holding the lock in write mode keeps queries out. The main thread doesn't
+  // wait for the queries in flight or for a mode switch, the increment is
+  // skipped and the pass resumes on the next defrag cycle instead.
+  vmsdk::TryMutexLock lock(&time_sliced_mutex_,
+                           vmsdk::TimeSlicedMRMWMutex::Mode::kLockWrite);
+  if (!lock.owns_lock()) {
+    return false;
+  }
+  if (!cursor.compacting) {
+    for (auto it = resume_at(); it != indexes.end(); ++it) {
+      if (cursor.attribute != it->first) {
+        cursor.attribute = std::string(it->first);
+        cursor.position = 0;
+      }
+      if (ctx.ShouldStop() || !it->second->Defrag(ctx, cursor.position)) {
+        return false;
+      }
+    }
+    cursor = DefragCursor{};
+    cursor.compacting = true;
+  }
+  for (auto it = resume_at(); it != indexes.end(); ++it) {
+    cursor.attribute = std::string(it->first);
+    if (ctx.ShouldStop() || !it->second->CompactMemory(ctx)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::Status IndexSchema::BeginBulkLoad() {
+  if (bulk_load_state_ == BulkLoadState::kLoading) {
+    return absl::FailedPreconditionError(
+        absl::StrFormat("Index %s is already bulk loading", name_));
+  }
+  bulk_load_state_ = BulkLoadState::kLoading;
+  VMSDK_LOG(NOTICE, detached_ctx_.get())
+      << "Bulk load started for index schema "
+      << vmsdk::config::RedactIfNeeded(name_) << " in DB " << db_num_;
+  return absl::OkStatus();
+}
+
+absl::Status IndexSchema::EndBulkLoad(ValkeyModuleCtx *ctx) {
+  if (bulk_load_state_ != BulkLoadState::kLoading) {
+    return absl::FailedPreconditionError(
+        absl::StrFormat("Index %s is not bulk loading", name_));
+  }
+  // A fresh job makes the schema wait for the next scan round of its DB, so
+  // that every key written during the bulk load is visited.
+  backfill_job_ = std::make_optional<BackfillJob>(ctx, name_, db_num_);
+  bulk_load_state_ = BulkLoadState::kBuilding;
+  return absl::OkStatus();
+}
+
+void IndexSchema::MaybeFinishBulkLoad() {
+  if (bulk_load_state_ != BulkLoadState::kBuilding || IsBackfillInProgress()) {
+    return;
+  }
+  bulk_load_state_ = BulkLoadState::kNone;
+  VMSDK_LOG(NOTICE, detached_ctx_.get())
+      << "Bulk load completed for index schema "
+      << vmsdk::config::RedactIfNeeded(name_) << " in DB " << db_num_;
+}
+
 absl::string_view IndexSchema::GetStateForInfo() const {
+  if (bulk_load_state_ == BulkLoadState::kLoading) {
+    return "bulk_loading";
+  }
   if (!IsBackfillInProgress()) {
     return "ready";
   } else {
@@ -1074,7 +1223,7 @@ int IndexSchema::GetTextItemCount() const {
 }
 
 void IndexSchema::RespondWithInfo(ValkeyModuleCtx *ctx) const {
-  int arrSize = 28;
+  int arrSize = 30;
   // Text-attribute info fields
   if (text_index_schema_) {
     arrSize += 8;  // punctuation, stop_words, with_offsets, min_stem_size (4
@@ -1131,6 +1280,10 @@ void IndexSchema::RespondWithInfo(ValkeyModuleCtx *ctx) const {
   ValkeyModule_ReplyWithSimpleString(ctx, "backfill_complete_percent");
   ValkeyModule_ReplyWithCString(
       ctx, absl::StrFormat("%f", GetBackfillPercent()).c_str());
+  ValkeyModule_ReplyWithSimpleString(ctx, "backfill_main_thread_stall");
+  ValkeyModule_ReplyWithCString(
+      ctx, absl::StrFormat("%lu ms", stats_.backfill_stall_us.load() / 1000)
+               .c_str());
 
   absl::MutexLock lock(&stats_.mutex_);
   ValkeyModule_ReplyWithSimpleString(ctx, "mutation_queue_size");
@@ -1304,9 +1457,11 @@ absl::Status IndexSchema::RDBSave(SafeRDB *rdb) const {
     VMSDK_RETURN_IF_ERROR(SaveSupplementalSection(
         rdb, data_model::SUPPLEMENTAL_CONTENT_INDEX_EXTENSION,
         [&](auto &header) {
-          rdb_save_backfilling_indexes.Increment(int(IsBackfillInProgress()));
-          header.mutable_mutation_queue_header()->set_backfilling(
-              IsBackfillInProgress());
+          // Keys written during a bulk load are only indexed by the backfill
+          // that ends it, so a reload has to backfill them.
+          bool backfilling = IsBackfillInProgress() || IsBulkLoadInProgress();
+          rdb_save_backfilling_indexes.Increment(int(backfilling));
+          header.mutable_mutation_queue_header()->set_backfilling(backfilling);
           VMSDK_LOG(DEBUG, nullptr)
               << "RDB: Saving Index Extension Backfill = "
               << header.mutation_queue_header().backfilling();
@@ -1684,10 +1839,6 @@ void IndexSchema::OnSwapDB(ValkeyModuleSwapDbInfo *swap_db_info) {
     return;
   }
   db_num_ = db_to_swap_to;
-  auto &backfill_job = backfill_job_.Get();
-  if (IsBackfillInProgress() && !backfill_job->IsScanDone()) {
-    ValkeyModule_SelectDb(backfill_job->scan_ctx.get(), db_to_swap_to);
-  }
 }
 
 void IndexSchema::DrainMutationQueue(ValkeyModuleCtx *ctx) const {
@@ -1828,7 +1979,10 @@ bool IndexSchema::InTrackedMutationRecords(
 }
 
 // This function is used to compute how much memory will be allocated
-// in approximate as a result of ingestion.
+// in approximate as a result of ingestion. When measured weights are enabled
+// with mutation-weight-ns-per-byte, the buffer instead tracks the estimated
+// cost of the pending mutation, so a backlog of expensive mutations throttles
+// writes sooner.
 size_t IndexSchema::ComputeWeightedBufferSize(
     const MutatedAttributes &attributes) const {
   size_t total = 0;
@@ -1840,7 +1994,7 @@ size_t IndexSchema::ComputeWeightedBufferSize(
     uint32_t weight = 0;
     auto attr_itr = attributes_.find(alias);
     if (attr_itr != attributes_.end()) {
-      weight = attr_itr->second.GetIndex()->GetMutationWeight();
+      weight = GetEffectiveMutationWeight(*attr_itr->second.GetIndex());
     }
     total += data_size * weight;
   }
@@ -28,6 +28,7 @@
 #include "gtest/gtest_prod.h"
 #include "src/attribute.h"
 #include "src/attribute_data_type.h"
+#include "src/expiry_tracker.h"
 #include "src/index_schema.pb.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/text/text_index.h"
@@ -117,6 +118,9 @@ class IndexSchema : public KeyspaceEventSubscription,
     ResultCnt<std::atomic<uint64_t>> subscription_add;
     std::atomic<uint32_t> document_cnt{0};
     std::atomic<uint32_t> backfill_inqueue_tasks{0};
+    // Time the main thread spent on, or was locked out by, the backfill of
+    // this schema.
+    std::atomic<uint64_t> backfill_stall_us{0};
     uint64_t mutation_queue_size_ ABSL_GUARDED_BY(mutex_){0};
     absl::Duration mutations_queue_delay_ ABSL_GUARDED_BY(mutex_);
     mutable absl::Mutex mutex_;
@@ -169,6 +173,10 @@ class IndexSchema : public KeyspaceEventSubscription,
     return subscribed_key_prefixes_;
   }
 
+  bool ReadsRecord(absl::string_view identifier) const override {
+    return identifier_to_alias_.contains(identifier);
+  }
+
   inline const std::string &GetName() const { return name_; }
   inline std::uint32_t GetDBNum() const { return db_num_; }
 
@@ -189,8 +197,9 @@ class IndexSchema : public KeyspaceEventSubscription,
 
   void OnKeyspaceNotification(ValkeyModuleCtx *ctx, int type, const char *event,
                               ValkeyModuleString *key) override;
-
-  uint32_t PerformBackfill(ValkeyModuleCtx *ctx, uint32_t batch_size);
+  void OnKeyspaceNotification(ValkeyModuleCtx *ctx, int type, const char *event,
+                              ValkeyModuleString *key,
+                              KeyRecordCache &cache) override;
 
   bool IsBackfillInProgress() const {
     auto &backfill_job = backfill_job_.Get();
@@ -198,6 +207,40 @@ class IndexSchema : public KeyspaceEventSubscription,
            (!backfill_job->IsScanDone() || stats_.backfill_inqueue_tasks > 0);
   }
 
+  // While a schema is bulk loading, writes to keys are not indexed one by one.
+  // Ending the bulk load rebuilds the index with a backfill scan, and queries
+  // are refused until that scan completes, so that the loaded keys become
+  // visible at once.
+  enum class BulkLoadState : uint8_t { kNone, kLoading, kBuilding };
+  absl::Status BeginBulkLoad();
+  absl::Status EndBulkLoad(ValkeyModuleCtx *ctx);
+  // Ends the build of a bulk load once its backfill has completed.
+  void MaybeFinishBulkLoad();
+  // Safe to call from any thread.
+  bool IsBulkLoadInProgress() const {
+    return bulk_load_state_ != BulkLoadState::kNone;
+  }
+
+  // Drops the neighbors whose keys have expired. Safe to call from any thread.
+  void RemoveExpiredNeighbors(std::vector<indexes::Neighbor> &neighbors) const;
+  // Removes up to `max_keys` expired keys from the index, ahead of their
+  // deletion by the server. Returns the number of keys removed.
+  size_t RemoveExpiredKeys(ValkeyModuleCtx *ctx, size_t max_keys);
+  const ExpiryTracker &GetExpiryTracker() const { return expiry_tracker_; }
+
+  // Where a defragmentation pass over the schema resumes.
+  struct DefragCursor {
+    // Set once every index completed IndexBase::Defrag.
+    bool compacting{false};
+    // Alias of the next attribute to visit, attributes are visited in order.
+    std::string attribute;
+    uint64_t position{0};
+  };
+  // Runs one increment of the defragmentation pass over the indexes of the
+  // schema. Returns whether the pass is complete. Main thread only, never
+  // waits for a lock: the increment is skipped while the schema is busy.
+  bool Defrag(indexes::DefragContext &ctx, DefragCursor &cursor);
+
   float GetBackfillPercent() const;
   absl::string_view GetStateForInfo() const;
   uint64_t CountRecords() const;
@@ -424,16 +467,16 @@ class IndexSchema : public KeyspaceEventSubscription,
   // exclusion is provided by mutated_records_mutex_.
   IndexKeyInfoMap index_key_info_ ABSL_GUARDED_BY(time_sliced_mutex_);
 
+  // Backfill progress of this schema. The keyspace scan itself is shared by
+  // all schemas of the DB and driven by the BackfillCoordinator.
   struct BackfillJob {
     BackfillJob() = delete;
     BackfillJob(ValkeyModuleCtx *ctx, absl::string_view name, int db_num);
-    bool IsScanDone() const { return scan_ctx.get() == nullptr; }
-    void MarkScanAsDone() {
-      scan_ctx.reset();
-      cursor.reset();
-    }
-    vmsdk::UniqueValkeyDetachedThreadSafeContext scan_ctx;
-    vmsdk::UniqueValkeyScanCursor cursor;
+    bool IsScanDone() const { return scan_done; }
+    void MarkScanAsDone() { scan_done = true; }
+    bool scan_done{false};
+    // Set once the schema takes part in a scan round of its DB.
+    bool joined_scan{false};
     uint64_t scanned_key_count{0};
     uint64_t db_size;
     vmsdk::StopWatch stopwatch;
@@ -441,6 +484,8 @@ class IndexSchema : public KeyspaceEventSubscription,
   };
 
   vmsdk::MainThreadAccessGuard<std::optional<BackfillJob>> backfill_job_;
+  std::atomic<BulkLoadState> bulk_load_state_{BulkLoadState::kNone};
+  ExpiryTracker expiry_tracker_;
   absl::flat_hash_map<std::string, indexes::VectorBase *>
       vector_externalizer_subscriptions_;
   void VectorExternalizer(const Key &key,
@@ -451,6 +496,9 @@ class IndexSchema : public KeyspaceEventSubscription,
 
   void ProcessKeyspaceNotification(ValkeyModuleCtx *ctx,
                                    ValkeyModuleString *key, bool from_backfill);
+  // Same as above, reading the key through a cache shared with the other
+  // schemas interested in it.
+  void ProcessKeyspaceNotification(KeyRecordCache &cache, bool from_backfill);
 
   void ProcessMutation(ValkeyModuleCtx *ctx,
                        MutatedAttributes &mutated_attributes,
@@ -470,9 +518,7 @@ class IndexSchema : public KeyspaceEventSubscription,
                                 const Attribute &attribute, const Key &key,
                                 vmsdk::UniqueValkeyString data,
                                 indexes::DeletionType deletion_type);
-  static void BackfillScanCallback(ValkeyModuleCtx *ctx,
-                                   ValkeyModuleString *keyname,
-                                   ValkeyModuleKey *key, void *privdata);
+  void UpdateNumericColumns(const Key &key) const;
   bool DeleteIfNotInValkeyDict(ValkeyModuleCtx *ctx, ValkeyModuleString *key,
                                const Attribute &attribute);
   vmsdk::BlockedClientCategory GetBlockedCategoryFromProto() const;
@@ -525,6 +571,7 @@ class IndexSchema : public KeyspaceEventSubscription,
   vmsdk::MainThreadAccessGuard<std::deque<Key>> multi_mutations_keys_;
   vmsdk::MainThreadAccessGuard<bool> schedule_multi_exec_processing_{false};
 
+  friend class BackfillCoordinator;
   FRIEND_TEST(IndexSchemaRDBTest, SaveAndLoad);
   FRIEND_TEST(IndexSchemaRDBTest, ComprehensiveSkipLoadTest);
   FRIEND_TEST(IndexSchemaFriendTest, ConsistencyTest);
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/indexes/geo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/indexes/index_base.h"
+#include "src/query/predicate.h"
+#include "src/utils/geohash.h"
+#include "src/utils/string_interning.h"
+#include "src/valkey_search_options.h"
+#include "vmsdk/src/status/status_macros.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search::indexes {
+namespace {
+// Negated searches walk the whole tree.
+const std::vector<utils::GeoHashRange> kAllHashes{
+    {0, std::numeric_limits<uint64_t>::max()}};
+}  // namespace
+
+Geo::Geo(const data_model::GeoIndex& geo_index_proto)
+    : IndexBase(IndexerType::kGeo) {}
+
+absl::StatusOr<bool> Geo::AddRecord(const InternedStringPtr& key,
+                                    absl::string_view data) {
+  auto point = utils::ParseGeoPoint(data);
+  absl::MutexLock lock(&index_mutex_);
+  if (!point.ok()) {
+    untracked_keys_.insert(key);
+    return false;
+  }
+  const uint64_t hash = utils::GeoHashEncode(*point);
+  auto [_, succ] = tracked_keys_.insert({key, TrackedPoint{*point, hash}});
+  if (!succ) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("Key `", key->Str(), "` already exists"));
+  }
+  untracked_keys_.erase(key);
+  tree_.Insert(hash, Entry{key, *point});
+  return true;
+}
+
+absl::StatusOr<bool> Geo::ModifyRecord(const InternedStringPtr& key,
+                                       absl::string_view data) {
+  auto point = utils::ParseGeoPoint(data);
+  if (!point.ok()) {
+    [[maybe_unused]] auto res =
+        RemoveRecord(key, indexes::DeletionType::kIdentifier);
+    return false;
+  }
+  absl::MutexLock lock(&index_mutex_);
+  auto it = tracked_keys_.find(key);
+  if (it == tracked_keys_.end()) {
+    return absl::NotFoundError(
+        absl::StrCat("Key `", key->Str(), "` not found"));
+  }
+  tree_.Erase(it->second.hash, Entry{it->first, it->second.point});
+  it->second = TrackedPoint{*point, utils::GeoHashEncode(*point)};
+  tree_.Insert(it->second.hash, Entry{it->first, *point});
+  return true;
+}
+
+absl::StatusOr<bool> Geo::RemoveRecord(const InternedStringPtr& key,
+                                       DeletionType deletion_type) {
+  absl::MutexLock lock(&index_mutex_);
+  if (deletion_type == DeletionType::kRecord) {
+    // If key is DELETED, remove it from untracked_keys_.
+    untracked_keys_.erase(key);
+  } else {
+    // If key doesn't have GEO but exists, insert it to untracked_keys_.
+    untracked_keys_.insert(key);
+  }
+  auto it = tracked_keys_.find(key);
+  if (it == tracked_keys_.end()) {
+    return false;
+  }
+  tree_.Erase(it->second.hash, Entry{it->first, it->second.point});
+  tracked_keys_.erase(it);
+  return true;
+}
+
+int Geo::RespondWithInfo(ValkeyModuleCtx* ctx) const {
+  ValkeyModule_ReplyWithSimpleString(ctx, "type");
+  ValkeyModule_ReplyWithSimpleString(ctx, "GEO");
+  ValkeyModule_ReplyWithSimpleString(ctx, "size");
+  absl::MutexLock lock(&index_mutex_);
+  ValkeyModule_ReplyWithCString(ctx,
+                                std::to_string(tracked_keys_.size()).c_str());
+  return 4;
+}
+
+std::unique_ptr<data_model::Index> Geo::ToProto() const {
+  auto index_proto = std::make_unique<data_model::Index>();
+  auto geo_index = std::make_unique<data_model::GeoIndex>();
+  index_proto->set_allocated_geo_index(geo_index.release());
+  return index_proto;
+}
+
+uint32_t Geo::GetMutationWeight() const {
+  return options::GetMutationWeightGeo().GetValue();
+}
+
+const utils::GeoPoint* Geo::GetValue(const InternedStringPtr& key) const {
+  // Like Numeric::GetValue, the index is not mutated while the time sliced
+  // mutex is in read mode, so it is safe to skip lock acquiring.
+  if (auto it = tracked_keys_.find(key); it != tracked_keys_.end()) {
+    return &it->second.point;
+  }
+  return nullptr;
+}
+
+std::unique_ptr<Geo::EntriesFetcher> Geo::Search(
+    const query::GeoPredicate& predicate, bool negate) const {
+  if (negate) {
+    return std::make_unique<Geo::EntriesFetcher>(
+        tree_, predicate, tree_.Size() + untracked_keys_.size(), true,
+        &untracked_keys_);
+  }
+  size_t size = 0;
+  for (const auto& [start, end] : predicate.GetHashRanges()) {
+    size += tree_.Count(start, end, true, false);
+  }
+  return std::make_unique<Geo::EntriesFetcher>(tree_, predicate, size, false);
+}
+
+Geo::EntriesFetcherIterator::EntriesFetcherIterator(
+    const TreeType& tree, const query::GeoPredicate& predicate, bool negate,
+    const InternedStringSet* untracked_keys)
+    : tree_(tree),
+      predicate_(predicate),
+      negate_(negate),
+      ranges_(negate ? kAllHashes : predicate.GetHashRanges()),
+      untracked_keys_(untracked_keys) {
+  if (untracked_keys_) {
+    untracked_keys_iter_ = untracked_keys_->begin();
+  }
+  if (!ranges_.empty()) {
+    entries_iter_ = tree_.LowerBound(ranges_[0].first);
+    entries_end_ = tree_.LowerBound(ranges_[0].second);
+  }
+  SkipToMatch();
+}
+
+void Geo::EntriesFetcherIterator::SkipToMatch() {
+  while (range_index_ < ranges_.size()) {
+    for (; entries_iter_ != entries_end_; ++entries_iter_) {
+      if (predicate_.Contains(entries_iter_->value.point) != negate_) {
+        return;
+      }
+    }
+    if (++range_index_ < ranges_.size()) {
+      entries_iter_ = tree_.LowerBound(ranges_[range_index_].first);
+      entries_end_ = tree_.LowerBound(ranges_[range_index_].second);
+    }
+  }
+}
+
+bool Geo::EntriesFetcherIterator::Done() const {
+  return range_index_ >= ranges_.size() &&
+         (untracked_keys_ == nullptr ||
+          untracked_keys_iter_ == untracked_keys_->end());
+}
+
+void Geo::EntriesFetcherIterator::Next() {
+  if (range_index_ < ranges_.size()) {
+    ++entries_iter_;
+    SkipToMatch();
+    return;
+  }
+  if (untracked_keys_ && untracked_keys_iter_ != untracked_keys_->end()) {
+    ++untracked_keys_iter_;
+  }
+}
+
+const InternedStringPtr& Geo::EntriesFetcherIterator::operator*() const {
+  if (range_index_ < ranges_.size()) {
+    return entries_iter_->value.key;
+  }
+  DCHECK(untracked_keys_ && untracked_keys_iter_ != untracked_keys_->end());
+  return *untracked_keys_iter_;
+}
+
+size_t Geo::EntriesFetcher::Size() const { return size_; }
+
+std::unique_ptr<EntriesFetcherIteratorBase> Geo::EntriesFetcher::Begin() {
+  return std::make_unique<EntriesFetcherIterator>(tree_, predicate_, negate_,
+                                                  untracked_keys_);
+}
+
+size_t Geo::GetTrackedKeyCount() const {
+  absl::MutexLock lock(&index_mutex_);
+  return tracked_keys_.size();
+}
+
+size_t Geo::GetUnTrackedKeyCount() const {
+  absl::MutexLock lock(&index_mutex_);
+  return untracked_keys_.size();
+}
+
+bool Geo::IsTracked(const InternedStringPtr& key) const {
+  absl::MutexLock lock(&index_mutex_);
+  return tracked_keys_.contains(key);
+}
+
+bool Geo::IsUnTracked(const InternedStringPtr& key) const {
+  absl::MutexLock lock(&index_mutex_);
+  return untracked_keys_.contains(key);
+}
+
+void Geo::UnTrack(const InternedStringPtr& key) {
+  absl::MutexLock lock(&index_mutex_);
+  CHECK(!tracked_keys_.contains(key));
+  untracked_keys_.insert(key);
+}
+
+absl::Status Geo::ForEachTrackedKey(
+    absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn) const {
+  absl::MutexLock lock(&index_mutex_);
+  for (const auto& [key, _] : tracked_keys_) {
+    VMSDK_RETURN_IF_ERROR(fn(key));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Geo::ForEachUnTrackedKey(
+    absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn) const {
+  absl::MutexLock lock(&index_mutex_);
+  for (const auto& key : untracked_keys_) {
+    VMSDK_RETURN_IF_ERROR(fn(key));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace valkey_search::indexes
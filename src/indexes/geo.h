@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_INDEXES_GEO_H_
+#define VALKEYSEARCH_SRC_INDEXES_GEO_H_
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/index_schema.pb.h"
+#include "src/indexes/index_base.h"
+#include "src/query/predicate.h"
+#include "src/rdb_serialization.h"
+#include "src/utils/counted_btree.h"
+#include "src/utils/geohash.h"
+#include "src/utils/string_interning.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search::indexes {
+
+//
+// Indexes longitude,latitude points in a counted B+tree ordered by their 52-bit
+// geohash. Any geohash cell is a contiguous run of the tree, so a radius or
+// polygon query walks the few cells that cover the shape's bounding box and
+// checks each candidate exactly.
+//
+class Geo : public IndexBase {
+ public:
+  explicit Geo(const data_model::GeoIndex& geo_index_proto);
+  absl::StatusOr<bool> AddRecord(const InternedStringPtr& key,
+                                 absl::string_view data) override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  absl::StatusOr<bool> RemoveRecord(
+      const InternedStringPtr& key,
+      DeletionType deletion_type = DeletionType::kNone) override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  absl::StatusOr<bool> ModifyRecord(const InternedStringPtr& key,
+                                    absl::string_view data) override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  int RespondWithInfo(ValkeyModuleCtx* ctx) const override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  absl::Status SaveIndex(RDBChunkOutputStream chunked_out) const override {
+    return absl::OkStatus();
+  }
+
+  size_t GetTrackedKeyCount() const override ABSL_LOCKS_EXCLUDED(index_mutex_);
+  size_t GetUnTrackedKeyCount() const override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  bool IsTracked(const InternedStringPtr& key) const override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  bool IsUnTracked(const InternedStringPtr& key) const override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  void UnTrack(const InternedStringPtr& key) override
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+
+  absl::Status ForEachTrackedKey(
+      absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn)
+      const override ABSL_LOCKS_EXCLUDED(index_mutex_);
+  absl::Status ForEachUnTrackedKey(
+      absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn)
+      const override ABSL_LOCKS_EXCLUDED(index_mutex_);
+
+  std::unique_ptr<data_model::Index> ToProto() const override;
+
+  uint32_t GetMutationWeight() const override;
+
+  const utils::GeoPoint* GetValue(const InternedStringPtr& key) const
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
+  struct Entry {
+    InternedStringPtr key;
+    utils::GeoPoint point;
+  };
+  struct EntryKeyAddress {
+    const InternedString* operator()(const Entry& entry) const {
+      return &*entry.key;
+    }
+  };
+  using TreeType = utils::CountedBTree<uint64_t, Entry, EntryKeyAddress>;
+
+  class EntriesFetcherIterator : public EntriesFetcherIteratorBase {
+   public:
+    EntriesFetcherIterator(const TreeType& tree,
+                           const query::GeoPredicate& predicate, bool negate,
+                           const InternedStringSet* untracked_keys);
+    bool Done() const override;
+    void Next() override;
+    const InternedStringPtr& operator*() const override;
+
+   private:
+    // Moves forward to the first matching entry at or after the current
+    // position, opening the following hash ranges as needed.
+    void SkipToMatch();
+    const TreeType& tree_;
+    const query::GeoPredicate& predicate_;
+    bool negate_;
+    const std::vector<utils::GeoHashRange>& ranges_;
+    size_t range_index_{0};
+    TreeType::ConstIterator entries_iter_;
+    TreeType::ConstIterator entries_end_;
+    const InternedStringSet* untracked_keys_;
+    InternedStringSet::const_iterator untracked_keys_iter_;
+  };
+
+  class EntriesFetcher : public EntriesFetcherBase {
+   public:
+    EntriesFetcher(const TreeType& tree, const query::GeoPredicate& predicate,
+                   size_t size, bool negate,
+                   const InternedStringSet* untracked_keys = nullptr)
+        : tree_(tree),
+          predicate_(predicate),
+          size_(size),
+          negate_(negate),
+          untracked_keys_(untracked_keys) {}
+    size_t Size() const override;
+    std::unique_ptr<EntriesFetcherIteratorBase> Begin() override;
+
+   private:
+    const TreeType& tree_;
+    const query::GeoPredicate& predicate_;
+    size_t size_{0};
+    bool negate_;
+    const InternedStringSet* untracked_keys_;
+  };
+
+  // The returned size is an upper bound: it counts every point in the hash
+  // ranges covering the shape.
+  virtual std::unique_ptr<EntriesFetcher> Search(
+      const query::GeoPredicate& predicate,
+      bool negate) const ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
+ private:
+  struct TrackedPoint {
+    utils::GeoPoint point;
+    uint64_t hash;
+  };
+  mutable absl::Mutex index_mutex_;
+  InternedStringHashMap<TrackedPoint> tracked_keys_
+      ABSL_GUARDED_BY(index_mutex_);
+  // untracked keys is needed to support negate filtering
+  InternedStringSet untracked_keys_ ABSL_GUARDED_BY(index_mutex_);
+  TreeType tree_ ABSL_GUARDED_BY(index_mutex_);
+};
+}  // namespace valkey_search::indexes
+
+#endif  // VALKEYSEARCH_SRC_INDEXES_GEO_H_
@@ -8,15 +8,18 @@
 #ifndef VALKEYSEARCH_SRC_INDEXES_INDEX_BASE_H
 #define VALKEYSEARCH_SRC_INDEXES_INDEX_BASE_H
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 
 #include "absl/base/no_destructor.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "src/index_schema.pb.h"
 #include "src/rdb_serialization.h"
 #include "src/utils/string_interning.h"
@@ -24,7 +27,16 @@
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
 namespace valkey_search::indexes {
-enum class IndexerType { kHNSW, kFlat, kNumeric, kTag, kVector, kNone, kText };
+enum class IndexerType {
+  kHNSW,
+  kFlat,
+  kNumeric,
+  kTag,
+  kVector,
+  kNone,
+  kText,
+  kGeo
+};
 
 enum class DeletionType {
   kRecord,      // The record was deleted from the index.
@@ -36,7 +48,29 @@ const absl::NoDestructor<absl::flat_hash_map<absl::string_view, IndexerType>>
     kIndexerTypeByStr({{"VECTOR", IndexerType::kVector},
                        {"TAG", IndexerType::kTag},
                        {"NUMERIC", IndexerType::kNumeric},
-                       {"TEXT", IndexerType::kText}});
+                       {"TEXT", IndexerType::kText},
+                       {"GEO", IndexerType::kGeo}});
+
+// The time budget of one increment of index defragmentation and the means to
+// move heap allocations.
+class DefragContext {
+ public:
+  DefragContext(absl::FunctionRef<bool()> should_stop,
+                absl::FunctionRef<void*(void*)> move)
+      : should_stop_(should_stop), move_(move) {}
+  // Whether the budget of this increment is spent.
+  bool ShouldStop() const { return should_stop_(); }
+  // Moves a heap allocation if the allocator considers it worth moving.
+  // Returns the new address, or nullptr if the allocation stayed in place.
+  void* Move(void* ptr) const { return move_(ptr); }
+
+ private:
+  absl::FunctionRef<bool()> should_stop_;
+  absl::FunctionRef<void*(void*)> move_;
+};
+
+// Weight of a new sample in the moving average of mutation costs.
+constexpr double kMutationCostSmoothing = 1.0 / 16;
 
 class IndexBase {
  public:
@@ -76,8 +110,41 @@ class IndexBase {
   /// Returns the mutation weight for this index type
   virtual uint32_t GetMutationWeight() const = 0;
 
+  // Feeds a sampled mutation of `bytes` input bytes into the measured cost of
+  // mutating this index.
+  void RecordMutationCost(absl::Duration elapsed, size_t bytes) {
+    if (bytes == 0) {
+      return;
+    }
+    const double sample = absl::ToDoubleNanoseconds(elapsed) / bytes;
+    double cost = mutation_cost_.load(std::memory_order_relaxed);
+    double updated;
+    do {
+      updated =
+          cost == 0 ? sample : cost + (sample - cost) * kMutationCostSmoothing;
+    } while (!mutation_cost_.compare_exchange_weak(cost, updated,
+                                                   std::memory_order_relaxed));
+  }
+  // Exponentially weighted moving average of the sampled mutation costs, in
+  // nanoseconds per input byte. Zero until a mutation was sampled.
+  double GetMutationCost() const {
+    return mutation_cost_.load(std::memory_order_relaxed);
+  }
+
+  // Incremental defragmentation, driven by IndexSchema::Defrag.
+  //
+  // Defrag moves allocations in place of their owners and is called while no
+  // query reads the index. It resumes the pass over the index from cursor and
+  // returns whether the pass is complete, otherwise cursor is where to resume.
+  virtual bool Defrag(DefragContext& ctx, uint64_t& cursor) { return true; }
+  // CompactMemory moves data that queries read, and is also called while no
+  // query reads the index. It resumes where the previous call stopped and
+  // returns whether it is complete. The old copies are freed before it returns.
+  virtual bool CompactMemory(DefragContext& ctx) { return true; }
+
  private:
   IndexerType indexer_type_{IndexerType::kNone};
+  std::atomic<double> mutation_cost_{0};
 };
 
 class EntriesFetcherIteratorBase {
@@ -131,10 +131,19 @@ const double* Numeric::GetValue(const InternedStringPtr& key) const {
   return nullptr;
 }
 
+std::optional<double> Numeric::GetValueLocked(
+    const InternedStringPtr& key) const {
+  absl::MutexLock lock(&index_mutex_);
+  if (auto it = tracked_keys_.find(key); it != tracked_keys_.end()) {
+    return it->second;
+  }
+  return std::nullopt;
+}
+
 std::unique_ptr<Numeric::EntriesFetcher> Numeric::Search(
     const query::NumericPredicate& predicate, bool negate) const {
   EntriesRange entries_range;
-  const auto& btree = index_->GetBtree();
+  const auto& tree = index_->GetTree();
   if (negate) {
     auto size =
         index_->GetCount(std::numeric_limits<double>::lowest(),
@@ -142,51 +151,32 @@ std::unique_ptr<Numeric::EntriesFetcher> Numeric::Search(
                          !predicate.IsStartInclusive()) +
         index_->GetCount(predicate.GetEnd(), std::numeric_limits<double>::max(),
                          !predicate.IsEndInclusive(), true);
-    entries_range.first = btree.begin();
+    entries_range.first = tree.begin();
     entries_range.second = predicate.IsStartInclusive()
-                               ? btree.lower_bound(predicate.GetStart())
-                               : btree.upper_bound(predicate.GetStart());
+                               ? tree.LowerBound(predicate.GetStart())
+                               : tree.UpperBound(predicate.GetStart());
     EntriesRange additional_entries_range;
     additional_entries_range.first =
-        predicate.IsEndInclusive() ? btree.upper_bound(predicate.GetEnd())
-                                   : btree.lower_bound(predicate.GetEnd());
-    ;
-    additional_entries_range.second = btree.end();
+        predicate.IsEndInclusive() ? tree.UpperBound(predicate.GetEnd())
+                                   : tree.LowerBound(predicate.GetEnd());
+    additional_entries_range.second = tree.end();
     return std::make_unique<Numeric::EntriesFetcher>(
         entries_range, size + untracked_keys_.size(), additional_entries_range,
         &untracked_keys_);
   }
 
   entries_range.first = predicate.IsStartInclusive()
-                            ? btree.lower_bound(predicate.GetStart())
-                            : btree.upper_bound(predicate.GetStart());
+                            ? tree.LowerBound(predicate.GetStart())
+                            : tree.UpperBound(predicate.GetStart());
   entries_range.second = predicate.IsEndInclusive()
-                             ? btree.upper_bound(predicate.GetEnd())
-                             : btree.lower_bound(predicate.GetEnd());
+                             ? tree.UpperBound(predicate.GetEnd())
+                             : tree.LowerBound(predicate.GetEnd());
   size_t size = index_->GetCount(predicate.GetStart(), predicate.GetEnd(),
                                  predicate.IsStartInclusive(),
                                  predicate.IsEndInclusive());
   return std::make_unique<Numeric::EntriesFetcher>(entries_range, size);
 }
 
-bool Numeric::EntriesFetcherIterator::NextKeys(
-    const Numeric::EntriesRange& range, BTreeNumericIndex::ConstIterator& iter,
-    std::optional<InternedStringSet::const_iterator>& keys_iter) {
-  while (iter != range.second) {
-    if (!keys_iter.has_value()) {
-      keys_iter = iter->second.begin();
-    } else {
-      ++keys_iter.value();
-    }
-    if (keys_iter.value() != iter->second.end()) {
-      return true;
-    }
-    ++iter;
-    keys_iter = std::nullopt;
-  }
-  return false;
-}
-
 Numeric::EntriesFetcherIterator::EntriesFetcherIterator(
     const EntriesRange& entries_range,
     const std::optional<EntriesRange>& additional_entries_range,
@@ -198,6 +188,9 @@ Numeric::EntriesFetcherIterator::EntriesFetcherIterator(
   if (additional_entries_range_.has_value()) {
     additional_entries_iter_ = additional_entries_range_.value().first;
   }
+  if (untracked_keys_) {
+    untracked_keys_iter_ = untracked_keys_->begin();
+  }
 }
 
 bool Numeric::EntriesFetcherIterator::Done() const {
@@ -206,51 +199,41 @@ bool Numeric::EntriesFetcherIterator::Done() const {
           additional_entries_iter_ ==
               additional_entries_range_.value().second) &&
          (untracked_keys_ == nullptr ||
-          (untracked_keys_iter_.has_value() &&
-           untracked_keys_iter_ == untracked_keys_->end()));
+          untracked_keys_iter_ == untracked_keys_->end());
 }
 
 void Numeric::EntriesFetcherIterator::Next() {
-  if (NextKeys(entries_range_, entries_iter_, entry_keys_iter_)) {
+  if (entries_iter_ != entries_range_.second) {
+    ++entries_iter_;
     return;
   }
   if (additional_entries_range_.has_value() &&
-      NextKeys(additional_entries_range_.value(), additional_entries_iter_,
-               additional_entry_keys_iter_)) {
+      additional_entries_iter_ != additional_entries_range_.value().second) {
+    ++additional_entries_iter_;
     return;
   }
-  if (untracked_keys_) {
-    if (untracked_keys_iter_.has_value()) {
-      ++untracked_keys_iter_.value();
-    } else {
-      untracked_keys_iter_ = untracked_keys_->begin();
-    }
+  if (untracked_keys_ && untracked_keys_iter_ != untracked_keys_->end()) {
+    ++untracked_keys_iter_;
   }
 }
 
 const InternedStringPtr& Numeric::EntriesFetcherIterator::operator*() const {
   if (entries_iter_ != entries_range_.second) {
-    DCHECK(entry_keys_iter_ != entries_iter_->second.end());
-    return *entry_keys_iter_.value();
+    return entries_iter_->value;
   }
   if (additional_entries_range_.has_value() &&
       additional_entries_iter_ != additional_entries_range_.value().second) {
-    DCHECK(additional_entry_keys_iter_ !=
-           additional_entries_iter_->second.end());
-    return *additional_entry_keys_iter_.value();
+    return additional_entries_iter_->value;
   }
-  DCHECK(untracked_keys_ && untracked_keys_iter_.has_value() &&
-         untracked_keys_iter_ != untracked_keys_->end());
-  return *untracked_keys_iter_.value();
+  DCHECK(untracked_keys_ && untracked_keys_iter_ != untracked_keys_->end());
+  return *untracked_keys_iter_;
 }
 
 size_t Numeric::EntriesFetcher::Size() const { return size_; }
 
 std::unique_ptr<EntriesFetcherIteratorBase> Numeric::EntriesFetcher::Begin() {
-  auto itr = std::make_unique<EntriesFetcherIterator>(
+  return std::make_unique<EntriesFetcherIterator>(
       entries_range_, additional_entries_range_, untracked_keys_);
-  itr->Next();
-  return itr;
 }
 
 size_t Numeric::GetTrackedKeyCount() const {
@@ -14,7 +14,6 @@
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
-#include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/hash/hash.h"
@@ -26,56 +25,40 @@
 #include "src/indexes/index_base.h"
 #include "src/query/predicate.h"
 #include "src/rdb_serialization.h"
-#include "src/utils/segment_tree.h"
+#include "src/utils/counted_btree.h"
 #include "src/utils/string_interning.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
 namespace valkey_search::indexes {
 
-template <typename T, typename Hasher = absl::Hash<T>,
-          typename Equalizer = std::equal_to<T>>
+template <typename T, typename TOrdinal = std::identity>
 class BTreeNumeric {
  public:
-  using SetType = absl::flat_hash_set<T, Hasher, Equalizer>;
-  using ConstIterator =
-      typename absl::btree_map<double, SetType>::const_iterator;
+  using TreeType = utils::CountedBTree<double, T, TOrdinal>;
+  using ConstIterator = typename TreeType::ConstIterator;
 
-  void Add(const T& value, double key) {
-    btree_[key].insert(value);
-    segment_tree_.Add(key);
-  }
+  void Add(const T& value, double key) { tree_.Insert(key, value); }
 
   void Modify(const T& value, double old_key, double new_key) {
     Remove(value, old_key);
     Add(value, new_key);
   }
 
-  void Remove(const T& value, double key) {
-    btree_[key].erase(value);
-    if (btree_[key].empty()) {
-      btree_.erase(key);
-    }
-    segment_tree_.Remove(key);
-  }
-  const absl::btree_map<double, SetType>& GetBtree() const { return btree_; }
+  void Remove(const T& value, double key) { tree_.Erase(key, value); }
+
+  const TreeType& GetTree() const { return tree_; }
 
   size_t GetCount(double start, double end, bool start_inclusive,
-                  bool end_inclusive) {
-    return segment_tree_.Count(start, end, start_inclusive, end_inclusive);
+                  bool end_inclusive) const {
+    return tree_.Count(start, end, start_inclusive, end_inclusive);
   }
 
  private:
-  // Right now we have both BTree and Segment Tree. The BTree is used to
-  // maintain the keys and the values. The segment tree is used to maintain the
-  // count of the keys in the range.
-  //
-  // Note on overhead: SegmentTree is roughly 80 bytes per entry (40 B per node,
-  // 2x nodes per entries with a balanced tree).
-  //
-  // TODO: Consider using a single data structure to maintain both
-  // the keys and the count.
-  absl::btree_map<double, SetType> btree_;
-  utils::SegmentTree segment_tree_;
+  // A single counted B+tree of (value, key) pairs serves both range
+  // iteration and range counting. Each entry costs the value plus the key
+  // pointer in a leaf array, instead of a hash set per distinct value plus a
+  // segment tree node per entry.
+  TreeType tree_;
 };
 
 class Numeric : public IndexBase {
@@ -120,7 +103,11 @@ class Numeric : public IndexBase {
 
   const double* GetValue(const InternedStringPtr& key) const
       ABSL_NO_THREAD_SAFETY_ANALYSIS;
-  using BTreeNumericIndex = BTreeNumeric<InternedStringPtr>;
+  // Same as GetValue, but safe to call while other mutations are in flight.
+  std::optional<double> GetValueLocked(const InternedStringPtr& key) const
+      ABSL_LOCKS_EXCLUDED(index_mutex_);
+  using BTreeNumericIndex =
+      BTreeNumeric<InternedStringPtr, InternedStringAddress>;
   using EntriesRange = std::pair<BTreeNumericIndex::ConstIterator,
                                  BTreeNumericIndex::ConstIterator>;
   class EntriesFetcherIterator : public EntriesFetcherIteratorBase {
@@ -134,19 +121,12 @@ class Numeric : public IndexBase {
     const InternedStringPtr& operator*() const override;
 
    private:
-    static bool NextKeys(
-        const Numeric::EntriesRange& range,
-        BTreeNumericIndex::ConstIterator& iter,
-        std::optional<InternedStringSet::const_iterator>& keys_iter);
     const EntriesRange& entries_range_;
     BTreeNumericIndex::ConstIterator entries_iter_;
-    std::optional<InternedStringSet::const_iterator> entry_keys_iter_;
     const std::optional<EntriesRange>& additional_entries_range_;
     BTreeNumericIndex::ConstIterator additional_entries_iter_;
-    std::optional<InternedStringSet::const_iterator>
-        additional_entry_keys_iter_;
     const InternedStringSet* untracked_keys_;
-    std::optional<InternedStringSet::const_iterator> untracked_keys_iter_;
+    InternedStringSet::const_iterator untracked_keys_iter_;
   };
 
   class EntriesFetcher : public EntriesFetcherBase {
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/indexes/numeric_column.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace valkey_search::indexes {
+
+NumericRange::NumericRange(double start, bool start_inclusive, double end,
+                           bool end_inclusive)
+    : min(start_inclusive
+              ? start
+              : std::nextafter(start, std::numeric_limits<double>::infinity())),
+      max(end_inclusive
+              ? end
+              : std::nextafter(end, -std::numeric_limits<double>::infinity())) {
+}
+
+void NumericColumn::Set(uint64_t id, double value) {
+  const uint64_t page_index = id / kIdsPerPage;
+  if (page_index >= pages_.size()) {
+    pages_.resize(page_index + 1);
+  }
+  auto& page = pages_[page_index];
+  if (!page) {
+    page = std::make_unique<Page>();
+    ++allocated_pages_;
+  }
+  const size_t offset = id % kIdsPerPage;
+  uint64_t& word = page->present[offset / kBitsPerWord];
+  const uint64_t bit = uint64_t{1} << (offset % kBitsPerWord);
+  if (!(word & bit)) {
+    word |= bit;
+    ++page->present_count;
+  }
+  page->values[offset] = value;
+}
+
+void NumericColumn::Clear(uint64_t id) {
+  const uint64_t page_index = id / kIdsPerPage;
+  if (page_index >= pages_.size() || !pages_[page_index]) {
+    return;
+  }
+  auto& page = pages_[page_index];
+  const size_t offset = id % kIdsPerPage;
+  uint64_t& word = page->present[offset / kBitsPerWord];
+  const uint64_t bit = uint64_t{1} << (offset % kBitsPerWord);
+  if (!(word & bit)) {
+    return;
+  }
+  word &= ~bit;
+  if (--page->present_count > 0) {
+    return;
+  }
+  page.reset();
+  --allocated_pages_;
+  // Trim the dead tail so that Size() follows the highest live id.
+  while (!pages_.empty() && !pages_.back()) {
+    pages_.pop_back();
+  }
+}
+
+void NumericColumn::FilterInto(const NumericRange& range,
+                               std::vector<uint64_t>& bitmap) const {
+  const size_t words = std::min(bitmap.size(), pages_.size() * kWordsPerPage);
+  const double min = range.min;
+  const double max = range.max;
+  for (size_t word = 0; word < words; ++word) {
+    const Page* page = pages_[word / kWordsPerPage].get();
+    if (page == nullptr) {
+      bitmap[word] = 0;
+      continue;
+    }
+    const size_t page_word = word % kWordsPerPage;
+    const double* values = page->values + page_word * kBitsPerWord;
+    uint64_t mask = 0;
+    for (size_t bit = 0; bit < kBitsPerWord; ++bit) {
+      mask |= static_cast<uint64_t>((values[bit] >= min) & (values[bit] <= max))
+              << bit;
+    }
+    bitmap[word] &= mask & page->present[page_word];
+  }
+  std::fill(bitmap.begin() + words, bitmap.end(), 0);
+}
+
+}  // namespace valkey_search::indexes
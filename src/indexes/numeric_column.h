@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_INDEXES_NUMERIC_COLUMN_H_
+#define VALKEYSEARCH_SRC_INDEXES_NUMERIC_COLUMN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace valkey_search::indexes {
+
+//
+// An inclusive [min, max] range over doubles. Exclusive bounds are converted
+// to the adjacent representable value so a range check is two comparisons.
+//
+struct NumericRange {
+  NumericRange(double start, bool start_inclusive, double end,
+               bool end_inclusive);
+  bool Contains(double value) const { return value >= min && value <= max; }
+  double min;
+  double max;
+};
+
+//
+// A column of numeric values indexed by a vector index internal id, with a
+// presence bitmap for ids that have no value. It lets numeric filters be
+// evaluated for a vector candidate with a single array access instead of
+// looking up the key and then the key's value in the Numeric index.
+//
+// Values are stored in fixed-size pages of ids. Internal ids are never reused,
+// so a page is freed once none of its ids has a value, which keeps the column
+// proportional to the live keys rather than to every id ever issued.
+//
+// Not thread safe. Mutations must be serialized by the caller, and reads must
+// not run concurrently with mutations.
+//
+class NumericColumn {
+ public:
+  static constexpr size_t kBitsPerWord = 64;
+  static constexpr size_t kIdsPerPage = 1024;
+
+  void Set(uint64_t id, double value);
+  void Clear(uint64_t id);
+  bool Contains(uint64_t id, const NumericRange& range) const {
+    const Page* page = GetPage(id);
+    if (page == nullptr) {
+      return false;
+    }
+    const size_t offset = id % kIdsPerPage;
+    const uint64_t word = page->present[offset / kBitsPerWord];
+    return (word >> (offset % kBitsPerWord) & 1) &&
+           range.Contains(page->values[offset]);
+  }
+  // Number of ids covered by the column, always a multiple of kBitsPerWord.
+  size_t Size() const { return pages_.size() * kIdsPerPage; }
+  // Bytes held by the pages and the page directory.
+  size_t GetAllocatedBytes() const {
+    return allocated_pages_ * sizeof(Page) +
+           pages_.capacity() * sizeof(pages_[0]);
+  }
+
+  //
+  // ANDs the range predicate into a bitmap of ids, one bit per id. Bits for
+  // ids without a page or past the end of the column are cleared. The loop is
+  // branch free over contiguous values so that the compiler turns it into
+  // vector compares and mask extraction.
+  //
+  void FilterInto(const NumericRange& range,
+                  std::vector<uint64_t>& bitmap) const;
+
+ private:
+  static constexpr size_t kWordsPerPage = kIdsPerPage / kBitsPerWord;
+  struct Page {
+    double values[kIdsPerPage]{};
+    uint64_t present[kWordsPerPage]{};
+    size_t present_count{0};
+  };
+  const Page* GetPage(uint64_t id) const {
+    const uint64_t page = id / kIdsPerPage;
+    return page < pages_.size() ? pages_[page].get() : nullptr;
+  }
+  std::vector<std::unique_ptr<Page>> pages_;
+  size_t allocated_pages_{0};
+};
+
+}  // namespace valkey_search::indexes
+
+#endif  // VALKEYSEARCH_SRC_INDEXES_NUMERIC_COLUMN_H_
@@ -13,10 +13,13 @@
 #include <string>
 #include <utility>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
@@ -35,11 +38,149 @@ static bool IsValidPrefix(absl::string_view str) {
          str[str.length() - 2] != '*';
 }
 
+constexpr size_t kTrigramLength = 3;
+
 Tag::Tag(const data_model::TagIndex& tag_index_proto)
     : IndexBase(IndexerType::kTag),
       separator_(tag_index_proto.separator()[0]),
       case_sensitive_(tag_index_proto.case_sensitive()),
-      tree_(case_sensitive_) {}
+      tree_(case_sensitive_),
+      wildcard_index_(tag_index_proto.with_suffix_trie()
+                          ? std::make_unique<WildcardIndex>(case_sensitive_)
+                          : nullptr) {}
+
+std::string Tag::NormalizeTag(absl::string_view tag) const {
+  return case_sensitive_ ? std::string(tag) : absl::AsciiStrToLower(tag);
+}
+
+void Tag::AddToWildcardIndex(absl::string_view tag) {
+  auto normalized = NormalizeTag(tag);
+  auto interned_tag = StringInternStore::Intern(normalized);
+  std::string reversed(normalized.rbegin(), normalized.rend());
+  wildcard_index_->reversed_tags.AddKeyValue(reversed, interned_tag);
+  for (size_t i = 0; i + kTrigramLength <= normalized.size(); ++i) {
+    wildcard_index_->trigrams[normalized.substr(i, kTrigramLength)].insert(
+        interned_tag);
+  }
+}
+
+void Tag::RemoveFromWildcardIndex(absl::string_view tag) {
+  auto normalized = NormalizeTag(tag);
+  auto interned_tag = StringInternStore::Intern(normalized);
+  std::string reversed(normalized.rbegin(), normalized.rend());
+  wildcard_index_->reversed_tags.Remove(reversed, interned_tag);
+  for (size_t i = 0; i + kTrigramLength <= normalized.size(); ++i) {
+    auto it =
+        wildcard_index_->trigrams.find(normalized.substr(i, kTrigramLength));
+    if (it == wildcard_index_->trigrams.end()) {
+      continue;
+    }
+    it->second.erase(interned_tag);
+    if (it->second.empty()) {
+      wildcard_index_->trigrams.erase(it);
+    }
+  }
+}
+
+void Tag::AddTag(absl::string_view tag, const InternedStringPtr& key) {
+  tree_.AddKeyValue(tag, key);
+  // Only the first key carrying a tag value adds it to the wildcard index.
+  if (wildcard_index_ && tree_.GetQualifiedElementsCount(tag, true) == 1) {
+    AddToWildcardIndex(tag);
+  }
+}
+
+void Tag::RemoveTag(absl::string_view tag, const InternedStringPtr& key) {
+  if (tree_.Remove(tag, key) && wildcard_index_ && !tree_.HasKey(tag)) {
+    RemoveFromWildcardIndex(tag);
+  }
+}
+
+bool Tag::IsWildcardPattern(absl::string_view tag) {
+  auto pos = tag.find('*');
+  return pos != absl::string_view::npos && pos + 1 != tag.size();
+}
+
+bool Tag::MatchTagPattern(absl::string_view tag, absl::string_view pattern,
+                          bool case_sensitive) {
+  auto equals = [case_sensitive](char a, char b) {
+    return case_sensitive ? a == b
+                          : absl::ascii_tolower(a) == absl::ascii_tolower(b);
+  };
+  size_t t = 0;
+  size_t p = 0;
+  // Position after the last `*` seen and the tag position it was tried at.
+  size_t star = absl::string_view::npos;
+  size_t star_t = 0;
+  while (t < tag.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      star = ++p;
+      star_t = t;
+    } else if (p < pattern.size() && equals(pattern[p], tag[t])) {
+      ++p;
+      ++t;
+    } else if (star != absl::string_view::npos) {
+      p = star;
+      t = ++star_t;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+void Tag::ForEachWildcardMatch(
+    absl::string_view pattern,
+    absl::FunctionRef<void(absl::string_view)> fn) const {
+  auto normalized = NormalizeTag(pattern);
+  absl::string_view literal = absl::string_view(normalized).substr(1);
+  if (normalized.front() == '*' &&
+      literal.find('*') == absl::string_view::npos) {
+    // Suffix pattern: a prefix walk of the reversed tags, no verification
+    // needed.
+    std::string reversed(literal.rbegin(), literal.rend());
+    for (auto it = wildcard_index_->reversed_tags.PrefixMatcher(reversed);
+         !it.Done(); it.Next()) {
+      for (const auto& tag : *it.Value()->value) {
+        fn(tag->Str());
+      }
+    }
+    return;
+  }
+  // Pick the rarest trigram of the literal parts of the pattern. Without any
+  // trigram, every distinct tag is a candidate.
+  const InternedStringSet* candidates = nullptr;
+  for (absl::string_view part : absl::StrSplit(normalized, '*')) {
+    for (size_t i = 0; i + kTrigramLength <= part.size(); ++i) {
+      auto it = wildcard_index_->trigrams.find(part.substr(i, kTrigramLength));
+      if (it == wildcard_index_->trigrams.end()) {
+        return;
+      }
+      if (candidates == nullptr || it->second.size() < candidates->size()) {
+        candidates = &it->second;
+      }
+    }
+  }
+  if (candidates != nullptr) {
+    for (const auto& tag : *candidates) {
+      if (MatchTagPattern(tag->Str(), normalized, true)) {
+        fn(tag->Str());
+      }
+    }
+    return;
+  }
+  for (auto it = wildcard_index_->reversed_tags.RootIterator(); !it.Done();
+       it.Next()) {
+    for (const auto& tag : *it.Value()->value) {
+      if (MatchTagPattern(tag->Str(), normalized, true)) {
+        fn(tag->Str());
+      }
+    }
+  }
+}
 
 absl::StatusOr<bool> Tag::AddRecord(const InternedStringPtr& key,
                                     absl::string_view data) {
@@ -59,7 +200,7 @@ absl::StatusOr<bool> Tag::AddRecord(const InternedStringPtr& key,
   }
   untracked_keys_.erase(key);
   for (const auto& tag : parsed_tags) {
-    tree_.AddKeyValue(tag, key);
+    AddTag(tag, key);
   }
   return true;
 }
@@ -88,7 +229,20 @@ absl::StatusOr<absl::flat_hash_set<absl::string_view>> Tag::ParseSearchTags(
     if (tag.empty()) {
       return absl::OkStatus();  // Empty tags are silently ignored
     }
-    if (tag.back() == '*') {
+    if (IsWildcardPattern(tag)) {
+      if (absl::StrContains(tag, "**")) {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Tag string `", tag, "` contains multiple *."));
+      }
+      const auto min_prefix_length =
+          options::GetTagMinPrefixLength().GetValue();
+      // Like prefixes, patterns need enough literal characters.
+      if (tag.length() - absl::c_count(tag, '*') < min_prefix_length) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Tag string `", tag, "` is too short for wildcard."));
+      }
+      parsed_tags.insert(tag);
+    } else if (tag.back() == '*') {
       if (!IsValidPrefix(tag)) {
         return absl::InvalidArgumentError(
             absl::StrCat("Tag string `", tag, "` ends with multiple *."));
@@ -165,14 +319,14 @@ absl::StatusOr<bool> Tag::ModifyRecord(const InternedStringPtr& key,
   // insert new tags that are not present in the old tags.
   for (const auto& tag : new_parsed_tags) {
     if (!tag_info.tags.contains(tag)) {
-      tree_.AddKeyValue(tag, key);
+      AddTag(tag, key);
     }
   }
 
   // remove old tags that are not present in the new tags.
   for (const auto& tag : tag_info.tags) {
     if (!new_parsed_tags.contains(tag)) {
-      tree_.Remove(tag, key);
+      RemoveTag(tag, key);
     }
   }
 
@@ -197,7 +351,7 @@ absl::StatusOr<bool> Tag::RemoveRecord(const InternedStringPtr& key,
   }
   auto& tag_info = it->second;
   for (const auto& tag : tag_info.tags) {
-    tree_.Remove(tag, key);
+    RemoveTag(tag, key);
   }
   tracked_tags_by_keys_.erase(it);
   return true;
@@ -212,6 +366,11 @@ int Tag::RespondWithInfo(ValkeyModuleCtx* ctx) const {
       ctx, std::string(&separator_, sizeof(char)).c_str());
   ValkeyModule_ReplyWithSimpleString(ctx, "CASESENSITIVE");
   ValkeyModule_ReplyWithSimpleString(ctx, case_sensitive_ ? "1" : "0");
+  if (wildcard_index_) {
+    ValkeyModule_ReplyWithSimpleString(ctx, "WITH_SUFFIX_TRIE");
+    ValkeyModule_ReplyWithSimpleString(ctx, "1");
+    num_replies += 2;
+  }
   ValkeyModule_ReplyWithSimpleString(ctx, "size");
   absl::MutexLock lock(&index_mutex_);
   ValkeyModule_ReplyWithCString(
@@ -224,6 +383,7 @@ std::unique_ptr<data_model::Index> Tag::ToProto() const {
   auto tag_index = std::make_unique<data_model::TagIndex>();
   tag_index->set_separator(absl::string_view(&separator_, 1));
   tag_index->set_case_sensitive(case_sensitive_);
+  tag_index->set_with_suffix_trie(wildcard_index_ != nullptr);
   index_proto->set_allocated_tag_index(tag_index.release());
   return index_proto;
 }
@@ -328,14 +488,27 @@ const InternedStringPtr& Tag::EntriesFetcherIterator::operator*() const {
   return *next_iter_;
 }
 
-// TODO: b/357027854 - Support Suffix/Infix Search
 std::unique_ptr<Tag::EntriesFetcher> Tag::Search(
     const query::TagPredicate& predicate, bool negate) const {
   absl::flat_hash_set<PatriciaNodeIndex*> entries;
   size_t size = 0;
 
   for (const auto& tag : predicate.GetTags()) {
-    if (tag.back() == '*') {
+    if (IsWildcardPattern(tag)) {
+      if (!wildcard_index_) {
+        // Rejected by the filter parser, nothing can match.
+        continue;
+      }
+      ForEachWildcardMatch(tag, [&](absl::string_view matched_tag) {
+        PatriciaNodeIndex* node = tree_.ExactMatcher(matched_tag);
+        if (node != nullptr) {
+          auto res = entries.insert(node);
+          if (res.second && node->value.has_value()) {
+            size += node->value.value().size();
+          }
+        }
+      });
+    } else if (tag.back() == '*') {
       auto prefix_tag = tag.substr(0, tag.length() - 1);
       for (auto it = tree_.PrefixMatcher(prefix_tag); !it.Done(); it.Next()) {
         PatriciaNodeIndex* node = it.Value();
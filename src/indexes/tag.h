@@ -13,8 +13,10 @@
 #include <string>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -90,7 +92,7 @@ class Tag : public IndexBase {
     PatriciaTreeIndex::PrefixSubTreeIterator tree_iter_;
     absl::flat_hash_set<PatriciaNodeIndex*>& entries_;
     PatriciaNodeIndex* next_node_{nullptr};
-    InternedStringSet::const_iterator next_iter_;
+    PatriciaNodeIndex::SetType::const_iterator next_iter_;
     const InternedStringSet& untracked_keys_;
     bool negate_;
     std::optional<InternedStringSet::const_iterator> untracked_keys_iter_;
@@ -123,6 +125,15 @@ class Tag : public IndexBase {
       bool negate) const ABSL_NO_THREAD_SAFETY_ANALYSIS;
   char GetSeparator() const { return separator_; }
   bool IsCaseSensitive() const { return case_sensitive_; }
+  // Whether suffix (`*foo`), infix (`*foo*`) and other wildcard patterns can
+  // be searched, i.e. the attribute was created WITHSUFFIXTRIE.
+  bool HasWildcardIndex() const { return wildcard_index_ != nullptr; }
+  // Returns true if the tag query needs the wildcard index, i.e. it has a `*`
+  // anywhere but as its last character.
+  static bool IsWildcardPattern(absl::string_view tag);
+  // Glob match where `*` matches any sequence of characters.
+  static bool MatchTagPattern(absl::string_view tag, absl::string_view pattern,
+                              bool case_sensitive);
   static absl::StatusOr<absl::flat_hash_set<absl::string_view>> ParseSearchTags(
       absl::string_view data, char separator);
   static absl::flat_hash_set<absl::string_view> ParseRecordTags(
@@ -131,6 +142,34 @@ class Tag : public IndexBase {
   static std::string UnescapeTag(absl::string_view tag);
 
  private:
+  //
+  // Side index over the distinct tag values, used to answer patterns that a
+  // prefix walk of tree_ cannot. Suffix patterns walk the tree of reversed
+  // tags, other patterns intersect through the trigram postings and verify
+  // each candidate. Both hold the tag (lower cased for case insensitive
+  // indexes), which is then looked up in tree_ to reach the keys.
+  //
+  struct WildcardIndex {
+    explicit WildcardIndex(bool case_sensitive)
+        : reversed_tags(case_sensitive) {}
+    PatriciaTreeIndex reversed_tags;
+    absl::flat_hash_map<std::string, InternedStringSet> trigrams;
+  };
+  void AddToWildcardIndex(absl::string_view tag)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(index_mutex_);
+  void RemoveFromWildcardIndex(absl::string_view tag)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(index_mutex_);
+  void AddTag(absl::string_view tag, const InternedStringPtr& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(index_mutex_);
+  void RemoveTag(absl::string_view tag, const InternedStringPtr& key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(index_mutex_);
+  // Invokes fn with every distinct tag matching the wildcard pattern.
+  void ForEachWildcardMatch(
+      absl::string_view pattern,
+      absl::FunctionRef<void(absl::string_view)> fn) const
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+  std::string NormalizeTag(absl::string_view tag) const;
+
   mutable absl::Mutex index_mutex_;
   struct TagInfo {
     InternedStringPtr raw_tag_string;
@@ -144,6 +183,9 @@ class Tag : public IndexBase {
   const char separator_;
   const bool case_sensitive_;
   PatriciaTreeIndex tree_ ABSL_GUARDED_BY(index_mutex_);
+  // Null unless the attribute was created WITHSUFFIXTRIE. The pointer is fixed
+  // at construction, its contents are guarded by index_mutex_.
+  const std::unique_ptr<WildcardIndex> wildcard_index_;
 };
 }  // namespace valkey_search::indexes
 
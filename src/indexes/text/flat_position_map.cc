@@ -7,11 +7,14 @@
 
 #include "src/indexes/text/flat_position_map.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <string>
+#include <utility>
 #include <vector>
 
-#include "absl/container/inlined_vector.h"
+#include "absl/base/optimization.h"
 #include "absl/log/check.h"
 #include "src/indexes/text/posting.h"
 
@@ -58,9 +61,8 @@ inline char C(uint8_t v) { return static_cast<char>(v); }
 // Encode: composite = (value << 1) | type_bit, big-endian, 7 bits/byte
 // Encoding scheme: bit 7 = 1 (continue), bit 7 = 0 (end/last byte)
 template <typename T>
-static inline void EncodeValue(
-    absl::InlinedVector<char, kPartitionSize>& buffer, T value,
-    bool is_position) {
+static inline void EncodeValue(std::string& buffer, T value,
+                               bool is_position) {
   __uint128_t v = (U128(value) << 1) | __uint128_t(is_position);
 
   // Count how many 7-bit groups are needed
@@ -77,92 +79,149 @@ static inline void EncodeValue(
 
 // Decode: big-endian, continuation bytes bit 7=1, last byte bit 7=0
 // Returns pair of (decoded_value, is_position)
-template <typename T>
-static inline std::pair<T, bool> DecodeValue(const char*& ptr) {
-  // Read first byte (should not be terminator)
-  CHECK(U8(*ptr) != kTerminatorByte) << "Attempted to decode terminator byte";
+//
+// Nearly all position deltas, and the field masks of the first few fields,
+// fit in a single byte, which is decoded without entering the loop. Longer
+// values accumulate in 64 bits; only a field mask using bit 63 needs a tenth
+// byte, and so the 128-bit composite.
+static inline std::pair<uint64_t, bool> DecodeValue(const char*& ptr) {
+  DCHECK(U8(*ptr) != kTerminatorByte) << "Attempted to decode terminator byte";
 
-  // Read first byte and check continuation bit
   uint8_t byte = U8(*ptr++);
-  T composite = byte & kSevenBitMask;
+  if (ABSL_PREDICT_TRUE(!(byte & kContinueBit))) {
+    return {byte >> 1, byte & 1};
+  }
 
-  // Read continuation bytes and assemble big-endian
-  while (byte & kContinueBit) {
+  uint64_t composite = byte & kSevenBitMask;
+  for (int groups = 1; byte & kContinueBit; ++groups) {
     byte = U8(*ptr++);
+    if (ABSL_PREDICT_FALSE(groups == 9)) {
+      __uint128_t wide =
+          (U128(composite) << kBitsPerByte) | (byte & kSevenBitMask);
+      return {U64(wide >> 1), bool(wide & 1)};
+    }
     composite = (composite << kBitsPerByte) | (byte & kSevenBitMask);
   }
 
   // Extract type from LSB and value from remaining bits
-  bool is_position = composite & 1;
-  T value = composite >> 1;
-  return {value, is_position};
+  return {composite >> 1, composite & 1};
 }
 
 //=============================================================================
 // Serialization
 //=============================================================================
 
-// Static factory and destroyer
-FlatPositionMap* FlatPositionMap::Create(
-    const absl::btree_map<Position, FieldMask>& position_map,
-    size_t num_text_fields) {
-  CHECK(!position_map.empty())
-      << "Cannot create FlatPositionMap from empty position_map";
+FlatPositionMapBuilder::FlatPositionMapBuilder(size_t num_text_fields)
+    : num_text_fields_(static_cast<uint8_t>(num_text_fields)) {}
 
-  // First pass: compute data size (same logic as old constructor)
-  uint32_t num_positions = position_map.size();
+void FlatPositionMapBuilder::AddPosition(Position position,
+                                         uint64_t field_mask) {
+  if (spilled_) {
+    entries_.emplace_back(position, field_mask);
+    return;
+  }
+  if (has_pending_) {
+    if (position == pending_position_) {
+      pending_mask_ |= field_mask;
+      return;
+    }
+    if (position < pending_position_) {
+      Spill();
+      entries_.emplace_back(position, field_mask);
+      return;
+    }
+    Encode(pending_position_, pending_mask_);
+  }
+  pending_position_ = position;
+  pending_mask_ = field_mask;
+  has_pending_ = true;
+}
 
-  absl::InlinedVector<char, kPartitionSize> position_data;
-  std::vector<uint32_t> partition_byte_offsets;
-  std::vector<Position> partition_deltas;
+// Encode: [field_mask (if changed)][position]...
+void FlatPositionMapBuilder::Encode(Position position, uint64_t field_mask) {
+  bool is_partition_start = num_positions_ == 0;
 
-  Position prev_pos = 0;
-  Position cumulative_delta = 0;
-  uint64_t prev_field_mask = 0;
-  bool is_partition_start = true;
+  // Check for new partition boundary
+  if (!is_partition_start &&
+      position_data_.size() >= (partitions_.size() + 1) * kPartitionSize) {
+    partitions_.emplace_back(position_data_.size(), prev_position_);
+    is_partition_start = true;
+  }
 
-  // Encode: [field_mask (if changed)][position]...
-  for (const auto& [pos, field_mask] : position_map) {
-    // Check for new partition boundary
-    if (position_data.size() >=
-            (partition_byte_offsets.size() + 1) * kPartitionSize &&
-        !is_partition_start) {
-      partition_byte_offsets.push_back(position_data.size());
-      partition_deltas.push_back(cumulative_delta);
-      is_partition_start = true;
-      prev_field_mask = 0;
-    }
+  // Encode field mask if multi-field and changed
+  if (num_text_fields_ > 1 &&
+      (is_partition_start || field_mask != prev_field_mask_)) {
+    EncodeValue(position_data_, field_mask, false);  // false = field_mask
+    prev_field_mask_ = field_mask;
+  }
 
-    Position delta = pos - prev_pos;
-    cumulative_delta += delta;
+  // Encode position delta after field mask
+  EncodeValue(position_data_, position - prev_position_, true);
 
-    // Encode field mask if multi-field and changed
-    if (num_text_fields > 1) {
-      uint64_t current_mask = field_mask.GetMask();
-      if (is_partition_start || current_mask != prev_field_mask) {
-        EncodeValue(position_data, current_mask, false);  // false = field_mask
-        prev_field_mask = current_mask;
-      }
-    }
+  prev_position_ = position;
+  ++num_positions_;
+  term_frequency_ += __builtin_popcountll(field_mask);
+}
 
-    // Encode position delta after field mask
-    EncodeValue(position_data, delta, true);  // true = position
+void FlatPositionMapBuilder::Spill() {
+  entries_.reserve(num_positions_ + 2);
+  const char* p = position_data_.data();
+  const char* end = p + position_data_.size();
+  Position position = 0;
+  uint64_t field_mask = 1;
+  while (p != end) {
+    auto [value, is_position] = DecodeValue(p);
+    if (!is_position) {
+      field_mask = value;
+      continue;
+    }
+    position += static_cast<Position>(value);
+    entries_.emplace_back(position, field_mask);
+  }
+  entries_.emplace_back(pending_position_, pending_mask_);
+
+  std::string().swap(position_data_);
+  std::vector<std::pair<uint32_t, Position>>().swap(partitions_);
+  prev_field_mask_ = 0;
+  prev_position_ = 0;
+  num_positions_ = 0;
+  term_frequency_ = 0;
+  has_pending_ = false;
+  spilled_ = true;
+}
 
-    prev_pos = pos;
-    is_partition_start = false;
+FlatPositionMap* FlatPositionMapBuilder::Build() {
+  CHECK(!IsEmpty()) << "Cannot create FlatPositionMap from empty position_map";
+
+  if (spilled_) {
+    std::sort(entries_.begin(), entries_.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    position_data_.reserve(entries_.size() * 2);
+    for (size_t i = 0; i < entries_.size();) {
+      auto [position, field_mask] = entries_[i];
+      for (++i; i < entries_.size() && entries_[i].first == position; ++i) {
+        field_mask |= entries_[i].second;
+      }
+      Encode(position, field_mask);
+    }
+    std::vector<std::pair<Position, uint64_t>>().swap(entries_);
+  } else {
+    Encode(pending_position_, pending_mask_);
+    has_pending_ = false;
   }
 
-  uint32_t num_partitions = partition_byte_offsets.size();
+  uint32_t num_positions = num_positions_;
+  uint32_t num_partitions = partitions_.size();
 
   // Terminator: Field mask with value 0: composite = 0, encoded as 0x00
-  position_data.push_back(C(kTerminatorByte));
+  position_data_.push_back(C(kTerminatorByte));
 
   // Calculate sizes
-  uint8_t pos_bytes = BytesNeeded(num_positions) - 1;
-  uint8_t part_bytes = BytesNeeded(num_partitions) - 1;
+  uint8_t pos_bytes = FlatPositionMap::BytesNeeded(num_positions) - 1;
+  uint8_t part_bytes = FlatPositionMap::BytesNeeded(num_partitions) - 1;
   size_t partition_map_size = num_partitions * kPartitionDeltaBytes * 2;
   size_t counts_size = (pos_bytes + 1) + (part_bytes + 1);
-  size_t data_size = counts_size + partition_map_size + position_data.size();
+  size_t data_size = counts_size + partition_map_size + position_data_.size();
   size_t total_size = sizeof(FlatPositionMap) + data_size;
 
   // Allocate single block: [FlatPositionMap | data...]
@@ -183,19 +242,32 @@ FlatPositionMap* FlatPositionMap::Create(
   map->WriteCounts(p, num_positions, num_partitions);
 
   // Write partition map
-  for (size_t i = 0; i < num_partitions; ++i) {
-    std::memcpy(p, &partition_byte_offsets[i], kPartitionDeltaBytes);
+  for (const auto& [byte_offset, cumulative_delta] : partitions_) {
+    std::memcpy(p, &byte_offset, kPartitionDeltaBytes);
     p += kPartitionDeltaBytes;
-    std::memcpy(p, &partition_deltas[i], kPartitionDeltaBytes);
+    std::memcpy(p, &cumulative_delta, kPartitionDeltaBytes);
     p += kPartitionDeltaBytes;
   }
 
   // Write position data
-  std::memcpy(p, position_data.data(), position_data.size());
+  std::memcpy(p, position_data_.data(), position_data_.size());
+  std::string().swap(position_data_);
+  std::vector<std::pair<uint32_t, Position>>().swap(partitions_);
 
   return map;
 }
 
+// Static factory and destroyer
+FlatPositionMap* FlatPositionMap::Create(
+    const absl::btree_map<Position, FieldMask>& position_map,
+    size_t num_text_fields) {
+  FlatPositionMapBuilder builder(num_text_fields);
+  for (const auto& [pos, field_mask] : position_map) {
+    builder.AddPosition(pos, field_mask.GetMask());
+  }
+  return builder.Build();
+}
+
 void FlatPositionMap::Destroy(FlatPositionMap* map) {
   if (!map) return;
   map->~FlatPositionMap();
@@ -294,17 +366,17 @@ void PositionIterator::NextPosition() {
   }
 
   // Decode next value - could be field mask or position
-  auto [value, is_position] = DecodeValue<__uint128_t>(current_ptr_);
+  auto [value, is_position] = DecodeValue(current_ptr_);
 
   if (!is_position) {
     // It's a field mask - update it and read the position that MUST follow
-    current_field_mask_ = U64(value);
-    auto [delta, delta_is_position] = DecodeValue<Position>(current_ptr_);
+    current_field_mask_ = value;
+    auto [delta, delta_is_position] = DecodeValue(current_ptr_);
     CHECK(delta_is_position) << "Expected position after field mask";
     cumulative_position_ += delta;
   } else {
     // It's a position directly (field mask unchanged)
-    cumulative_position_ += U64(value);
+    cumulative_position_ += value;
   }
 }
 
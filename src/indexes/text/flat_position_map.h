@@ -15,10 +15,13 @@ replacing std::map<Position, FieldMask> which consumes 80+ bytes per position
 with a byte array achieving 1-8 bytes per position. This is critical for memory
 efficiency as millions of these structures exist across the full-text corpus.
 
-During document ingestion, positions accumulate in std::map for efficient
-random insertion. Upon completion, the map is serialized into FlatPositionMap
-and the map is destroyed. The FlatPositionMap is read-only thereafter and used
-by search queries.
+During document ingestion, positions accumulate in a FlatPositionMapBuilder.
+Positions that arrive in ascending order, as they do for the tokens of a single
+field, are encoded straight into the builder's buffer, with the partition map
+computed as the data grows. Only when a later field restarts the positions does
+the builder fall back to a flat vector of (position, field mask) entries, which
+is sorted and encoded once the key is complete. The FlatPositionMap is
+read-only thereafter and used by search queries.
 
 Structure Layout:
   [Variable header] [optional partition map] [position/field data]
@@ -58,6 +61,9 @@ minimal state overhead, maintaining cumulative position for delta decoding.
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/container/btree_map.h"
 
@@ -71,7 +77,8 @@ struct FieldMask;
 // Layout: [Bitfield Header][Optional Partition Map][Position/Field Data]
 class FlatPositionMap {
  public:
-  // Factory: allocates single block [FlatPositionMap | data...]
+  // Factory: allocates single block [FlatPositionMap | data...]. Equivalent to
+  // adding every entry of the map to a FlatPositionMapBuilder.
   static FlatPositionMap* Create(
       const absl::btree_map<Position, FieldMask>& position_map,
       size_t num_text_fields);
@@ -97,6 +104,7 @@ class FlatPositionMap {
 
  private:
   friend class PositionIterator;  // Allow iterator to access bitfield members
+  friend class FlatPositionMapBuilder;
 
   // Helper methods (implemented in .cc)
   static uint8_t BytesNeeded(uint32_t value);
@@ -118,6 +126,45 @@ class FlatPositionMap {
   FlatPositionMap() = default;
 };
 
+// Incrementally builds a FlatPositionMap without an intermediate ordered map.
+// Adding a position already added ORs the field masks together.
+class FlatPositionMapBuilder {
+ public:
+  explicit FlatPositionMapBuilder(size_t num_text_fields);
+
+  void AddPosition(Position position, uint64_t field_mask);
+
+  bool IsEmpty() const { return !has_pending_ && entries_.empty(); }
+
+  // Encodes the added positions into a new FlatPositionMap. The builder must
+  // not be used afterwards, except for the counts below.
+  FlatPositionMap* Build();
+
+  // Number of positions and sum of field mask popcounts encoded by Build.
+  uint32_t GetNumPositions() const { return num_positions_; }
+  size_t GetTermFrequency() const { return term_frequency_; }
+
+ private:
+  void Encode(Position position, uint64_t field_mask);
+  // Decodes the data encoded so far into entries_, for out-of-order adds.
+  void Spill();
+
+  std::string position_data_;
+  // (byte offset, cumulative position) of each partition after the first.
+  std::vector<std::pair<uint32_t, Position>> partitions_;
+  // Unsorted entries, only used once positions arrive out of order.
+  std::vector<std::pair<Position, uint64_t>> entries_;
+  uint64_t pending_mask_{0};
+  uint64_t prev_field_mask_{0};
+  Position pending_position_{0};
+  Position prev_position_{0};
+  uint32_t num_positions_{0};
+  size_t term_frequency_{0};
+  uint8_t num_text_fields_;
+  bool has_pending_{false};
+  bool spilled_{false};
+};
+
 // Iterator for FlatPositionMap
 class PositionIterator {
  public:
@@ -6,7 +6,10 @@
 
 #include "src/indexes/text/lexer.h"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -16,6 +19,7 @@
 #include "libstemmer.h"
 #include "src/indexes/text/unicode_normalizer.h"
 #include "src/utils/scanner.h"
+#include "vmsdk/src/status/status_macros.h"
 
 namespace valkey_search::indexes::text {
 
@@ -74,6 +78,67 @@ using StemmerPtr = std::unique_ptr<sb_stemmer, StemmerDeleter>;
 // at least once.
 thread_local absl::flat_hash_map<data_model::Language, StemmerPtr> stemmers_;
 
+// Thread-local cache of the stems of recently seen words, per language. Word
+// frequencies are heavily skewed, so most stemmer calls hit it. It is dropped
+// when full rather than evicting entries one by one.
+constexpr size_t kStemCacheCapacity = 16 * 1024;
+thread_local absl::flat_hash_map<
+    data_model::Language, absl::flat_hash_map<std::string, std::string>>
+    stem_caches_;
+
+// Scratch buffer for the tokens that have to be rewritten.
+thread_local std::string token_scratch_;
+
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+inline uint64_t LoadWord(const char* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+// Returns the length of the longest ASCII prefix of `text`, up to a multiple
+// of eight bytes.
+size_t AsciiPrefixLength(absl::string_view text) {
+  size_t pos = 0;
+  while (pos + sizeof(uint64_t) <= text.size() &&
+         (LoadWord(text.data() + pos) & kHighBits) == 0) {
+    pos += sizeof(uint64_t);
+  }
+  return pos;
+}
+
+// Returns true if `word`, which must be ASCII, holds an upper case letter.
+inline bool WordHasAsciiUpper(uint64_t word) {
+  // The high bit of a byte of `ge_a` is set if the byte is >= 'A', and of
+  // `gt_z` if it is > 'Z'. No byte overflows into the next one.
+  uint64_t ge_a = word + 0x3F3F3F3F3F3F3F3FULL;  // 0x80 - 'A'
+  uint64_t gt_z = word + 0x2525252525252525ULL;  // 0x80 - 'Z' - 1
+  return (ge_a & ~gt_z & kHighBits) != 0;
+}
+
+enum class TokenCase { kLowerAscii, kAscii, kNonAscii };
+
+TokenCase ClassifyToken(absl::string_view token) {
+  size_t pos = 0;
+  bool upper = false;
+  for (; pos + sizeof(uint64_t) <= token.size(); pos += sizeof(uint64_t)) {
+    uint64_t word = LoadWord(token.data() + pos);
+    if (word & kHighBits) {
+      return TokenCase::kNonAscii;
+    }
+    upper = upper || WordHasAsciiUpper(word);
+  }
+  for (; pos < token.size(); ++pos) {
+    unsigned char c = token[pos];
+    if (c & 0x80) {
+      return TokenCase::kNonAscii;
+    }
+    upper = upper || absl::ascii_isupper(c);
+  }
+  return upper ? TokenCase::kAscii : TokenCase::kLowerAscii;
+}
+
 }  // namespace
 
 Lexer::Lexer(data_model::Language language, const std::string& punctuation,
@@ -85,6 +150,17 @@ Lexer::Lexer(data_model::Language language, const std::string& punctuation,
 absl::StatusOr<std::vector<std::string>> Lexer::Tokenize(
     absl::string_view text, bool stemming_enabled, uint32_t min_stem_size,
     InProgressStemMap* stem_mappings) const {
+  std::vector<std::string> tokens;
+  VMSDK_RETURN_IF_ERROR(ForEachToken(
+      text, stemming_enabled, min_stem_size, stem_mappings,
+      [&tokens](absl::string_view token) { tokens.emplace_back(token); }));
+  return tokens;
+}
+
+absl::Status Lexer::ForEachToken(
+    absl::string_view text, bool stemming_enabled, uint32_t min_stem_size,
+    InProgressStemMap* stem_mappings,
+    absl::FunctionRef<void(absl::string_view)> fn) const {
   if (stemming_enabled) {
     CHECK(stem_mappings) << "stem_mappings must not be null";
   }
@@ -94,11 +170,7 @@ absl::StatusOr<std::vector<std::string>> Lexer::Tokenize(
 
   // Get or create the thread-local stemmer for this lexer's language
   sb_stemmer* stemmer = stemming_enabled ? GetStemmer() : nullptr;
-  // Deque grows by adding new blocks—avoids the cost of copying
-  // existing elements during reallocation.
-  std::vector<std::string> tokens;
-  std::string word;
-  word.reserve(64);
+  std::string& scratch = token_scratch_;
   size_t pos = 0;
   while (pos < text.size()) {
     // Skip leading punctuation, but check for backslash escape sequences
@@ -110,17 +182,22 @@ absl::StatusOr<std::vector<std::string>> Lexer::Tokenize(
       pos++;
     }
 
-    word.clear();
-
-    // Build word, handling backslash escape sequences
+    // Build word, handling backslash escape sequences. The word is a view of
+    // the text until an escape sequence forces it into the scratch buffer.
+    size_t start = pos;
+    bool escaped = false;
     while (pos < text.size()) {
       char ch = text[pos];
       if (ch == '\\' && pos + 1 < text.size()) {
+        if (!escaped) {
+          scratch.assign(text.data() + start, pos - start);
+          escaped = true;
+        }
         char next_ch = text[pos + 1];
         pos++;  // Consume the backslash
         if (next_ch == '\\' || IsPunctuation(next_ch)) {
           // Backslash escapes backslash or punctuation
-          word.push_back(text[pos++]);  // Keep the escaped character
+          scratch.push_back(text[pos++]);  // Keep the escaped character
         } else {
           // Backslash before non-punctuation
           if (IsPunctuation('\\')) {
@@ -129,7 +206,7 @@ absl::StatusOr<std::vector<std::string>> Lexer::Tokenize(
             break;
           } else {
             // Backslash not punctuation → keep letter
-            word.push_back(text[pos++]);
+            scratch.push_back(text[pos++]);
           }
         }
       } else if (IsPunctuation(ch)) {
@@ -137,27 +214,48 @@ absl::StatusOr<std::vector<std::string>> Lexer::Tokenize(
         break;
       } else {
         // Regular character
-        word.push_back(ch);
+        if (escaped) {
+          scratch.push_back(ch);
+        }
         pos++;
       }
     }
 
-    if (!word.empty()) {
-      NormalizeLowerCaseInPlace(word);
+    absl::string_view word =
+        escaped ? absl::string_view(scratch) : text.substr(start, pos - start);
+    if (word.empty()) {
+      continue;
+    }
+    switch (ClassifyToken(word)) {
+      case TokenCase::kLowerAscii:
+        break;
+      case TokenCase::kAscii:
+        if (!escaped) {
+          scratch.assign(word.data(), word.size());
+        }
+        absl::AsciiStrToLower(&scratch);
+        word = scratch;
+        break;
+      case TokenCase::kNonAscii:
+        if (!escaped) {
+          scratch.assign(word.data(), word.size());
+        }
+        UnicodeNormalizer::CaseFoldInPlace(scratch);
+        word = scratch;
+        break;
+    }
 
-      if (IsStopWord(word)) {
-        continue;  // Skip stop words
-      }
+    if (IsStopWord(word)) {
+      continue;  // Skip stop words
+    }
 
-      if (stemming_enabled) {
-        UpdateStemMap(word, stemmer, min_stem_size, *stem_mappings);
-      }
-      tokens.push_back(std::move(word));
-      word.clear();
+    if (stemming_enabled) {
+      UpdateStemMap(word, stemmer, min_stem_size, *stem_mappings);
     }
+    fn(word);
   }
 
-  return tokens;
+  return absl::OkStatus();
 }
 
 // Returns a thread-local cached stemmer for this lexer's language, creating it
@@ -175,6 +273,12 @@ sb_stemmer* Lexer::GetStemmer() const {
 
 // UTF-8 validation using Scanner
 bool Lexer::IsValidUtf8(absl::string_view text) const {
+  // ASCII is valid UTF-8 and ends on a character boundary, so only the rest
+  // needs to be decoded.
+  text.remove_prefix(AsciiPrefixLength(text));
+  if (text.empty()) {
+    return true;
+  }
   valkey_search::utils::Scanner scanner(text);
 
   // Try to parse each UTF-8 character - Scanner counts invalid sequences
@@ -204,13 +308,22 @@ std::string_view Lexer::DoStemming(absl::string_view word, sb_stemmer* stemmer,
     return word;
   }
   CHECK(stemmer) << "Stemmer is not initialized";
+  auto& stem_cache = stem_caches_[language_];
+  if (auto it = stem_cache.find(word); it != stem_cache.end()) {
+    return it->second;
+  }
   const sb_symbol* stemmed = sb_stemmer_stem(
       stemmer, reinterpret_cast<const sb_symbol*>(word.data()), word.length());
   CHECK(stemmed) << "Stemming failed";
   int stemmed_length = sb_stemmer_length(stemmer);
   CHECK(stemmed_length > 0) << "Stemming failed";
-  return std::string_view(reinterpret_cast<const char*>(stemmed),
-                          stemmed_length);
+  if (stem_cache.size() >= kStemCacheCapacity) {
+    stem_cache.clear();
+  }
+  return stem_cache
+      .try_emplace(std::string(word), reinterpret_cast<const char*>(stemmed),
+                   stemmed_length)
+      .first->second;
 }
 
 void Lexer::StemWordInPlace(std::string& word, sb_stemmer* stemmer,
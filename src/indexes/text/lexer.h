@@ -22,6 +22,12 @@ Tokenization Pipeline:
 3. Stop word removal (filter out common words)
 4. Apply stemming based on language and field settings
 
+Tokens are streamed to the caller as views, either into the input text or,
+when they have to be rewritten (escapes, upper case), into a per-thread
+scratch buffer. Plain lower case ASCII tokens are therefore never copied.
+ASCII runs are recognized eight bytes at a time; only tokens with non-ASCII
+bytes go through ICU case folding.
+
 */
 
 #include <bitset>
@@ -31,6 +37,8 @@ Tokenization Pipeline:
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "src/index_schema.pb.h"
@@ -57,6 +65,13 @@ struct Lexer {
       absl::string_view text, bool stemming_enabled, uint32_t min_stem_size,
       InProgressStemMap* stem_mappings = nullptr) const;
 
+  // Calls `fn` with each token of `text`, in order, without allocating. A
+  // token view is only valid for the duration of the call.
+  absl::Status ForEachToken(
+      absl::string_view text, bool stemming_enabled, uint32_t min_stem_size,
+      InProgressStemMap* stem_mappings,
+      absl::FunctionRef<void(absl::string_view)> fn) const;
+
   bool IsPunctuation(char c) const {
     return punct_bitmap_[static_cast<unsigned char>(c)];
   }
@@ -79,7 +94,8 @@ struct Lexer {
 
   // UTF-8 processing helpers
   bool IsValidUtf8(absl::string_view text) const;
-  // Common stemming logic
+  // Common stemming logic. The returned view is valid until the next call on
+  // the same thread.
   std::string_view DoStemming(absl::string_view word, sb_stemmer* stemmer,
                               uint32_t min_stem_size) const;
 };
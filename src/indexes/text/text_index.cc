@@ -157,34 +157,47 @@ absl::StatusOr<bool> TextIndexSchema::StageAttributeData(
     stem_mappings_ptr = &in_progress_stem_mappings_[key];
   }
 
-  // Tokenize and collect stem mappings
-  auto tokens = lexer_.Tokenize(data, stem, min_stem_size_, stem_mappings_ptr);
+  // Map tokens -> positions -> field-masks. The key is only staged once its
+  // text was found to be valid.
+  TokenPositions *token_positions = nullptr;
+  auto get_token_positions = [&]() {
+    if (!token_positions) {
+      std::lock_guard<std::mutex> guard(in_progress_key_updates_mutex_);
+      token_positions = &in_progress_key_updates_[key];
+    }
+    return token_positions;
+  };
+  // Tokenize and collect stem mappings. Tokens are streamed as views, so only
+  // the first occurrence of a token in the key is copied.
+  uint32_t token_count = 0;
+  auto status = lexer_.ForEachToken(
+      data, stem, min_stem_size_, stem_mappings_ptr,
+      [&](absl::string_view token) {
+        uint32_t position = with_offsets_ ? token_count
+                                          : 0;  // If positional info is
+                                                // disabled we default to 0
+        ++token_count;
+        get_token_positions();
+        auto it = token_positions->find(token);
+        if (it == token_positions->end()) {
+          it = token_positions
+                   ->try_emplace(std::string(token),
+                                 FlatPositionMapBuilder(num_text_fields_),
+                                 false)
+                   .first;
+        }
+        auto &[positions, suffix_eligible] = it->second;
+        if (suffix) suffix_eligible = true;
+        positions.AddPosition(position, uint64_t{1} << text_field_number);
+      });
 
-  if (!tokens.ok()) {
-    if (tokens.status().code() == absl::StatusCode::kInvalidArgument) {
+  if (!status.ok()) {
+    if (status.code() == absl::StatusCode::kInvalidArgument) {
       return false;  // UTF-8 errors → hash_indexing_failures
     }
-    return tokens.status();
+    return status;
   }
-
-  // Map tokens -> positions -> field-masks
-  TokenPositions *token_positions;
-  {
-    std::lock_guard<std::mutex> guard(in_progress_key_updates_mutex_);
-    token_positions = &in_progress_key_updates_[key];
-  }
-  for (uint32_t i = 0; i < tokens->size(); ++i) {
-    const auto &token = (*tokens)[i];
-    uint32_t position =
-        with_offsets_ ? i
-                      : 0;  // If positional info is disabled we default to 0
-    auto &[positions, suffix_eligible] = (*token_positions)[token];
-    if (suffix) suffix_eligible = true;
-    auto [pos_it, _] =
-        positions.try_emplace(position, FieldMask(num_text_fields_));
-    pos_it->second.SetField(text_field_number);
-  }
-
+  get_token_positions();
   return true;
 }
 
@@ -216,22 +229,17 @@ void TextIndexSchema::CommitKeyData(const InternedStringPtr &key) {
   // Index the key's tokens
   for (auto &entry : token_positions) {
     const std::string &token = entry.first;
-    auto &[pos_map, suffix] = entry.second;
+    auto &[positions, suffix] = entry.second;
 
     const std::optional<std::string> reverse_token =
         with_suffix_trie_ ? std::optional<std::string>(
                                 std::string(token.rbegin(), token.rend()))
                           : std::nullopt;
 
-    // Update metadata from PositionMap
-    metadata_.total_positions += pos_map.size();
-    for (const auto &[_, field_mask] : pos_map) {
-      metadata_.total_term_frequency += field_mask.CountSetFields();
-    }
-
-    // Create FlatPositionMap from PositionMap
-    FlatPositionMap *flat_map =
-        FlatPositionMap::Create(pos_map, num_text_fields_);
+    // Encode the positions and update metadata from what was encoded
+    FlatPositionMap *flat_map = positions.Build();
+    metadata_.total_positions += positions.GetNumPositions();
+    metadata_.total_term_frequency += positions.GetTermFrequency();
 
     // The updated target gets set in target_add_fn and later used in
     // target_set_fn, so that all trees point to the same postings object
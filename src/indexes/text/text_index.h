@@ -23,6 +23,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "src/index_schema.pb.h"
+#include "src/indexes/text/flat_position_map.h"
 #include "src/indexes/text/invasive_ptr.h"
 #include "src/indexes/text/lexer.h"
 #include "src/indexes/text/posting.h"
@@ -36,9 +37,9 @@ namespace valkey_search::indexes::text {
 // Inline capacity for stem variants extracted from stem tree
 constexpr size_t kStemVariantsInlineCapacity = 20;
 
-// token -> (PositionMap, suffix support)
+// token -> (positions being encoded, suffix support)
 using TokenPositions =
-    absl::flat_hash_map<std::string, std::pair<PositionMap, bool>>;
+    absl::flat_hash_map<std::string, std::pair<FlatPositionMapBuilder, bool>>;
 
 class TextIndexSchema;
 
@@ -10,6 +10,7 @@
 #include <sys/types.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -36,9 +37,11 @@
 #include "absl/synchronization/mutex.h"
 #include "src/attribute_data_type.h"
 #include "src/index_schema.pb.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
+#include "src/metrics.h"
 #include "src/query/predicate.h"
 #include "src/rdb_serialization.h"
 #include "src/utils/string_interning.h"
@@ -100,6 +103,12 @@ query::EvaluationResult PrefilterEvaluator::EvaluateNumeric(
   return predicate.Evaluate(value);
 }
 
+query::EvaluationResult PrefilterEvaluator::EvaluateGeo(
+    const query::GeoPredicate &predicate) {
+  CHECK(key_);
+  return predicate.Evaluate(predicate.GetIndex()->GetValue(*key_));
+}
+
 query::EvaluationResult PrefilterEvaluator::EvaluateText(
     const query::TextPredicate &predicate, bool require_positions) {
   CHECK(key_);
@@ -149,20 +158,43 @@ void VectorBase::Init(int dimensions,
   }
 }
 
+std::vector<char> VectorBase::NormalizeRecord(absl::string_view record,
+                                              float *magnitude) const {
+  if (!multi_vector_) {
+    return NormalizeEmbedding(record, GetDataTypeSize(), magnitude);
+  }
+  // A multi-vector record has no single magnitude to restore, so its vectors
+  // are returned normalized.
+  std::vector<char> ret;
+  ret.reserve(record.size());
+  for (size_t offset = 0; offset < record.size();
+       offset += GetVectorDataSize()) {
+    auto normalized = NormalizeEmbedding(
+        record.substr(offset, GetVectorDataSize()), GetDataTypeSize());
+    ret.insert(ret.end(), normalized.begin(), normalized.end());
+  }
+  return ret;
+}
+
 InternedStringPtr VectorBase::InternVector(absl::string_view record,
                                            std::optional<float> &magnitude) {
   if (!IsValidSizeVector(record)) {
     return {};
   }
+  // Multi-vector records vary in size and can't use the fixed size allocator.
+  auto allocator = multi_vector_ ? nullptr : vector_allocator_.get();
   if (normalize_) {
-    magnitude = kDefaultMagnitude;
-    auto norm_record =
-        NormalizeEmbedding(record, GetDataTypeSize(), &magnitude.value());
+    float *record_magnitude = nullptr;
+    if (!multi_vector_) {
+      magnitude = kDefaultMagnitude;
+      record_magnitude = &magnitude.value();
+    }
+    auto norm_record = NormalizeRecord(record, record_magnitude);
     return StringInternStore::Intern(
         absl::string_view((const char *)norm_record.data(), norm_record.size()),
-        vector_allocator_.get());
+        allocator);
   }
-  return StringInternStore::Intern(record, vector_allocator_.get());
+  return StringInternStore::Intern(record, allocator);
 }
 
 absl::StatusOr<bool> VectorBase::AddRecord(const InternedStringPtr &key,
@@ -191,9 +223,10 @@ absl::StatusOr<bool> VectorBase::AddRecord(const InternedStringPtr &key,
 
 absl::StatusOr<uint64_t> VectorBase::GetInternalId(
     const InternedStringPtr &key) const {
-  absl::ReaderMutexLock lock(&key_to_metadata_mutex_);
-  auto it = tracked_metadata_by_key_.find(key);
-  if (it == tracked_metadata_by_key_.end()) {
+  auto &shard = ShardFor(key);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  auto it = shard.metadata_by_key.find(key);
+  if (it == shard.metadata_by_key.end()) {
     return absl::InvalidArgumentError("Record was not found");
   }
   return it->second.internal_id;
@@ -201,8 +234,9 @@ absl::StatusOr<uint64_t> VectorBase::GetInternalId(
 
 absl::StatusOr<uint64_t> VectorBase::GetInternalIdDuringSearch(
     const InternedStringPtr &key) const {
-  auto it = tracked_metadata_by_key_.find(key);
-  if (it == tracked_metadata_by_key_.end()) {
+  const auto &shard = ShardFor(key);
+  auto it = shard.metadata_by_key.find(key);
+  if (it == shard.metadata_by_key.end()) {
     return absl::InvalidArgumentError("Record was not found");
   }
   return it->second.internal_id;
@@ -210,11 +244,11 @@ absl::StatusOr<uint64_t> VectorBase::GetInternalIdDuringSearch(
 
 absl::StatusOr<InternedStringPtr> VectorBase::GetKeyDuringSearch(
     uint64_t internal_id) const {
-  auto it = key_by_internal_id_.find(internal_id);
-  if (it == key_by_internal_id_.end()) {
+  const InternedStringPtr *key = key_by_internal_id_.Get(internal_id);
+  if (key == nullptr) {
     return absl::InvalidArgumentError("Record was not found");
   }
-  return it->second;
+  return *key;
 }
 
 absl::StatusOr<bool> VectorBase::ModifyRecord(const InternedStringPtr &key,
@@ -272,18 +306,27 @@ absl::StatusOr<std::vector<Neighbor>> VectorBase::CreateReply(
 
 absl::StatusOr<std::vector<char>> VectorBase::GetValue(
     const InternedStringPtr &key) const {
-  auto it = tracked_metadata_by_key_.find(key);
-  if (it == tracked_metadata_by_key_.end()) {
-    return absl::NotFoundError("Record was not found");
+  TrackedKeyMetadata metadata;
+  {
+    auto &shard = ShardFor(key);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.metadata_by_key.find(key);
+    if (it == shard.metadata_by_key.end()) {
+      return absl::NotFoundError("Record was not found");
+    }
+    metadata = it->second;
+  }
+  if (multi_vector_) {
+    return GetMultiVectorValueImpl(metadata.internal_id);
   }
   std::vector<char> result;
-  char *value = GetValueImpl(it->second.internal_id);
+  char *value = GetValueImpl(metadata.internal_id);
   if (normalize_) {
-    if (it->second.magnitude < 0) {
+    if (metadata.magnitude < 0) {
       return absl::InternalError("Magnitude is not initialized");
     }
     result = DenormalizeVector(absl::string_view(value, GetVectorDataSize()),
-                               GetDataTypeSize(), it->second.magnitude);
+                               GetDataTypeSize(), metadata.magnitude);
   } else {
     result.assign(value, value + GetVectorDataSize());
   }
@@ -306,24 +349,57 @@ absl::StatusOr<std::optional<uint64_t>> VectorBase::UnTrackKey(
   if (key->Str().empty()) {
     return std::nullopt;
   }
-  absl::WriterMutexLock lock(&key_to_metadata_mutex_);
-  auto it = tracked_metadata_by_key_.find(key);
-  if (it == tracked_metadata_by_key_.end()) {
-    return std::nullopt;
+  uint64_t id;
+  {
+    auto &shard = ShardFor(key);
+    absl::WriterMutexLock lock(&shard.mutex);
+    auto it = shard.metadata_by_key.find(key);
+    if (it == shard.metadata_by_key.end()) {
+      return std::nullopt;
+    }
+    id = it->second.internal_id;
+    if (key_by_internal_id_.Get(id) != &it->first) {
+      return absl::InvalidArgumentError(
+          "Error while untracking key - key was not found in "
+          "key_by_internal_id_ but in metadata_by_key");
+    }
+    // Unpublish the id before the key it points at is erased.
+    key_by_internal_id_.Set(id, nullptr);
+    UnTrackVector(id);
+    shard.metadata_by_key.erase(it);
   }
-  auto id = it->second.internal_id;
-  UnTrackVector(id);
-  tracked_metadata_by_key_.erase(it);
-  auto key_by_internal_id_it = key_by_internal_id_.find(id);
-  if (key_by_internal_id_it == key_by_internal_id_.end()) {
-    return absl::InvalidArgumentError(
-        "Error while untracking key - key was not found in key_by_internal_id_ "
-        "but in internal_by_key_");
+  absl::MutexLock lock(&numeric_columns_mutex_);
+  for (auto &[_, column] : numeric_columns_) {
+    column.Clear(id);
   }
-  key_by_internal_id_.erase(key_by_internal_id_it);
   return id;
 }
 
+void VectorBase::UpdateNumericColumn(const InternedStringPtr &key,
+                                     const Numeric *numeric_index,
+                                     std::optional<double> value) {
+  auto internal_id = GetInternalId(key);
+  if (!internal_id.ok()) {
+    return;
+  }
+  absl::MutexLock lock(&numeric_columns_mutex_);
+  if (value.has_value()) {
+    numeric_columns_[numeric_index].Set(*internal_id, *value);
+  } else if (auto column_it = numeric_columns_.find(numeric_index);
+             column_it != numeric_columns_.end()) {
+    column_it->second.Clear(*internal_id);
+  }
+}
+
+const NumericColumn *VectorBase::GetNumericColumnDuringSearch(
+    const Numeric *numeric_index) const {
+  auto it = numeric_columns_.find(numeric_index);
+  if (it == numeric_columns_.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
 char *VectorBase::TrackVector(uint64_t internal_id, char *vector, size_t len) {
   auto interned_vector = StringInternStore::Intern(
       absl::string_view(vector, len), vector_allocator_.get());
@@ -331,15 +407,124 @@ char *VectorBase::TrackVector(uint64_t internal_id, char *vector, size_t len) {
   return (char *)interned_vector->Str().data();
 }
 
+void VectorBase::AddVectorOwner(uint64_t internal_id,
+                                const InternedStringPtr &vector) {
+  if (!vector_allocator_ || multi_vector_) {
+    return;
+  }
+  absl::MutexLock lock(&vector_owners_mutex_);
+  auto &owners = vector_owners_[vector->Str().data()];
+  if (!owners.vector) {
+    owners.vector = vector;
+  }
+  owners.internal_ids.push_back(internal_id);
+}
+
+void VectorBase::RemoveVectorOwner(uint64_t internal_id,
+                                   const InternedStringPtr &vector) {
+  if (!vector_allocator_ || multi_vector_) {
+    return;
+  }
+  absl::MutexLock lock(&vector_owners_mutex_);
+  auto it = vector_owners_.find(vector->Str().data());
+  if (it == vector_owners_.end()) {
+    return;
+  }
+  auto &internal_ids = it->second.internal_ids;
+  auto id_it = std::find(internal_ids.begin(), internal_ids.end(), internal_id);
+  if (id_it != internal_ids.end()) {
+    internal_ids.erase(id_it);
+  }
+  if (internal_ids.empty()) {
+    vector_owners_.erase(it);
+  }
+}
+
+bool VectorBase::MoveVector(const char *from, char *to) {
+  absl::MutexLock lock(&vector_owners_mutex_);
+  auto it = vector_owners_.find(from);
+  if (it == vector_owners_.end()) {
+    return false;
+  }
+  // The index holds a reference per internal id and the entry holds one. The
+  // vector externalizer may hold more for the keys, compaction runs on the
+  // main thread where its entries can be read.
+  size_t owned_refs = it->second.internal_ids.size() + 1;
+  for (auto internal_id : it->second.internal_ids) {
+    if (auto key = key_by_internal_id_.Get(internal_id)) {
+      owned_refs += VectorExternalizer::Instance().CountReferences(
+          *key, it->second.vector);
+    }
+  }
+  if (!StringInternStore::Relocate(it->second.vector, from, to, owned_refs)) {
+    return false;
+  }
+  for (auto internal_id : it->second.internal_ids) {
+    RelocateVector(internal_id, from, to);
+  }
+  auto owners = std::move(it->second);
+  vector_owners_.erase(it);
+  vector_owners_.emplace(to, std::move(owners));
+  compacted_vectors_.push_back(from);
+  return true;
+}
+
+// Number of live vectors of the evacuated chunk visited between budget checks.
+constexpr size_t kCompactBatchSize = 32;
+
+bool VectorBase::CompactVectors(DefragContext &ctx) {
+  if (!vector_allocator_) {
+    return true;
+  }
+  auto chunk = vector_allocator_->BeginCompaction();
+  if (chunk.empty()) {
+    return true;
+  }
+  if (compaction_cursor_.chunk != chunk.data()) {
+    compaction_cursor_ = {chunk.data(), 0, 0};
+  }
+  size_t moved = 0;
+  bool done = false;
+  while (!done && !ctx.ShouldStop()) {
+    done = vector_allocator_->Compact(
+        compaction_cursor_.position, kCompactBatchSize,
+        [this, &moved](const char *from, char *to) {
+          if (!MoveVector(from, to)) {
+            return false;
+          }
+          ++moved;
+          return true;
+        });
+  }
+  Metrics::GetStats().defrag_vectors_moved_cnt += moved;
+  compaction_cursor_.moved += moved;
+  // The caller keeps queries out, none is left that might read the old copies.
+  for (auto vector : compacted_vectors_) {
+    Allocator::Free(const_cast<char *>(vector));
+  }
+  compacted_vectors_.clear();
+  if (!done) {
+    return false;
+  }
+  if (compaction_cursor_.moved == 0) {
+    // What is left in the chunk is shared with other indexes, leave it be.
+    // Otherwise the chunk is released with the last moved vector.
+    vector_allocator_->EndCompaction();
+  }
+  compaction_cursor_ = {};
+  return true;
+}
+
 absl::StatusOr<uint64_t> VectorBase::TrackKey(const InternedStringPtr &key,
                                               float magnitude,
                                               const InternedStringPtr &vector) {
   if (key->Str().empty()) {
     return absl::InvalidArgumentError("key can't be empty");
   }
-  absl::WriterMutexLock lock(&key_to_metadata_mutex_);
-  auto id = inc_id_++;
-  auto [_, succ] = tracked_metadata_by_key_.insert(
+  auto &shard = ShardFor(key);
+  absl::WriterMutexLock lock(&shard.mutex);
+  auto id = inc_id_.fetch_add(1, std::memory_order_relaxed);
+  auto [it, succ] = shard.metadata_by_key.insert(
       {key, {.internal_id = id, .magnitude = magnitude}});
 
   if (!succ) {
@@ -347,7 +532,7 @@ absl::StatusOr<uint64_t> VectorBase::TrackKey(const InternedStringPtr &key,
         absl::StrCat("Embedding id already exists: ", key->Str()));
   }
   TrackVector(id, vector);
-  key_by_internal_id_.insert({id, key});
+  key_by_internal_id_.Set(id, &it->first);
   return id;
 }
 // Return an error if the key is empty or not being tracked.
@@ -361,9 +546,10 @@ absl::StatusOr<bool> VectorBase::UpdateMetadata(
   }
   uint64_t internal_id;
   {
-    absl::WriterMutexLock lock(&key_to_metadata_mutex_);
-    auto it = tracked_metadata_by_key_.find(key);
-    if (it == tracked_metadata_by_key_.end()) {
+    auto &shard = ShardFor(key);
+    absl::WriterMutexLock lock(&shard.mutex);
+    auto it = shard.metadata_by_key.find(key);
+    if (it == shard.metadata_by_key.end()) {
       return absl::InvalidArgumentError(
           absl::StrCat("Embedding id not found: ", key->Str()));
     }
@@ -391,12 +577,11 @@ int VectorBase::RespondWithInfo(ValkeyModuleCtx *ctx) const {
   ValkeyModule_ReplyWithSimpleString(
       ctx, LookupKeyByValue(*kDistanceMetricByStr, distance_metric_).data());
   ValkeyModule_ReplyWithSimpleString(ctx, "size");
-  {
-    absl::MutexLock lock(&key_to_metadata_mutex_);
-    ValkeyModule_ReplyWithCString(
-        ctx, std::to_string(key_by_internal_id_.size()).c_str());
-  }
-  int array_len = 8;
+  ValkeyModule_ReplyWithCString(ctx,
+                                std::to_string(GetTrackedKeyCount()).c_str());
+  ValkeyModule_ReplyWithSimpleString(ctx, "id_map_memory");
+  ValkeyModule_ReplyWithLongLong(ctx, GetIdMapMemoryUsage());
+  int array_len = 10;
   array_len += RespondWithInfoImpl(ctx);
   ValkeyModule_ReplySetArrayLength(ctx, array_len);
 
@@ -410,16 +595,18 @@ absl::Status VectorBase::SaveIndex(RDBChunkOutputStream chunked_out) const {
 
 absl::Status VectorBase::SaveTrackedKeys(
     RDBChunkOutputStream chunked_out) const {
-  absl::ReaderMutexLock lock(&key_to_metadata_mutex_);
-  for (const auto &[key, metadata] : tracked_metadata_by_key_) {
-    data_model::TrackedKeyMetadata metadata_pb;
-    metadata_pb.set_key(key->Str());
-    metadata_pb.set_internal_id(metadata.internal_id);
-    metadata_pb.set_magnitude(metadata.magnitude);
-    auto metadata_pb_str = metadata_pb.SerializeAsString();
-    VMSDK_RETURN_IF_ERROR(
-        chunked_out.SaveChunk(metadata_pb_str.data(), metadata_pb_str.size()))
-        << "Error saving key_by_internal_id_ entry";
+  for (const auto &shard : key_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    for (const auto &[key, metadata] : shard.metadata_by_key) {
+      data_model::TrackedKeyMetadata metadata_pb;
+      metadata_pb.set_key(key->Str());
+      metadata_pb.set_internal_id(metadata.internal_id);
+      metadata_pb.set_magnitude(metadata.magnitude);
+      auto metadata_pb_str = metadata_pb.SerializeAsString();
+      VMSDK_RETURN_IF_ERROR(chunked_out.SaveChunk(metadata_pb_str.data(),
+                                                  metadata_pb_str.size()))
+          << "Error saving tracked key metadata";
+    }
   }
   return absl::OkStatus();
 }
@@ -453,7 +640,6 @@ void VectorBase::ExternalizeVector(ValkeyModuleCtx *ctx,
 absl::Status VectorBase::LoadTrackedKeys(
     ValkeyModuleCtx *ctx, const AttributeDataType *attribute_data_type,
     SupplementalContentChunkIter &&iter) {
-  absl::WriterMutexLock lock(&key_to_metadata_mutex_);
   while (iter.HasNext()) {
     VMSDK_ASSIGN_OR_RETURN(auto metadata_str, iter.Next(),
                            _ << "Error loading metadata");
@@ -462,29 +648,33 @@ absl::Status VectorBase::LoadTrackedKeys(
       return absl::InvalidArgumentError("Error parsing metadata from proto");
     }
     auto interned_key = StringInternStore::Intern(tracked_key_metadata.key());
-    tracked_metadata_by_key_.insert(
-        {interned_key,
-         {.internal_id = tracked_key_metadata.internal_id(),
-          .magnitude = tracked_key_metadata.magnitude()}});
-    key_by_internal_id_.insert(
-        {tracked_key_metadata.internal_id(), interned_key});
-    ExternalizeVector(ctx, attribute_data_type, tracked_key_metadata.key(),
-                      attribute_identifier_);
+    {
+      auto &shard = ShardFor(interned_key);
+      absl::WriterMutexLock lock(&shard.mutex);
+      auto [it, _] = shard.metadata_by_key.insert(
+          {interned_key,
+           {.internal_id = tracked_key_metadata.internal_id(),
+            .magnitude = tracked_key_metadata.magnitude()}});
+      key_by_internal_id_.Set(tracked_key_metadata.internal_id(), &it->first);
+    }
+    if (!multi_vector_) {
+      ExternalizeVector(ctx, attribute_data_type, tracked_key_metadata.key(),
+                        attribute_identifier_);
+    }
   }
   // Use max label from label_lookup_
-  inc_id_ = GetMaxInternalLabel();
-  ++inc_id_;
+  inc_id_.store(GetMaxInternalLabel() + 1, std::memory_order_relaxed);
   return absl::OkStatus();
 }
 
 std::unique_ptr<data_model::Index> VectorBase::ToProto() const {
-  absl::ReaderMutexLock lock(&key_to_metadata_mutex_);
   auto index_proto = std::make_unique<data_model::Index>();
   auto vector_index = std::make_unique<data_model::VectorIndex>();
   vector_index->set_normalize(normalize_);
   vector_index->set_distance_metric(distance_metric_);
   vector_index->set_dimension_count(dimensions_);
   vector_index->set_initial_cap(GetCapacity());
+  vector_index->set_multi_vector(multi_vector_);
   ToProtoImpl(vector_index.get());
   index_proto->set_allocated_vector_index(vector_index.release());
   return index_proto;
@@ -528,7 +718,15 @@ vmsdk::UniqueValkeyString VectorBase::NormalizeStringRecord(
     vmsdk::UniqueValkeyString record) const {
   CHECK_EQ(GetDataTypeSize(), sizeof(float));
   auto record_str = vmsdk::ToStringView(record.get());
-  if (absl::ConsumePrefix(&record_str, "[")) {
+  std::string flattened;
+  if (multi_vector_) {
+    // A JSON array of vectors is read as the concatenation of its vectors.
+    flattened = std::string(record_str);
+    flattened.erase(std::remove_if(flattened.begin(), flattened.end(),
+                                   [](char c) { return c == '[' || c == ']'; }),
+                    flattened.end());
+    record_str = flattened;
+  } else if (absl::ConsumePrefix(&record_str, "[")) {
     absl::ConsumeSuffix(&record_str, "]");
   }
   std::vector<std::string> float_strings =
@@ -546,16 +744,29 @@ vmsdk::UniqueValkeyString VectorBase::NormalizeStringRecord(
 }
 
 size_t VectorBase::GetTrackedKeyCount() const {
-  absl::ReaderMutexLock lock(&key_to_metadata_mutex_);
-  return key_by_internal_id_.size();
+  size_t count = 0;
+  for (const auto &shard : key_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    count += shard.metadata_by_key.size();
+  }
+  return count;
+}
+
+size_t VectorBase::GetIdMapMemoryUsage() const {
+  size_t bytes = key_by_internal_id_.GetAllocatedBytes();
+  absl::MutexLock lock(&numeric_columns_mutex_);
+  for (const auto &[_, column] : numeric_columns_) {
+    bytes += column.GetAllocatedBytes();
+  }
+  return bytes;
 }
 
 size_t VectorBase::GetUnTrackedKeyCount() const { return 0; }
 
 bool VectorBase::IsTracked(const InternedStringPtr &key) const {
-  absl::ReaderMutexLock lock(&key_to_metadata_mutex_);
-  auto it = tracked_metadata_by_key_.find(key);
-  return (it != tracked_metadata_by_key_.end());
+  auto &shard = ShardFor(key);
+  absl::ReaderMutexLock lock(&shard.mutex);
+  return shard.metadata_by_key.contains(key);
 }
 
 bool VectorBase::IsUnTracked(const InternedStringPtr &key) const {
@@ -566,9 +777,11 @@ void VectorBase::UnTrack(const InternedStringPtr &key) {}
 
 absl::Status VectorBase::ForEachTrackedKey(
     absl::AnyInvocable<absl::Status(const InternedStringPtr &)> fn) const {
-  absl::MutexLock lock(&key_to_metadata_mutex_);
-  for (const auto &[key, _] : tracked_metadata_by_key_) {
-    VMSDK_RETURN_IF_ERROR(fn(key));
+  for (const auto &shard : key_shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex);
+    for (const auto &[key, _] : shard.metadata_by_key) {
+      VMSDK_RETURN_IF_ERROR(fn(key));
+    }
   }
   return absl::OkStatus();
 }
@@ -8,6 +8,7 @@
 #ifndef VALKEYSEARCH_SRC_INDEXES_VECTOR_BASE_H_
 #define VALKEYSEARCH_SRC_INDEXES_VECTOR_BASE_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -19,9 +20,11 @@
 #include <vector>
 
 #include "absl/base/no_destructor.h"
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -30,9 +33,11 @@
 #include "src/attribute_data_type.h"
 #include "src/index_schema.pb.h"
 #include "src/indexes/index_base.h"
+#include "src/indexes/numeric_column.h"
 #include "src/query/predicate.h"
 #include "src/rdb_serialization.h"
 #include "src/utils/allocator.h"
+#include "src/utils/segmented_array.h"
 #include "src/utils/string_interning.h"
 #include "third_party/hnswlib/hnswlib.h"
 #include "third_party/hnswlib/iostream.h"
@@ -122,44 +127,46 @@ absl::string_view LookupKeyByValue(
 class VectorBase : public IndexBase, public hnswlib::VectorTracker {
  public:
   absl::StatusOr<bool> AddRecord(const InternedStringPtr& key,
-                                 absl::string_view record) override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+                                 absl::string_view record) override;
   absl::StatusOr<bool> RemoveRecord(const InternedStringPtr& key,
                                     indexes::DeletionType deletion_type =
-                                        indexes::DeletionType::kNone) override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+                                        indexes::DeletionType::kNone) override;
   absl::StatusOr<bool> ModifyRecord(const InternedStringPtr& key,
-                                    absl::string_view record) override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+                                    absl::string_view record) override;
   virtual size_t GetCapacity() const = 0;
   bool GetNormalize() const { return normalize_; }
+  // A multi-vector record holds up to kMaxVectorsPerKey vectors, each of which
+  // is a separate point of the index.
+  static constexpr int kMultiVectorLabelBits = 8;
+  static constexpr size_t kMaxVectorsPerKey = size_t{1}
+                                              << kMultiVectorLabelBits;
+  bool IsMultiVector() const { return multi_vector_; }
   std::unique_ptr<data_model::Index> ToProto() const override;
   absl::Status SaveIndex(RDBChunkOutputStream chunked_out) const override;
-  absl::Status SaveTrackedKeys(RDBChunkOutputStream chunked_out) const
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+  absl::Status SaveTrackedKeys(RDBChunkOutputStream chunked_out) const;
   absl::Status LoadTrackedKeys(ValkeyModuleCtx* ctx,
                                const AttributeDataType* attribute_data_type,
                                SupplementalContentChunkIter&& iter);
 
   uint32_t GetMutationWeight() const override;
 
-  size_t GetTrackedKeyCount() const override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
-  size_t GetUnTrackedKeyCount() const override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
-  bool IsTracked(const InternedStringPtr& key) const override
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+  size_t GetTrackedKeyCount() const override;
+  // Bytes held by the structures indexed by internal id.
+  size_t GetIdMapMemoryUsage() const;
+  size_t GetUnTrackedKeyCount() const override;
+  bool IsTracked(const InternedStringPtr& key) const override;
   bool IsUnTracked(const InternedStringPtr& key) const override;
   void UnTrack(const InternedStringPtr& key) override;
   absl::Status ForEachTrackedKey(
       absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn)
-      const override ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+      const override;
   absl::Status ForEachUnTrackedKey(
       absl::AnyInvocable<absl::Status(const InternedStringPtr&)> fn)
-      const override ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+      const override;
 
+  // Lock free, safe to call concurrently with mutations of other keys.
   absl::StatusOr<InternedStringPtr> GetKeyDuringSearch(
-      uint64_t internal_id) const ABSL_NO_THREAD_SAFETY_ANALYSIS;
+      uint64_t internal_id) const;
   bool AddPrefilteredKey(
       absl::string_view query, uint64_t count, const InternedStringPtr& key,
       std::priority_queue<std::pair<float, hnswlib::labeltype>>& results,
@@ -169,8 +176,8 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
   template <typename T>
   absl::StatusOr<std::vector<Neighbor>> CreateReply(
       std::priority_queue<std::pair<T, hnswlib::labeltype>>& knn_res);
-  absl::StatusOr<std::vector<char>> GetValue(const InternedStringPtr& key) const
-      ABSL_NO_THREAD_SAFETY_ANALYSIS;
+  absl::StatusOr<std::vector<char>> GetValue(
+      const InternedStringPtr& key) const;
   int GetVectorDataSize() const { return GetDataTypeSize() * dimensions_; }
   char* TrackVector(uint64_t internal_id, char* vector, size_t len) override;
   InternedStringPtr InternVector(absl::string_view record,
@@ -178,6 +185,17 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
   virtual uint64_t GetMaxInternalLabel() const { return 0; }
   virtual size_t GetLabelCount() const { return 0; }
 
+  // Mirrors the value of a Numeric attribute for a tracked key into a dense
+  // column indexed by internal id, so that numeric filters can be evaluated
+  // for vector candidates without resolving the key. A nullopt value clears
+  // the entry. No-op if the key is not tracked by this index.
+  void UpdateNumericColumn(const InternedStringPtr& key,
+                           const Numeric* numeric_index,
+                           std::optional<double> value)
+      ABSL_LOCKS_EXCLUDED(numeric_columns_mutex_);
+  const NumericColumn* GetNumericColumnDuringSearch(
+      const Numeric* numeric_index) const ABSL_NO_THREAD_SAFETY_ANALYSIS;
+
  protected:
   VectorBase(IndexerType indexer_type, int dimensions,
              data_model::AttributeDataType attribute_data_type,
@@ -195,10 +213,17 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
   }
 
   bool IsValidSizeVector(absl::string_view record) {
-    const auto data_type_size = GetDataTypeSize();
-    int32_t dim = record.size() / GetDataTypeSize();
-    return dim == dimensions_ && (record.size() % data_type_size == 0);
+    const size_t vector_size = GetVectorDataSize();
+    if (multi_vector_) {
+      return !record.empty() && record.size() % vector_size == 0 &&
+             record.size() / vector_size <= kMaxVectorsPerKey;
+    }
+    return record.size() == vector_size;
   }
+  // Normalizes a record, treating each vector of a multi-vector record
+  // independently.
+  std::vector<char> NormalizeRecord(absl::string_view record,
+                                    float* magnitude = nullptr) const;
   int RespondWithInfo(ValkeyModuleCtx* ctx) const override;
   template <typename T>
   void Init(int dimensions, data_model::DistanceMetric distance_metric,
@@ -221,10 +246,15 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
                          absl::string_view key_cstr,
                          absl::string_view attribute_identifier);
   virtual char* GetValueImpl(uint64_t internal_id) const = 0;
+  virtual absl::StatusOr<std::vector<char>> GetMultiVectorValueImpl(
+      uint64_t internal_id) const {
+    return absl::UnimplementedError("Multi-vector records are not supported");
+  }
 
   int dimensions_;
   std::string attribute_identifier_;
   bool normalize_{false};
+  bool multi_vector_{false};
   data_model::AttributeDataType attribute_data_type_;
   data_model::DistanceMetric distance_metric_;
   virtual absl::StatusOr<std::pair<float, hnswlib::labeltype>>
@@ -235,24 +265,36 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
   virtual bool IsVectorMatch(uint64_t internal_id,
                              const InternedStringPtr& vector) = 0;
   virtual void UnTrackVector(uint64_t internal_id) = 0;
+  // Points the point of internal_id at `to` if its vector is at `from`.
+  virtual void RelocateVector(uint64_t internal_id, const char* from,
+                              char* to) = 0;
+  // Maintain the back-references of the vectors tracked by the index, called
+  // for each reference taken or dropped by TrackVector and UnTrackVector.
+  void AddVectorOwner(uint64_t internal_id, const InternedStringPtr& vector)
+      ABSL_LOCKS_EXCLUDED(vector_owners_mutex_);
+  void RemoveVectorOwner(uint64_t internal_id, const InternedStringPtr& vector)
+      ABSL_LOCKS_EXCLUDED(vector_owners_mutex_);
+  // Evacuates the sparsest chunk of the vector allocator, resuming where the
+  // previous call stopped, and returns whether the chunk is done. Vectors are
+  // only moved if this index holds all references to them. The caller keeps
+  // queries and the mutations of the index out.
+  bool CompactVectors(DefragContext& ctx)
+      ABSL_LOCKS_EXCLUDED(vector_owners_mutex_);
 
  private:
   absl::StatusOr<uint64_t> TrackKey(const InternedStringPtr& key,
                                     float magnitude,
-                                    const InternedStringPtr& vector)
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+                                    const InternedStringPtr& vector);
   absl::StatusOr<std::optional<uint64_t>> UnTrackKey(
-      const InternedStringPtr& key) ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+      const InternedStringPtr& key);
   absl::StatusOr<bool> UpdateMetadata(const InternedStringPtr& key,
                                       float magnitude,
-                                      const InternedStringPtr& vector)
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
-  absl::StatusOr<uint64_t> GetInternalId(const InternedStringPtr& key) const
-      ABSL_LOCKS_EXCLUDED(key_to_metadata_mutex_);
+                                      const InternedStringPtr& vector);
+  absl::StatusOr<uint64_t> GetInternalId(const InternedStringPtr& key) const;
+  // Queries and mutations never overlap under the time-sliced mutex, so the
+  // search path looks the key up without taking its shard lock.
   absl::StatusOr<uint64_t> GetInternalIdDuringSearch(
       const InternedStringPtr& key) const ABSL_NO_THREAD_SAFETY_ANALYSIS;
-  absl::flat_hash_map<uint64_t, InternedStringPtr> key_by_internal_id_
-      ABSL_GUARDED_BY(key_to_metadata_mutex_);
   struct TrackedKeyMetadata {
     uint64_t internal_id;
     // If normalize_ is false, this will be -1.0f. Otherwise, it will be the
@@ -261,15 +303,62 @@ class VectorBase : public IndexBase, public hnswlib::VectorTracker {
     // from the old RDB format that didn't include magnitudes).
     float magnitude;
   };
-
-  InternedStringHashMap<TrackedKeyMetadata> tracked_metadata_by_key_
-      ABSL_GUARDED_BY(key_to_metadata_mutex_);
-  uint64_t inc_id_ ABSL_GUARDED_BY(key_to_metadata_mutex_){0};
-  mutable absl::Mutex key_to_metadata_mutex_;
+  //
+  // The key to metadata map is hash-partitioned into independently locked
+  // shards, so that mutations of different keys don't serialize on a single
+  // mutex and search-time lookups only take a shared lock on one shard. A node
+  // map is used so that the address of a tracked key is stable until it is
+  // untracked, which lets key_by_internal_id_ point at it.
+  //
+  static constexpr size_t kNumKeyShards = 16;
+  struct alignas(ABSL_CACHELINE_SIZE) KeyShard {
+    InternedStringNodeHashMap<TrackedKeyMetadata> metadata_by_key
+        ABSL_GUARDED_BY(mutex);
+    mutable absl::Mutex mutex;
+  };
+  KeyShard& ShardFor(const InternedStringPtr& key) const {
+    return key_shards_[(key.Hash() >> 32) % kNumKeyShards];
+  }
+  mutable KeyShard key_shards_[kNumKeyShards];
+  // Maps an internal id to its tracked key in key_shards_. Published after the
+  // key is inserted and cleared before it is erased, so search-time
+  // translation is a few acquire loads without a lock or a hash lookup. Ids
+  // are never reused, since hnswlib keeps the labels of deleted points, so
+  // pages whose ids are all untracked are freed.
+  utils::SegmentedArray<const InternedStringPtr*> key_by_internal_id_;
+  std::atomic<uint64_t> inc_id_{0};
+  absl::flat_hash_map<const Numeric*, NumericColumn> numeric_columns_
+      ABSL_GUARDED_BY(numeric_columns_mutex_);
+  mutable absl::Mutex numeric_columns_mutex_;
   absl::StatusOr<std::pair<float, hnswlib::labeltype>>
   ComputeDistanceFromRecord(const InternedStringPtr& key,
                             absl::string_view query) const;
   UniqueFixedSizeAllocatorPtr vector_allocator_{nullptr, nullptr};
+  bool MoveVector(const char* from, char* to)
+      ABSL_LOCKS_EXCLUDED(vector_owners_mutex_);
+  struct VectorOwners {
+    // The entry holds a reference of its own.
+    InternedStringPtr vector;
+    // The internal id of each reference held by the index.
+    absl::InlinedVector<uint64_t, 1> internal_ids;
+  };
+  // Back-references from the address of each tracked vector to its references
+  // in the index, so that compaction moves a vector and repoints the index
+  // without scanning it.
+  absl::flat_hash_map<const char*, VectorOwners> vector_owners_
+      ABSL_GUARDED_BY(vector_owners_mutex_);
+  mutable absl::Mutex vector_owners_mutex_;
+  // Where CompactVectors resumes in the chunk being evacuated. Only accessed
+  // by the defrag increments.
+  struct CompactionCursor {
+    const char* chunk{nullptr};
+    size_t position{0};
+    size_t moved{0};
+  };
+  CompactionCursor compaction_cursor_;
+  // Old addresses of the vectors moved by CompactVectors, released before it
+  // returns. Only accessed by the defrag increments.
+  std::vector<const char*> compacted_vectors_;
 };
 
 class PrefilterEvaluator : public query::Evaluator {
@@ -291,6 +380,8 @@ class PrefilterEvaluator : public query::Evaluator {
       const query::TagPredicate& predicate) override;
   query::EvaluationResult EvaluateNumeric(
       const query::NumericPredicate& predicate) override;
+  query::EvaluationResult EvaluateGeo(
+      const query::GeoPredicate& predicate) override;
   query::EvaluationResult EvaluateText(const query::TextPredicate& predicate,
                                        bool require_positions) override;
   const valkey_search::indexes::text::TextIndex* text_index_;
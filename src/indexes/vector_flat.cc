@@ -76,7 +76,12 @@ template <typename T>
 void VectorFlat<T>::TrackVector(uint64_t internal_id,
                                 const InternedStringPtr &vector) {
   absl::MutexLock lock(&tracked_vectors_mutex_);
-  tracked_vectors_[internal_id] = vector;
+  auto &tracked = tracked_vectors_[internal_id];
+  if (tracked) {
+    RemoveVectorOwner(internal_id, tracked);
+  }
+  tracked = vector;
+  AddVectorOwner(internal_id, vector);
 }
 
 template <typename T>
@@ -93,7 +98,36 @@ bool VectorFlat<T>::IsVectorMatch(uint64_t internal_id,
 template <typename T>
 void VectorFlat<T>::UnTrackVector(uint64_t internal_id) {
   absl::MutexLock lock(&tracked_vectors_mutex_);
-  tracked_vectors_.erase(internal_id);
+  auto it = tracked_vectors_.find(internal_id);
+  if (it == tracked_vectors_.end()) {
+    return;
+  }
+  RemoveVectorOwner(internal_id, it->second);
+  tracked_vectors_.erase(it);
+}
+
+template <typename T>
+void VectorFlat<T>::RelocateVector(uint64_t internal_id, const char *from,
+                                   char *to) {
+  algo_->relocateData(internal_id, from, to);
+}
+
+template <typename T>
+bool VectorFlat<T>::CompactMemory(DefragContext &ctx) {
+  // The resize lock keeps the mutations of the index out while the caller
+  // keeps queries out, and the tracked vectors lock keeps IsVectorMatch from
+  // reading a vector while it moves. The main thread doesn't wait for
+  // mutations in flight, the increment is retried instead.
+  if (!resize_mutex_.TryLock()) {
+    return false;
+  }
+  bool done = false;
+  if (tracked_vectors_mutex_.TryLock()) {
+    done = CompactVectors(ctx);
+    tracked_vectors_mutex_.Unlock();
+  }
+  resize_mutex_.Unlock();
+  return done;
 }
 
 template <typename T>
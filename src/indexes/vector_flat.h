@@ -61,6 +61,8 @@ class VectorFlat : public VectorBase {
       cancel::Token& cancellation_token,
       std::unique_ptr<hnswlib::BaseFilterFunctor> filter = nullptr)
       ABSL_LOCKS_EXCLUDED(resize_mutex_);
+  bool CompactMemory(DefragContext& ctx) override
+      ABSL_LOCKS_EXCLUDED(resize_mutex_, tracked_vectors_mutex_);
 
  protected:
   absl::Status ResizeIfFull() ABSL_LOCKS_EXCLUDED(resize_mutex_);
@@ -90,6 +92,9 @@ class VectorFlat : public VectorBase {
       ABSL_LOCKS_EXCLUDED(tracked_vectors_mutex_);
   void UnTrackVector(uint64_t internal_id) override
       ABSL_LOCKS_EXCLUDED(tracked_vectors_mutex_);
+  // Called by CompactVectors, under CompactMemory's exclusive locks.
+  void RelocateVector(uint64_t internal_id, const char* from,
+                      char* to) override ABSL_NO_THREAD_SAFETY_ANALYSIS;
 
  private:
   VectorFlat(int dimensions, data_model::DistanceMetric distance_metric,
@@ -7,11 +7,14 @@
 
 #include "src/indexes/vector_hnsw.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <exception>
+#include <limits>
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
 #include <optional>
@@ -21,6 +24,7 @@
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -88,6 +92,7 @@ absl::StatusOr<std::shared_ptr<VectorHNSW<T>>> VectorHNSW<T>::Create(
     auto index = std::shared_ptr<VectorHNSW<T>>(
         new VectorHNSW<T>(vector_index_proto.dimension_count(),
                           attribute_identifier, attribute_data_type));
+    index->multi_vector_ = vector_index_proto.multi_vector();
     index->Init(vector_index_proto.dimension_count(),
                 vector_index_proto.distance_metric(), index->space_);
     const auto &hnsw_proto = vector_index_proto.hnsw_algorithm();
@@ -110,12 +115,29 @@ void VectorHNSW<T>::TrackVector(uint64_t internal_id,
                                 const InternedStringPtr &vector) {
   absl::MutexLock lock(&tracked_vectors_mutex_);
   tracked_vectors_.push_back(vector);
+  AddVectorOwner(internal_id, vector);
 }
 
 template <typename T>
 bool VectorHNSW<T>::IsVectorMatch(uint64_t internal_id,
                                   const InternedStringPtr &vector) {
   absl::ReaderMutexLock lock(&resize_mutex_);
+  if (multi_vector_) {
+    auto points = GetMultiVectorPoints(internal_id, false);
+    absl::string_view record = vector->Str();
+    const size_t vector_size = GetVectorDataSize();
+    if (points.size() * vector_size != record.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (record.substr(i * vector_size, vector_size) !=
+          absl::string_view(algo_->getDataByInternalId(points[i]),
+                            vector_size)) {
+        return false;
+      }
+    }
+    return true;
+  }
   {
     std::unique_lock<std::mutex> lock_label(
         algo_->getLabelOpMutex(internal_id));
@@ -134,6 +156,50 @@ bool VectorHNSW<T>::IsVectorMatch(uint64_t internal_id,
 template <typename T>
 void VectorHNSW<T>::UnTrackVector(uint64_t internal_id) {}
 
+template <typename T>
+void VectorHNSW<T>::RelocateVector(uint64_t internal_id, const char *from,
+                                   char *to) {
+  algo_->relocateData(internal_id, from, to);
+}
+
+template <typename T>
+bool VectorHNSW<T>::CompactMemory(DefragContext &ctx) {
+  // Holding the lock exclusively keeps the mutations of the index out while
+  // the caller keeps queries out. The main thread doesn't wait for mutations
+  // in flight, the increment is retried instead.
+  if (!resize_mutex_.TryLock()) {
+    return false;
+  }
+  bool done = CompactVectors(ctx);
+  resize_mutex_.Unlock();
+  return done;
+}
+
+// Number of points whose link lists are visited between budget checks.
+constexpr size_t kDefragLinkListsBatchSize = 1024;
+
+template <typename T>
+bool VectorHNSW<T>::Defrag(DefragContext &ctx, uint64_t &cursor) {
+  // Not waiting for a resize in flight on the main thread.
+  if (!resize_mutex_.ReaderTryLock()) {
+    return false;
+  }
+  uint64_t moved = 0;
+  auto move = [&ctx, &moved](char *link_list) {
+    auto new_link_list = static_cast<char *>(ctx.Move(link_list));
+    moved += new_link_list != nullptr;
+    return new_link_list;
+  };
+  bool done = false;
+  while (!done && !ctx.ShouldStop()) {
+    cursor = algo_->defragLinkLists(cursor, kDefragLinkListsBatchSize, move);
+    done = cursor == 0;
+  }
+  resize_mutex_.ReaderUnlock();
+  Metrics::GetStats().defrag_link_lists_moved_cnt += moved;
+  return done;
+}
+
 template <typename T>
 absl::StatusOr<std::shared_ptr<VectorHNSW<T>>> VectorHNSW<T>::LoadFromRDB(
     ValkeyModuleCtx *ctx, const AttributeDataType *attribute_data_type,
@@ -144,6 +210,7 @@ absl::StatusOr<std::shared_ptr<VectorHNSW<T>>> VectorHNSW<T>::LoadFromRDB(
     auto index = std::shared_ptr<VectorHNSW<T>>(new VectorHNSW<T>(
         vector_index_proto.dimension_count(), attribute_identifier,
         attribute_data_type->ToProto()));
+    index->multi_vector_ = vector_index_proto.multi_vector();
     index->Init(vector_index_proto.dimension_count(),
                 vector_index_proto.distance_metric(), index->space_);
 
@@ -178,12 +245,35 @@ VectorHNSW<T>::VectorHNSW(int dimensions,
 template <typename T>
 absl::Status VectorHNSW<T>::AddRecordImpl(uint64_t internal_id,
                                           absl::string_view record) {
+  if (!multi_vector_) {
+    return AddPoint(record.data(), internal_id);
+  }
+  const size_t vector_size = GetVectorDataSize();
+  for (size_t pos = 0; pos * vector_size < record.size(); ++pos) {
+    auto status = AddPoint(record.data() + pos * vector_size,
+                           MultiVectorLabel(internal_id, pos));
+    if (!status.ok()) {
+      // Don't leave a partially added record behind.
+      try {
+        absl::ReaderMutexLock lock(&resize_mutex_);
+        MarkMultiVectorDeleted(internal_id);
+      } catch (const std::exception &e) {
+        ++Metrics::GetStats().hnsw_remove_exceptions_cnt;
+      }
+      return status;
+    }
+  }
+  return absl::OkStatus();
+}
+
+template <typename T>
+absl::Status VectorHNSW<T>::AddPoint(const char *vector,
+                                     hnswlib::labeltype label) {
   do {
     try {
       absl::ReaderMutexLock lock(&resize_mutex_);
 
-      algo_->addPoint((T *)record.data(), internal_id,
-                      algo_->allow_replace_deleted_);
+      algo_->addPoint((T *)vector, label, algo_->allow_replace_deleted_);
       return absl::OkStatus();
     } catch (const std::exception &e) {
       std::string error_msg = e.what();
@@ -275,6 +365,19 @@ absl::Status VectorHNSW<T>::ResizeIfFull() {
 template <typename T>
 absl::Status VectorHNSW<T>::ModifyRecordImpl(uint64_t internal_id,
                                              absl::string_view record) {
+  if (multi_vector_) {
+    try {
+      absl::ReaderMutexLock lock(&resize_mutex_);
+      MarkMultiVectorDeleted(internal_id);
+    } catch (const std::exception &e) {
+      ++Metrics::GetStats().hnsw_modify_exceptions_cnt;
+      return absl::InternalError(
+          absl::StrCat("Error while modifying a record: ", e.what()));
+    }
+    // The new record may hold more vectors than the old one, so the index is
+    // allowed to grow.
+    return AddRecordImpl(internal_id, record);
+  }
   try {
     absl::ReaderMutexLock lock(&resize_mutex_);
     // TODO - an alternative approach is to call HierarchicalNSW::updatePoint.
@@ -295,7 +398,11 @@ template <typename T>
 absl::Status VectorHNSW<T>::RemoveRecordImpl(uint64_t internal_id) {
   try {
     absl::ReaderMutexLock lock(&resize_mutex_);
-    algo_->markDelete(internal_id);
+    if (multi_vector_) {
+      MarkMultiVectorDeleted(internal_id);
+    } else {
+      algo_->markDelete(internal_id);
+    }
   } catch (const std::exception &e) {
     ++Metrics::GetStats().hnsw_remove_exceptions_cnt;
     return absl::InternalError(
@@ -304,6 +411,19 @@ absl::Status VectorHNSW<T>::RemoveRecordImpl(uint64_t internal_id) {
   return absl::OkStatus();
 }
 
+namespace {
+// The filter-aware traversal only queues nodes that pass the filter, so a
+// restrictive filter leaves it fewer routes through the graph. The search
+// breadth is widened by 1/sqrt(selectivity), capped to keep the cost bounded.
+constexpr double kMaxFilterAwareEfScale = 16.0;
+
+size_t FilterAwareEf(size_t ef, double selectivity) {
+  double scale = selectivity > 0 ? 1.0 / std::sqrt(selectivity)
+                                 : kMaxFilterAwareEfScale;
+  return static_cast<size_t>(ef * std::min(scale, kMaxFilterAwareEfScale));
+}
+}  // namespace
+
 // Paper over the impedance mismatch between the
 // cancel::Token and hnswlib::BaseCancellationFunctor.
 class CancelCondition : public hnswlib::BaseCancellationFunctor {
@@ -319,22 +439,39 @@ template <typename T>
 absl::StatusOr<std::vector<Neighbor>> VectorHNSW<T>::Search(
     absl::string_view query, uint64_t count, cancel::Token &cancellation_token,
     std::unique_ptr<hnswlib::BaseFilterFunctor> filter,
-    std::optional<size_t> ef_runtime, bool enable_partial_results) {
+    std::optional<size_t> ef_runtime, bool enable_partial_results,
+    std::optional<double> filter_selectivity, hnswlib::SearchStats *stats) {
   if (!IsValidSizeVector(query)) {
     return absl::InvalidArgumentError(absl::StrCat(
         "Error parsing vector similarity query: query vector blob size (",
         query.size(), ") does not match index's expected size (",
         dimensions_ * GetDataTypeSize(), ")."));
   }
+  if (multi_vector_) {
+    if (!normalize_) {
+      return SearchMultiVector(query, count, cancellation_token, filter.get(),
+                               ef_runtime, enable_partial_results);
+    }
+    auto norm_record = NormalizeRecord(query);
+    return SearchMultiVector(
+        absl::string_view(norm_record.data(), norm_record.size()), count,
+        cancellation_token, filter.get(), ef_runtime, enable_partial_results);
+  }
   auto perform_search = [this, count, &filter, enable_partial_results,
-                         &ef_runtime,
+                         &ef_runtime, &filter_selectivity, stats,
                          &cancellation_token](absl::string_view query)
                             ABSL_NO_THREAD_SAFETY_ANALYSIS
       -> absl::StatusOr<std::priority_queue<std::pair<T, hnswlib::labeltype>>> {
     try {
       CancelCondition cancel_condition(cancellation_token);
-      auto res = algo_->searchKnn((T *)query.data(), count, ef_runtime,
-                                  filter.get(), &cancel_condition);
+      const bool filter_aware = filter && filter_selectivity.has_value();
+      if (filter_aware) {
+        ef_runtime = FilterAwareEf(ef_runtime.value_or(algo_->ef_),
+                                   *filter_selectivity);
+      }
+      auto res =
+          algo_->searchKnn((T *)query.data(), count, ef_runtime, filter.get(),
+                           &cancel_condition, filter_aware, stats);
       if (!enable_partial_results && cancellation_token->IsCancelled()) {
         return absl::CancelledError(
             "Search operation cancelled due to timeout");
@@ -358,6 +495,142 @@ absl::StatusOr<std::vector<Neighbor>> VectorHNSW<T>::Search(
   return CreateReply(search_result);
 }
 
+namespace {
+// Applies a filter on internal ids to the points of multi-vector records.
+class MultiVectorFilter : public hnswlib::BaseFilterFunctor {
+ public:
+  explicit MultiVectorFilter(hnswlib::BaseFilterFunctor *filter)
+      : filter_(filter) {}
+  bool operator()(hnswlib::labeltype label) override {
+    return (*filter_)(label >> VectorBase::kMultiVectorLabelBits);
+  }
+
+ private:
+  hnswlib::BaseFilterFunctor *filter_;
+};
+}  // namespace
+
+// Late-interaction search: each query vector retrieves the points of its ef
+// closest records, and the union of those records is re-ranked by MaxSim over
+// their full set of vectors.
+template <typename T>
+absl::StatusOr<std::vector<Neighbor>> VectorHNSW<T>::SearchMultiVector(
+    absl::string_view query, uint64_t count, cancel::Token &cancellation_token,
+    hnswlib::BaseFilterFunctor *filter, std::optional<size_t> ef_runtime,
+    bool enable_partial_results) {
+  CancelCondition cancel_condition(cancellation_token);
+  std::optional<MultiVectorFilter> multi_vector_filter;
+  if (filter) {
+    multi_vector_filter.emplace(filter);
+  }
+  const size_t ef = std::max<size_t>(ef_runtime.value_or(algo_->ef_), count);
+  const size_t vector_size = GetVectorDataSize();
+  absl::flat_hash_set<uint64_t> candidates;
+  try {
+    for (size_t offset = 0; offset < query.size(); offset += vector_size) {
+      hnswlib::MultiVectorLabelSearchStopCondition<T> stop_condition(
+          kMultiVectorLabelBits, ef, ef);
+      auto points = algo_->searchStopConditionClosest(
+          query.data() + offset, stop_condition,
+          multi_vector_filter ? &*multi_vector_filter : nullptr,
+          &cancel_condition);
+      for (const auto &[_, label] : points) {
+        candidates.insert(label >> kMultiVectorLabelBits);
+      }
+      if (cancellation_token->IsCancelled()) {
+        break;
+      }
+    }
+  } catch (const std::exception &e) {
+    Metrics::GetStats().hnsw_search_exceptions_cnt.fetch_add(
+        1, std::memory_order_relaxed);
+    return absl::InternalError(e.what());
+  }
+  if (!enable_partial_results && cancellation_token->IsCancelled()) {
+    return absl::CancelledError("Search operation cancelled due to timeout");
+  }
+  std::priority_queue<std::pair<T, hnswlib::labeltype>> results;
+  for (uint64_t internal_id : candidates) {
+    auto points = GetMultiVectorPoints(internal_id, true);
+    if (points.empty()) {
+      continue;
+    }
+    T distance = MultiVectorDistance(query, points);
+    if (results.size() < count) {
+      results.emplace(distance, internal_id);
+    } else if (distance < results.top().first) {
+      results.pop();
+      results.emplace(distance, internal_id);
+    }
+  }
+  return CreateReply(results);
+}
+
+template <typename T>
+std::vector<hnswlib::tableint> VectorHNSW<T>::GetMultiVectorPoints(
+    uint64_t internal_id, bool during_search) const {
+  std::vector<hnswlib::tableint> points;
+  // Mutations re-add a record's vectors from position 0, so the live points
+  // are a prefix of the positions.
+  for (size_t pos = 0; pos < kMaxVectorsPerKey; ++pos) {
+    auto label = MultiVectorLabel(internal_id, pos);
+    auto id =
+        during_search
+            ? hnswlib_helpers::GetInternalIdDuringSearch(algo_.get(), label)
+            : hnswlib_helpers::GetInternalId(algo_.get(), label);
+    if (!id.has_value()) {
+      break;
+    }
+    points.push_back(*id);
+  }
+  return points;
+}
+
+template <typename T>
+void VectorHNSW<T>::MarkMultiVectorDeleted(uint64_t internal_id) {
+  auto points = GetMultiVectorPoints(internal_id, false);
+  for (size_t pos = 0; pos < points.size(); ++pos) {
+    algo_->markDelete(MultiVectorLabel(internal_id, pos));
+  }
+}
+
+template <typename T>
+T VectorHNSW<T>::MultiVectorDistance(
+    absl::string_view query,
+    const std::vector<hnswlib::tableint> &points) const {
+  const size_t vector_size = GetVectorDataSize();
+  T distance = 0;
+  for (size_t offset = 0; offset < query.size(); offset += vector_size) {
+    T closest = std::numeric_limits<T>::max();
+    for (auto point : points) {
+      closest = std::min(
+          closest,
+          algo_->fstdistfunc_(query.data() + offset,
+                              algo_->getDataByInternalId(point),
+                              algo_->dist_func_param_));
+    }
+    distance += closest;
+  }
+  return distance;
+}
+
+template <typename T>
+absl::StatusOr<std::vector<char>> VectorHNSW<T>::GetMultiVectorValueImpl(
+    uint64_t internal_id) const {
+  auto points = GetMultiVectorPoints(internal_id, true);
+  if (points.empty()) {
+    return absl::NotFoundError("Record was not found");
+  }
+  const size_t vector_size = GetVectorDataSize();
+  std::vector<char> result;
+  result.reserve(points.size() * vector_size);
+  for (auto point : points) {
+    const char *data = algo_->getDataByInternalId(point);
+    result.insert(result.end(), data, data + vector_size);
+  }
+  return result;
+}
+
 template <typename T>
 void VectorHNSW<T>::ToProtoImpl(
     data_model::VectorIndex *vector_index_proto) const {
@@ -382,6 +655,15 @@ template <typename T>
 absl::StatusOr<std::pair<float, hnswlib::labeltype>>
 VectorHNSW<T>::ComputeDistanceFromRecordImpl(uint64_t internal_id,
                                              absl::string_view query) const {
+  if (multi_vector_) {
+    auto points = GetMultiVectorPoints(internal_id, true);
+    if (points.empty()) {
+      return absl::InternalError(
+          absl::StrCat("Couldn't find internal id: ", internal_id));
+    }
+    return std::pair<float, hnswlib::labeltype>{
+        MultiVectorDistance(query, points), internal_id};
+  }
   auto id =
       hnswlib_helpers::GetInternalIdDuringSearch(algo_.get(), internal_id);
   if (!id.has_value()) {
@@ -402,7 +684,7 @@ uint64_t VectorHNSW<T>::GetMaxInternalLabel() const {
   for (const auto &[label, _] : algo_->label_lookup_) {
     max_label = std::max(max_label, static_cast<uint64_t>(label));
   }
-  return max_label;
+  return multi_vector_ ? max_label >> kMultiVectorLabelBits : max_label;
 }
 
 template <typename T>
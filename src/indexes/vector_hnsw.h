@@ -13,6 +13,7 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/status/status.h"
@@ -70,7 +71,15 @@ class VectorHNSW : public VectorBase {
       cancel::Token& cancellation_token,
       std::unique_ptr<hnswlib::BaseFilterFunctor> filter = nullptr,
       std::optional<size_t> ef_runtime = std::nullopt,
-      bool enable_partial_results = false) ABSL_LOCKS_EXCLUDED(resize_mutex_);
+      bool enable_partial_results = false,
+      std::optional<double> filter_selectivity = std::nullopt,
+      hnswlib::SearchStats* stats = nullptr)
+      ABSL_LOCKS_EXCLUDED(resize_mutex_);
+  // Moves the upper level link lists of the graph, cursor is the next point.
+  bool Defrag(DefragContext& ctx, uint64_t& cursor) override
+      ABSL_LOCKS_EXCLUDED(resize_mutex_);
+  bool CompactMemory(DefragContext& ctx) override
+      ABSL_LOCKS_EXCLUDED(resize_mutex_);
 
  protected:
   absl::Status ResizeIfFull() ABSL_LOCKS_EXCLUDED(resize_mutex_);
@@ -93,6 +102,8 @@ class VectorHNSW : public VectorBase {
       ABSL_NO_THREAD_SAFETY_ANALYSIS {
     return algo_->getPoint(internal_id);
   }
+  absl::StatusOr<std::vector<char>> GetMultiVectorValueImpl(
+      uint64_t internal_id) const override ABSL_NO_THREAD_SAFETY_ANALYSIS;
   bool IsVectorMatch(uint64_t internal_id,
                      const InternedStringPtr& vector) override
       ABSL_LOCKS_EXCLUDED(tracked_vectors_mutex_);
@@ -101,12 +112,41 @@ class VectorHNSW : public VectorBase {
       ABSL_LOCKS_EXCLUDED(tracked_vectors_mutex_);
   void UnTrackVector(uint64_t internal_id) override
       ABSL_LOCKS_EXCLUDED(tracked_vectors_mutex_);
+  // Called by CompactVectors, under CompactMemory's exclusive lock.
+  void RelocateVector(uint64_t internal_id, const char* from,
+                      char* to) override ABSL_NO_THREAD_SAFETY_ANALYSIS;
   uint64_t GetMaxInternalLabel() const override ABSL_NO_THREAD_SAFETY_ANALYSIS;
   size_t GetLabelCount() const override ABSL_NO_THREAD_SAFETY_ANALYSIS;
 
  private:
   VectorHNSW(int dimensions, absl::string_view attribute_identifier,
              data_model::AttributeDataType attribute_data_type);
+  absl::Status AddPoint(const char* vector, hnswlib::labeltype label)
+      ABSL_LOCKS_EXCLUDED(resize_mutex_);
+
+  // Each vector of a multi-vector record is a separate point, labeled with the
+  // record's internal id followed by the position of the vector in the record.
+  static hnswlib::labeltype MultiVectorLabel(uint64_t internal_id,
+                                             size_t position) {
+    return (internal_id << kMultiVectorLabelBits) | position;
+  }
+  // Returns the live points of a multi-vector record in record order. Takes
+  // the label lookup lock unless called during search.
+  std::vector<hnswlib::tableint> GetMultiVectorPoints(uint64_t internal_id,
+                                                      bool during_search) const
+      ABSL_SHARED_LOCKS_REQUIRED(resize_mutex_);
+  void MarkMultiVectorDeleted(uint64_t internal_id)
+      ABSL_SHARED_LOCKS_REQUIRED(resize_mutex_);
+  // MaxSim as a distance: the sum, over the vectors of the query, of the
+  // distance to the closest vector of the record.
+  T MultiVectorDistance(absl::string_view query,
+                        const std::vector<hnswlib::tableint>& points) const
+      ABSL_SHARED_LOCKS_REQUIRED(resize_mutex_);
+  absl::StatusOr<std::vector<Neighbor>> SearchMultiVector(
+      absl::string_view query, uint64_t count,
+      cancel::Token& cancellation_token, hnswlib::BaseFilterFunctor* filter,
+      std::optional<size_t> ef_runtime, bool enable_partial_results)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS;
   std::unique_ptr<hnswlib::HierarchicalNSW<T>> algo_
       ABSL_GUARDED_BY(resize_mutex_);
   std::unique_ptr<hnswlib::SpaceInterface<T>> space_;
@@ -7,7 +7,10 @@
 
 #include "src/keyspace_event_manager.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -15,7 +18,9 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "src/attribute_data_type.h"
 #include "src/vector_externalizer.h"
+#include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/status/status_macros.h"
 #include "vmsdk/src/type_conversions.h"
 #include "vmsdk/src/utils.h"
@@ -51,12 +56,65 @@ void KeyspaceEventManager::NotifySubscribers(ValkeyModuleCtx *ctx, int type,
       }
     }
   }
+  KeyRecordCache cache(ctx, key, subscriptions_to_notify);
   for (const auto &subscription : subscriptions_to_notify) {
-    subscription->OnKeyspaceNotification(ctx, type, event, key);
+    subscription->OnKeyspaceNotification(ctx, type, event, key, cache);
   }
   VectorExternalizer::Instance().ProcessEngineUpdateQueue();
 }
 
+ValkeyModuleKey *KeyRecordCache::GetOpenKey() {
+  if (!key_obj_.has_value()) {
+    key_obj_ = vmsdk::MakeUniqueValkeyOpenKey(
+        ctx_, key_, VALKEYMODULE_OPEN_KEY_NOEFFECTS | VALKEYMODULE_READ);
+  }
+  return key_obj_->get();
+}
+
+vmsdk::UniqueValkeyString KeyRecordCache::GetRecord(
+    const AttributeDataType &attribute_data_type, absl::string_view identifier,
+    bool &is_module_owned) {
+  auto [itr, inserted] = records_.try_emplace(
+      std::make_pair(attribute_data_type.ToProto(), std::string(identifier)));
+  auto &cached = itr->second;
+  if (inserted) {
+    cached.readers = CountReaders(attribute_data_type, identifier);
+  }
+  // A subscription may ask again for a record it already took, e.g. when two
+  // of its attributes share an identifier.
+  if (inserted || cached.handed_out) {
+    cached.record = VectorExternalizer::Instance().GetRecord(
+        ctx_, &attribute_data_type, GetOpenKey(), vmsdk::ToStringView(key_),
+        identifier, cached.is_module_owned);
+    cached.handed_out = false;
+  }
+  is_module_owned = cached.is_module_owned;
+  if (!cached.record) {
+    return nullptr;
+  }
+  if (++cached.requests >= cached.readers) {
+    cached.handed_out = true;
+    return std::move(cached.record);
+  }
+  return vmsdk::UniqueValkeyString(
+      ValkeyModule_CreateStringFromString(nullptr, cached.record.get()));
+}
+
+size_t KeyRecordCache::CountReaders(
+    const AttributeDataType &attribute_data_type,
+    absl::string_view identifier) const {
+  size_t readers = 0;
+  auto data_type = attribute_data_type.ToProto();
+  for (const auto *consumer : consumers_) {
+    if (consumer->GetAttributeDataType().ToProto() == data_type &&
+        consumer->ReadsRecord(identifier)) {
+      ++readers;
+    }
+  }
+  // The requester reads the record, whether it says so or not.
+  return std::max<size_t>(readers, 1);
+}
+
 absl::Status KeyspaceEventManager::RemoveSubscription(
     KeyspaceEventSubscription *subscription) {
   auto &subscriptions = subscriptions_.Get();
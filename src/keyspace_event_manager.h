@@ -8,21 +8,82 @@
 #ifndef VALKEYSEARCH_SRC_KEYSPACE_EVENT_MANAGER_H_
 #define VALKEYSEARCH_SRC_KEYSPACE_EVENT_MANAGER_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "src/attribute_data_type.h"
+#include "src/index_schema.pb.h"
 #include "src/utils/patricia_tree.h"
+#include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/utils.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
 namespace valkey_search {
+class KeyspaceEventSubscription;
+
 using StartSubscriptionFunction =
     std::function<absl::Status(ValkeyModuleCtx *, int)>;
 
+// KeyRecordCache holds what was read from a single key while a keyspace event
+// is handed to the subscriptions interested in it, so that the key is opened
+// once and every record is extracted once, however many subscriptions index
+// it.
+//
+// `consumers` are the subscriptions the event is handed to, none when there is
+// a single one. Of those that read a record, the last to ask for it takes the
+// cached one, the others get a copy: the records are consumed on the writer
+// threads, where the reference count of a shared string cannot be released
+// safely. `consumers` must outlive the cache.
+class KeyRecordCache {
+ public:
+  KeyRecordCache(ValkeyModuleCtx *ctx, ValkeyModuleString *key,
+                 absl::Span<KeyspaceEventSubscription *const> consumers = {})
+      : ctx_(ctx), key_(key), consumers_(consumers) {}
+  KeyRecordCache(const KeyRecordCache &) = delete;
+  KeyRecordCache &operator=(const KeyRecordCache &) = delete;
+
+  ValkeyModuleCtx *GetCtx() const { return ctx_; }
+  ValkeyModuleString *GetKey() const { return key_; }
+  // Returns the key opened for reading, or null if it does not exist.
+  ValkeyModuleKey *GetOpenKey();
+  // Returns the record of `identifier` as read by `attribute_data_type`, or
+  // null if the key has no such record. See VectorExternalizer::GetRecord for
+  // `is_module_owned`.
+  vmsdk::UniqueValkeyString GetRecord(
+      const AttributeDataType &attribute_data_type,
+      absl::string_view identifier, bool &is_module_owned);
+
+ private:
+  struct CachedRecord {
+    vmsdk::UniqueValkeyString record;
+    bool is_module_owned{false};
+    bool handed_out{false};
+    size_t requests{0};
+    // The consumers that read the record.
+    size_t readers{1};
+  };
+
+  size_t CountReaders(const AttributeDataType &attribute_data_type,
+                      absl::string_view identifier) const;
+
+  ValkeyModuleCtx *ctx_;
+  ValkeyModuleString *key_;
+  absl::Span<KeyspaceEventSubscription *const> consumers_;
+  std::optional<vmsdk::UniqueValkeyOpenKey> key_obj_;
+  absl::flat_hash_map<std::pair<data_model::AttributeDataType, std::string>,
+                      CachedRecord>
+      records_;
+};
+
 // KeyspaceEventSubscription is an interface for classes that want to subscribe
 // to keyspace events.
 class KeyspaceEventSubscription {
@@ -41,9 +102,26 @@ class KeyspaceEventSubscription {
   // completely prefixed by B. Otherwise, duplicate events may fire.
   virtual const std::vector<std::string> &GetKeyPrefixes() const = 0;
 
+  // Whether the subscription asks the KeyRecordCache for the record of
+  // `identifier`. An over-estimate only costs the cache a copy.
+  virtual bool ReadsRecord(
+      [[maybe_unused]] absl::string_view identifier) const {
+    return true;
+  }
+
   virtual void OnKeyspaceNotification(ValkeyModuleCtx *ctx, int type,
                                       const char *event,
                                       ValkeyModuleString *key) = 0;
+
+  // Called by the KeyspaceEventManager instead of the above, so that the
+  // subscriptions notified of the same event share the records read from the
+  // key.
+  virtual void OnKeyspaceNotification(ValkeyModuleCtx *ctx, int type,
+                                      const char *event,
+                                      ValkeyModuleString *key,
+                                      [[maybe_unused]] KeyRecordCache &cache) {
+    OnKeyspaceNotification(ctx, type, event, key);
+  }
 };
 
 class KeyspaceEventManager {
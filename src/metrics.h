@@ -77,6 +77,20 @@ class Metrics {
     vmsdk::LatencySampler flat_vector_index_search_latency{
         absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
         absl::ToInt64Nanoseconds(absl::Seconds(1)), LATENCY_PRECISION};
+    // End to end latencies of the commands, from the start of parsing to the
+    // reply, and the phases of their execution.
+    vmsdk::LatencySampler ft_search_latency{
+        absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
+        absl::ToInt64Nanoseconds(absl::Seconds(60)), LATENCY_PRECISION};
+    vmsdk::LatencySampler ft_aggregate_latency{
+        absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
+        absl::ToInt64Nanoseconds(absl::Seconds(60)), LATENCY_PRECISION};
+    vmsdk::LatencySampler content_fetch_latency{
+        absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
+        absl::ToInt64Nanoseconds(absl::Seconds(1)), LATENCY_PRECISION};
+    vmsdk::LatencySampler mutation_apply_latency{
+        absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
+        absl::ToInt64Nanoseconds(absl::Seconds(1)), LATENCY_PRECISION};
     std::atomic<uint64_t> coordinator_server_get_global_metadata_success_cnt{0};
     std::atomic<uint64_t> coordinator_server_get_global_metadata_failure_cnt{0};
     std::atomic<uint64_t> coordinator_server_search_index_partition_success_cnt{
@@ -101,9 +115,15 @@ class Metrics {
     std::atomic<uint64_t> ingest_field_numeric{0};
     std::atomic<uint64_t> ingest_field_tag{0};
     std::atomic<uint64_t> ingest_field_text{0};
+    std::atomic<uint64_t> ingest_field_geo{0};
     std::atomic<uint64_t> ingest_last_batch_size{0};
     std::atomic<uint64_t> ingest_total_batches{0};
     std::atomic<uint64_t> ingest_total_failures{0};
+    std::atomic<uint64_t> expired_keys_removed_cnt{0};
+    std::atomic<uint64_t> query_expired_keys_skipped_cnt{0};
+    std::atomic<uint64_t> defrag_cycles_cnt{0};
+    std::atomic<uint64_t> defrag_vectors_moved_cnt{0};
+    std::atomic<uint64_t> defrag_link_lists_moved_cnt{0};
     vmsdk::LatencySampler
         coordinator_client_get_global_metadata_failure_latency{
             absl::ToInt64Nanoseconds(absl::Nanoseconds(1)),
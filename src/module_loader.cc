@@ -56,6 +56,14 @@ vmsdk::module::Options options = {
                 .cmd_func =
                     &vmsdk::CreateCommand<valkey_search::FTDropIndexCmd>,
             },
+            {
+                .cmd_name = valkey_search::kBulkLoadCommand,
+                .permissions = ACLPermissionFormatter(
+                    valkey_search::kBulkLoadCmdPermissions),
+                .flags = {vmsdk::module::kWriteFlag, vmsdk::module::kFastFlag},
+                .cmd_func =
+                    &vmsdk::CreateCommand<valkey_search::FTBulkLoadCmd>,
+            },
             {
                 .cmd_name = valkey_search::kInfoCommand,
                 .permissions =
@@ -106,6 +114,22 @@ vmsdk::module::Options options = {
                 .cmd_func =
                     &vmsdk::CreateCommand<valkey_search::FTAggregateCmd>,
             },
+            {
+                .cmd_name = valkey_search::kProfileCommand,
+                .permissions = ACLPermissionFormatter(
+                    valkey_search::kSearchCmdPermissions),
+                .flags = {vmsdk::module::kReadOnlyFlag,
+                          vmsdk::module::kDenyOOMFlag},
+                .cmd_func = &vmsdk::CreateCommand<valkey_search::FTProfileCmd>,
+            },
+            {
+                .cmd_name = valkey_search::kSlowLogCommand,
+                .permissions = ACLPermissionFormatter(
+                    valkey_search::kSlowLogCmdPermissions),
+                .flags = {vmsdk::module::kReadOnlyFlag,
+                          vmsdk::module::kAdminFlag},
+                .cmd_func = &vmsdk::CreateCommand<valkey_search::FTSlowLogCmd>,
+            },
         },
     .on_load =
         [](ValkeyModuleCtx *ctx, ValkeyModuleString **argv, int argc,
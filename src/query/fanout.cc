@@ -92,14 +92,58 @@ struct SearchPartitionResultsTracker {
   std::atomic_bool has_node_error{false};       // Whether any node failed
   absl::Status first_node_error
       ABSL_GUARDED_BY(mutex);  // First error encountered
+  // Set when the query collects its timings, under FT.PROFILE or while the
+  // slow log is enabled. Shard latencies are measured from the start of the
+  // fanout.
+  const bool timing;
+  // Set when the query runs under FT.PROFILE.
+  const bool profiling;
+  vmsdk::StopWatch fanout_time;
 
   SearchPartitionResultsTracker(int outstanding_requests, int k,
                                 std::unique_ptr<SearchParameters> parameters)
       : outstanding_requests(outstanding_requests),
-        parameters(std::move(parameters)) {}
+        parameters(std::move(parameters)),
+        timing(this->parameters->timings.has_value()),
+        profiling(this->parameters->profile != nullptr) {}
+
+  // Adds a shard to the timings of the query. Only the local shard reports
+  // its execution statistics, remote shards report their latency.
+  void RecordShard(std::string address, const absl::Status &status,
+                   size_t results, const SearchParameters *local)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    auto &timings = *parameters->timings;
+    timings.shards.push_back(QueryTimings::Shard{
+        .address = std::move(address),
+        .time = fanout_time.Duration(),
+        .status = status,
+        .results = results,
+    });
+    if (local == nullptr) {
+      return;
+    }
+    timings.queue_wait_time = local->timings->queue_wait_time;
+    timings.search_time = local->timings->search_time;
+    timings.content_fetch_time += local->timings->content_fetch_time;
+    timings.plan = local->timings->plan;
+    if (!profiling) {
+      return;
+    }
+    auto &profile = *parameters->profile;
+    profile.estimated_entries = local->profile->estimated_entries;
+    profile.fetchers = local->profile->fetchers;
+    profile.keys_evaluated = local->profile->keys_evaluated;
+    profile.keys_matched = local->profile->keys_matched;
+    profile.hnsw = local->profile->hnsw;
+  }
 
   void HandleResponse(coordinator::SearchIndexPartitionResponse &response,
                       const std::string &address, const grpc::Status &status) {
+    if (timing) {
+      absl::MutexLock lock(&mutex);
+      RecordShard(address, ToAbslStatus(status),
+                  status.ok() ? response.neighbors_size() : 0, nullptr);
+    }
     if (!status.ok()) {
       // Store first error for partial results disabled case
       {
@@ -243,6 +287,11 @@ class LocalResponderSearch : public query::SearchParameters {
 
  private:
   void QueryCompleteImpl(std::unique_ptr<SearchParameters> self) {
+    if (timings) {
+      absl::MutexLock lock(&tracker->mutex);
+      tracker->RecordShard("local", search_result.status,
+                           search_result.neighbors.size(), this);
+    }
     if (search_result.status.ok()) {
       tracker->has_successful_node.store(true);
       tracker->AddResults(search_result.neighbors);
@@ -408,6 +457,12 @@ absl::Status PerformSearchFanoutAsync(
     VMSDK_RETURN_IF_ERROR(coordinator::GRPCSearchRequestToParameters(
         *request, nullptr, local_parameters.get()));
     local_parameters->tracker = tracker;
+    if (tracker->timing) {
+      local_parameters->timings.emplace();
+    }
+    if (tracker->profiling) {
+      local_parameters->profile = std::make_unique<QueryProfile>();
+    }
     VMSDK_RETURN_IF_ERROR(query::SearchAsync(std::move(local_parameters),
                                              thread_pool, SearchMode::kLocal))
         << "Failed to handle FT.SEARCH locally during fan-out";
@@ -7,7 +7,9 @@
 
 #include "src/query/planner.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <optional>
 
 #include "absl/log/check.h"
 #include "src/indexes/index_base.h"
@@ -44,4 +46,23 @@ bool UsePreFiltering(size_t estimated_num_of_keys,
   CHECK(false) << "Unsupported indexer type: "
                << (int)vector_index->GetIndexerType();
 }
+
+std::optional<double> FilterAwareSelectivity(
+    size_t estimated_num_of_keys, indexes::VectorBase *vector_index) {
+  if (vector_index->GetIndexerType() != indexes::IndexerType::kHNSW) {
+    return std::nullopt;
+  }
+  size_t N = vector_index->GetTrackedKeyCount();
+  if (N == 0) {
+    return std::nullopt;
+  }
+  // The fetcher sizes may over-count, e.g. for ORs of overlapping filters.
+  double selectivity =
+      std::min(1.0, static_cast<double>(estimated_num_of_keys) / N);
+  if (selectivity > options::GetFilterAwareSearchThresholdRatio()) {
+    return std::nullopt;
+  }
+  return selectivity;
+}
+
 }  // namespace valkey_search::query
@@ -8,6 +8,9 @@
 #ifndef VALKEYSEARCH_SRC_QUERY_PLANNER_H_
 #define VALKEYSEARCH_SRC_QUERY_PLANNER_H_
 
+#include <cstddef>
+#include <optional>
+
 #include "src/indexes/vector_base.h"
 
 namespace valkey_search::query {
@@ -16,6 +19,12 @@ namespace valkey_search::query {
 // heuristics.
 bool UsePreFiltering(size_t estimated_num_of_keys,
                      indexes::VectorBase *vector_index);
+
+// For an inline-filtered HNSW search, returns the estimated fraction of the
+// index that passes the filter if it is restrictive enough for the
+// filter-aware graph traversal, nullopt otherwise.
+std::optional<double> FilterAwareSelectivity(
+    size_t estimated_num_of_keys, indexes::VectorBase *vector_index);
 }  // namespace valkey_search::query
 
 #endif  // VALKEYSEARCH_SRC_QUERY_PLANNER_H_
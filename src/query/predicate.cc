@@ -7,6 +7,7 @@
 
 #include "src/query/predicate.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -16,6 +17,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/string_view.h"
 #include "src/commands/filter_parser.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
 #include "src/indexes/text.h"
@@ -340,6 +342,63 @@ EvaluationResult NumericPredicate::Evaluate(const double *value) const {
   return EvaluationResult(matches);
 }
 
+GeoPredicate::GeoPredicate(const indexes::Geo *index, absl::string_view alias,
+                           absl::string_view identifier,
+                           utils::GeoPoint center, double radius_meters)
+    : Predicate(PredicateType::kGeo),
+      index_(index),
+      alias_(alias),
+      identifier_(vmsdk::MakeUniqueValkeyString(identifier)),
+      shape_(Shape::kRadius),
+      center_(center),
+      radius_meters_(radius_meters) {
+  std::vector<utils::GeoHashRange> ranges;
+  for (const auto &box : utils::GeoRadiusBoxes(center, radius_meters)) {
+    auto box_ranges = utils::GeoHashCoverBox(box);
+    ranges.insert(ranges.end(), box_ranges.begin(), box_ranges.end());
+  }
+  // The two halves of a circle crossing the antimeridian may share coarse
+  // cells, merge them so that no point is fetched twice.
+  std::sort(ranges.begin(), ranges.end());
+  for (const auto &range : ranges) {
+    if (!hash_ranges_.empty() && hash_ranges_.back().second >= range.first) {
+      hash_ranges_.back().second =
+          std::max(hash_ranges_.back().second, range.second);
+    } else {
+      hash_ranges_.push_back(range);
+    }
+  }
+}
+
+GeoPredicate::GeoPredicate(const indexes::Geo *index, absl::string_view alias,
+                           absl::string_view identifier,
+                           std::vector<utils::GeoPoint> polygon)
+    : Predicate(PredicateType::kGeo),
+      index_(index),
+      alias_(alias),
+      identifier_(vmsdk::MakeUniqueValkeyString(identifier)),
+      shape_(Shape::kPolygon),
+      polygon_(std::move(polygon)),
+      hash_ranges_(utils::GeoHashCoverBox(utils::GeoPolygonBox(polygon_))) {}
+
+EvaluationResult GeoPredicate::Evaluate(Evaluator &evaluator) const {
+  return evaluator.EvaluateGeo(*this);
+}
+
+EvaluationResult GeoPredicate::Evaluate(const utils::GeoPoint *point) const {
+  if (!point) {
+    return EvaluationResult(false);
+  }
+  return EvaluationResult(Contains(*point));
+}
+
+bool GeoPredicate::Contains(const utils::GeoPoint &point) const {
+  if (shape_ == Shape::kRadius) {
+    return utils::GeoDistance(center_, point) <= radius_meters_;
+  }
+  return utils::GeoPolygonContains(polygon_, point);
+}
+
 TagPredicate::TagPredicate(const indexes::Tag *index, absl::string_view alias,
                            absl::string_view identifier,
                            absl::string_view raw_tag_string,
@@ -368,6 +427,12 @@ EvaluationResult TagPredicate::Evaluate(
 
   for (const auto &in_tag : *in_tags) {
     for (const auto &tag : tags_) {
+      if (indexes::Tag::IsWildcardPattern(tag)) {
+        if (indexes::Tag::MatchTagPattern(in_tag, tag, case_sensitive)) {
+          return EvaluationResult(true);
+        }
+        continue;
+      }
       absl::string_view left_hand_side = in_tag;
       absl::string_view right_hand_side = tag;
       if (right_hand_side.back() == '*') {
@@ -16,6 +16,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "src/indexes/text/text_iterator.h"
+#include "src/utils/geohash.h"
 #include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/type_conversions.h"
 
@@ -23,6 +24,7 @@ namespace valkey_search::indexes {
 class Text;
 class Numeric;
 class Tag;
+class Geo;
 class EntriesFetcherBase;
 }  // namespace valkey_search::indexes
 
@@ -45,12 +47,14 @@ enum class PredicateType {
   kComposedOr,
   kNegate,
   kText,
+  kGeo,
   kNone
 };
 
 class TextPredicate;
 class TagPredicate;
 class NumericPredicate;
+class GeoPredicate;
 
 struct EvaluationResult {
   bool matches;
@@ -82,6 +86,7 @@ class Evaluator {
   virtual EvaluationResult EvaluateTags(const TagPredicate& predicate) = 0;
   virtual EvaluationResult EvaluateNumeric(
       const NumericPredicate& predicate) = 0;
+  virtual EvaluationResult EvaluateGeo(const GeoPredicate& predicate) = 0;
   // Access target key for proximity validation (only for Text)
   virtual const InternedStringPtr& GetTargetKey() const = 0;
   virtual bool IsPrefilterEvaluator() const { return false; }
@@ -151,6 +156,51 @@ class NumericPredicate : public Predicate {
   bool is_inclusive_end_;
 };
 
+class GeoPredicate : public Predicate {
+ public:
+  enum class Shape { kRadius, kPolygon };
+  // Matches points within radius_meters of center.
+  GeoPredicate(const indexes::Geo* index, absl::string_view alias,
+               absl::string_view identifier, utils::GeoPoint center,
+               double radius_meters);
+  // Matches points inside the polygon.
+  GeoPredicate(const indexes::Geo* index, absl::string_view alias,
+               absl::string_view identifier,
+               std::vector<utils::GeoPoint> polygon);
+  EvaluationResult Evaluate(Evaluator& evaluator) const override;
+  EvaluationResult Evaluate(const utils::GeoPoint* point) const;
+  bool Contains(const utils::GeoPoint& point) const;
+  const indexes::Geo* GetIndex() const { return index_; }
+  absl::string_view GetIdentifier() const {
+    return vmsdk::ToStringView(identifier_.get());
+  }
+  vmsdk::UniqueValkeyString GetRetainedIdentifier() const {
+    return vmsdk::RetainUniqueValkeyString(identifier_.get());
+  }
+  absl::string_view GetAlias() const { return alias_; }
+  Shape GetShape() const { return shape_; }
+  // The center and radius of a kRadius predicate.
+  const utils::GeoPoint& GetCenter() const { return center_; }
+  double GetRadiusMeters() const { return radius_meters_; }
+  // The vertices of a kPolygon predicate.
+  const std::vector<utils::GeoPoint>& GetPolygon() const { return polygon_; }
+  // Sorted geohash ranges covering the shape. Every matching point falls in
+  // one of them, but not every point in them matches.
+  const std::vector<utils::GeoHashRange>& GetHashRanges() const {
+    return hash_ranges_;
+  }
+
+ private:
+  const indexes::Geo* index_;
+  std::string alias_;
+  vmsdk::UniqueValkeyString identifier_;
+  Shape shape_;
+  utils::GeoPoint center_{0, 0};
+  double radius_meters_{0};
+  std::vector<utils::GeoPoint> polygon_;
+  std::vector<utils::GeoHashRange> hash_ranges_;
+};
+
 class TagPredicate : public Predicate {
  public:
   TagPredicate(const indexes::Tag* index, absl::string_view alias,
@@ -27,6 +27,7 @@
 #include "src/metrics.h"
 #include "src/query/predicate.h"
 #include "src/query/search.h"
+#include "src/utils/geohash.h"
 #include "src/valkey_search.h"
 #include "vmsdk/src/info.h"
 #include "vmsdk/src/log.h"
@@ -135,6 +136,20 @@ class PredicateEvaluator : public query::Evaluator {
     return predicate.Evaluate(&out_numeric.value());
   }
 
+  EvaluationResult EvaluateGeo(const query::GeoPredicate &predicate) override {
+    auto identifier = predicate.GetRetainedIdentifier();
+    auto it = records_.find(vmsdk::ToStringView(identifier.get()));
+    if (it == records_.end()) {
+      return EvaluationResult(false);
+    }
+    auto point =
+        utils::ParseGeoPoint(vmsdk::ToStringView(it->second.value.get()));
+    if (!point.ok()) {
+      return EvaluationResult(false);
+    }
+    return predicate.Evaluate(&point.value());
+  }
+
   EvaluationResult EvaluateText(const query::TextPredicate &predicate,
                                 bool require_positions) override {
     CHECK(target_key_);
@@ -155,7 +170,9 @@ DEV_INTEGER_COUNTER(query, predicate_revalidation);
 bool VerifyFilter(const query::SearchParameters &parameters,
                   const RecordsMap &records, const indexes::Neighbor &n) {
   auto predicate = parameters.filter_parse_results.root_predicate.get();
-  if (predicate == nullptr) {
+  // The vector leg of a hybrid query runs without the filter, so fused keys
+  // need not match it and there is nothing to re-validate.
+  if (predicate == nullptr || parameters.fusion.has_value()) {
     return true;
   }
   auto db_seq =
@@ -379,6 +396,8 @@ void ProcessNeighborsForReply(
       options::GetMaxSearchResultRecordSize().GetValue();
   const auto max_content_fields =
       options::GetMaxSearchResultFieldsCount().GetValue();
+  // Always measured, it feeds the content fetch latency metric.
+  vmsdk::StopWatch fetch_time;
   for (auto &neighbor : neighbors) {
     // Remote neighbors (from fanout) always have attribute_contents populated,
     // so they skip this entire block. Only local neighbors without content
@@ -438,6 +457,11 @@ void ProcessNeighborsForReply(
                        return !neighbor.attribute_contents.has_value();
                      }),
       neighbors.end());
+  auto fetch_duration = fetch_time.Duration();
+  Metrics::GetStats().content_fetch_latency.SubmitSample(fetch_duration);
+  if (parameters.timings) {
+    parameters.timings->content_fetch_time += fetch_duration;
+  }
 }
 
 }  // namespace valkey_search::query
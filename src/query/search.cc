@@ -9,7 +9,10 @@
 
 #include <absl/strings/str_split.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <optional>
@@ -26,8 +29,10 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "src/attribute_data_type.h"
+#include "src/indexes/geo.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
+#include "src/indexes/numeric_column.h"
 #include "src/indexes/tag.h"
 #include "src/indexes/text.h"
 #include "src/indexes/text/orproximity.h"
@@ -53,6 +58,7 @@
 #include "vmsdk/src/thread_pool.h"
 #include "vmsdk/src/time_sliced_mrmw_mutex.h"
 #include "vmsdk/src/type_conversions.h"
+#include "vmsdk/src/utils.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
 namespace valkey_search::query {
@@ -65,7 +71,10 @@ DEV_INTEGER_COUNTER(query_stats, query_text_fuzzy_count);
 DEV_INTEGER_COUNTER(query_stats, query_text_proximity_count);
 DEV_INTEGER_COUNTER(query_stats, query_numeric_count);
 DEV_INTEGER_COUNTER(query_stats, query_tag_count);
+DEV_INTEGER_COUNTER(query_stats, query_geo_count);
+DEV_INTEGER_COUNTER(query_stats, query_filter_aware_count);
 DEV_INTEGER_COUNTER(query_stats, nonvector_results_fetched_limited_count);
+DEV_INTEGER_COUNTER(query_stats, query_hybrid_fusion_count);
 
 class InlineVectorFilter : public hnswlib::BaseFilterFunctor {
  public:
@@ -99,32 +108,112 @@ class InlineVectorFilter : public hnswlib::BaseFilterFunctor {
   const std::shared_ptr<indexes::text::TextIndexSchema> text_index_schema_;
   QueryOperations query_operations_;
 };
-absl::StatusOr<std::vector<indexes::Neighbor>> PerformVectorSearch(
-    indexes::VectorBase *vector_index, const SearchParameters &parameters) {
-  std::unique_ptr<InlineVectorFilter> inline_filter;
-  if (parameters.filter_parse_results.root_predicate != nullptr) {
-    const std::shared_ptr<indexes::text::TextIndexSchema> text_index_schema =
-        parameters.index_schema->GetTextIndexSchema();
-    inline_filter = std::make_unique<InlineVectorFilter>(
-        parameters.filter_parse_results.root_predicate.get(), vector_index,
-        text_index_schema, parameters.filter_parse_results.query_operations);
-    VMSDK_LOG(DEBUG, nullptr) << "Performing vector search with inline filter";
+
+using NumericColumnRanges = absl::InlinedVector<
+    std::pair<const indexes::NumericColumn *, indexes::NumericRange>, 4>;
+
+// Evaluates a filter made only of ANDed numeric ranges against the numeric
+// columns of the vector index. A candidate costs one array access per range
+// instead of an id to key lookup followed by a key to value lookup.
+class NumericColumnFilter : public hnswlib::BaseFilterFunctor {
+ public:
+  explicit NumericColumnFilter(NumericColumnRanges ranges)
+      : ranges_(std::move(ranges)) {}
+  ~NumericColumnFilter() override = default;
+
+  bool operator()(hnswlib::labeltype id) override {
+    for (const auto &[column, range] : ranges_) {
+      if (!column->Contains(id, range)) {
+        return false;
+      }
+    }
+    return true;
   }
+
+ private:
+  NumericColumnRanges ranges_;
+};
+
+// FLAT search visits every id, so the ranges are evaluated up front in
+// vectorized passes over the columns and each candidate is a single bit test.
+class NumericBitmapFilter : public hnswlib::BaseFilterFunctor {
+ public:
+  explicit NumericBitmapFilter(const NumericColumnRanges &ranges) {
+    size_t size = ranges.front().first->Size();
+    for (const auto &[column, range] : ranges) {
+      size = std::min(size, column->Size());
+    }
+    bitmap_.assign(size / indexes::NumericColumn::kBitsPerWord, ~uint64_t{0});
+    for (const auto &[column, range] : ranges) {
+      column->FilterInto(range, bitmap_);
+    }
+  }
+  ~NumericBitmapFilter() override = default;
+
+  bool operator()(hnswlib::labeltype id) override {
+    const size_t word = id / indexes::NumericColumn::kBitsPerWord;
+    return word < bitmap_.size() &&
+           (bitmap_[word] >> (id % indexes::NumericColumn::kBitsPerWord) & 1);
+  }
+
+ private:
+  std::vector<uint64_t> bitmap_;
+};
+
+// Collects the numeric ranges of a filter that is a numeric predicate or an
+// AND of numeric predicates. Returns false if the filter has any other shape
+// or if the vector index has no column for one of the numeric attributes.
+bool CollectNumericColumnRanges(const Predicate *predicate,
+                                const indexes::VectorBase *vector_index,
+                                NumericColumnRanges &ranges) {
+  if (predicate->GetType() == PredicateType::kNumeric) {
+    auto numeric_predicate = dynamic_cast<const NumericPredicate *>(predicate);
+    auto column = vector_index->GetNumericColumnDuringSearch(
+        numeric_predicate->GetIndex());
+    if (column == nullptr) {
+      return false;
+    }
+    ranges.emplace_back(
+        column, indexes::NumericRange(numeric_predicate->GetStart(),
+                                      numeric_predicate->IsStartInclusive(),
+                                      numeric_predicate->GetEnd(),
+                                      numeric_predicate->IsEndInclusive()));
+    return true;
+  }
+  if (predicate->GetType() == PredicateType::kComposedAnd) {
+    auto composed_predicate =
+        dynamic_cast<const ComposedPredicate *>(predicate);
+    for (const auto &child : composed_predicate->GetChildren()) {
+      if (!CollectNumericColumnRanges(child.get(), vector_index, ranges)) {
+        return false;
+      }
+    }
+    return !ranges.empty();
+  }
+  return false;
+}
+
+// Runs the KNN search of the query, restricted by `inline_filter` if set.
+absl::StatusOr<std::vector<indexes::Neighbor>> SearchVectorIndex(
+    indexes::VectorBase *vector_index, const SearchParameters &parameters,
+    std::unique_ptr<hnswlib::BaseFilterFunctor> inline_filter,
+    std::optional<double> filter_selectivity) {
   if (vector_index->GetIndexerType() == indexes::IndexerType::kHNSW) {
     auto vector_hnsw = dynamic_cast<indexes::VectorHNSW<float> *>(vector_index);
 
-    auto latency_sample = SAMPLE_EVERY_N(100);
-    auto res = vector_hnsw->Search(parameters.query, parameters.k,
-                                   parameters.cancellation_token,
-                                   std::move(inline_filter), parameters.ef,
-                                   parameters.enable_partial_results);
+    auto latency_sample = std::make_unique<vmsdk::StopWatch>();
+    auto res = vector_hnsw->Search(
+        parameters.query, parameters.k, parameters.cancellation_token,
+        std::move(inline_filter), parameters.ef,
+        parameters.enable_partial_results, filter_selectivity,
+        parameters.profile ? &parameters.profile->hnsw : nullptr);
     Metrics::GetStats().hnsw_vector_index_search_latency.SubmitSample(
         std::move(latency_sample));
     return res;
   }
   if (vector_index->GetIndexerType() == indexes::IndexerType::kFlat) {
     auto vector_flat = dynamic_cast<indexes::VectorFlat<float> *>(vector_index);
-    auto latency_sample = SAMPLE_EVERY_N(100);
+    auto latency_sample = std::make_unique<vmsdk::StopWatch>();
     auto res = vector_flat->Search(parameters.query, parameters.k,
                                    parameters.cancellation_token,
                                    std::move(inline_filter));
@@ -136,6 +225,36 @@ absl::StatusOr<std::vector<indexes::Neighbor>> PerformVectorSearch(
                << (int)vector_index->GetIndexerType();
 }
 
+absl::StatusOr<std::vector<indexes::Neighbor>> PerformVectorSearch(
+    indexes::VectorBase *vector_index, const SearchParameters &parameters,
+    std::optional<double> filter_selectivity) {
+  std::unique_ptr<hnswlib::BaseFilterFunctor> inline_filter;
+  NumericColumnRanges numeric_column_ranges;
+  if (parameters.filter_parse_results.root_predicate != nullptr &&
+      CollectNumericColumnRanges(
+          parameters.filter_parse_results.root_predicate.get(), vector_index,
+          numeric_column_ranges)) {
+    if (vector_index->GetIndexerType() == indexes::IndexerType::kFlat) {
+      inline_filter =
+          std::make_unique<NumericBitmapFilter>(numeric_column_ranges);
+    } else {
+      inline_filter = std::make_unique<NumericColumnFilter>(
+          std::move(numeric_column_ranges));
+    }
+    VMSDK_LOG(DEBUG, nullptr)
+        << "Performing vector search with numeric column filter";
+  } else if (parameters.filter_parse_results.root_predicate != nullptr) {
+    const std::shared_ptr<indexes::text::TextIndexSchema> text_index_schema =
+        parameters.index_schema->GetTextIndexSchema();
+    inline_filter = std::make_unique<InlineVectorFilter>(
+        parameters.filter_parse_results.root_predicate.get(), vector_index,
+        text_index_schema, parameters.filter_parse_results.query_operations);
+    VMSDK_LOG(DEBUG, nullptr) << "Performing vector search with inline filter";
+  }
+  return SearchVectorIndex(vector_index, parameters, std::move(inline_filter),
+                           filter_selectivity);
+}
+
 void AppendQueue(
     std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> &dest,
     std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> &src) {
@@ -160,11 +279,12 @@ inline PredicateType EvaluateAsComposedPredicate(
 
 // Helper fn to identify if query is not fully solved after the entries fetcher
 // search, meaning it requires prefilter evaluation Prefiltering is needed when
-// query contains an AND with numeric or tag predicates.
+// query contains an AND with numeric, tag or geo predicates.
 // It is also needed when negate is involved.
 inline bool IsUnsolvedQuery(QueryOperations query_operations) {
   return query_operations & (QueryOperations::kContainsNumeric |
-                             QueryOperations::kContainsTag) &&
+                             QueryOperations::kContainsTag |
+                             QueryOperations::kContainsGeo) &&
              query_operations & QueryOperations::kContainsAnd ||
          (query_operations & QueryOperations::kContainsNegate);
 }
@@ -336,6 +456,13 @@ size_t EvaluateFilterAsPrimary(
     entries_fetchers.push(std::move(fetcher));
     return size;
   }
+  if (predicate->GetType() == PredicateType::kGeo) {
+    auto geo_predicate = dynamic_cast<const GeoPredicate *>(predicate);
+    auto fetcher = geo_predicate->GetIndex()->Search(*geo_predicate, negate);
+    size_t size = fetcher->Size();
+    entries_fetchers.push(std::move(fetcher));
+    return size;
+  }
   if (predicate->GetType() == PredicateType::kText) {
     auto text_predicate = dynamic_cast<const TextPredicate *>(predicate);
     size_t size = text_predicate->EstimateSize(is_vec_query);
@@ -380,6 +507,7 @@ void EvaluatePrefilteredKeys(
   const std::shared_ptr<indexes::text::TextIndexSchema> text_index_schema =
       parameters.index_schema ? parameters.index_schema->GetTextIndexSchema()
                               : nullptr;
+  QueryProfile *profile = parameters.profile.get();
   while (!entries_fetchers.empty()) {
     auto fetcher = std::move(entries_fetchers.front());
     entries_fetchers.pop();
@@ -397,9 +525,15 @@ void EvaluatePrefilteredKeys(
       indexes::PrefilterEvaluator key_evaluator(
           text_index, parameters.filter_parse_results.query_operations);
       BACKGROUND_PAUSEPOINT("search_prefilter_eval");
+      if (profile) {
+        ++profile->keys_evaluated;
+      }
       // 3. Evaluate predicate
       if (key_evaluator.Evaluate(
               *parameters.filter_parse_results.root_predicate, key)) {
+        if (profile) {
+          ++profile->keys_matched;
+        }
         bool result = appender(key, result_keys);
         if (needs_dedup && result) {
           result_keys.insert(key->Str().data());
@@ -529,8 +663,10 @@ absl::StatusOr<std::vector<indexes::Neighbor>> MaybeAddIndexedContent(
           }
           break;
         }
-        case indexes::IndexerType::kText: {
-          // Text indexes don't store retrievable raw values
+        case indexes::IndexerType::kText:
+        case indexes::IndexerType::kGeo: {
+          // Text indexes don't store retrievable raw values, and geo indexes
+          // only keep the parsed point, not the original string.
           any_value_missing = true;
           break;
         }
@@ -561,6 +697,60 @@ absl::StatusOr<std::vector<indexes::Neighbor>> MaybeAddIndexedContent(
   return results;
 }
 
+// Records the query planner's decision in the timings and the profile of the
+// query, if any.
+void RecordPlan(const SearchParameters &parameters, absl::string_view plan,
+                size_t estimated_entries, size_t fetchers) {
+  if (parameters.timings) {
+    parameters.timings->plan = plan;
+  }
+  if (!parameters.profile) {
+    return;
+  }
+  parameters.profile->estimated_entries = estimated_entries;
+  parameters.profile->fetchers = fetchers;
+}
+
+// Passes every key of the fetchers of a query that needs no prefilter
+// evaluation to the appender, until the appender returns false.
+void AppendSolvedFilterMatches(
+    const SearchParameters &parameters,
+    std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> &entries_fetchers,
+    absl::AnyInvocable<bool(const InternedStringPtr &,
+                            absl::flat_hash_set<const char *> &)>
+        appender,
+    size_t qualified_entries) {
+  bool needs_dedup =
+      NeedsDeduplication(parameters.filter_parse_results.query_operations);
+  absl::flat_hash_set<const char *> seen_keys;
+  if (needs_dedup) {
+    seen_keys.reserve(std::min(qualified_entries, static_cast<size_t>(5000)));
+  }
+  while (!entries_fetchers.empty()) {
+    auto fetcher = std::move(entries_fetchers.front());
+    entries_fetchers.pop();
+    auto iterator = fetcher->Begin();
+    while (!iterator->Done()) {
+      const auto &key = **iterator;
+      BACKGROUND_PAUSEPOINT("search_entries_fetcher");
+      if (needs_dedup) {
+        if (seen_keys.contains(key->Str().data())) {
+          iterator->Next();
+          continue;
+        }
+        seen_keys.insert(key->Str().data());
+      }
+      if (!appender(key, seen_keys)) {
+        return;
+      }
+      iterator->Next();
+      if (parameters.cancellation_token->IsCancelled()) {
+        return;
+      }
+    }
+  }
+}
+
 absl::StatusOr<std::vector<indexes::Neighbor>> SearchNonVectorQuery(
     const SearchParameters &parameters) {
   std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> entries_fetchers;
@@ -589,48 +779,201 @@ absl::StatusOr<std::vector<indexes::Neighbor>> SearchNonVectorQuery(
   // Cannot skip evaluation if the query contains unsolved composed operations.
   bool requires_prefilter_evaluation =
       IsUnsolvedQuery(parameters.filter_parse_results.query_operations);
-  if (!requires_prefilter_evaluation) {
-    bool needs_dedup =
-        NeedsDeduplication(parameters.filter_parse_results.query_operations);
-    absl::flat_hash_set<const char *> seen_keys;
-    if (needs_dedup) {
-      seen_keys.reserve(std::min(qualified_entries, static_cast<size_t>(5000)));
+  RecordPlan(parameters,
+             requires_prefilter_evaluation ? "filter-evaluate" : "filter",
+             qualified_entries, entries_fetchers.size());
+  if (requires_prefilter_evaluation) {
+    EvaluatePrefilteredKeys(parameters, entries_fetchers,
+                            std::move(results_appender), qualified_entries,
+                            /*stop_on_fetch_limit=*/true);
+  } else {
+    AppendSolvedFilterMatches(parameters, entries_fetchers,
+                              std::move(results_appender), qualified_entries);
+  }
+  if (fetch_limited) {
+    nonvector_results_fetched_limited_count.Increment();
+  }
+  return neighbors;
+}
+
+// Term frequency saturation of the BM25 text score.
+constexpr double kTextScoreK1{1.2};
+
+void CollectTextPredicates(
+    const Predicate *predicate,
+    std::vector<const TextPredicate *> &text_predicates) {
+  switch (predicate->GetType()) {
+    case PredicateType::kText:
+      text_predicates.push_back(dynamic_cast<const TextPredicate *>(predicate));
+      break;
+    case PredicateType::kComposedAnd:
+    case PredicateType::kComposedOr:
+      for (const auto &child :
+           dynamic_cast<const ComposedPredicate *>(predicate)->GetChildren()) {
+        CollectTextPredicates(child.get(), text_predicates);
+      }
+      break;
+    default:
+      // Negated terms do not contribute to the relevance of a match.
+      break;
+  }
+}
+
+std::vector<indexes::Neighbor> RankTextMatches(
+    const SearchParameters &parameters, size_t count) {
+  std::vector<const TextPredicate *> text_predicates;
+  CollectTextPredicates(parameters.filter_parse_results.root_predicate.get(),
+                        text_predicates);
+  std::vector<double> idfs;
+  idfs.reserve(text_predicates.size());
+  for (const auto *text_predicate : text_predicates) {
+    const double key_count = static_cast<double>(
+        text_predicate->GetTextIndexSchema()->GetTrackedKeyCount());
+    const double doc_frequency =
+        std::max<size_t>(1, text_predicate->EstimateSize(true));
+    idfs.push_back(std::log(
+        1.0 + (key_count - doc_frequency + 0.5) / (doc_frequency + 0.5)));
+  }
+  const std::shared_ptr<indexes::text::TextIndexSchema> text_index_schema =
+      parameters.index_schema->GetTextIndexSchema();
+  auto score_key = [&](const InternedStringPtr &key) {
+    double score = 0;
+    const indexes::text::TextIndex *text_index =
+        text_index_schema ? text_index_schema->GetPerKeyTextIndex(key, false)
+                          : nullptr;
+    if (!text_index) {
+      return score;
     }
-    while (!entries_fetchers.empty()) {
-      auto fetcher = std::move(entries_fetchers.front());
-      entries_fetchers.pop();
-      auto iterator = fetcher->Begin();
-      while (!iterator->Done()) {
-        const auto &key = **iterator;
-        BACKGROUND_PAUSEPOINT("search_entries_fetcher");
-        if (needs_dedup) {
-          if (seen_keys.contains(key->Str().data())) {
-            iterator->Next();
-            continue;
-          }
-          seen_keys.insert(key->Str().data());
-        }
-        // Check if we've reached the limit
-        if (neighbors.size() >= max_keys) {
-          nonvector_results_fetched_limited_count.Increment();
-          return neighbors;
-        }
-        neighbors.emplace_back(indexes::Neighbor{key, 0.0f});
-        iterator->Next();
-        if (parameters.cancellation_token->IsCancelled()) {
-          return neighbors;
+    for (size_t i = 0; i < text_predicates.size(); ++i) {
+      auto result = text_predicates[i]->Evaluate(*text_index, key, true);
+      if (!result.matches) {
+        continue;
+      }
+      double term_frequency = 0;
+      if (result.filter_iterator) {
+        while (!result.filter_iterator->DonePositions()) {
+          ++term_frequency;
+          result.filter_iterator->NextPosition();
         }
       }
+      term_frequency = std::max(term_frequency, 1.0);
+      score += idfs[i] * term_frequency * (kTextScoreK1 + 1) /
+               (term_frequency + kTextScoreK1);
     }
-    return neighbors;
+    return score;
+  };
+  // A min-heap of the best `count` keys seen so far, so that every match is
+  // scored without holding more than `count` of them.
+  using ScoredKey = std::pair<double, InternedStringPtr>;
+  auto better = [](const ScoredKey &a, const ScoredKey &b) {
+    return a.first > b.first;
+  };
+  std::priority_queue<ScoredKey, std::vector<ScoredKey>, decltype(better)>
+      best(better);
+  auto results_appender =
+      [&best, &score_key, count](
+          const InternedStringPtr &key,
+          absl::flat_hash_set<const char *> &top_keys) -> bool {
+    if (count == 0) {
+      return false;
+    }
+    const double score = score_key(key);
+    if (best.size() < count) {
+      best.emplace(score, key);
+    } else if (score > best.top().first) {
+      best.pop();
+      best.emplace(score, key);
+    }
+    return true;
+  };
+
+  std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> entries_fetchers;
+  size_t qualified_entries = EvaluateFilterAsPrimary(
+      parameters, parameters.filter_parse_results.root_predicate.get(),
+      entries_fetchers, false);
+  RecordPlan(parameters, "hybrid", qualified_entries, entries_fetchers.size());
+  if (IsUnsolvedQuery(parameters.filter_parse_results.query_operations)) {
+    EvaluatePrefilteredKeys(parameters, entries_fetchers,
+                            std::move(results_appender), qualified_entries,
+                            /*stop_on_fetch_limit=*/true);
+  } else {
+    AppendSolvedFilterMatches(parameters, entries_fetchers,
+                              std::move(results_appender), qualified_entries);
   }
-  EvaluatePrefilteredKeys(parameters, entries_fetchers,
-                          std::move(results_appender), qualified_entries,
-                          /*stop_on_fetch_limit=*/true);
-  if (fetch_limited) {
-    nonvector_results_fetched_limited_count.Increment();
+  std::vector<indexes::Neighbor> results(best.size());
+  for (size_t i = results.size(); i > 0; --i) {
+    results[i - 1] = indexes::Neighbor{best.top().second,
+                                       static_cast<float>(-best.top().first)};
+    best.pop();
   }
-  return neighbors;
+  return results;
+}
+
+std::vector<indexes::Neighbor> FuseResults(
+    std::vector<indexes::Neighbor> text_results,
+    std::vector<indexes::Neighbor> vector_results,
+    const FusionParameter &fusion, size_t k) {
+  std::vector<indexes::Neighbor> fused;
+  fused.reserve(text_results.size() + vector_results.size());
+  std::vector<double> scores;
+  scores.reserve(fused.capacity());
+  InternedStringHashMap<size_t> fused_index;
+  auto fuse = [&](std::vector<indexes::Neighbor> &results, double weight) {
+    if (results.empty()) {
+      return;
+    }
+    const double best = results.front().distance;
+    const double worst = results.back().distance;
+    for (size_t rank = 0; rank < results.size(); ++rank) {
+      double score;
+      if (fusion.method == FusionMethod::kRRF) {
+        score = 1.0 / (fusion.rrf_constant + rank + 1);
+      } else if (worst > best) {
+        score = weight * (worst - results[rank].distance) / (worst - best);
+      } else {
+        score = weight;
+      }
+      auto [itr, inserted] =
+          fused_index.try_emplace(results[rank].external_id, fused.size());
+      if (inserted) {
+        fused.emplace_back(std::move(results[rank]));
+        scores.push_back(score);
+      } else {
+        scores[itr->second] += score;
+      }
+    }
+  };
+  fuse(text_results, fusion.text_weight);
+  fuse(vector_results, fusion.vector_weight);
+  for (size_t i = 0; i < fused.size(); ++i) {
+    fused[i].distance = -scores[i];
+  }
+  std::sort(fused.begin(), fused.end(),
+            [](const indexes::Neighbor &a, const indexes::Neighbor &b) {
+              if (a.distance != b.distance) {
+                return a.distance < b.distance;
+              }
+              return a.external_id->Str() < b.external_id->Str();
+            });
+  if (fused.size() > k) {
+    fused.erase(fused.begin() + k, fused.end());
+  }
+  return fused;
+}
+
+// Runs a hybrid query: the filter is evaluated as a text query whose matches
+// are ranked by text score, the vector query runs without the filter, and the
+// two rankings are fused. Both rankings are computed in this reader's time
+// slice so that they observe the same index state.
+absl::StatusOr<std::vector<indexes::Neighbor>> SearchHybridQuery(
+    indexes::VectorBase *vector_index, const SearchParameters &parameters) {
+  query_hybrid_fusion_count.Increment();
+  auto text_results = RankTextMatches(parameters, parameters.k);
+  VMSDK_ASSIGN_OR_RETURN(
+      auto vector_results,
+      SearchVectorIndex(vector_index, parameters, nullptr, std::nullopt));
+  return FuseResults(std::move(text_results), std::move(vector_results),
+                     *parameters.fusion, parameters.k);
 }
 
 absl::StatusOr<std::vector<indexes::Neighbor>> DoSearch(
@@ -660,15 +1003,22 @@ absl::StatusOr<std::vector<indexes::Neighbor>> DoSearch(
   }
 
   if (!parameters.filter_parse_results.root_predicate) {
+    RecordPlan(parameters, "vector", 0, 0);
     return PerformVectorSearch(vector_index, parameters);
   }
+  if (parameters.fusion.has_value()) {
+    lock.SetMayProlong();
+    return SearchHybridQuery(vector_index, parameters);
+  }
   std::queue<std::unique_ptr<indexes::EntriesFetcherBase>> entries_fetchers;
   size_t qualified_entries = EvaluateFilterAsPrimary(
       parameters, parameters.filter_parse_results.root_predicate.get(),
       entries_fetchers, false);
+  const size_t fetchers = entries_fetchers.size();
 
   // Query planner makes the decision for pre-filtering vs inline-filtering.
   if (UsePreFiltering(qualified_entries, vector_index)) {
+    RecordPlan(parameters, "prefilter", qualified_entries, fetchers);
     VMSDK_LOG(DEBUG, nullptr)
         << "Using pre-filter query execution, qualified entries="
         << qualified_entries;
@@ -682,7 +1032,18 @@ absl::StatusOr<std::vector<indexes::Neighbor>> DoSearch(
   }
   ++Metrics::GetStats().query_inline_filtering_requests_cnt;
   lock.SetMayProlong();
-  return PerformVectorSearch(vector_index, parameters);
+  auto filter_selectivity =
+      FilterAwareSelectivity(qualified_entries, vector_index);
+  if (filter_selectivity.has_value()) {
+    VMSDK_LOG(DEBUG, nullptr)
+        << "Using filter-aware HNSW traversal, selectivity="
+        << *filter_selectivity;
+    query_filter_aware_count.Increment();
+  }
+  RecordPlan(parameters,
+             filter_selectivity.has_value() ? "filter-aware" : "inline-filter",
+             qualified_entries, fetchers);
+  return PerformVectorSearch(vector_index, parameters, filter_selectivity);
 }
 
 // Check if no results should be returned based on query parameters.
@@ -785,10 +1146,17 @@ SerializationRange SearchResult::GetSerializationRange(
 }
 
 absl::Status Search(SearchParameters &parameters, SearchMode search_mode) {
+  std::optional<vmsdk::StopWatch> search_time;
+  if (parameters.timings) {
+    search_time.emplace();
+  }
   auto &time_sliced_mutex = parameters.index_schema->GetTimeSlicedMutex();
   vmsdk::ReaderMutexLock lock(&time_sliced_mutex);
   absl::StatusOr<std::vector<indexes::Neighbor>> neighbors =
       DoSearch(parameters, search_mode, lock);
+  if (neighbors.ok()) {
+    parameters.index_schema->RemoveExpiredNeighbors(*neighbors);
+  }
   VMSDK_ASSIGN_OR_RETURN(
       auto result, MaybeAddIndexedContent(std::move(neighbors), parameters));
   size_t total_count = result.size();
@@ -796,14 +1164,25 @@ absl::Status Search(SearchParameters &parameters, SearchMode search_mode) {
       SearchResult(total_count, std::move(result), parameters);
   parameters.index_schema->PopulateIndexMutationSequenceNumbers(
       parameters.search_result.neighbors);
+  if (parameters.timings) {
+    parameters.timings->search_time = search_time->Duration();
+    parameters.timings->results = total_count;
+  }
   return absl::OkStatus();
 }
 
 absl::Status SearchAsync(std::unique_ptr<SearchParameters> parameters,
                          vmsdk::ThreadPool *thread_pool,
                          SearchMode search_mode) {
+  std::optional<vmsdk::StopWatch> queue_time;
+  if (parameters->timings) {
+    queue_time.emplace();
+  }
   thread_pool->Schedule(
-      [parameters = std::move(parameters), search_mode]() mutable {
+      [parameters = std::move(parameters), search_mode, queue_time]() mutable {
+        if (parameters->timings) {
+          parameters->timings->queue_wait_time = queue_time->Duration();
+        }
         auto res = Search(*parameters, search_mode);
         BACKGROUND_PAUSEPOINT("background_search_completing");
         parameters->search_result.status = res;
@@ -843,6 +1222,9 @@ void IncrementQueryOperationMetrics(QueryOperations query_operations) {
   if (query_operations & QueryOperations::kContainsTag) {
     query_tag_count.Increment();
   }
+  if (query_operations & QueryOperations::kContainsGeo) {
+    query_geo_count.Increment();
+  }
   // Text operation type metrics
   if (query_operations & QueryOperations::kContainsTextTerm) {
     query_text_term_count.Increment();
@@ -21,6 +21,8 @@
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "src/commands/filter_parser.h"
 #include "src/index_schema.h"
 #include "src/indexes/index_base.h"
@@ -46,6 +48,18 @@ struct SortByParameter {
   SortOrder order{SortOrder::kAscending};
 };
 
+// Combines the text and vector rankings of a hybrid query, see FuseResults.
+enum class FusionMethod { kRRF, kWeighted };
+constexpr uint32_t kDefaultRRFConstant{60};
+struct FusionParameter {
+  FusionMethod method{FusionMethod::kRRF};
+  // Reciprocal rank fusion scores a key as the sum of 1 / (constant + rank).
+  uint32_t rrf_constant{kDefaultRRFConstant};
+  // Weighted fusion sums the min-max normalized scores of each ranking.
+  double text_weight{0.5};
+  double vector_weight{0.5};
+};
+
 constexpr int64_t kTimeoutMS{50000};
 constexpr size_t kMaxTimeoutMs{60000};
 constexpr absl::string_view kOOMMsg{
@@ -73,6 +87,10 @@ constexpr absl::string_view kVectorFilterDelimiter{"=>"};
 constexpr absl::string_view kSlop{"SLOP"};
 constexpr absl::string_view kInorder{"INORDER"};
 constexpr absl::string_view kVerbatim{"VERBATIM"};
+constexpr absl::string_view kFusionParam{"FUSION"};
+constexpr absl::string_view kFusionRRF{"RRF"};
+constexpr absl::string_view kFusionRRFConstant{"K"};
+constexpr absl::string_view kFusionWeights{"WEIGHTS"};
 
 struct LimitParameter {
   uint64_t first_index{0};
@@ -154,6 +172,57 @@ enum ContentProcessing {
   kContentionCheckRequired,  // Content and contention check is required.
 };
 
+//
+// Timings of a single query and the strategy its planner picked, the part of
+// its execution statistics that is cheap to collect. Collected when the query
+// runs under FT.PROFILE or while the slow log is enabled. The search path fills
+// it in through the (const) parameters, so every field is written by at most
+// one thread at a time.
+//
+struct QueryTimings {
+  // One entry per shard of a fanout, the local shard included.
+  struct Shard {
+    std::string address;
+    absl::Duration time;
+    absl::Status status;
+    size_t results{0};
+  };
+  absl::Duration parse_time;
+  // Time spent in the reader thread pool queue before the search started.
+  absl::Duration queue_wait_time;
+  absl::Duration search_time;
+  absl::Duration content_fetch_time;
+  // The execution strategy picked by the query planner, see DoSearch. Always
+  // one of its string literals.
+  absl::string_view plan;
+  size_t results{0};
+  std::vector<Shard> shards;
+};
+
+//
+// Detailed execution statistics of a single query, collected only when the
+// query runs under FT.PROFILE: counting them slows down the search. Filled in
+// the same way as QueryTimings.
+//
+struct QueryProfile {
+  // One entry per FT.AGGREGATE stage, in execution order.
+  struct Stage {
+    std::string name;
+    size_t input_records{0};
+    size_t output_records{0};
+    absl::Duration time;
+  };
+  // The planner's estimate of the entries qualified by the filter and the
+  // number of index fetchers it produced.
+  size_t estimated_entries{0};
+  size_t fetchers{0};
+  // Keys run through the prefilter evaluator, and those it accepted.
+  size_t keys_evaluated{0};
+  size_t keys_matched{0};
+  hnswlib::SearchStats hnsw;
+  std::vector<Stage> stages;
+};
+
 struct SearchParameters {
   mutable cancel::Token cancellation_token;
   virtual ~SearchParameters() = default;
@@ -224,6 +293,10 @@ struct SearchParameters {
   // The sortby parameter, populated by FT.SEARCH SORTBY clause or
   // deserialized from gRPC requests. Available to all query operations.
   std::optional<SortByParameter> sortby_parameter;
+  // The fusion parameter, populated by the FT.SEARCH FUSION clause. When set,
+  // a vector query with a text filter runs as a hybrid query: the text matches
+  // and the nearest neighbors are ranked separately and then fused.
+  std::optional<FusionParameter> fusion;
   //
   // Called when the query is complete and results are ready to be sent back to
   // the client.
@@ -241,6 +314,12 @@ struct SearchParameters {
   // resolution due to contention with in-flight mutations.
   unsigned int content_resolution_blocked_{0};
 
+  // Set by FT.PROFILE and, while the slow log is enabled, by FT.SEARCH and
+  // FT.AGGREGATE.
+  mutable std::optional<QueryTimings> timings;
+  // Set by FT.PROFILE only. Null otherwise.
+  std::unique_ptr<QueryProfile> profile;
+
   // In CME, when a LocalResponderSearch is used, the neighbors of that
   // operation get moved into this operation. But the neighbors has string_view
   // references into the return_attributes of the owning operation. So in order
@@ -288,8 +367,11 @@ size_t EvaluateFilterAsPrimary(
     bool negate);
 
 // Defined in the header to support testing
+// A filter_selectivity selects the filter-aware HNSW traversal, see
+// FilterAwareSelectivity.
 absl::StatusOr<std::vector<indexes::Neighbor>> PerformVectorSearch(
-    indexes::VectorBase* vector_index, const SearchParameters& parameters);
+    indexes::VectorBase* vector_index, const SearchParameters& parameters,
+    std::optional<double> filter_selectivity = std::nullopt);
 
 std::priority_queue<std::pair<float, hnswlib::labeltype>>
 CalcBestMatchingPrefilteredKeys(
@@ -297,6 +379,27 @@ CalcBestMatchingPrefilteredKeys(
     std::queue<std::unique_ptr<indexes::EntriesFetcherBase>>& entries_fetchers,
     indexes::VectorBase* vector_index, size_t qualified_entries);
 
+// Defined in the header to support testing
+// Fuses the two rankings of a hybrid query into the best k keys. Each ranking
+// is ordered by ascending distance; the text ranking uses the negated text
+// score as its distance. The fused neighbors carry the negated fused score as
+// their distance, so they keep sorting best first like any vector result.
+std::vector<indexes::Neighbor> FuseResults(
+    std::vector<indexes::Neighbor> text_results,
+    std::vector<indexes::Neighbor> vector_results,
+    const FusionParameter& fusion, size_t k);
+
+// Defined in the header to support testing
+// Ranks every match of the filter of a hybrid query by a BM25 score and keeps
+// the best `count`, ordered by the negated score as their distance. Matches
+// are scored through the per-key text index as they are fetched, so the
+// ranking is not limited to the first max-nonvector-search-results-fetched
+// matches. The text index keeps no document lengths, so the score has no
+// length normalization: each term contributes its inverse document frequency
+// weighted by its saturated term frequency in the key.
+std::vector<indexes::Neighbor> RankTextMatches(
+    const SearchParameters& parameters, size_t count);
+
 bool QueryHasTextPredicate(const SearchParameters& parameters);
 
 // Check if no results should be returned based on limit parameters
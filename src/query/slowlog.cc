@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/query/slowlog.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "absl/base/no_destructor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "src/query/search.h"
+#include "src/valkey_search_options.h"
+#include "vmsdk/src/module_config.h"
+
+namespace valkey_search::query {
+
+SlowLog &SlowLog::Instance() {
+  static absl::NoDestructor<SlowLog> instance;
+  return *instance;
+}
+
+bool SlowLog::IsEnabled() {
+  return options::GetSlowLogLogSlowerThan().GetValue() >= 0 &&
+         options::GetSlowLogMaxLen().GetValue() > 0;
+}
+
+void SlowLog::MaybeRecord(absl::Duration duration, absl::string_view command,
+                          absl::string_view index_name,
+                          absl::string_view query, const QueryTimings &timings,
+                          absl::Duration reply_time) {
+  auto threshold = options::GetSlowLogLogSlowerThan().GetValue();
+  if (threshold < 0 || duration < absl::Microseconds(threshold)) {
+    return;
+  }
+  auto max_len = static_cast<size_t>(options::GetSlowLogMaxLen().GetValue());
+  if (max_len != slots_.size()) {
+    Resize(max_len);
+  }
+  if (slots_.empty()) {
+    return;
+  }
+  auto &entry = slots_[next_];
+  next_ = (next_ + 1) % slots_.size();
+  len_ = std::min(len_ + 1, slots_.size());
+  entry.id = next_id_++;
+  entry.time = absl::Now();
+  entry.duration = duration;
+  entry.command.assign(command);
+  entry.index_name.assign(index_name);
+  entry.query.assign(vmsdk::config::RedactIfNeeded(query));
+  entry.plan.assign(timings.plan);
+  entry.results = timings.results;
+  entry.parse_time = timings.parse_time;
+  entry.queue_wait_time = timings.queue_wait_time;
+  entry.search_time = timings.search_time;
+  entry.content_fetch_time = timings.content_fetch_time;
+  entry.reply_time = reply_time;
+  entry.shards.assign(timings.shards.begin(), timings.shards.end());
+}
+
+std::vector<const SlowLog::Entry *> SlowLog::Get(size_t count) const {
+  std::vector<const Entry *> entries;
+  count = std::min(count, len_);
+  entries.reserve(count);
+  for (size_t i = 1; i <= count; ++i) {
+    entries.push_back(&slots_[(next_ + slots_.size() - i) % slots_.size()]);
+  }
+  return entries;
+}
+
+void SlowLog::Reset() {
+  next_ = 0;
+  len_ = 0;
+}
+
+void SlowLog::Resize(size_t max_len) {
+  std::vector<Entry> slots(max_len);
+  size_t kept = std::min(len_, max_len);
+  // Move the newest entries, oldest first, to the start of the new ring.
+  for (size_t i = 0; i < kept; ++i) {
+    slots[i] = std::move(
+        slots_[(next_ + slots_.size() - kept + i) % slots_.size()]);
+  }
+  slots_ = std::move(slots);
+  len_ = kept;
+  next_ = max_len == 0 ? 0 : kept % max_len;
+}
+
+}  // namespace valkey_search::query
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_QUERY_SLOWLOG_H_
+#define VALKEYSEARCH_SRC_QUERY_SLOWLOG_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "src/query/search.h"
+
+namespace valkey_search::query {
+
+//
+// The slow log keeps the most recent FT.SEARCH and FT.AGGREGATE queries whose
+// end to end latency exceeded the slowlog-log-slower-than threshold, with the
+// execution statistics of the query.
+//
+// Unlike the engine's SLOWLOG, which only sees the main thread part of a
+// blocked command, the latency covers the queueing, the search on the reader
+// threads, the fanout and the reply.
+//
+// Queries are recorded when their reply is sent, which always happens on the
+// main thread, as do FT.SLOWLOG and the config updates. So the log needs no
+// synchronization. The entries are kept in a ring of preallocated slots whose
+// strings and vectors are reused, so recording a query does not allocate once
+// the ring has wrapped around.
+//
+class SlowLog {
+ public:
+  struct Entry {
+    uint64_t id{0};
+    absl::Time time;
+    absl::Duration duration;
+    std::string command;
+    std::string index_name;
+    // Redacted when user data is hidden from the logs.
+    std::string query;
+    std::string plan;
+    size_t results{0};
+    absl::Duration parse_time;
+    absl::Duration queue_wait_time;
+    absl::Duration search_time;
+    absl::Duration content_fetch_time;
+    absl::Duration reply_time;
+    std::vector<QueryTimings::Shard> shards;
+  };
+
+  static SlowLog &Instance();
+
+  // Whether queries should collect the timings recorded in the log.
+  static bool IsEnabled();
+
+  // Records the query if its duration exceeds the threshold.
+  void MaybeRecord(absl::Duration duration, absl::string_view command,
+                   absl::string_view index_name, absl::string_view query,
+                   const QueryTimings &timings, absl::Duration reply_time);
+
+  // Up to count entries, the most recent first.
+  std::vector<const Entry *> Get(size_t count) const;
+  size_t Len() const { return len_; }
+  void Reset();
+
+ private:
+  // Resizes the ring to the configured length, keeping the newest entries.
+  void Resize(size_t max_len);
+
+  std::vector<Entry> slots_;
+  // The slot the next entry is written to.
+  size_t next_{0};
+  size_t len_{0};
+  uint64_t next_id_{0};
+};
+
+}  // namespace valkey_search::query
+
+#endif  // VALKEYSEARCH_SRC_QUERY_SLOWLOG_H_
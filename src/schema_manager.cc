@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -26,6 +28,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "highwayhash/arch_specific.h"
 #include "highwayhash/hh_types.h"
 #include "highwayhash/highwayhash.h"
@@ -55,6 +58,13 @@ constexpr absl::string_view kIndexSchemaBackfillBatchSizeConfig(
     "backfill-batch-size");
 constexpr uint32_t kIndexSchemaBackfillBatchSize{10240};
 
+constexpr absl::string_view kExpiryBatchSizeConfig("expiry-batch-size");
+constexpr uint32_t kExpiryBatchSize{1024};
+
+constexpr absl::string_view kDefragMaxTimeUsConfig("defrag-max-time-us");
+constexpr uint32_t kDefragMaxTimeUs{1000};
+constexpr uint32_t kMaxDefragMaxTimeUs{1000000};
+
 namespace options {
 
 /// Register the "--max-indexes" flag. Controls the max number of indexes we can
@@ -86,6 +96,34 @@ vmsdk::config::Number &GetBackfillBatchSize() {
   return dynamic_cast<vmsdk::config::Number &>(*backfill_batch_size);
 }
 
+/// Register the "--expiry-batch-size" flag. Controls the max number of expired
+/// keys removed from the indexes per server cron run, 0 to leave the removal
+/// to the deletion of the keys by the server.
+static auto expiry_batch_size =
+    vmsdk::config::NumberBuilder(kExpiryBatchSizeConfig, kExpiryBatchSize, 0,
+                                 std::numeric_limits<int32_t>::max())
+        .WithValidationCallback(CHECK_RANGE(
+            0, std::numeric_limits<int32_t>::max(), kExpiryBatchSizeConfig))
+        .Build();
+
+vmsdk::config::Number &GetExpiryBatchSize() {
+  return dynamic_cast<vmsdk::config::Number &>(*expiry_batch_size);
+}
+
+/// Register the "--defrag-max-time-us" flag. Controls the max time spent
+/// defragmenting index memory per call of the server's active defrag, 0 to
+/// leave index memory alone.
+static auto defrag_max_time_us =
+    vmsdk::config::NumberBuilder(kDefragMaxTimeUsConfig, kDefragMaxTimeUs, 0,
+                                 kMaxDefragMaxTimeUs)
+        .WithValidationCallback(
+            CHECK_RANGE(0, kMaxDefragMaxTimeUs, kDefragMaxTimeUsConfig))
+        .Build();
+
+vmsdk::config::Number &GetDefragMaxTimeUs() {
+  return dynamic_cast<vmsdk::config::Number &>(*defrag_max_time_us);
+}
+
 }  // namespace options
 
 // Randomly generated 32 bit key for fingerprinting the metadata.
@@ -109,6 +147,7 @@ SchemaManager::SchemaManager(
           std::move(server_events_subscriber_callback)),
       mutations_thread_pool_(mutations_thread_pool),
       detached_ctx_(vmsdk::MakeUniqueValkeyDetachedThreadSafeContext(ctx)),
+      backfill_coordinator_(mutations_thread_pool),
       coordinator_enabled_(coordinator_enabled) {
   RegisterRDBCallback(
       data_model::RDB_SECTION_INDEX_SCHEMA,
@@ -550,6 +589,7 @@ void SchemaManager::OnSwapDB(ValkeyModuleSwapDbInfo *swap_db_info) {
        absl::flat_hash_map<std::string, std::shared_ptr<IndexSchema>>()});
   std::swap(db_to_index_schemas_[swap_db_info->dbnum_first],
             db_to_index_schemas_[swap_db_info->dbnum_second]);
+  backfill_coordinator_.OnSwapDB(swap_db_info);
   for (auto &schema : db_to_index_schemas_[swap_db_info->dbnum_first]) {
     schema.second->OnSwapDB(swap_db_info);
   }
@@ -606,10 +646,81 @@ void SchemaManager::PerformBackfill(ValkeyModuleCtx *ctx, uint32_t batch_size) {
   absl::MutexLock lock(&db_to_index_schemas_mutex_);
   uint32_t remaining_count = batch_size;
   for (const auto &[db_num, inner_map] : db_to_index_schemas_) {
+    std::vector<std::shared_ptr<IndexSchema>> schemas;
+    schemas.reserve(inner_map.size());
     for (const auto &[name, schema] : inner_map) {
-      remaining_count -= schema->PerformBackfill(ctx, remaining_count);
+      schemas.push_back(schema);
+    }
+    // A scan step can visit more keys than asked for.
+    uint32_t scanned = backfill_coordinator_.PerformBackfill(
+        ctx, db_num, schemas, remaining_count);
+    remaining_count -= std::min(remaining_count, scanned);
+    for (const auto &schema : schemas) {
+      schema->MaybeFinishBulkLoad();
+    }
+  }
+}
+
+void SchemaManager::RemoveExpiredKeys(ValkeyModuleCtx *ctx,
+                                      uint32_t batch_size) {
+  absl::MutexLock lock(&db_to_index_schemas_mutex_);
+  uint32_t remaining_count = batch_size;
+  for (const auto &[db_num, inner_map] : db_to_index_schemas_) {
+    for (const auto &[name, schema] : inner_map) {
+      if (remaining_count == 0) {
+        return;
+      }
+      remaining_count -= schema->RemoveExpiredKeys(ctx, remaining_count);
+    }
+  }
+}
+
+void SchemaManager::Defrag(absl::FunctionRef<bool()> should_stop,
+                           absl::FunctionRef<void *(void *)> move) {
+  const auto max_time =
+      absl::Microseconds(options::GetDefragMaxTimeUs().GetValue());
+  if (max_time == absl::ZeroDuration()) {
+    return;
+  }
+  vmsdk::StopWatch stop_watch;
+  indexes::DefragContext ctx(
+      [&]() { return stop_watch.Duration() >= max_time || should_stop(); },
+      move);
+  // Schemas are copied out so that the mutex isn't held while waiting for
+  // their locks.
+  std::vector<std::tuple<uint32_t, std::string, std::shared_ptr<IndexSchema>>>
+      schemas;
+  {
+    absl::MutexLock lock(&db_to_index_schemas_mutex_);
+    for (const auto &[db_num, inner_map] : db_to_index_schemas_) {
+      for (const auto &[name, schema] : inner_map) {
+        schemas.emplace_back(db_num, name, schema);
+      }
+    }
+  }
+  std::sort(schemas.begin(), schemas.end(),
+            [](const auto &a, const auto &b) {
+              return std::tie(std::get<0>(a), std::get<1>(a)) <
+                     std::tie(std::get<0>(b), std::get<1>(b));
+            });
+  auto &cursor = defrag_cursor_.Get();
+  auto it = std::lower_bound(
+      schemas.begin(), schemas.end(),
+      std::tie(cursor.db_num, cursor.schema_name),
+      [](const auto &schema, const auto &position) {
+        return std::tie(std::get<0>(schema), std::get<1>(schema)) < position;
+      });
+  for (; it != schemas.end(); ++it) {
+    auto &[db_num, name, schema] = *it;
+    if (cursor.db_num != db_num || cursor.schema_name != name) {
+      cursor = {db_num, name, {}};
+    }
+    if (!schema->Defrag(ctx, cursor.schema_cursor)) {
+      return;
     }
   }
+  cursor = {};
+  ++Metrics::GetStats().defrag_cycles_cnt;
 }
 
 absl::Status SchemaManager::SaveIndexes(ValkeyModuleCtx *ctx, SafeRDB *rdb,
@@ -741,6 +852,8 @@ void SchemaManager::OnServerCronCallback(ValkeyModuleCtx *ctx,
                                          [[maybe_unused]] void *data) {
   SchemaManager::Instance().PerformBackfill(
       ctx, options::GetBackfillBatchSize().GetValue());
+  SchemaManager::Instance().RemoveExpiredKeys(
+      ctx, options::GetExpiryBatchSize().GetValue());
 }
 
 void SchemaManager::OnShutdownCallback(ValkeyModuleCtx *ctx,
@@ -17,10 +17,12 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "src/backfill_coordinator.h"
 #include "src/coordinator/coordinator.pb.h"
 #include "src/index_schema.h"
 #include "src/index_schema.pb.h"
@@ -90,6 +92,16 @@ class SchemaManager {
 
   void PerformBackfill(ValkeyModuleCtx *ctx, uint32_t batch_size)
       ABSL_LOCKS_EXCLUDED(db_to_index_schemas_mutex_);
+  // Removes up to `batch_size` expired keys from the indexes of all DBs.
+  void RemoveExpiredKeys(ValkeyModuleCtx *ctx, uint32_t batch_size)
+      ABSL_LOCKS_EXCLUDED(db_to_index_schemas_mutex_);
+  // Runs one time-bounded increment of the index defragmentation cycle,
+  // resuming where the previous increment stopped. `move` reallocates a heap
+  // allocation if the allocator considers it worth moving, see
+  // indexes::DefragContext.
+  void Defrag(absl::FunctionRef<bool()> should_stop,
+              absl::FunctionRef<void *(void *)> move)
+      ABSL_LOCKS_EXCLUDED(db_to_index_schemas_mutex_);
 
   void OnFlushDBCallback(ValkeyModuleCtx *ctx, ValkeyModuleEvent eid,
                          uint64_t subevent, void *data)
@@ -166,6 +178,15 @@ class SchemaManager {
       uint32_t db_num, absl::string_view name) const
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(db_to_index_schemas_mutex_);
   vmsdk::MainThreadAccessGuard<bool> staging_indices_due_to_repl_load_ = false;
+  // Shares one keyspace scan per DB across the schemas being backfilled.
+  BackfillCoordinator backfill_coordinator_;
+  // Where the defragmentation cycle resumes, schemas are visited in order.
+  struct DefragCursor {
+    uint32_t db_num{0};
+    std::string schema_name;
+    IndexSchema::DefragCursor schema_cursor;
+  };
+  vmsdk::MainThreadAccessGuard<DefragCursor> defrag_cursor_;
 
   bool coordinator_enabled_;
 };
@@ -13,6 +13,7 @@
 #include "src/schema_manager.h"
 #include "src/valkey_search.h"
 #include "vmsdk/src/debug.h"
+#include "vmsdk/src/memory_allocation.h"
 #include "vmsdk/src/utils.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
@@ -70,6 +71,20 @@ void OnShutdownCallback(ValkeyModuleCtx *ctx, ValkeyModuleEvent eid,
   SchemaManager::Instance().OnShutdownCallback(ctx, eid, subevent, data);
 }
 
+int OnDefragCallback(ValkeyModuleDefragCtx *ctx) {
+  SchemaManager::Instance().Defrag(
+      [ctx]() { return ValkeyModule_DefragShouldStop(ctx) != 0; },
+      [ctx](void *ptr) -> void * {
+        // Allocations made before the switch to the Valkey allocator can't
+        // be handed to it.
+        if (!vmsdk::IsValkeyAllocated(ptr)) {
+          return nullptr;
+        }
+        return ValkeyModule_DefragAlloc(ctx, ptr);
+      });
+  return 0;
+}
+
 void AtForkPrepare() { ValkeySearch::Instance().AtForkPrepare(); }
 
 void AfterForkParent() { ValkeySearch::Instance().AfterForkParent(); }
@@ -94,6 +109,7 @@ void SubscribeToServerEvents() {
                                       &OnFlushDBCallback);
   ValkeyModule_SubscribeToServerEvent(ctx, ValkeyModuleEvent_Shutdown,
                                       &OnShutdownCallback);
+  ValkeyModule_RegisterDefragFunc(ctx, &OnDefragCallback);
 }
 
 }  // namespace valkey_search::server_events
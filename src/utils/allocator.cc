@@ -13,10 +13,13 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/log/check.h"
+#include "absl/functional/function_ref.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 
 namespace valkey_search {
 
@@ -87,6 +90,10 @@ FixedSizeAllocator::~FixedSizeAllocator() {
 
 size_t FixedSizeAllocator::ChunkCount() const {
   absl::MutexLock lock(&mutex_);
+  return ChunkCountLocked();
+}
+
+size_t FixedSizeAllocator::ChunkCountLocked() const {
   auto size = fully_used_chunks_.Size();
   for (auto &chunk_group : chunks_grouped_by_free_entries_) {
     size += chunk_group.Size();
@@ -150,9 +157,12 @@ void FixedSizeAllocator::SelectCurrentChunk() {
       current_chunk_ ? CalcChunkFreeGroup(current_chunk_->free_list.size())
                      : kFreeEntriesPerChunkGroupSize;
   for (size_t i = 0; i < current_chunk_group; ++i) {
-    if (!chunks_grouped_by_free_entries_[i].Empty()) {
-      current_chunk_ = chunks_grouped_by_free_entries_[i].Front();
-      break;
+    for (auto chunk = chunks_grouped_by_free_entries_[i].Front(); chunk;
+         chunk = chunk->next) {
+      if (chunk != evacuating_chunk_) {
+        current_chunk_ = chunk;
+        return;
+      }
     }
   }
 }
@@ -179,6 +189,9 @@ void FixedSizeAllocator::Free(AllocatorChunk *chunk, char *ptr) {
       if (chunk == current_chunk_) {
         current_chunk_ = nullptr;
       }
+      if (chunk == evacuating_chunk_) {
+        evacuating_chunk_ = nullptr;
+      }
       delete chunk;
     }
     SelectCurrentChunk();
@@ -186,6 +199,84 @@ void FixedSizeAllocator::Free(AllocatorChunk *chunk, char *ptr) {
   DecrementRef();
 }
 
+absl::Span<const char> FixedSizeAllocator::BeginCompaction() {
+  absl::MutexLock lock(&mutex_);
+  if (!evacuating_chunk_) {
+    // Chunks in the highest free group are the sparsest.
+    AllocatorChunk *candidate = nullptr;
+    for (size_t i = kFreeEntriesPerChunkGroupSize; i > 0 && !candidate; --i) {
+      for (auto chunk = chunks_grouped_by_free_entries_[i - 1].Front(); chunk;
+           chunk = chunk->next) {
+        if (!candidate ||
+            chunk->free_list.size() > candidate->free_list.size()) {
+          candidate = chunk;
+        }
+      }
+    }
+    if (!candidate) {
+      return {};
+    }
+    const size_t entries = candidate->entries_in_chunk;
+    const size_t live = entries - candidate->free_list.size();
+    const size_t free_elsewhere = ChunkCountLocked() * entries -
+                                  active_allocations_ -
+                                  candidate->free_list.size();
+    // Only evacuate a chunk that is at least half empty and whose live
+    // buffers fit in the other chunks, so compaction never grows the
+    // allocator.
+    if (live * 2 > entries || live > free_elsewhere) {
+      return {};
+    }
+    evacuating_chunk_ = candidate;
+    if (current_chunk_ == candidate) {
+      current_chunk_ = nullptr;
+      SelectCurrentChunk();
+    }
+  }
+  return {evacuating_chunk_->data.get(),
+          BufferSize(evacuating_chunk_->entries_in_chunk, size_)};
+}
+
+bool FixedSizeAllocator::Compact(
+    size_t &position, size_t max_moves,
+    absl::FunctionRef<bool(const char *from, char *to)> relocate) {
+  std::vector<char *> live;
+  bool done;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!evacuating_chunk_) {
+      return true;
+    }
+    const size_t entries = evacuating_chunk_->entries_in_chunk;
+    char *data = evacuating_chunk_->data.get();
+    std::vector<bool> is_free(entries, false);
+    auto free_list = evacuating_chunk_->free_list;
+    while (!free_list.empty()) {
+      is_free[(free_list.top() - data) / size_] = true;
+      free_list.pop();
+    }
+    for (; position < entries && live.size() < max_moves; ++position) {
+      if (!is_free[position]) {
+        live.push_back(data + position * size_);
+      }
+    }
+    done = position >= entries;
+  }
+  for (auto from : live) {
+    char *to = Allocate();
+    if (!relocate(from, to)) {
+      Allocator::Free(to);
+    }
+  }
+  return done;
+}
+
+void FixedSizeAllocator::EndCompaction() {
+  absl::MutexLock lock(&mutex_);
+  evacuating_chunk_ = nullptr;
+  SelectCurrentChunk();
+}
+
 size_t GetPageSize() { return static_cast<size_t>(sysconf(_SC_PAGESIZE)); }
 
 size_t EntriesFitInChunk(size_t size, size_t num_pages) {
@@ -13,7 +13,9 @@
 #include <stack>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "src/utils/intrusive_list.h"
 #include "src/utils/intrusive_ref_count.h"
 
@@ -32,6 +34,13 @@ same-sized buffers.
 The `FixedSizeAllocator` prioritizes allocation from heavily utilized chunks.
 This approach enhances CPU cache locality and the formation of unutilized chunks
 which are deallocated.
+
+Churn can still leave many sparsely used chunks behind. These are compacted
+incrementally: BeginCompaction() picks the sparsest chunk whose live buffers fit
+in the free entries of the other chunks and stops allocating from it, and
+Compact() moves its live buffers elsewhere a batch at a time, letting the owner
+of each buffer switch to the new copy. Once the old buffers are freed the chunk
+is released.
 */
 
 struct AllocatorChunk;
@@ -72,6 +81,21 @@ class FixedSizeAllocator : public IntrusiveRefCount, public Allocator {
     return active_allocations_;
   }
   size_t ChunkCount() const ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the memory of the chunk being evacuated, selecting one if needed.
+  // An empty span means no chunk is sparse enough to be worth evacuating.
+  absl::Span<const char> BeginCompaction() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Visits the entries of the chunk being evacuated from position onwards
+  // and, for up to max_moves live buffers, allocates a new buffer outside the
+  // chunk and calls relocate(from, to). The callback copies the contents
+  // while it can guarantee `from` is still live and returns true once the
+  // owner uses `to`; the caller must then eventually free `from` with
+  // Allocator::Free. Otherwise `to` is freed. Advances position past the
+  // visited entries and returns whether every entry of the chunk was visited.
+  bool Compact(size_t &position, size_t max_moves,
+               absl::FunctionRef<bool(const char *from, char *to)> relocate)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Stops evacuating the current chunk, allocations may use it again.
+  void EndCompaction() ABSL_LOCKS_EXCLUDED(mutex_);
   ~FixedSizeAllocator() override;
   size_t ChunkSize() const override { return size_; }
 
@@ -84,11 +108,14 @@ class FixedSizeAllocator : public IntrusiveRefCount, public Allocator {
   size_t size_;
   IntrusiveList<AllocatorChunk> fully_used_chunks_ ABSL_GUARDED_BY(mutex_);
   AllocatorChunk *current_chunk_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  // Chunk being compacted, nothing is allocated from it.
+  AllocatorChunk *evacuating_chunk_ ABSL_GUARDED_BY(mutex_) = nullptr;
   size_t active_allocations_ ABSL_GUARDED_BY(mutex_){0};
   mutable absl::Mutex mutex_;
   void HandleChunkEntryUsageChange(AllocatorChunk *chunk, int old_free_group)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void SelectCurrentChunk() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  size_t ChunkCountLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void AllocateChunk() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void FreeImpl(char *ptr) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   bool require_ptr_alignment_;
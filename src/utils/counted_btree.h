@@ -0,0 +1,506 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_UTILS_COUNTED_BTREE_H_
+#define VALKEYSEARCH_SRC_UTILS_COUNTED_BTREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace valkey_search::utils {
+
+//
+// An order-statistics B+tree of (key, value) entries.
+//
+// Entries are kept sorted by key and then by the ordinal of the value, so the
+// same key may be associated with many values and an individual (key, value)
+// pair can still be located in logarithmic time. The entries themselves live in
+// sorted arrays in the leaves, which are chained together so range iteration is
+// a sequential walk. Inner nodes keep the number of entries below each child,
+// which makes counting the entries in a key range two root-to-leaf descents.
+//
+// The VOrdinal functor maps a value to the (cheap, totally ordered) token used
+// to break ties between equal keys. Inner nodes store the token rather than the
+// value itself, so separators never extend the lifetime of a value that was
+// removed from the tree.
+//
+// Not thread safe.
+//
+template <typename K, typename V, typename VOrdinal = std::identity,
+          size_t kLeafCapacity = 64, size_t kInnerCapacity = 64>
+class CountedBTree {
+ public:
+  struct Entry {
+    K key;
+    V value;
+  };
+
+ private:
+  using Ordinal = std::decay_t<std::invoke_result_t<VOrdinal, const V &>>;
+  static_assert(kLeafCapacity >= 4 && kInnerCapacity >= 4);
+  static constexpr size_t kLeafMin = kLeafCapacity / 4;
+  static constexpr size_t kInnerMin = kInnerCapacity / 4;
+
+  struct Separator {
+    K key;
+    Ordinal ordinal;
+  };
+
+  struct Node {
+    explicit Node(bool is_leaf) : is_leaf(is_leaf) {}
+    bool is_leaf;
+    uint32_t size{0};
+  };
+
+  struct Leaf : Node {
+    Leaf() : Node(true) {}
+    Leaf *next{nullptr};
+    Entry entries[kLeafCapacity];
+  };
+
+  // children[i] holds entries e with separators[i] <= e < separators[i + 1].
+  // separators[0] is unused.
+  struct Inner : Node {
+    Inner() : Node(false) {}
+    size_t counts[kInnerCapacity];
+    Node *children[kInnerCapacity];
+    Separator separators[kInnerCapacity];
+  };
+
+ public:
+  class ConstIterator {
+   public:
+    ConstIterator() = default;
+    const Entry &operator*() const { return leaf_->entries[pos_]; }
+    const Entry *operator->() const { return &leaf_->entries[pos_]; }
+    ConstIterator &operator++() {
+      ++pos_;
+      Normalize();
+      return *this;
+    }
+    bool operator==(const ConstIterator &other) const {
+      return leaf_ == other.leaf_ && pos_ == other.pos_;
+    }
+    bool operator!=(const ConstIterator &other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class CountedBTree;
+    ConstIterator(const Leaf *leaf, uint32_t pos) : leaf_(leaf), pos_(pos) {
+      Normalize();
+    }
+    // Positions past the end of a leaf are moved to the start of the next
+    // leaf. Only an empty root leaf can have no entries, and it has no
+    // successor, so this terminates at end().
+    void Normalize() {
+      while (leaf_ && pos_ >= leaf_->size) {
+        leaf_ = leaf_->next;
+        pos_ = 0;
+      }
+    }
+    const Leaf *leaf_{nullptr};
+    uint32_t pos_{0};
+  };
+
+  CountedBTree() : root_(new Leaf()) {}
+  ~CountedBTree() { Destroy(root_); }
+  CountedBTree(const CountedBTree &) = delete;
+  CountedBTree &operator=(const CountedBTree &) = delete;
+
+  size_t Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+  // Inserts the (key, value) entry. Returns false if it is already present.
+  bool Insert(const K &key, const V &value) {
+    std::optional<Split> split;
+    if (!Insert(root_, key, value, split)) {
+      return false;
+    }
+    if (split.has_value()) {
+      auto new_root = new Inner();
+      new_root->size = 2;
+      new_root->children[0] = root_;
+      new_root->counts[0] = size_ + 1 - split->count;
+      new_root->children[1] = split->node;
+      new_root->counts[1] = split->count;
+      new_root->separators[1] = split->separator;
+      root_ = new_root;
+    }
+    ++size_;
+    return true;
+  }
+
+  // Removes the (key, value) entry. Returns false if it is not present.
+  bool Erase(const K &key, const V &value) {
+    if (!Erase(root_, key, VOrdinal{}(value))) {
+      return false;
+    }
+    --size_;
+    if (!root_->is_leaf && root_->size == 1) {
+      auto old_root = static_cast<Inner *>(root_);
+      root_ = old_root->children[0];
+      delete old_root;
+    }
+    return true;
+  }
+
+  ConstIterator begin() const { return ConstIterator(FirstLeaf(), 0); }
+  ConstIterator end() const { return ConstIterator(); }
+
+  // First entry with entry.key >= key.
+  ConstIterator LowerBound(const K &key) const {
+    return Bound(key, /*upper=*/false).first;
+  }
+  // First entry with entry.key > key.
+  ConstIterator UpperBound(const K &key) const {
+    return Bound(key, /*upper=*/true).first;
+  }
+
+  // Number of entries with entry.key < key, or entry.key <= key when
+  // inclusive is set.
+  size_t CountLess(const K &key, bool inclusive) const {
+    return Bound(key, inclusive).second;
+  }
+
+  // Number of entries with keys in the range between start and end.
+  size_t Count(const K &start, const K &end, bool start_inclusive,
+               bool end_inclusive) const {
+    size_t before_start = CountLess(start, !start_inclusive);
+    size_t through_end = CountLess(end, end_inclusive);
+    return through_end > before_start ? through_end - before_start : 0;
+  }
+
+ private:
+  struct Split {
+    Node *node;
+    size_t count;
+    Separator separator;
+  };
+
+  static bool Less(const K &key, const Ordinal &ordinal, const K &other_key,
+                   const Ordinal &other_ordinal) {
+    if (key < other_key) {
+      return true;
+    }
+    if (other_key < key) {
+      return false;
+    }
+    return std::less<Ordinal>{}(ordinal, other_ordinal);
+  }
+
+  static Separator MakeSeparator(const Entry &entry) {
+    return {entry.key, VOrdinal{}(entry.value)};
+  }
+
+  static size_t Count(const Node *node) {
+    if (node->is_leaf) {
+      return node->size;
+    }
+    auto inner = static_cast<const Inner *>(node);
+    size_t count = 0;
+    for (uint32_t i = 0; i < inner->size; ++i) {
+      count += inner->counts[i];
+    }
+    return count;
+  }
+
+  // Index of the child that holds, or would hold, the (key, ordinal) entry.
+  static uint32_t ChildFor(const Inner *node, const K &key,
+                           const Ordinal &ordinal) {
+    uint32_t lo = 1;
+    uint32_t hi = node->size;
+    while (lo < hi) {
+      uint32_t mid = (lo + hi) / 2;
+      const auto &sep = node->separators[mid];
+      if (Less(key, ordinal, sep.key, sep.ordinal)) {
+        hi = mid;
+      } else {
+        lo = mid + 1;
+      }
+    }
+    return lo - 1;
+  }
+
+  // Position of the first entry with entry.key > key (upper) or
+  // entry.key >= key (!upper), along with the number of entries before it.
+  std::pair<ConstIterator, size_t> Bound(const K &key, bool upper) const {
+    auto past = [&](const K &other) {
+      return upper ? key < other : !(other < key);
+    };
+    size_t rank = 0;
+    const Node *node = root_;
+    while (!node->is_leaf) {
+      auto inner = static_cast<const Inner *>(node);
+      uint32_t lo = 1;
+      uint32_t hi = inner->size;
+      while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (past(inner->separators[mid].key)) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      for (uint32_t i = 0; i < lo - 1; ++i) {
+        rank += inner->counts[i];
+      }
+      node = inner->children[lo - 1];
+    }
+    auto leaf = static_cast<const Leaf *>(node);
+    auto it = std::partition_point(
+        leaf->entries, leaf->entries + leaf->size,
+        [&](const Entry &entry) { return !past(entry.key); });
+    uint32_t pos = it - leaf->entries;
+    return {ConstIterator(leaf, pos), rank + pos};
+  }
+
+  const Leaf *FirstLeaf() const {
+    const Node *node = root_;
+    while (!node->is_leaf) {
+      node = static_cast<const Inner *>(node)->children[0];
+    }
+    return static_cast<const Leaf *>(node);
+  }
+
+  bool Insert(Node *node, const K &key, const V &value,
+              std::optional<Split> &split) {
+    Ordinal ordinal = VOrdinal{}(value);
+    if (node->is_leaf) {
+      auto leaf = static_cast<Leaf *>(node);
+      auto it = std::partition_point(
+          leaf->entries, leaf->entries + leaf->size, [&](const Entry &entry) {
+            return Less(entry.key, VOrdinal{}(entry.value), key, ordinal);
+          });
+      uint32_t pos = it - leaf->entries;
+      if (pos < leaf->size && !Less(key, ordinal, it->key,
+                                    VOrdinal{}(it->value))) {
+        return false;
+      }
+      if (leaf->size == kLeafCapacity) {
+        auto right = new Leaf();
+        uint32_t mid = kLeafCapacity / 2;
+        std::move(leaf->entries + mid, leaf->entries + kLeafCapacity,
+                  right->entries);
+        right->size = kLeafCapacity - mid;
+        leaf->size = mid;
+        right->next = leaf->next;
+        leaf->next = right;
+        if (pos > mid) {
+          InsertAt(right, pos - mid, key, value);
+        } else {
+          InsertAt(leaf, pos, key, value);
+        }
+        split = Split{right, right->size, MakeSeparator(right->entries[0])};
+      } else {
+        InsertAt(leaf, pos, key, value);
+      }
+      return true;
+    }
+    auto inner = static_cast<Inner *>(node);
+    uint32_t index = ChildFor(inner, key, ordinal);
+    std::optional<Split> child_split;
+    if (!Insert(inner->children[index], key, value, child_split)) {
+      return false;
+    }
+    ++inner->counts[index];
+    if (!child_split.has_value()) {
+      return true;
+    }
+    inner->counts[index] -= child_split->count;
+    if (inner->size == kInnerCapacity) {
+      auto right = new Inner();
+      uint32_t mid = kInnerCapacity / 2;
+      MoveChildren(inner, mid, kInnerCapacity, right, 0);
+      right->size = kInnerCapacity - mid;
+      inner->size = mid;
+      if (index >= mid) {
+        InsertChildAt(right, index + 1 - mid, *child_split);
+      } else {
+        InsertChildAt(inner, index + 1, *child_split);
+      }
+      split = Split{right, Count(right), right->separators[0]};
+    } else {
+      InsertChildAt(inner, index + 1, *child_split);
+    }
+    return true;
+  }
+
+  static void InsertAt(Leaf *leaf, uint32_t pos, const K &key,
+                       const V &value) {
+    std::move_backward(leaf->entries + pos, leaf->entries + leaf->size,
+                       leaf->entries + leaf->size + 1);
+    leaf->entries[pos].key = key;
+    leaf->entries[pos].value = value;
+    ++leaf->size;
+  }
+
+  static void MoveChildren(Inner *from, uint32_t begin, uint32_t end,
+                           Inner *to, uint32_t dest) {
+    std::copy(from->children + begin, from->children + end,
+              to->children + dest);
+    std::copy(from->counts + begin, from->counts + end, to->counts + dest);
+    std::copy(from->separators + begin, from->separators + end,
+              to->separators + dest);
+  }
+
+  static void InsertChildAt(Inner *inner, uint32_t pos, const Split &split) {
+    std::copy_backward(inner->children + pos, inner->children + inner->size,
+                       inner->children + inner->size + 1);
+    std::copy_backward(inner->counts + pos, inner->counts + inner->size,
+                       inner->counts + inner->size + 1);
+    std::copy_backward(inner->separators + pos,
+                       inner->separators + inner->size,
+                       inner->separators + inner->size + 1);
+    inner->children[pos] = split.node;
+    inner->counts[pos] = split.count;
+    inner->separators[pos] = split.separator;
+    ++inner->size;
+  }
+
+  static void RemoveChildAt(Inner *inner, uint32_t pos) {
+    std::copy(inner->children + pos + 1, inner->children + inner->size,
+              inner->children + pos);
+    std::copy(inner->counts + pos + 1, inner->counts + inner->size,
+              inner->counts + pos);
+    std::copy(inner->separators + pos + 1, inner->separators + inner->size,
+              inner->separators + pos);
+    --inner->size;
+  }
+
+  bool Erase(Node *node, const K &key, const Ordinal &ordinal) {
+    if (node->is_leaf) {
+      auto leaf = static_cast<Leaf *>(node);
+      auto it = std::partition_point(
+          leaf->entries, leaf->entries + leaf->size, [&](const Entry &entry) {
+            return Less(entry.key, VOrdinal{}(entry.value), key, ordinal);
+          });
+      if (it == leaf->entries + leaf->size ||
+          Less(key, ordinal, it->key, VOrdinal{}(it->value))) {
+        return false;
+      }
+      std::move(it + 1, leaf->entries + leaf->size, it);
+      --leaf->size;
+      // Release the value held by the now unused slot.
+      leaf->entries[leaf->size].value = V();
+      return true;
+    }
+    auto inner = static_cast<Inner *>(node);
+    uint32_t index = ChildFor(inner, key, ordinal);
+    Node *child = inner->children[index];
+    if (!Erase(child, key, ordinal)) {
+      return false;
+    }
+    --inner->counts[index];
+    if (child->size < (child->is_leaf ? kLeafMin : kInnerMin) &&
+        inner->size > 1) {
+      Rebalance(inner, index == 0 ? 0 : index - 1);
+    }
+    return true;
+  }
+
+  // Restores the occupancy of children[index] and children[index + 1] by
+  // merging the right child into the left one, or by shifting entries from
+  // the fuller of the two into the other.
+  static void Rebalance(Inner *parent, uint32_t index) {
+    Node *left = parent->children[index];
+    Node *right = parent->children[index + 1];
+    if (left->is_leaf) {
+      auto left_leaf = static_cast<Leaf *>(left);
+      auto right_leaf = static_cast<Leaf *>(right);
+      if (left_leaf->size + right_leaf->size <= kLeafCapacity) {
+        std::move(right_leaf->entries, right_leaf->entries + right_leaf->size,
+                  left_leaf->entries + left_leaf->size);
+        left_leaf->size += right_leaf->size;
+        left_leaf->next = right_leaf->next;
+        parent->counts[index] += parent->counts[index + 1];
+        RemoveChildAt(parent, index + 1);
+        delete right_leaf;
+        return;
+      }
+      if (left_leaf->size < right_leaf->size) {
+        left_leaf->entries[left_leaf->size++] =
+            std::move(right_leaf->entries[0]);
+        std::move(right_leaf->entries + 1,
+                  right_leaf->entries + right_leaf->size,
+                  right_leaf->entries);
+        --right_leaf->size;
+        right_leaf->entries[right_leaf->size].value = V();
+        ++parent->counts[index];
+        --parent->counts[index + 1];
+      } else {
+        std::move_backward(right_leaf->entries,
+                           right_leaf->entries + right_leaf->size,
+                           right_leaf->entries + right_leaf->size + 1);
+        ++right_leaf->size;
+        right_leaf->entries[0] =
+            std::move(left_leaf->entries[--left_leaf->size]);
+        --parent->counts[index];
+        ++parent->counts[index + 1];
+      }
+      parent->separators[index + 1] = MakeSeparator(right_leaf->entries[0]);
+      return;
+    }
+    auto left_inner = static_cast<Inner *>(left);
+    auto right_inner = static_cast<Inner *>(right);
+    // The parent separator becomes the lower bound of the right node's first
+    // child once it is no longer the first child of its node.
+    right_inner->separators[0] = parent->separators[index + 1];
+    if (left_inner->size + right_inner->size <= kInnerCapacity) {
+      MoveChildren(right_inner, 0, right_inner->size, left_inner,
+                   left_inner->size);
+      left_inner->size += right_inner->size;
+      parent->counts[index] += parent->counts[index + 1];
+      RemoveChildAt(parent, index + 1);
+      delete right_inner;
+      return;
+    }
+    size_t moved;
+    if (left_inner->size < right_inner->size) {
+      MoveChildren(right_inner, 0, 1, left_inner, left_inner->size);
+      ++left_inner->size;
+      moved = right_inner->counts[0];
+      RemoveChildAt(right_inner, 0);
+      parent->counts[index] += moved;
+      parent->counts[index + 1] -= moved;
+    } else {
+      Split child{left_inner->children[left_inner->size - 1],
+                  left_inner->counts[left_inner->size - 1],
+                  left_inner->separators[left_inner->size - 1]};
+      --left_inner->size;
+      InsertChildAt(right_inner, 0, child);
+      moved = child.count;
+      parent->counts[index] -= moved;
+      parent->counts[index + 1] += moved;
+    }
+    parent->separators[index + 1] = right_inner->separators[0];
+  }
+
+  static void Destroy(Node *node) {
+    if (node->is_leaf) {
+      delete static_cast<Leaf *>(node);
+      return;
+    }
+    auto inner = static_cast<Inner *>(node);
+    for (uint32_t i = 0; i < inner->size; ++i) {
+      Destroy(inner->children[i]);
+    }
+    delete inner;
+  }
+
+  Node *root_;
+  size_t size_{0};
+};
+
+}  // namespace valkey_search::utils
+
+#endif  // VALKEYSEARCH_SRC_UTILS_COUNTED_BTREE_H_
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/utils/geohash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+
+namespace valkey_search::utils {
+namespace {
+
+constexpr uint32_t kCellsPerAxis = uint32_t{1} << kGeoHashSteps;
+
+double DegToRad(double degrees) { return degrees * M_PI / 180.0; }
+double RadToDeg(double radians) { return radians * 180.0 / M_PI; }
+
+uint32_t Quantize(double value, double min, double max) {
+  double offset = (value - min) / (max - min) * kCellsPerAxis;
+  if (offset <= 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(
+      std::min(offset, static_cast<double>(kCellsPerAxis - 1)));
+}
+
+// Spreads the low 32 bits of v to the even bit positions of the result.
+uint64_t Spread(uint32_t v) {
+  uint64_t x = v;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  x = (x | (x << 2)) & 0x3333333333333333ULL;
+  x = (x | (x << 1)) & 0x5555555555555555ULL;
+  return x;
+}
+
+uint64_t Interleave(uint32_t lat_bits, uint32_t lon_bits) {
+  return Spread(lat_bits) | (Spread(lon_bits) << 1);
+}
+
+absl::StatusOr<double> ParseCoordinate(absl::string_view str) {
+  double value;
+  str = absl::StripAsciiWhitespace(str);
+  if (absl::EqualsIgnoreCase(str, "nan") || !absl::SimpleAtod(str, &value)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid coordinate `", str, "`"));
+  }
+  return value;
+}
+
+absl::StatusOr<GeoPoint> MakeGeoPoint(double lon, double lat) {
+  if (lon < kGeoLonMin || lon > kGeoLonMax || lat < kGeoLatMin ||
+      lat > kGeoLatMax) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid longitude,latitude pair ", lon, ",", lat));
+  }
+  return GeoPoint{lon, lat};
+}
+
+}  // namespace
+
+uint64_t GeoHashEncode(const GeoPoint& point) {
+  return Interleave(Quantize(point.lat, kGeoLatMin, kGeoLatMax),
+                    Quantize(point.lon, kGeoLonMin, kGeoLonMax));
+}
+
+double GeoDistance(const GeoPoint& a, const GeoPoint& b) {
+  double lat1 = DegToRad(a.lat);
+  double lat2 = DegToRad(b.lat);
+  double u = std::sin((lat2 - lat1) / 2);
+  double v = std::sin(DegToRad(b.lon - a.lon) / 2);
+  // Rounding can push the haversine of near antipodal points past 1.
+  double h = std::min(1.0, u * u + std::cos(lat1) * std::cos(lat2) * v * v);
+  return 2.0 * kEarthRadiusMeters * std::asin(std::sqrt(h));
+}
+
+std::vector<GeoHashRange> GeoHashCoverBox(const GeoBox& box,
+                                          size_t max_cells) {
+  const uint32_t min_x = Quantize(box.min_lon, kGeoLonMin, kGeoLonMax);
+  const uint32_t max_x = Quantize(box.max_lon, kGeoLonMin, kGeoLonMax);
+  const uint32_t min_y = Quantize(box.min_lat, kGeoLatMin, kGeoLatMax);
+  const uint32_t max_y = Quantize(box.max_lat, kGeoLatMin, kGeoLatMax);
+  int step = kGeoHashSteps;
+  for (; step > 0; --step) {
+    const int shift = kGeoHashSteps - step;
+    const uint64_t width = (max_x >> shift) - (min_x >> shift) + 1;
+    const uint64_t height = (max_y >> shift) - (min_y >> shift) + 1;
+    if (width * height <= max_cells) {
+      break;
+    }
+  }
+  const int shift = kGeoHashSteps - step;
+  std::vector<GeoHashRange> ranges;
+  for (uint32_t x = min_x >> shift; x <= max_x >> shift; ++x) {
+    for (uint32_t y = min_y >> shift; y <= max_y >> shift; ++y) {
+      const uint64_t cell = Interleave(y, x);
+      ranges.emplace_back(cell << (2 * shift), (cell + 1) << (2 * shift));
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+  std::vector<GeoHashRange> merged;
+  for (const auto& range : ranges) {
+    if (!merged.empty() && merged.back().second >= range.first) {
+      merged.back().second = std::max(merged.back().second, range.second);
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+absl::InlinedVector<GeoBox, 2> GeoRadiusBoxes(const GeoPoint& center,
+                                              double radius_meters) {
+  const double angular_radius = radius_meters / kEarthRadiusMeters;
+  const double min_lat = center.lat - RadToDeg(angular_radius);
+  const double max_lat = center.lat + RadToDeg(angular_radius);
+  if (min_lat <= kGeoLatMin || max_lat >= kGeoLatMax ||
+      angular_radius >= M_PI / 2) {
+    return {GeoBox{kGeoLonMin, std::max(min_lat, kGeoLatMin), kGeoLonMax,
+                   std::min(max_lat, kGeoLatMax)}};
+  }
+  const double delta_lon = RadToDeg(
+      std::asin(std::sin(angular_radius) / std::cos(DegToRad(center.lat))));
+  const double min_lon = center.lon - delta_lon;
+  const double max_lon = center.lon + delta_lon;
+  if (min_lon < kGeoLonMin) {
+    return {GeoBox{kGeoLonMin, min_lat, max_lon, max_lat},
+            GeoBox{min_lon + 360.0, min_lat, kGeoLonMax, max_lat}};
+  }
+  if (max_lon > kGeoLonMax) {
+    return {GeoBox{min_lon, min_lat, kGeoLonMax, max_lat},
+            GeoBox{kGeoLonMin, min_lat, max_lon - 360.0, max_lat}};
+  }
+  return {GeoBox{min_lon, min_lat, max_lon, max_lat}};
+}
+
+GeoBox GeoPolygonBox(const std::vector<GeoPoint>& polygon) {
+  GeoBox box{kGeoLonMax, kGeoLatMax, kGeoLonMin, kGeoLatMin};
+  for (const auto& vertex : polygon) {
+    box.min_lon = std::min(box.min_lon, vertex.lon);
+    box.max_lon = std::max(box.max_lon, vertex.lon);
+    box.min_lat = std::min(box.min_lat, vertex.lat);
+    box.max_lat = std::max(box.max_lat, vertex.lat);
+  }
+  return box;
+}
+
+bool GeoPolygonContains(const std::vector<GeoPoint>& polygon,
+                        const GeoPoint& point) {
+  bool inside = false;
+  for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+    const auto& a = polygon[i];
+    const auto& b = polygon[j];
+    if ((a.lat > point.lat) != (b.lat > point.lat) &&
+        point.lon <
+            (b.lon - a.lon) * (point.lat - a.lat) / (b.lat - a.lat) + a.lon) {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+absl::StatusOr<GeoPoint> ParseGeoPoint(absl::string_view data) {
+  std::vector<absl::string_view> parts =
+      absl::StrSplit(data, absl::ByAnyChar(", "), absl::SkipEmpty());
+  if (parts.size() != 2) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected `longitude,latitude`, got `", data, "`"));
+  }
+  auto lon = ParseCoordinate(parts[0]);
+  if (!lon.ok()) {
+    return lon.status();
+  }
+  auto lat = ParseCoordinate(parts[1]);
+  if (!lat.ok()) {
+    return lat.status();
+  }
+  return MakeGeoPoint(*lon, *lat);
+}
+
+absl::StatusOr<double> ParseGeoUnit(absl::string_view unit) {
+  if (absl::EqualsIgnoreCase(unit, "m")) {
+    return 1.0;
+  }
+  if (absl::EqualsIgnoreCase(unit, "km")) {
+    return 1000.0;
+  }
+  if (absl::EqualsIgnoreCase(unit, "mi")) {
+    return 1609.34;
+  }
+  if (absl::EqualsIgnoreCase(unit, "ft")) {
+    return 0.3048;
+  }
+  return absl::InvalidArgumentError(
+      absl::StrCat("Unsupported unit `", unit, "`. Expected m, km, mi or ft"));
+}
+
+absl::StatusOr<std::vector<GeoPoint>> ParseWktPolygon(absl::string_view wkt) {
+  wkt = absl::StripAsciiWhitespace(wkt);
+  if (!absl::StartsWithIgnoreCase(wkt, "POLYGON")) {
+    return absl::InvalidArgumentError("Expected a WKT POLYGON");
+  }
+  wkt.remove_prefix(absl::string_view("POLYGON").size());
+  wkt = absl::StripAsciiWhitespace(wkt);
+  if (!absl::ConsumePrefix(&wkt, "((") || !absl::ConsumeSuffix(&wkt, "))")) {
+    return absl::InvalidArgumentError(
+        "Expected the POLYGON ring to be wrapped in `((` and `))`");
+  }
+  std::vector<GeoPoint> polygon;
+  for (absl::string_view vertex : absl::StrSplit(wkt, ',')) {
+    std::vector<absl::string_view> coordinates =
+        absl::StrSplit(vertex, ' ', absl::SkipEmpty());
+    if (coordinates.size() != 2) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Expected `longitude latitude` POLYGON vertex, got `", vertex, "`"));
+    }
+    auto lon = ParseCoordinate(coordinates[0]);
+    if (!lon.ok()) {
+      return lon.status();
+    }
+    auto lat = ParseCoordinate(coordinates[1]);
+    if (!lat.ok()) {
+      return lat.status();
+    }
+    auto point = MakeGeoPoint(*lon, *lat);
+    if (!point.ok()) {
+      return point.status();
+    }
+    polygon.push_back(*point);
+  }
+  if (polygon.size() > 1 && polygon.front().lon == polygon.back().lon &&
+      polygon.front().lat == polygon.back().lat) {
+    polygon.pop_back();
+  }
+  if (polygon.size() < 3) {
+    return absl::InvalidArgumentError("A POLYGON needs at least 3 vertices");
+  }
+  return polygon;
+}
+
+}  // namespace valkey_search::utils
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_UTILS_GEOHASH_H_
+#define VALKEYSEARCH_SRC_UTILS_GEOHASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace valkey_search::utils {
+
+// Coordinate limits match the ones enforced by the Valkey GEO commands.
+constexpr double kGeoLonMin = -180.0;
+constexpr double kGeoLonMax = 180.0;
+constexpr double kGeoLatMin = -85.05112878;
+constexpr double kGeoLatMax = 85.05112878;
+constexpr double kEarthRadiusMeters = 6372797.560856;
+
+// Number of bisections applied to each of longitude and latitude. The
+// interleaved hash is 2 * kGeoHashSteps = 52 bits wide.
+constexpr int kGeoHashSteps = 26;
+
+struct GeoPoint {
+  double lon;
+  double lat;
+};
+
+struct GeoBox {
+  double min_lon;
+  double min_lat;
+  double max_lon;
+  double max_lat;
+};
+
+// Half open [first, second) range of 52-bit geohashes.
+using GeoHashRange = std::pair<uint64_t, uint64_t>;
+
+//
+// Interleaves the bits of the quantized latitude and longitude so that points
+// that are close on the sphere tend to be close in hash order, and so that
+// every geohash cell at a coarser step is one contiguous hash range.
+//
+uint64_t GeoHashEncode(const GeoPoint& point);
+
+// Great circle distance in meters.
+double GeoDistance(const GeoPoint& a, const GeoPoint& b);
+
+//
+// Returns sorted, non overlapping hash ranges whose union covers the box. The
+// covering uses the finest step at which the box spans at most max_cells
+// cells, so it may include points outside of the box and callers are expected
+// to check candidates exactly.
+//
+std::vector<GeoHashRange> GeoHashCoverBox(const GeoBox& box,
+                                          size_t max_cells = 16);
+
+// Bounding boxes of the circle around center. Circles crossing the
+// antimeridian are split in two boxes, circles reaching a pole span all
+// longitudes.
+absl::InlinedVector<GeoBox, 2> GeoRadiusBoxes(const GeoPoint& center,
+                                              double radius_meters);
+
+// Bounding box of a polygon, ignoring antimeridian crossings.
+GeoBox GeoPolygonBox(const std::vector<GeoPoint>& polygon);
+
+// Even-odd test treating longitude and latitude as planar coordinates.
+bool GeoPolygonContains(const std::vector<GeoPoint>& polygon,
+                        const GeoPoint& point);
+
+// Parses "lon,lat" (or "lon lat") and validates the coordinate limits.
+absl::StatusOr<GeoPoint> ParseGeoPoint(absl::string_view data);
+
+// Returns the number of meters in one of the units m, km, mi or ft.
+absl::StatusOr<double> ParseGeoUnit(absl::string_view unit);
+
+// Parses a WKT "POLYGON((lon lat, lon lat, ...))" with a single ring. The
+// closing vertex is optional.
+absl::StatusOr<std::vector<GeoPoint>> ParseWktPolygon(absl::string_view wkt);
+
+}  // namespace valkey_search::utils
+
+#endif  // VALKEYSEARCH_SRC_UTILS_GEOHASH_H_
@@ -12,14 +12,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <stack>
 #include <string>
 #include <utility>
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/hash/hash.h"
 #include "absl/log/check.h"
 #include "absl/strings/ascii.h"
@@ -28,16 +29,163 @@
 
 namespace valkey_search {
 
+//
+// Set of the values stored under a single key. Most keys hold a handful of
+// values, so those are kept in a small inline vector and scanned linearly.
+// The set switches to a hash set once it grows past kMaxSmallValues and back
+// once it shrinks well below it.
+//
+template <typename T, typename Hasher = absl::Hash<T>,
+          typename Equaler = std::equal_to<T>>
+class PatriciaValueSet {
+ public:
+  static constexpr size_t kInlineValues = 2;
+  static constexpr size_t kMaxSmallValues = 8;
+  using HashSetType = absl::flat_hash_set<T, Hasher, Equaler>;
+  using value_type = T;
+  using size_type = size_t;
+  using reference = const T &;
+  using const_reference = const T &;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    reference operator*() const { return small_ ? *small_ : *large_; }
+    pointer operator->() const { return &**this; }
+    const_iterator &operator++() {
+      if (small_) {
+        ++small_;
+      } else {
+        ++large_;
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    friend bool operator==(const const_iterator &a, const const_iterator &b) {
+      return a.small_ == b.small_ && a.large_ == b.large_;
+    }
+    friend bool operator!=(const const_iterator &a, const const_iterator &b) {
+      return !(a == b);
+    }
+
+   private:
+    friend class PatriciaValueSet;
+    explicit const_iterator(const T *small) : small_(small) {}
+    explicit const_iterator(typename HashSetType::const_iterator large)
+        : large_(large) {}
+    const T *small_{nullptr};
+    typename HashSetType::const_iterator large_;
+  };
+  using iterator = const_iterator;
+
+  PatriciaValueSet() = default;
+  explicit PatriciaValueSet(const T &value) { small_.push_back(value); }
+
+  const_iterator begin() const {
+    return large_ ? const_iterator(large_->begin())
+                  : const_iterator(small_.data());
+  }
+  const_iterator end() const {
+    return large_ ? const_iterator(large_->end())
+                  : const_iterator(small_.data() + small_.size());
+  }
+  size_t size() const { return large_ ? large_->size() : small_.size(); }
+  bool empty() const { return size() == 0; }
+
+  bool contains(const T &value) const {
+    if (large_) {
+      return large_->contains(value);
+    }
+    return FindSmall(value) != small_.end();
+  }
+
+  // Returns true if the value was not present.
+  bool insert(const T &value) {
+    if (large_) {
+      return large_->insert(value).second;
+    }
+    if (FindSmall(value) != small_.end()) {
+      return false;
+    }
+    if (small_.size() < kMaxSmallValues) {
+      small_.push_back(value);
+      return true;
+    }
+    large_ = std::make_unique<HashSetType>(small_.begin(), small_.end());
+    large_->insert(value);
+    small_.clear();
+    small_.shrink_to_fit();
+    return true;
+  }
+
+  // Returns true if the value was present.
+  bool erase(const T &value) {
+    if (large_) {
+      if (large_->erase(value) == 0) {
+        return false;
+      }
+      if (large_->size() <= kMaxSmallValues / 2) {
+        small_.assign(large_->begin(), large_->end());
+        large_.reset();
+      }
+      return true;
+    }
+    auto it = FindSmall(value);
+    if (it == small_.end()) {
+      return false;
+    }
+    // Order is not meaningful, fill the hole with the last value.
+    *it = std::move(small_.back());
+    small_.pop_back();
+    return true;
+  }
+
+ private:
+  typename absl::InlinedVector<T, kInlineValues>::iterator FindSmall(
+      const T &value) {
+    return std::find_if(small_.begin(), small_.end(),
+                        [&](const T &v) { return Equaler()(v, value); });
+  }
+  typename absl::InlinedVector<T, kInlineValues>::const_iterator FindSmall(
+      const T &value) const {
+    return std::find_if(small_.begin(), small_.end(),
+                        [&](const T &v) { return Equaler()(v, value); });
+  }
+
+  absl::InlinedVector<T, kInlineValues> small_;
+  std::unique_ptr<HashSetType> large_;
+};
+
+//
+// A node owns the label of the edge leading to it. Children are kept sorted by
+// the first byte of their edge label (lower cased for case insensitive trees),
+// and that byte is mirrored in child_bytes so that picking the child to follow
+// is a binary search over a small inline byte array rather than a hash lookup
+// or a pointer chase per sibling. No two children share a first byte.
+//
 template <typename T, typename Hasher = absl::Hash<T>,
           typename Equaler = std::equal_to<T>>
 class PatriciaNode {
  public:
+  using SetType = PatriciaValueSet<T, Hasher, Equaler>;
   PatriciaNode() = default;
-  absl::flat_hash_map<std::string,
-                      std::unique_ptr<PatriciaNode<T, Hasher, Equaler>>>
+  explicit PatriciaNode(absl::string_view edge) : edge(edge) {}
+  std::string edge;
+  absl::InlinedVector<char, 16> child_bytes;
+  absl::InlinedVector<std::unique_ptr<PatriciaNode<T, Hasher, Equaler>>, 1>
       children;
   int64_t subtree_values_count = 0;
-  std::optional<absl::flat_hash_set<T, Hasher, Equaler>> value;
+  std::optional<SetType> value;
   void PrintValue() {}
 };
 
@@ -45,8 +193,8 @@ template <typename T, typename Hasher = absl::Hash<T>,
           typename Equaler = std::equal_to<T>>
 class PatriciaTree {
  public:
-  using SetType = absl::flat_hash_set<T, Hasher, Equaler>;
   using PatriciaNodeType = PatriciaNode<T, Hasher, Equaler>;
+  using SetType = typename PatriciaNodeType::SetType;
   PatriciaTree(bool case_sensitive)
       : root_(std::make_unique<PatriciaNodeType>()),
         case_sensitive_(case_sensitive) {}
@@ -57,47 +205,39 @@ class PatriciaTree {
       node->subtree_values_count++;
       if (remaining_key.empty()) {
         if (!node->value.has_value()) {
-          node->value.emplace(std::move(SetType{value}));
+          node->value.emplace(value);
         } else {
           node->value.value().insert(value);
         }
         return;
       }
-      bool found = false;
-      for (auto &[child_key, child_node] : node->children) {
-        absl::string_view common_prefix =
-            GetCommonPrefix(remaining_key, child_key, case_sensitive_);
-        if (!common_prefix.empty()) {
-          if (common_prefix.size() == child_key.size()) {
-            // Continue in this branch
-            node = child_node.get();
-            remaining_key = remaining_key.substr(common_prefix.size());
-            found = true;
-            break;
-          }
-          // Split the edge
-          auto new_node = std::make_unique<PatriciaNodeType>();
-          new_node->subtree_values_count = child_node->subtree_values_count;
-          new_node
-              ->children[std::string(child_key.substr(common_prefix.size()))] =
-              std::move(child_node);
-          auto common_prefix_str = std::string(common_prefix);
-          node->children.erase(std::string(child_key));
-          node->children[common_prefix_str] = std::move(new_node);
-          node = node->children[common_prefix_str].get();
-          remaining_key = remaining_key.substr(common_prefix.size());
-          found = true;
-          break;
-        }
-      }
-
-      if (!found) {
-        auto new_node = std::make_unique<PatriciaNodeType>();
+      size_t pos = ChildPosition(node, remaining_key[0]);
+      if (pos == node->children.size() ||
+          node->child_bytes[pos] != Fold(remaining_key[0])) {
+        auto new_node = std::make_unique<PatriciaNodeType>(remaining_key);
         auto new_node_ptr = new_node.get();
-        node->children[std::string(remaining_key)] = std::move(new_node);
+        node->child_bytes.insert(node->child_bytes.begin() + pos,
+                                 Fold(remaining_key[0]));
+        node->children.insert(node->children.begin() + pos,
+                              std::move(new_node));
         node = new_node_ptr;
         remaining_key = "";
+        continue;
+      }
+      auto &child_node = node->children[pos];
+      absl::string_view common_prefix =
+          GetCommonPrefix(remaining_key, child_node->edge, case_sensitive_);
+      if (common_prefix.size() < child_node->edge.size()) {
+        // Split the edge
+        auto new_node = std::make_unique<PatriciaNodeType>(common_prefix);
+        new_node->subtree_values_count = child_node->subtree_values_count;
+        child_node->edge.erase(0, common_prefix.size());
+        new_node->child_bytes.push_back(Fold(child_node->edge[0]));
+        new_node->children.push_back(std::move(child_node));
+        child_node = std::move(new_node);
       }
+      node = child_node.get();
+      remaining_key = remaining_key.substr(common_prefix.size());
     }
   }
 
@@ -161,7 +301,7 @@ class PatriciaTree {
       if (node->value.has_value()) {
         values_.push(node);
       }
-      for (const auto &[child_key, child_node] : node->children) {
+      for (const auto &child_node : node->children) {
         DfsHelper(child_node.get());
       }
     }
@@ -190,21 +330,17 @@ class PatriciaTree {
         values_.push(root);
       }
       while (!str.empty()) {
-        bool found = false;
-        for (const auto &child : root->children) {
-          if (str.compare(0, child.first.size(), child.first) == 0) {
-            found = true;
-            if (child.second->value != std::nullopt) {
-              values_.push(child.second.get());
-            }
-            str = str.substr(child.first.size());
-            root = child.second.get();
-            break;
-          }
-        }
-        if (!found) {
+        PatriciaNodeType *child =
+            FindChild(root, str[0], case_sensitive_);
+        if (child == nullptr ||
+            str.compare(0, child->edge.size(), child->edge) != 0) {
           return;
         }
+        if (child->value != std::nullopt) {
+          values_.push(child);
+        }
+        str = str.substr(child->edge.size());
+        root = child;
       }
     }
 
@@ -231,6 +367,35 @@ class PatriciaTree {
   std::unique_ptr<PatriciaNodeType> root_;
   bool case_sensitive_;
 
+  static char Fold(char c, bool case_sensitive) {
+    return case_sensitive ? c : absl::ascii_tolower(c);
+  }
+  char Fold(char c) const { return Fold(c, case_sensitive_); }
+
+  // Position of the first child whose folded first byte is not less than c.
+  static size_t ChildPosition(const PatriciaNodeType *node, char c,
+                              bool case_sensitive) {
+    const char folded = Fold(c, case_sensitive);
+    return std::lower_bound(node->child_bytes.begin(), node->child_bytes.end(),
+                            folded) -
+           node->child_bytes.begin();
+  }
+  size_t ChildPosition(const PatriciaNodeType *node, char c) const {
+    return ChildPosition(node, c, case_sensitive_);
+  }
+
+  // Returns the only child whose edge may share a prefix with a key starting
+  // with c, nullptr if there is none.
+  static PatriciaNodeType *FindChild(const PatriciaNodeType *node, char c,
+                                     bool case_sensitive) {
+    size_t pos = ChildPosition(node, c, case_sensitive);
+    if (pos == node->children.size() ||
+        node->child_bytes[pos] != Fold(c, case_sensitive)) {
+      return nullptr;
+    }
+    return node->children[pos].get();
+  }
+
   static absl::string_view GetCommonPrefix(absl::string_view str1,
                                            absl::string_view str2,
                                            bool case_sensitive) {
@@ -250,37 +415,43 @@ class PatriciaTree {
   bool RemoveHelper(PatriciaNodeType *node, absl::string_view key,
                     const T &value) {
     if (key.empty()) {
-      if (!node->value) {
+      if (!node->value || !node->value.value().erase(value)) {
         return false;  // Key not found
       }
-      auto itr = node->value.value().find(value);
-      if (itr != node->value.value().end()) {
-        node->value.value().erase(itr);
-        node->subtree_values_count--;
-        return true;
+      if (node->value.value().empty()) {
+        node->value.reset();
       }
-      return false;
+      node->subtree_values_count--;
+      return true;
     }
 
-    for (auto it = node->children.begin(); it != node->children.end(); ++it) {
-      absl::string_view common_prefix =
-          GetCommonPrefix(key, it->first, case_sensitive_);
-      PatriciaNodeType *child_node = it->second.get();
-      if (!common_prefix.empty() && common_prefix.size() == it->first.size()) {
-        bool found =
-            RemoveHelper(child_node, key.substr(common_prefix.size()), value);
-        if (found) {
-          node->subtree_values_count--;
-          if (child_node->children.empty() &&
-              (!child_node->value.has_value() ||
-               child_node->value.value().empty())) {
-            node->children.erase(it);
-          }
-          return found;
-        }
+    size_t pos = ChildPosition(node, key[0]);
+    if (pos == node->children.size() ||
+        node->child_bytes[pos] != Fold(key[0])) {
+      return false;  // Key not found
+    }
+    auto &child_node = node->children[pos];
+    absl::string_view common_prefix =
+        GetCommonPrefix(key, child_node->edge, case_sensitive_);
+    if (common_prefix.size() != child_node->edge.size() ||
+        !RemoveHelper(child_node.get(), key.substr(common_prefix.size()),
+                      value)) {
+      return false;  // Key not found
+    }
+    node->subtree_values_count--;
+    if (!child_node->value.has_value()) {
+      if (child_node->children.empty()) {
+        node->child_bytes.erase(node->child_bytes.begin() + pos);
+        node->children.erase(node->children.begin() + pos);
+      } else if (child_node->children.size() == 1) {
+        // Keep the tree compressed: a valueless node with a single child is
+        // merged into it.
+        auto grandchild = std::move(child_node->children[0]);
+        grandchild->edge.insert(0, child_node->edge);
+        child_node = std::move(grandchild);
       }
     }
-    return false;  // Key not found
+    return true;
   }
 
   // Returns leaf node of the prefix of the key, nullptr otherwise.
@@ -289,27 +460,24 @@ class PatriciaTree {
     PatriciaNodeType *node = root_.get();
     absl::string_view remaining_key = key;
     while (!remaining_key.empty()) {
-      bool found = false;
-      for (const auto &[child_key, child_node] : node->children) {
-        auto common_prefix =
-            GetCommonPrefix(remaining_key, child_key, case_sensitive_);
-        if (!exact_match && common_prefix.size() == remaining_key.size()) {
-          // This takes care of case where key is a prefix of a node
-          // e.g. "a" matches "abc"
-          DCHECK(child_key.size() >= remaining_key.size());
-          node = child_node.get();
-          remaining_key = "";
-          found = true;
-          break;
-        } else if (common_prefix.size() == child_key.size()) {
-          // For key "abc" This takes of care of going to node "abc"
-          node = child_node.get();
-          remaining_key = remaining_key.substr(common_prefix.size());
-          found = true;
-          break;
-        }
+      PatriciaNodeType *child_node =
+          FindChild(node, remaining_key[0], case_sensitive_);
+      if (child_node == nullptr) {
+        return nullptr;
       }
-      if (!found) {
+      auto common_prefix =
+          GetCommonPrefix(remaining_key, child_node->edge, case_sensitive_);
+      if (!exact_match && common_prefix.size() == remaining_key.size()) {
+        // This takes care of case where key is a prefix of a node
+        // e.g. "a" matches "abc"
+        DCHECK(child_node->edge.size() >= remaining_key.size());
+        node = child_node;
+        remaining_key = "";
+      } else if (common_prefix.size() == child_node->edge.size()) {
+        // For key "abc" This takes of care of going to node "abc"
+        node = child_node;
+        remaining_key = remaining_key.substr(common_prefix.size());
+      } else {
         return nullptr;
       }
     }
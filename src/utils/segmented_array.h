@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#ifndef VALKEYSEARCH_SRC_UTILS_SEGMENTED_ARRAY_H_
+#define VALKEYSEARCH_SRC_UTILS_SEGMENTED_ARRAY_H_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace valkey_search::utils {
+
+//
+// A sparse array of atomic slots indexed by a 64-bit id that readers can
+// access without taking a lock.
+//
+// Slots live in fixed-size pages. A page is allocated on the first Set of a
+// non-default value in its range, zero initialized so that unset slots read as
+// T{}, and freed again once all of its slots are back to T{}. Ids that are
+// never reused therefore only cost memory while they hold a value, plus one
+// directory entry per page. The directory is split into segments whose sizes
+// double, so a directory entry never moves once its segment has been
+// allocated.
+//
+// Set publishes a value with release semantics and Get reads it with acquire
+// semantics: a reader that observes a value also observes every write the
+// writer made before publishing it. Writers are serialized by an internal
+// mutex. Since clearing the last value of a page frees it, readers must not
+// run concurrently with a Set that clears a slot.
+//
+template <typename T, int kPageBits = 10>
+class SegmentedArray {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "SegmentedArray slots must be trivially copyable");
+
+ public:
+  SegmentedArray() = default;
+  SegmentedArray(const SegmentedArray&) = delete;
+  SegmentedArray& operator=(const SegmentedArray&) = delete;
+  ~SegmentedArray() {
+    for (size_t i = 0; i < kNumSegments; ++i) {
+      PageSlot* segment = directory_[i].load(std::memory_order_relaxed);
+      if (segment == nullptr) {
+        continue;
+      }
+      for (size_t j = 0; j < SegmentSize(i); ++j) {
+        delete segment[j].load(std::memory_order_relaxed);
+      }
+      delete[] segment;
+    }
+  }
+
+  // Returns the value stored at `index`, or T{} if it was never set.
+  T Get(uint64_t index) const {
+    const auto [segment, offset] = Locate(index >> kPageBits);
+    const PageSlot* pages = directory_[segment].load(std::memory_order_acquire);
+    if (pages == nullptr) {
+      return T{};
+    }
+    const Page* page = pages[offset].load(std::memory_order_acquire);
+    if (page == nullptr) {
+      return T{};
+    }
+    return page->slots[index & kPageMask].load(std::memory_order_acquire);
+  }
+
+  void Set(uint64_t index, T value) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const bool is_set = value != T{};
+    PageSlot& page_slot = GetOrAllocatePageSlot(index >> kPageBits);
+    Page* page = page_slot.load(std::memory_order_relaxed);
+    if (page == nullptr) {
+      if (!is_set) {
+        return;
+      }
+      page = new Page();
+      page_slot.store(page, std::memory_order_release);
+      allocated_bytes_.fetch_add(sizeof(Page), std::memory_order_relaxed);
+    }
+    auto& slot = page->slots[index & kPageMask];
+    const bool was_set = slot.load(std::memory_order_relaxed) != T{};
+    slot.store(value, std::memory_order_release);
+    if (is_set && !was_set) {
+      ++page->live_slots;
+    } else if (!is_set && was_set && --page->live_slots == 0) {
+      page_slot.store(nullptr, std::memory_order_release);
+      delete page;
+      allocated_bytes_.fetch_sub(sizeof(Page), std::memory_order_relaxed);
+    }
+  }
+
+  // Bytes held by the allocated pages and directory segments.
+  size_t GetAllocatedBytes() const {
+    return allocated_bytes_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  using Slot = std::atomic<T>;
+  static constexpr uint64_t kPageMask = (uint64_t{1} << kPageBits) - 1;
+  struct Page {
+    Slot slots[uint64_t{1} << kPageBits]{};
+    // Number of slots that hold a value other than T{}, guarded by
+    // write_mutex_.
+    size_t live_slots{0};
+  };
+  using PageSlot = std::atomic<Page*>;
+  static constexpr int kFirstSegmentBits = 6;
+  static constexpr size_t kNumSegments = 65 - kPageBits - kFirstSegmentBits;
+
+  static constexpr size_t SegmentSize(size_t segment) {
+    return size_t{1} << (segment + kFirstSegmentBits);
+  }
+
+  // Segment i covers pages [2^(i+b) - 2^b, 2^(i+1+b) - 2^b), where b is
+  // kFirstSegmentBits. Biasing the page by 2^b turns that into a bit scan.
+  static std::pair<size_t, uint64_t> Locate(uint64_t page) {
+    const uint64_t biased = page + (uint64_t{1} << kFirstSegmentBits);
+    const size_t segment = std::bit_width(biased) - 1 - kFirstSegmentBits;
+    return {segment, biased - SegmentSize(segment)};
+  }
+
+  PageSlot& GetOrAllocatePageSlot(uint64_t page) {
+    const auto [segment, offset] = Locate(page);
+    PageSlot* pages = directory_[segment].load(std::memory_order_relaxed);
+    if (pages == nullptr) {
+      pages = new PageSlot[SegmentSize(segment)]();
+      directory_[segment].store(pages, std::memory_order_release);
+      allocated_bytes_.fetch_add(SegmentSize(segment) * sizeof(PageSlot),
+                                 std::memory_order_relaxed);
+    }
+    return pages[offset];
+  }
+
+  std::array<std::atomic<PageSlot*>, kNumSegments> directory_{};
+  std::mutex write_mutex_;
+  std::atomic<size_t> allocated_bytes_{0};
+};
+
+}  // namespace valkey_search::utils
+
+#endif  // VALKEYSEARCH_SRC_UTILS_SEGMENTED_ARRAY_H_
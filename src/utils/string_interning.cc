@@ -35,15 +35,25 @@ interned string if string is unknown) or when the last reference to a string is
 released.
 
 In addition to the ref-counted strings themselves is a global map that serves to
-ensure that each distinct string is only stored once. This map is protected by a
-mutex to ensure thread safety. The map invariant is that an entry exists iff
-the associated reference count is greater than zero. Thus incrementing the
-reference count of an entry never requires modifying the map and thus doesn't
-need to lock the global mutex. However, when decrementing the reference count
-for an entry, the 1->0 transition requires removing the entry from the map
-atomically in order to maintain the invariant. Here atomically means that the
-1->0 transition can only be done reliably when holding the global mutex.
-Substantial care in the decrement code is required to ensure this.
+ensure that each distinct string is only stored once. The map is partitioned by
+string hash into a fixed number of shards, each protected by its own reader
+writer mutex. The map invariant is that an entry exists iff the associated
+reference count is greater than zero. Thus incrementing the reference count of
+an entry never requires modifying the map and thus doesn't need to lock the
+shard exclusively. However, when decrementing the reference count for an entry,
+the 1->0 transition requires removing the entry from the map atomically in
+order to maintain the invariant. Here atomically means that the 1->0 transition
+can only be done reliably when holding the shard mutex exclusively. Substantial
+care in the decrement code is required to ensure this.
+
+Lookups of strings that are already interned (the common case for keys and
+tokens that are indexed repeatedly) only take the shard mutex in shared mode.
+This is safe because the exclusive lock is held across the final decrement in
+Release, so while a shared lock is held no entry in the shard can reach a zero
+reference count, and bumping the count of an entry found under the shared lock
+is sufficient to keep it alive. A concurrent Release of the same string that
+observed a count of one will then see the bumped count once it acquires the
+exclusive lock and back off.
 
 */
 
@@ -176,7 +186,8 @@ bool StringInternStore::Release(InternedString* str) {
   OutOfLineInternedString fake(str->Str().data(), str->Str().size());
   void* storage;
   InternedStringPtr* ptr_ptr = MakeShadowInternPtrPtr(&fake, storage);
-  absl::MutexLock lock(&mutex_);
+  auto& shard = ShardFor(str->Str());
+  absl::MutexLock lock(&shard.mutex_);
   //
   // Now that we have the lock, try our decrement to see if we really
   // want to destroy this entry.
@@ -191,10 +202,10 @@ bool StringInternStore::Release(InternedString* str) {
   //
   // This is the true 1->0 transition. Remove from map.
   //
-  auto it = str_to_interned_.find(*ptr_ptr);
-  CHECK(it != str_to_interned_.end()) << "Bad Map State";
+  auto it = shard.str_to_interned_.find(*ptr_ptr);
+  CHECK(it != shard.str_to_interned_.end()) << "Bad Map State";
   CHECK(str->RefCount() == 0);
-  str_to_interned_.erase(
+  shard.str_to_interned_.erase(
       it);  // Note this will also call the DecrementRefCount, but
             // since refcount is already zero, it will be a no-op.
   return true;
@@ -226,49 +237,87 @@ InternedStringPtr StringInternStore::InternImpl(absl::string_view str,
   void* storage;
   InternedStringPtr* ptr_ptr = MakeShadowInternPtrPtr(&fake, storage);
 
-  absl::MutexLock lock(&mutex_);
-  auto it = str_to_interned_.find(*ptr_ptr);
-  if (it != str_to_interned_.end()) {
-    return *it;  // will bump the refcount automatically.
+  auto& shard = ShardFor(str);
+  {
+    //
+    // Fast path, the string is already interned. A shared lock is enough to
+    // bump the refcount, see the comment at the top of this file.
+    //
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto it = shard.str_to_interned_.find(*ptr_ptr);
+    if (it != shard.str_to_interned_.end()) {
+      return *it;  // will bump the refcount automatically.
+    }
+  }
+  absl::MutexLock lock(&shard.mutex_);
+  //
+  // Somebody else may have inserted the string between dropping the shared
+  // lock and acquiring the exclusive one, so look again.
+  //
+  auto it = shard.str_to_interned_.find(*ptr_ptr);
+  if (it != shard.str_to_interned_.end()) {
+    return *it;
   }
   //
   // Create a new interned string. Without bumping the refcount....
   //
   InternedString* new_ptr = InternedString::Constructor(str, allocator);
-  str_to_interned_.insert(std::move(InternedStringPtr(new_ptr)));
+  shard.str_to_interned_.insert(std::move(InternedStringPtr(new_ptr)));
   return {new_ptr};
 }
 
+bool StringInternStore::Relocate(const InternedStringPtr& str,
+                                 const char* from, char* to,
+                                 uint32_t owned_refs) {
+  if (!str || str->IsInline()) {
+    return false;
+  }
+  auto& shard = Instance().ShardFor(str->Str());
+  // The exclusive lock keeps lookups, which may hand out new references,
+  // from reading the string while it moves.
+  absl::MutexLock lock(&shard.mutex_);
+  auto ptr = reinterpret_cast<OutOfLineInternedString*>(
+      const_cast<InternedString*>(&*str));
+  if (ptr->out_of_line_data_ != from || str.RefCount() != owned_refs) {
+    return false;
+  }
+  memcpy(to, from, str->Str().size() + 1);
+  ptr->out_of_line_data_ = to;
+  return true;
+}
+
 int64_t StringInternStore::GetMemoryUsage() { return memory_pool_.GetUsage(); }
 
 StringInternStore::Stats StringInternStore::GetStats() const {
   Stats stats;
-  absl::MutexLock lock(&mutex_);
-  for (const auto& str : str_to_interned_) {
-    auto size = str->Str().size();
-    auto allocated = str->Allocated();
-    auto refcount =
-        str.RefCount();  // This is volatile even while holding the lock
-    if (str->IsInline()) {
-      stats.inline_total_stats_.count_++;
-      stats.inline_total_stats_.bytes_ += size;
-      stats.inline_total_stats_.allocated_ += allocated;
-      stats.by_ref_stats_[refcount].count_++;
-      stats.by_ref_stats_[refcount].bytes_ += size;
-      stats.by_ref_stats_[refcount].allocated_ += allocated;
-      stats.by_size_stats_[size].count_++;
-      stats.by_size_stats_[size].bytes_ += size;
-      stats.by_size_stats_[size].allocated_ += allocated;
-    } else {
-      stats.out_of_line_total_stats_.count_++;
-      stats.out_of_line_total_stats_.bytes_ += size;
-      stats.out_of_line_total_stats_.allocated_ += allocated;
-      stats.by_ref_stats_[-refcount].count_++;
-      stats.by_ref_stats_[-refcount].bytes_ += size;
-      stats.by_ref_stats_[-refcount].allocated_ += allocated;
-      stats.by_size_stats_[-size].count_++;
-      stats.by_size_stats_[-size].bytes_ += size;
-      stats.by_size_stats_[-size].allocated_ += allocated;
+  for (const auto& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    for (const auto& str : shard.str_to_interned_) {
+      auto size = str->Str().size();
+      auto allocated = str->Allocated();
+      auto refcount =
+          str.RefCount();  // This is volatile even while holding the lock
+      if (str->IsInline()) {
+        stats.inline_total_stats_.count_++;
+        stats.inline_total_stats_.bytes_ += size;
+        stats.inline_total_stats_.allocated_ += allocated;
+        stats.by_ref_stats_[refcount].count_++;
+        stats.by_ref_stats_[refcount].bytes_ += size;
+        stats.by_ref_stats_[refcount].allocated_ += allocated;
+        stats.by_size_stats_[size].count_++;
+        stats.by_size_stats_[size].bytes_ += size;
+        stats.by_size_stats_[size].allocated_ += allocated;
+      } else {
+        stats.out_of_line_total_stats_.count_++;
+        stats.out_of_line_total_stats_.bytes_ += size;
+        stats.out_of_line_total_stats_.allocated_ += allocated;
+        stats.by_ref_stats_[-refcount].count_++;
+        stats.by_ref_stats_[-refcount].bytes_ += size;
+        stats.by_ref_stats_[-refcount].allocated_ += allocated;
+        stats.by_size_stats_[-size].count_++;
+        stats.by_size_stats_[-size].bytes_ += size;
+        stats.by_size_stats_[-size].allocated_ += allocated;
+      }
     }
   }
   return stats;
@@ -12,6 +12,7 @@
 
 #include <cstddef>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
@@ -178,6 +179,14 @@ using InternedStringSet = absl::flat_hash_set<InternedStringPtr>;
 template <typename T>
 using InternedStringNodeHashMap = absl::node_hash_map<InternedStringPtr, T>;
 
+// Orders interned strings by their address, which is stable for as long as a
+// reference is held. Used to break ties between equal keys in ordered indexes.
+struct InternedStringAddress {
+  const InternedString* operator()(const InternedStringPtr& key) const {
+    return &*key;
+  }
+};
+
 class StringInternStore {
  public:
   friend class InternedString;
@@ -190,11 +199,25 @@ class StringInternStore {
   static InternedStringPtr Intern(absl::string_view str,
                                   Allocator *allocator = nullptr);
 
+  //
+  // Moves the data of an out-of-line interned string from `from` to the
+  // buffer `to`. Only done while the data is still at `from` and the caller
+  // holds all owned_refs references to the string, including `str` itself,
+  // so that nobody else can pick up a reference while the data moves.
+  // Returns whether the data was moved; `from` is left for the caller to free.
+  //
+  static bool Relocate(const InternedStringPtr &str, const char *from,
+                       char *to, uint32_t owned_refs);
+
   static int64_t GetMemoryUsage();
 
   size_t UniqueStrings() const {
-    absl::MutexLock lock(&mutex_);
-    return str_to_interned_.size();
+    size_t count = 0;
+    for (const auto &shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex_);
+      count += shard.str_to_interned_.size();
+    }
+    return count;
   }
 
   struct Stats {
@@ -229,10 +252,26 @@ class StringInternStore {
       return lhs->Str() == rhs->Str();
     }
   };
-  absl::flat_hash_set<InternedStringPtr, InternedStringPtrFullHash,
-                      InternedStringPtrFullEqual>
-      str_to_interned_ ABSL_GUARDED_BY(mutex_);
-  mutable absl::Mutex mutex_;
+  //
+  // The intern table is hash-partitioned into independently locked shards so
+  // that concurrent interning of different strings doesn't serialize on a
+  // single mutex. Lookups of already interned strings only take a shared lock
+  // on their shard, the exclusive lock is reserved for insertion and for the
+  // 1->0 refcount transition.
+  //
+  static constexpr size_t kNumShards = 64;
+  struct alignas(ABSL_CACHELINE_SIZE) Shard {
+    absl::flat_hash_set<InternedStringPtr, InternedStringPtrFullHash,
+                        InternedStringPtrFullEqual>
+        str_to_interned_ ABSL_GUARDED_BY(mutex_);
+    mutable absl::Mutex mutex_;
+  };
+  Shard &ShardFor(absl::string_view str) {
+    // Use the high bits so the shard choice is independent of the low bits
+    // used by the per-shard table for bucket selection.
+    return shards_[(absl::HashOf(str) >> 32) % kNumShards];
+  }
+  Shard shards_[kNumShards];
 
   // Used for testing.
   static void SetMemoryUsage(int64_t value) {
@@ -9,6 +9,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -19,6 +20,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
@@ -79,6 +81,36 @@ void AddLatencyStat(ValkeyModuleInfoCtx *ctx, absl::string_view stat_name,
                                      sampler.GetStatsString().c_str());
   }
 }
+
+// The percentiles of a latency sampler, as <name>_usec over all the samples and
+// as <name>_window_usec over the samples of the last window.
+struct LatencyInfoFields {
+  LatencyInfoFields(
+      absl::string_view section, absl::string_view name,
+      std::function<vmsdk::LatencySampler &()> sampler,
+      std::function<bool()> visible = []() -> bool { return true; })
+      : cumulative(section, absl::StrCat(name, "_usec"),
+                   vmsdk::info_field::StringBuilder()
+                       .App()
+                       .ComputedString([sampler]() -> std::string {
+                         return sampler().GetStatsString();
+                       })
+                       .VisibleIf([sampler, visible]() -> bool {
+                         return visible() && sampler().HasSamples();
+                       })),
+        windowed(section, absl::StrCat(name, "_window_usec"),
+                 vmsdk::info_field::StringBuilder()
+                     .App()
+                     .ComputedString([sampler]() -> std::string {
+                       return sampler().GetWindowedStatsString();
+                     })
+                     .VisibleIf([sampler, visible]() -> bool {
+                       return visible() && sampler().HasSamples();
+                     })) {}
+
+  vmsdk::info_field::String cumulative;
+  vmsdk::info_field::String windowed;
+};
 /* Note: ValkeySearch::Info may be invoked during a crashdump by the engine.
  * In such cases, any section deemed unsafe is skipped.
  * A section is considered unsafe if it involves any of the following:
@@ -114,6 +146,24 @@ static vmsdk::info_field::Integer reclaimable_memory(
         })
         .CrashSafe());
 
+static vmsdk::info_field::Integer defrag_cycles(
+    "memory", "index_defrag_cycles",
+    vmsdk::info_field::IntegerBuilder().App().Computed([]() -> long long {
+      return Metrics::GetStats().defrag_cycles_cnt;
+    }));
+
+static vmsdk::info_field::Integer defrag_vectors_moved(
+    "memory", "index_defrag_vectors_moved",
+    vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
+      return Metrics::GetStats().defrag_vectors_moved_cnt;
+    }));
+
+static vmsdk::info_field::Integer defrag_link_lists_moved(
+    "memory", "index_defrag_link_lists_moved",
+    vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
+      return Metrics::GetStats().defrag_link_lists_moved_cnt;
+    }));
+
 static vmsdk::info_field::String background_indexing_status(
     "indexing", "background_indexing_status",
     vmsdk::info_field::StringBuilder().App().ComputedCharPtr(
@@ -199,6 +249,12 @@ static vmsdk::info_field::Integer ingest_field_text(
       return Metrics::GetStats().ingest_field_text;
     }));
 
+static vmsdk::info_field::Integer ingest_field_geo(
+    "global_ingestion", "ingest_field_geo",
+    vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
+      return Metrics::GetStats().ingest_field_geo;
+    }));
+
 static vmsdk::info_field::Integer ingest_last_batch_size(
     "global_ingestion", "ingest_last_batch_size",
     vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
@@ -217,6 +273,12 @@ static vmsdk::info_field::Integer ingest_total_failures(
       return Metrics::GetStats().ingest_total_failures;
     }));
 
+static vmsdk::info_field::Integer ingest_expired_keys_removed(
+    "global_ingestion", "ingest_expired_keys_removed",
+    vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
+      return Metrics::GetStats().expired_keys_removed_cnt;
+    }));
+
 static vmsdk::info_field::Integer time_slice_read_periods(
     "time_slice_mutex", "time_slice_read_periods",
     vmsdk::info_field::IntegerBuilder().Dev().Computed([]() -> long long {
@@ -433,6 +495,12 @@ static vmsdk::info_field::Integer prefiltering_requests_count(
       return Metrics::GetStats().query_prefiltering_requests_cnt;
     }));
 
+static vmsdk::info_field::Integer expired_keys_skipped_count(
+    "query", "expired_keys_skipped_count",
+    vmsdk::info_field::IntegerBuilder().App().Computed([]() -> long long {
+      return Metrics::GetStats().query_expired_keys_skipped_cnt;
+    }));
+
 static vmsdk::info_field::Integer nonvector_requests_count(
     "query", "nonvector_requests_count",
     vmsdk::info_field::IntegerBuilder().App().Computed([]() -> long long {
@@ -749,43 +817,25 @@ static vmsdk::info_field::String
                          .HasSamples();
             }));
 
-static vmsdk::info_field::String
-    coordinator_client_search_index_partition_success_latency_usec(
+static LatencyInfoFields
+    coordinator_client_search_index_partition_success_latency(
         "coordinator",
-        "coordinator_client_search_index_partition_success_latency_usec",
-        vmsdk::info_field::StringBuilder()
-            .App()
-            .ComputedString([]() -> std::string {
-              auto &sampler =
-                  Metrics::GetStats()
-                      .coordinator_client_search_index_partition_success_latency;
-              return sampler.GetStatsString();
-            })
-            .VisibleIf([]() -> bool {
-              return ValkeySearch::Instance().UsingCoordinator() &&
-                     Metrics::GetStats()
-                         .coordinator_client_search_index_partition_success_latency
-                         .HasSamples();
-            }));
+        "coordinator_client_search_index_partition_success_latency",
+        []() -> vmsdk::LatencySampler & {
+          return Metrics::GetStats()
+              .coordinator_client_search_index_partition_success_latency;
+        },
+        []() -> bool { return ValkeySearch::Instance().UsingCoordinator(); });
 
-static vmsdk::info_field::String
-    coordinator_client_search_index_partition_failure_latency_usec(
+static LatencyInfoFields
+    coordinator_client_search_index_partition_failure_latency(
         "coordinator",
-        "coordinator_client_search_index_partition_failure_latency_usec",
-        vmsdk::info_field::StringBuilder()
-            .App()
-            .ComputedString([]() -> std::string {
-              auto &sampler =
-                  Metrics::GetStats()
-                      .coordinator_client_search_index_partition_failure_latency;
-              return sampler.GetStatsString();
-            })
-            .VisibleIf([]() -> bool {
-              return ValkeySearch::Instance().UsingCoordinator() &&
-                     Metrics::GetStats()
-                         .coordinator_client_search_index_partition_failure_latency
-                         .HasSamples();
-            }));
+        "coordinator_client_search_index_partition_failure_latency",
+        []() -> vmsdk::LatencySampler & {
+          return Metrics::GetStats()
+              .coordinator_client_search_index_partition_failure_latency;
+        },
+        []() -> bool { return ValkeySearch::Instance().UsingCoordinator(); });
 
 static vmsdk::info_field::String
     coordinator_server_get_global_metadata_success_latency_usec(
@@ -863,31 +913,51 @@ static vmsdk::info_field::String
                          .HasSamples();
             }));
 
-static vmsdk::info_field::String hnsw_vector_index_search_latency_usec(
-    "latency", "hnsw_vector_index_search_latency_usec",
-    vmsdk::info_field::StringBuilder()
-        .App()
-        .ComputedString([]() -> std::string {
-          auto &sampler = Metrics::GetStats().hnsw_vector_index_search_latency;
-          return sampler.GetStatsString();
-        })
-        .VisibleIf([]() -> bool {
-          return Metrics::GetStats()
-              .hnsw_vector_index_search_latency.HasSamples();
-        }));
+static LatencyInfoFields hnsw_vector_index_search_latency(
+    "latency", "hnsw_vector_index_search_latency",
+    []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().hnsw_vector_index_search_latency;
+    });
 
-static vmsdk::info_field::String flat_vector_index_search_latency_usec(
-    "latency", "flat_vector_index_search_latency_usec",
-    vmsdk::info_field::StringBuilder()
-        .App()
-        .ComputedString([]() -> std::string {
-          auto &sampler = Metrics::GetStats().flat_vector_index_search_latency;
-          return sampler.GetStatsString();
-        })
-        .VisibleIf([]() -> bool {
-          return Metrics::GetStats()
-              .flat_vector_index_search_latency.HasSamples();
-        }));
+static LatencyInfoFields flat_vector_index_search_latency(
+    "latency", "flat_vector_index_search_latency",
+    []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().flat_vector_index_search_latency;
+    });
+
+static LatencyInfoFields ft_search_latency(
+    "latency", "ft_search_latency", []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().ft_search_latency;
+    });
+
+static LatencyInfoFields ft_aggregate_latency(
+    "latency", "ft_aggregate_latency", []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().ft_aggregate_latency;
+    });
+
+static LatencyInfoFields content_fetch_latency(
+    "latency", "content_fetch_latency", []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().content_fetch_latency;
+    });
+
+static LatencyInfoFields mutation_apply_latency(
+    "latency", "mutation_apply_latency", []() -> vmsdk::LatencySampler & {
+      return Metrics::GetStats().mutation_apply_latency;
+    });
+
+static LatencyInfoFields query_queue_wait_latency(
+    "latency", "query_queue_wait_latency", []() -> vmsdk::LatencySampler & {
+      return ValkeySearch::Instance()
+          .GetReaderThreadPool()
+          ->GetQueueWaitLatency();
+    });
+
+static LatencyInfoFields writer_queue_wait_latency(
+    "latency", "writer_queue_wait_latency", []() -> vmsdk::LatencySampler & {
+      return ValkeySearch::Instance()
+          .GetWriterThreadPool()
+          ->GetQueueWaitLatency();
+    });
 
 static vmsdk::info_field::Integer info_fanout_retry_count(
     "fanout", "info_fanout_retry_count",
@@ -1070,6 +1140,7 @@ void ValkeySearch::OnServerCronCallback(ValkeyModuleCtx *ctx,
                                         [[maybe_unused]] ValkeyModuleEvent eid,
                                         [[maybe_unused]] uint64_t subevent,
                                         [[maybe_unused]] void *data) {
+  vmsdk::LatencySampler::CollectAll();
   // Clean-up after threads that exited without being "joined"
   if (writer_thread_pool_) {
     writer_thread_pool_->JoinTerminatedWorkers();
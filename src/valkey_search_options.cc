@@ -376,6 +376,42 @@ static auto prefiltering_threshold_ratio_config =
         .Dev()  // can only be set in debug mode
         .Build();
 
+/// Register the "filter-aware-search-threshold-ratio" flag
+/// Inline-filtered HNSW queries whose estimated filter selectivity is at or
+/// below this ratio use the filter-aware graph traversal. Zero disables it.
+constexpr absl::string_view kFilterAwareSearchThresholdRatioConfig{
+    "filter-aware-search-threshold-ratio"};
+constexpr absl::string_view kDefaultFilterAwareSearchThresholdRatio{"0.05"};
+constexpr double kMinimumFilterAwareSearchThresholdRatio{0.0};
+constexpr double kMaximumFilterAwareSearchThresholdRatio{1.0};
+static double filter_aware_search_threshold_ratio{0.05};
+
+static auto filter_aware_search_threshold_ratio_config =
+    config::StringBuilder(kFilterAwareSearchThresholdRatioConfig,
+                          kDefaultFilterAwareSearchThresholdRatio)
+        .WithValidationCallback([](const std::string& value) -> absl::Status {
+          double parsed_value;
+          if (!absl::SimpleAtod(value, &parsed_value)) {
+            return absl::InvalidArgumentError(
+                "Filter aware search threshold ratio must be a valid number");
+          }
+          if (parsed_value < kMinimumFilterAwareSearchThresholdRatio ||
+              parsed_value > kMaximumFilterAwareSearchThresholdRatio) {
+            return absl::InvalidArgumentError(absl::StrFormat(
+                "Filter aware search threshold ratio must be between %.1f and "
+                "%.1f",
+                kMinimumFilterAwareSearchThresholdRatio,
+                kMaximumFilterAwareSearchThresholdRatio));
+          }
+          return absl::OkStatus();
+        })
+        .WithModifyCallback([](const std::string& value) {
+          double parsed_value;
+          CHECK(absl::SimpleAtod(value, &parsed_value));
+          filter_aware_search_threshold_ratio = parsed_value;
+        })
+        .Build();
+
 /// Register the "search-result-buffer-multiplier" flag
 constexpr absl::string_view kSearchResultBufferMultiplierConfig{
     "search-result-buffer-multiplier"};
@@ -415,6 +451,10 @@ double GetSearchResultBufferMultiplier() {
 
 double GetPrefilteringThresholdRatio() { return prefiltering_threshold_ratio; }
 
+double GetFilterAwareSearchThresholdRatio() {
+  return filter_aware_search_threshold_ratio;
+}
+
 /// Register the "drain-mutation-queue-on-load" flag
 /// Drain the mutation queue after RDB load
 constexpr absl::string_view kDrainMutationQueueOnLoadConfig{
@@ -727,6 +767,30 @@ static auto mutation_weight_tag =
         .Dev()
         .Build();
 
+/// Register the "--mutation-weight-geo" flag. Controls the weight multiplier
+/// for geo index types in mutation queue entries (scale: 100 = 1.0x)
+constexpr absl::string_view kMutationWeightGeoConfig{"mutation-weight-geo"};
+constexpr uint32_t kDefaultMutationWeightGeo{430};
+static auto mutation_weight_geo =
+    config::NumberBuilder(kMutationWeightGeoConfig, kDefaultMutationWeightGeo,
+                          kMinimumMutationWeight, kMaximumMutationWeight)
+        .Dev()
+        .Build();
+
+/// Register the "--mutation-weight-ns-per-byte" flag. When set, once an index
+/// has sampled mutations, its weight is derived from their measured cost: this
+/// many nanoseconds per input byte weigh 100 (1.0x). The weighted buffer then
+/// tracks CPU cost rather than memory. 0 (the default) keeps the static weights
+/// per index type.
+constexpr absl::string_view kMutationWeightNsPerByteConfig{
+    "mutation-weight-ns-per-byte"};
+constexpr uint32_t kDefaultMutationWeightNsPerByte{0};
+static auto mutation_weight_ns_per_byte =
+    config::NumberBuilder(kMutationWeightNsPerByteConfig,
+                          kDefaultMutationWeightNsPerByte, 0, 1000000)
+        .Dev()
+        .Build();
+
 config::Number& GetMutationWeightVector() {
   return dynamic_cast<config::Number&>(*mutation_weight_vector);
 }
@@ -743,5 +807,77 @@ config::Number& GetMutationWeightTag() {
   return dynamic_cast<config::Number&>(*mutation_weight_tag);
 }
 
+config::Number& GetMutationWeightGeo() {
+  return dynamic_cast<config::Number&>(*mutation_weight_geo);
+}
+
+config::Number& GetMutationWeightNsPerByte() {
+  return dynamic_cast<config::Number&>(*mutation_weight_ns_per_byte);
+}
+
+/// Register the "--backfill-off-main-thread" flag. When enabled, the backfill
+/// scan on the main thread only collects key names and the key fields are read
+/// by the writer threads in short windows under the module lock.
+constexpr absl::string_view kBackfillOffMainThreadConfig{
+    "backfill-off-main-thread"};
+static auto backfill_off_main_thread =
+    config::BooleanBuilder(kBackfillOffMainThreadConfig, false).Build();
+
+/// Register the "--backfill-max-stall-us" flag. The backfill batch size is
+/// adapted so that each batch stalls the main thread for about this long. Zero
+/// disables the adaptation and always uses the configured batch size.
+constexpr absl::string_view kBackfillMaxStallUsConfig{"backfill-max-stall-us"};
+constexpr uint32_t kDefaultBackfillMaxStallUs{10000};
+constexpr uint32_t kMaximumBackfillMaxStallUs{10000000};
+static auto backfill_max_stall_us =
+    config::NumberBuilder(kBackfillMaxStallUsConfig, kDefaultBackfillMaxStallUs,
+                          0, kMaximumBackfillMaxStallUs)
+        .WithValidationCallback(CHECK_RANGE(0, kMaximumBackfillMaxStallUs,
+                                            kBackfillMaxStallUsConfig))
+        .Build();
+
+const config::Boolean& GetBackfillOffMainThread() {
+  return dynamic_cast<const config::Boolean&>(*backfill_off_main_thread);
+}
+
+config::Boolean& GetBackfillOffMainThreadMutable() {
+  return dynamic_cast<config::Boolean&>(*backfill_off_main_thread);
+}
+
+config::Number& GetBackfillMaxStallUs() {
+  return dynamic_cast<config::Number&>(*backfill_max_stall_us);
+}
+
+/// Register the "--slowlog-log-slower-than" flag. FT.SEARCH and FT.AGGREGATE
+/// queries taking longer than this many microseconds, from parsing to reply,
+/// are recorded in the slow log. A negative value disables the slow log.
+constexpr absl::string_view kSlowLogLogSlowerThanConfig{
+    "slowlog-log-slower-than"};
+constexpr int64_t kDefaultSlowLogLogSlowerThan{10000};
+constexpr int64_t kMaximumSlowLogLogSlowerThan{3600000000};
+static auto slowlog_log_slower_than =
+    config::NumberBuilder(kSlowLogLogSlowerThanConfig,
+                          kDefaultSlowLogLogSlowerThan, -1,
+                          kMaximumSlowLogLogSlowerThan)
+        .Build();
+
+/// Register the "--slowlog-max-len" flag, the number of queries kept in the
+/// slow log. The oldest entries are dropped first.
+constexpr absl::string_view kSlowLogMaxLenConfig{"slowlog-max-len"};
+constexpr uint32_t kDefaultSlowLogMaxLen{128};
+constexpr uint32_t kMaximumSlowLogMaxLen{100000};
+static auto slowlog_max_len =
+    config::NumberBuilder(kSlowLogMaxLenConfig, kDefaultSlowLogMaxLen, 0,
+                          kMaximumSlowLogMaxLen)
+        .Build();
+
+config::Number& GetSlowLogLogSlowerThan() {
+  return dynamic_cast<config::Number&>(*slowlog_log_slower_than);
+}
+
+config::Number& GetSlowLogMaxLen() {
+  return dynamic_cast<config::Number&>(*slowlog_max_len);
+}
+
 }  // namespace options
 }  // namespace valkey_search
@@ -100,6 +100,9 @@ double GetSearchResultBufferMultiplier();
 /// Return the prefiltering threshold ratio value
 double GetPrefilteringThresholdRatio();
 
+/// Return the filter aware search threshold ratio value
+double GetFilterAwareSearchThresholdRatio();
+
 /// Return the configuration entry for draining mutation queue on save
 const config::Boolean& GetDrainMutationQueueOnSave();
 
@@ -142,9 +145,32 @@ config::Number& GetMutationWeightNumeric();
 /// Return the mutation weight for tag index types
 config::Number& GetMutationWeightTag();
 
+/// Return the mutation weight for geo index types
+config::Number& GetMutationWeightGeo();
+
+/// Return the measured mutation cost, in nanoseconds per byte, that weighs 100
+config::Number& GetMutationWeightNsPerByte();
+
 /// Return the recursion depth of the query string from FT.SEARCH and
 /// FT.AGGREGATE commands
 config::Number& GetQueryStringDepth();
 
+/// Return the configuration entry for reading backfilled keys off the main
+/// thread
+const config::Boolean& GetBackfillOffMainThread();
+
+/// Return a mutable reference for testing
+config::Boolean& GetBackfillOffMainThreadMutable();
+
+/// Return the target main thread stall of a backfill batch in microseconds
+config::Number& GetBackfillMaxStallUs();
+
+/// Return the end to end latency, in microseconds, above which a query is
+/// recorded in the slow log. Negative disables the slow log
+config::Number& GetSlowLogLogSlowerThan();
+
+/// Return the maximum number of queries kept in the slow log
+config::Number& GetSlowLogMaxLen();
+
 }  // namespace options
 }  // namespace valkey_search
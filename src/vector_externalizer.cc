@@ -136,36 +136,46 @@ void VectorExternalizer::ProcessEngineUpdateQueue() {
   auto& deferred_shared_vectors = deferred_shared_vectors_.Get();
   auto& shared_vectors = shared_vectors_.Get();
   for (auto& [key, attribute_identifiers] : deferred_shared_vectors) {
-    vmsdk::UniqueValkeyOpenKey key_obj;
+    // Deferred entries come from field values written by the client, which
+    // replaced any value previously externalized for them. Every update must
+    // therefore be externalized again for the keyspace to keep sharing the
+    // index copy.
+    auto key_str = vmsdk::MakeUniqueValkeyString(key->Str());
+    auto key_obj = vmsdk::MakeUniqueValkeyOpenKey(
+        ctx_.Get().get(), key_str.get(), VALKEYMODULE_WRITE);
+    auto shared_it = shared_vectors.find(key);
+    if (!key_obj) {
+      if (shared_it != shared_vectors.end()) {
+        for (const auto& [attribute_identifier, _] : attribute_identifiers) {
+          shared_it->second.erase(attribute_identifier);
+        }
+        if (shared_it->second.empty()) {
+          shared_vectors.erase(shared_it);
+        }
+      }
+      continue;
+    }
+    if (shared_it == shared_vectors.end()) {
+      shared_it = shared_vectors.try_emplace(key).first;
+    }
+    auto& shared_attributes = shared_it->second;
     for (auto& [attribute_identifier, vector_externalizer_entry] :
          attribute_identifiers) {
-      auto it = shared_vectors[key].find(attribute_identifier);
-      if (it != shared_vectors[key].end()) {
-        it->second.magnitude = vector_externalizer_entry.magnitude;
-        it->second.vector = std::move(vector_externalizer_entry.vector);
-        it->second.cache_normalized_ = nullptr;
-        continue;
-      }
-      auto& entry = shared_vectors[key][attribute_identifier];
+      auto& entry = shared_attributes[attribute_identifier];
       entry.magnitude = vector_externalizer_entry.magnitude;
       entry.vector = std::move(vector_externalizer_entry.vector);
-      if (!key_obj) {
-        auto key_str = vmsdk::MakeUniqueValkeyString(key->Str());
-        key_obj = vmsdk::MakeUniqueValkeyOpenKey(
-            ctx_.Get().get(), key_str.get(), VALKEYMODULE_WRITE);
-        if (!key_obj) {
-          break;
-        }
-      }
-
+      entry.cache_normalized_ = nullptr;
       if (ValkeyModule_HashExternalize(
               key_obj.get(),
               vmsdk::MakeUniqueValkeyString(attribute_identifier).get(),
               ExternalizeCB, &entry) != VALKEYMODULE_OK) {
-        shared_vectors[key].erase(attribute_identifier);
+        shared_attributes.erase(attribute_identifier);
         ++stats_.Get().hash_extern_errors;
       }
     }
+    if (shared_attributes.empty()) {
+      shared_vectors.erase(shared_it);
+    }
   }
   deferred_shared_vectors.clear();
 }
@@ -178,8 +188,36 @@ void VectorExternalizer::Remove(
           data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH) {
     return;
   }
-  shared_vectors_.Get()[key].erase(attribute_identifier);
-  deferred_shared_vectors_.Get()[key].erase(attribute_identifier);
+  // Drop emptied per key maps, otherwise every deleted key leaves one behind.
+  auto erase = [&](auto& vectors) {
+    auto it = vectors.find(key);
+    if (it == vectors.end()) {
+      return;
+    }
+    it->second.erase(attribute_identifier);
+    if (it->second.empty()) {
+      vectors.erase(it);
+    }
+  };
+  erase(shared_vectors_.Get());
+  erase(deferred_shared_vectors_.Get());
+}
+
+size_t VectorExternalizer::CountReferences(
+    const InternedStringPtr& key, const InternedStringPtr& vector) const {
+  size_t count = 0;
+  auto count_in = [&](const auto& vectors) {
+    auto it = vectors.find(key);
+    if (it == vectors.end()) {
+      return;
+    }
+    for (const auto& [_, entry] : it->second) {
+      count += entry.vector == vector;
+    }
+  };
+  count_in(shared_vectors_.Get());
+  count_in(deferred_shared_vectors_.Get());
+  return count;
 }
 
 VectorExternalizer::Stats VectorExternalizer::GetStats() const {
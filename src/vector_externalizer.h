@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/strings/string_view.h"
 #include "src/attribute_data_type.h"
@@ -49,6 +50,11 @@ class VectorExternalizer {
               absl::string_view attribute_identifier,
               data_model::AttributeDataType attribute_data_type);
   void ProcessEngineUpdateQueue();
+  // Returns the number of references to `vector` held by the entries of
+  // `key`. The entries read the vector through the interned string, so they
+  // follow it when its data is relocated.
+  size_t CountReferences(const InternedStringPtr& key,
+                         const InternedStringPtr& vector) const;
 
   struct Stats {
     size_t num_lru_entries{0};
@@ -98,8 +104,10 @@ class VectorExternalizer {
  private:
   VectorExternalizer();
 
+  // The engine and the LRU keep pointers to these entries, so they must not
+  // move when other attributes of the same key are added or removed.
   vmsdk::MainThreadAccessGuard<InternedStringHashMap<
-      absl::flat_hash_map<std::string, VectorExternalizerEntry>>>
+      absl::node_hash_map<std::string, VectorExternalizerEntry>>>
       shared_vectors_;
   vmsdk::MainThreadAccessGuard<InternedStringHashMap<
       absl::flat_hash_map<std::string, VectorExternalizerEntry>>>
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/expiry_tracker.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "src/utils/string_interning.h"
+
+namespace valkey_search {
+
+namespace {
+
+std::vector<std::string> Strs(const std::vector<InternedStringPtr> &keys) {
+  std::vector<std::string> strs;
+  for (const auto &key : keys) {
+    strs.emplace_back(key->Str());
+  }
+  return strs;
+}
+
+TEST(ExpiryTrackerTest, IsExpired) {
+  ExpiryTracker tracker;
+  auto key = StringInternStore::Intern("key");
+  EXPECT_TRUE(tracker.IsEmpty());
+  EXPECT_FALSE(tracker.IsExpired(key, 100));
+  tracker.Set(key, 100);
+  EXPECT_EQ(tracker.Size(), 1);
+  EXPECT_FALSE(tracker.IsExpired(key, 99));
+  EXPECT_TRUE(tracker.IsExpired(key, 100));
+  tracker.Remove(key);
+  EXPECT_TRUE(tracker.IsEmpty());
+  EXPECT_FALSE(tracker.IsExpired(key, 100));
+}
+
+TEST(ExpiryTrackerTest, EraseExpired) {
+  ExpiryTracker tracker;
+  auto key_a = StringInternStore::Intern("a");
+  auto key_b = StringInternStore::Intern("b");
+  auto key_c = StringInternStore::Intern("c");
+  auto key_d = StringInternStore::Intern("d");
+  auto key_of = [](const InternedStringPtr &key) -> const InternedStringPtr & {
+    return key;
+  };
+  std::vector<InternedStringPtr> keys{key_a, key_b, key_c, key_d};
+  EXPECT_EQ(tracker.EraseExpired(keys, 100, key_of), 0);
+  tracker.Set(key_a, 10);
+  tracker.Set(key_c, 20);
+  tracker.Set(key_d, 50);
+  EXPECT_EQ(tracker.EraseExpired(keys, 5, key_of), 0);
+  EXPECT_EQ(keys.size(), 4);
+  EXPECT_EQ(tracker.EraseExpired(keys, 20, key_of), 2);
+  EXPECT_EQ(Strs(keys), (std::vector<std::string>{"b", "d"}));
+  EXPECT_EQ(tracker.EraseExpired(keys, 100, key_of), 1);
+  EXPECT_EQ(Strs(keys), std::vector<std::string>{"b"});
+}
+
+TEST(ExpiryTrackerTest, PopExpiredInExpirationOrder) {
+  ExpiryTracker tracker;
+  auto key_a = StringInternStore::Intern("a");
+  auto key_b = StringInternStore::Intern("b");
+  auto key_c = StringInternStore::Intern("c");
+  auto key_d = StringInternStore::Intern("d");
+  tracker.Set(key_a, 30);
+  tracker.Set(key_b, 10);
+  tracker.Set(key_c, 20);
+  tracker.Set(key_d, 5);
+  // Pushed back and forgotten keys are not popped at their old times.
+  tracker.Set(key_b, 50);
+  tracker.Remove(key_d);
+
+  EXPECT_EQ(Strs(tracker.PopExpired(40, 1)), std::vector<std::string>{"c"});
+  EXPECT_EQ(Strs(tracker.PopExpired(40, 10)), std::vector<std::string>{"a"});
+  EXPECT_TRUE(tracker.PopExpired(40, 10).empty());
+  EXPECT_EQ(tracker.Size(), 1);
+  EXPECT_EQ(Strs(tracker.PopExpired(50, 10)), std::vector<std::string>{"b"});
+  EXPECT_TRUE(tracker.IsEmpty());
+}
+
+TEST(ExpiryTrackerTest, SlidingExpirationStaysBounded) {
+  ExpiryTracker tracker;
+  auto key = StringInternStore::Intern("session");
+  for (int64_t i = 1; i <= 100000; ++i) {
+    tracker.Set(key, i);
+  }
+  EXPECT_EQ(tracker.Size(), 1);
+  EXPECT_TRUE(tracker.PopExpired(99999, 10).empty());
+  EXPECT_EQ(Strs(tracker.PopExpired(100000, 10)),
+            std::vector<std::string>{"session"});
+}
+
+}  // namespace
+
+}  // namespace valkey_search
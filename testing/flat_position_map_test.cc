@@ -24,6 +24,7 @@ class FlatPositionMapPtr {
   FlatPositionMapPtr(const absl::btree_map<Position, FieldMask>& position_map,
                      size_t num_text_fields)
       : ptr_(FlatPositionMap::Create(position_map, num_text_fields)) {}
+  explicit FlatPositionMapPtr(FlatPositionMap* ptr) : ptr_(ptr) {}
 
   ~FlatPositionMapPtr() { FlatPositionMap::Destroy(ptr_); }
 
@@ -300,6 +301,66 @@ TEST_F(FlatPositionMapTest, MoveAssignment) {
   EXPECT_EQ(map1->CountPositions(), 1);
 }
 
+//=============================================================================
+// Builder Tests
+//=============================================================================
+
+TEST_F(FlatPositionMapTest, BuilderMergesRepeatedPositions) {
+  FlatPositionMapBuilder builder(2);
+  builder.AddPosition(10, 0b01);
+  builder.AddPosition(10, 0b10);
+  builder.AddPosition(20, 0b01);
+  FlatPositionMapPtr flat_map(builder.Build());
+
+  EXPECT_EQ(builder.GetNumPositions(), 2);
+  EXPECT_EQ(builder.GetTermFrequency(), 3);
+  VerifyIteration(*flat_map, {{10, 0b11}, {20, 0b01}});
+}
+
+TEST_F(FlatPositionMapTest, BuilderMergesFieldsAddedOutOfOrder) {
+  // Each field restarts its positions at 0, as the fields of a key do.
+  absl::btree_map<Position, uint64_t> reference;
+  FlatPositionMapBuilder builder(3);
+  for (Position pos = 0; pos < 300; ++pos) {
+    builder.AddPosition(pos, 0b001);
+    reference[pos] |= 0b001;
+  }
+  for (Position pos = 0; pos < 600; pos += 3) {
+    builder.AddPosition(pos, 0b010);
+    reference[pos] |= 0b010;
+  }
+  builder.AddPosition(7, 0b100);
+  reference[7] |= 0b100;
+  FlatPositionMapPtr flat_map(builder.Build());
+
+  std::vector<std::pair<Position, uint64_t>> expected(reference.begin(),
+                                                      reference.end());
+  size_t term_frequency = 0;
+  for (const auto& [_, mask] : expected) {
+    term_frequency += __builtin_popcountll(mask);
+  }
+  EXPECT_EQ(flat_map->CountPositions(), expected.size());
+  EXPECT_EQ(builder.GetNumPositions(), expected.size());
+  EXPECT_EQ(builder.GetTermFrequency(), term_frequency);
+  EXPECT_GT(flat_map->GetNumPartitions(), 0);
+  VerifyIteration(*flat_map, expected);
+
+  PositionIterator iter(*flat_map);
+  EXPECT_TRUE(iter.SkipForwardPosition(450));
+  EXPECT_EQ(iter.GetFieldMask(), 0b010);
+}
+
+TEST_F(FlatPositionMapTest, BuilderSpillsWideFieldMasks) {
+  const uint64_t high_field = 1ULL << 63;
+  FlatPositionMapBuilder builder(64);
+  builder.AddPosition(5, high_field);
+  builder.AddPosition(1000000, 1);
+  builder.AddPosition(5, 1);
+  FlatPositionMapPtr flat_map(builder.Build());
+
+  VerifyIteration(*flat_map, {{5, high_field | 1}, {1000000, 1}});
+}
+
 //=============================================================================
 // Stress Test
 //=============================================================================
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "google/protobuf/text_format.h"
+#include "gtest/gtest.h"
+#include "src/commands/commands.h"
+#include "src/index_schema.h"
+#include "src/index_schema.pb.h"
+#include "src/schema_manager.h"
+#include "testing/common.h"
+#include "vmsdk/src/testing_infra/module.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+namespace {
+
+class FTBulkLoadTest : public ValkeySearchTest {
+ protected:
+  void SetUp() override {
+    ValkeySearchTest::SetUp();
+    data_model::IndexSchema index_schema_proto;
+    ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+        R"(
+          name: "test_index"
+          db_num: 0
+          subscribed_key_prefixes: "prefix_1"
+          attribute_data_type: ATTRIBUTE_DATA_TYPE_HASH
+          attributes: {
+            alias: "attribute_1"
+            identifier: "attribute_1"
+            index: {
+              vector_index: {
+                dimension_count: 10
+                normalize: true
+                distance_metric: DISTANCE_METRIC_COSINE
+                vector_data_type: VECTOR_DATA_TYPE_FLOAT32
+                initial_cap: 100
+                flat_algorithm { block_size: 100 }
+              }
+            }
+          }
+        )",
+        &index_schema_proto));
+    VMSDK_EXPECT_OK(SchemaManager::Instance().CreateIndexSchema(
+        &fake_ctx_, index_schema_proto));
+    index_schema_ =
+        SchemaManager::Instance().GetIndexSchema(0, "test_index").value();
+  }
+
+  void TearDown() override {
+    index_schema_.reset();
+    ValkeySearchTest::TearDown();
+  }
+
+  absl::StatusCode Run(
+      absl::Status (*cmd)(ValkeyModuleCtx *, ValkeyModuleString **, int),
+      const std::vector<std::string> &argv) {
+    std::vector<ValkeyModuleString *> cmd_argv;
+    std::transform(argv.begin(), argv.end(), std::back_inserter(cmd_argv),
+                   [&](const std::string &val) {
+                     return TestValkeyModule_CreateStringPrintf(
+                         &fake_ctx_, "%s", val.data());
+                   });
+    auto code = cmd(&fake_ctx_, cmd_argv.data(), cmd_argv.size()).code();
+    for (auto cmd_arg : cmd_argv) {
+      TestValkeyModule_FreeString(&fake_ctx_, cmd_arg);
+    }
+    return code;
+  }
+
+  std::shared_ptr<IndexSchema> index_schema_;
+};
+
+TEST_F(FTBulkLoadTest, BeginAndEnd) {
+  EXPECT_FALSE(index_schema_->IsBulkLoadInProgress());
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "begin"}),
+            absl::StatusCode::kOk);
+  EXPECT_TRUE(index_schema_->IsBulkLoadInProgress());
+  EXPECT_EQ(index_schema_->GetStateForInfo(), "bulk_loading");
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "BEGIN"}),
+            absl::StatusCode::kFailedPrecondition);
+
+  // Queries are refused until the rebuild completes.
+  EXPECT_EQ(Run(FTSearchCmd, {"FT.SEARCH", "test_index", "*"}),
+            absl::StatusCode::kFailedPrecondition);
+
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "END"}),
+            absl::StatusCode::kOk);
+  EXPECT_TRUE(index_schema_->IsBackfillInProgress());
+  index_schema_->MaybeFinishBulkLoad();
+  EXPECT_TRUE(index_schema_->IsBulkLoadInProgress());
+  EXPECT_EQ(Run(FTSearchCmd, {"FT.SEARCH", "test_index", "*"}),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "END"}),
+            absl::StatusCode::kFailedPrecondition);
+}
+
+TEST_F(FTBulkLoadTest, InvalidArguments) {
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index"}),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "START"}),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "missing_index", "BEGIN"}),
+            absl::StatusCode::kNotFound);
+  EXPECT_EQ(Run(FTBulkLoadCmd, {"FT.BULKLOAD", "test_index", "END"}),
+            absl::StatusCode::kFailedPrecondition);
+  EXPECT_FALSE(index_schema_->IsBulkLoadInProgress());
+}
+
+}  // namespace
+
+}  // namespace valkey_search
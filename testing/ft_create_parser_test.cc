@@ -213,6 +213,10 @@ TEST_P(FTCreateParserTest, ParseParams) {
         EXPECT_EQ(hnsw_proto.ef_runtime(),
                   test_case.hnsw_parameters[hnsw_index].ef_runtime);
         EXPECT_EQ(hnsw_proto.m(), test_case.hnsw_parameters[hnsw_index].m);
+        EXPECT_EQ(
+            index_schema_proto->attributes(i).index().vector_index()
+                .multi_vector(),
+            test_case.hnsw_parameters[hnsw_index].multi_vector);
         ++hnsw_index;
       } else if (test_case.expected.attributes[i].indexer_type ==
                  indexes::IndexerType::kNumeric) {
@@ -296,6 +300,36 @@ INSTANTIATE_TEST_SUITE_P(
                               .indexer_type = indexes::IndexerType::kHNSW,
                           }}},
          },
+         {
+             .test_name = "happy_path_hnsw_multi_vector",
+             .success = true,
+             .command_str = "idx1 SChema hash_field1 vector hnsw 7 TYPE "
+                            "FLOAT32 DIM 3 DISTANCE_METRIC IP MULTIVECTOR",
+             .hnsw_parameters = {{
+                 {
+                     .dimensions = 3,
+                     .distance_metric = data_model::DISTANCE_METRIC_IP,
+                     .vector_data_type = data_model::VECTOR_DATA_TYPE_FLOAT32,
+                 },
+                 /* .m =*/kDefaultM,
+                 /* .ef_construction =*/kDefaultEFConstruction,
+                 /* .ef_runtime =*/kDefaultEFRuntime,
+                 /* .multi_vector =*/true,
+             }},
+             .expected = {.index_schema_name = "idx1",
+                          .on_data_type = data_model::ATTRIBUTE_DATA_TYPE_HASH,
+                          .attributes = {{
+                              .identifier = "hash_field1",
+                              .attribute_alias = "hash_field1",
+                              .indexer_type = indexes::IndexerType::kHNSW,
+                          }}},
+         },
+         {
+             .test_name = "invalid_flat_multi_vector",
+             .success = false,
+             .command_str = "idx1 SChema hash_field1 vector flat 7 TYPE "
+                            "FLOAT32 DIM 3 DISTANCE_METRIC IP MULTIVECTOR",
+         },
          {
              .test_name = "happy_path_flat",
              .success = true,
@@ -134,16 +134,16 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                         .expect_return_failure = false,
                         .expected_output =
-                            "*28\r\n+index_name\r\n+test_name\r\n+index_"
+                            "*30\r\n+index_name\r\n+test_name\r\n+index_"
                             "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                             "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                             "1\r\n1\r\n+attributes\r\n*1\r\n*10\r\n+"
                             "identifier\r\n+test_identifier_1\r\n+"
                             "attribute\r\n+test_attribute_1\r\n+user_indexed_"
                             "memory\r\n:0\r\n+type\r\n+VECTOR\r\n+index\r\n*"
-                            "12\r\n+capacity\r\n:100\r\n+dimensions\r\n:10\r\n+"
+                            "14\r\n+capacity\r\n:100\r\n+dimensions\r\n:10\r\n+"
                             "distance_metric\r\n+COSINE\r\n+size\r\n$"
-                            "1\r\n0\r\n+data_type\r\n+FLOAT32\r\n+"
+                            "1\r\n0\r\n+id_map_memory\r\n:0\r\n+data_type\r\n+FLOAT32\r\n+"
                             "algorithm\r\n*8\r\n+name\r\n+HNSW\r\n+m\r\n:"
                             "240\r\n+ef_construction\r\n:400\r\n+ef_"
                             "runtime\r\n:30\r\n+num_docs\r\n:0\r\n+num_"
@@ -153,6 +153,7 @@ INSTANTIATE_TEST_SUITE_P(
                             "hash_indexing_failures\r\n$"
                             "1\r\n0\r\n+backfill_in_progress\r\n$1\r\n0\r\n+"
                             "backfill_complete_percent\r\n$8\r\n1.000000\r\n+"
+                            "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
                             "mutation_queue_size\r\n$1\r\n0\r\n+recent_"
                             "mutations_queue_delay\r\n$5\r\n0 "
                             "sec\r\n+state\r\n+ready\r\n+language\r\n+"
@@ -190,16 +191,16 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                         .expect_return_failure = false,
                         .expected_output =
-                            "*28\r\n+index_name\r\n+test_name\r\n+index_"
+                            "*30\r\n+index_name\r\n+test_name\r\n+index_"
                             "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                             "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                             "1\r\n1\r\n+attributes\r\n*1\r\n*10\r\n+"
                             "identifier\r\n+test_identifier_1\r\n+"
                             "attribute\r\n+test_attribute_1\r\n+user_indexed_"
                             "memory\r\n:0\r\n+type\r\n+VECTOR\r\n+index\r\n*"
-                            "12\r\n+capacity\r\n:100\r\n+dimensions\r\n:10\r\n+"
+                            "14\r\n+capacity\r\n:100\r\n+dimensions\r\n:10\r\n+"
                             "distance_metric\r\n+COSINE\r\n+size\r\n$"
-                            "1\r\n0\r\n+data_type\r\n+FLOAT32\r\n+"
+                            "1\r\n0\r\n+id_map_memory\r\n:0\r\n+data_type\r\n+FLOAT32\r\n+"
                             "algorithm\r\n*4\r\n+name\r\n+FLAT\r\n+block_"
                             "size\r\n:1024\r\n+num_docs\r\n:0\r\n+num_"
                             "records\r\n:0\r\n+total_term_occurrences\r\n:"
@@ -208,6 +209,7 @@ INSTANTIATE_TEST_SUITE_P(
                             "hash_indexing_failures\r\n$"
                             "1\r\n0\r\n+backfill_in_progress\r\n$1\r\n0\r\n+"
                             "backfill_complete_percent\r\n$8\r\n1.000000\r\n+"
+                            "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
                             "mutation_queue_size\r\n$1\r\n0\r\n+recent_"
                             "mutations_queue_delay\r\n$5\r\n0 "
                             "sec\r\n+state\r\n+ready\r\n+language\r\n+"
@@ -238,7 +240,7 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                         .expect_return_failure = false,
                         .expected_output =
-                            "*28\r\n+index_name\r\n+test_name\r\n+index_"
+                            "*30\r\n+index_name\r\n+test_name\r\n+index_"
                             "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                             "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                             "1\r\n1\r\n+attributes\r\n*1\r\n*14\r\n+"
@@ -250,7 +252,9 @@ INSTANTIATE_TEST_SUITE_P(
                             "term_occurrences\r\n:0\r\n+num_terms\r\n:0\r\n+"
                             "hash_indexing_failures\r\n$1\r\n0\r\n+"
                             "backfill_in_progress\r\n$1\r\n0\r\n+backfill_"
-                            "complete_percent\r\n$8\r\n1.000000\r\n+mutation_"
+                            "complete_percent\r\n$8\r\n1.000000\r\n+"
+                            "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
+                            "mutation_"
                             "queue_size\r\n$1\r\n0\r\n+recent_mutations_queue_"
                             "delay\r\n$5\r\n0 "
                             "sec\r\n+state\r\n+ready\r\n+language\r\n+"
@@ -282,7 +286,7 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                         .expect_return_failure = false,
                         .expected_output =
-                            "*28\r\n+index_name\r\n+test_name\r\n+index_"
+                            "*30\r\n+index_name\r\n+test_name\r\n+index_"
                             "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                             "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                             "1\r\n1\r\n+attributes\r\n*1\r\n*14\r\n+"
@@ -294,7 +298,9 @@ INSTANTIATE_TEST_SUITE_P(
                             "term_occurrences\r\n:0\r\n+num_terms\r\n:0\r\n+"
                             "hash_indexing_failures\r\n$1\r\n0\r\n+"
                             "backfill_in_progress\r\n$1\r\n0\r\n+backfill_"
-                            "complete_percent\r\n$8\r\n1.000000\r\n+mutation_"
+                            "complete_percent\r\n$8\r\n1.000000\r\n+"
+                            "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
+                            "mutation_"
                             "queue_size\r\n$1\r\n0\r\n+recent_mutations_queue_"
                             "delay\r\n$5\r\n0 "
                             "sec\r\n+state\r\n+ready\r\n+language\r\n+"
@@ -323,7 +329,7 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                         .expect_return_failure = false,
                         .expected_output =
-                            "*28\r\n+index_name\r\n+test_name\r\n+index_"
+                            "*30\r\n+index_name\r\n+test_name\r\n+index_"
                             "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                             "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                             "1\r\n1\r\n+attributes\r\n*1\r\n*10\r\n+"
@@ -336,6 +342,7 @@ INSTANTIATE_TEST_SUITE_P(
                             "hash_indexing_failures\r\n$"
                             "1\r\n0\r\n+backfill_in_progress\r\n$1\r\n0\r\n+"
                             "backfill_complete_percent\r\n$8\r\n1.000000\r\n+"
+                            "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
                             "mutation_queue_size\r\n$1\r\n0\r\n+recent_"
                             "mutations_queue_delay\r\n$5\r\n0 "
                             "sec\r\n+state\r\n+ready\r\n+language\r\n+"
@@ -392,7 +399,7 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                      .expect_return_failure = false,
                      .expected_output =
-                         "*36\r\n+index_name\r\n+test_name\r\n+index_"
+                         "*38\r\n+index_name\r\n+test_name\r\n+index_"
                          "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                          "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                          "1\r\n1\r\n+attributes\r\n*1\r\n*14\r\n+"
@@ -405,7 +412,9 @@ INSTANTIATE_TEST_SUITE_P(
                          "0\r\n+"
                          "hash_indexing_failures\r\n$1\r\n0\r\n+backfill_in_"
                          "progress\r\n$1\r\n0\r\n+backfill_complete_"
-                         "percent\r\n$8\r\n1.000000\r\n+mutation_queue_"
+                         "percent\r\n$8\r\n1.000000\r\n+"
+                         "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
+                         "mutation_queue_"
                          "size\r\n$1\r\n0\r\n+recent_mutations_queue_delay\r\n$"
                          "5\r\n0 "
                          "sec\r\n+state\r\n+ready\r\n+punctuation\r\n+\r\n+"
@@ -444,7 +453,7 @@ INSTANTIATE_TEST_SUITE_P(
                         )",
                      .expect_return_failure = false,
                      .expected_output =
-                         "*36\r\n+index_name\r\n+test_name\r\n+index_"
+                         "*38\r\n+index_name\r\n+test_name\r\n+index_"
                          "definition\r\n*6\r\n+key_type\r\n+HASH\r\n+"
                          "prefixes\r\n*1\r\n+prefix_1\r\n+default_score\r\n$"
                          "1\r\n1\r\n+attributes\r\n*1\r\n*14\r\n+"
@@ -457,7 +466,9 @@ INSTANTIATE_TEST_SUITE_P(
                          "0\r\n+"
                          "hash_indexing_failures\r\n$1\r\n0\r\n+backfill_in_"
                          "progress\r\n$1\r\n0\r\n+backfill_complete_"
-                         "percent\r\n$8\r\n1.000000\r\n+mutation_queue_"
+                         "percent\r\n$8\r\n1.000000\r\n+"
+                         "backfill_main_thread_stall\r\n$4\r\n0 ms\r\n+"
+                         "mutation_queue_"
                          "size\r\n$1\r\n0\r\n+recent_mutations_queue_delay\r\n$"
                          "5\r\n0 "
                          "sec\r\n+state\r\n+ready\r\n+punctuation\r\n+.,!?\r\n+"
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gtest/gtest.h"
+#include "src/commands/commands.h"
+#include "testing/common.h"
+#include "vmsdk/src/testing_infra/module.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+namespace {
+
+class FTProfileTest : public ValkeySearchTest {
+ protected:
+  absl::Status Run(const std::vector<std::string> &argv) {
+    std::vector<ValkeyModuleString *> cmd_argv;
+    std::transform(argv.begin(), argv.end(), std::back_inserter(cmd_argv),
+                   [&](const std::string &val) {
+                     return TestValkeyModule_CreateStringPrintf(
+                         &fake_ctx_, "%s", val.data());
+                   });
+    auto status = FTProfileCmd(&fake_ctx_, cmd_argv.data(), cmd_argv.size());
+    for (auto cmd_arg : cmd_argv) {
+      TestValkeyModule_FreeString(&fake_ctx_, cmd_arg);
+    }
+    return status;
+  }
+};
+
+TEST_F(FTProfileTest, InvalidArguments) {
+  EXPECT_EQ(Run({"FT.PROFILE", "idx", "SEARCH", "QUERY"}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.PROFILE", "idx", "SEARCH", "LIMITED", "QUERY"}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.PROFILE", "idx", "SEARCH", "*", "QUERY"}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.PROFILE", "idx", "EXPLAIN", "QUERY", "*"}).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST_F(FTProfileTest, RunsProfiledCommand) {
+  // The arguments are handed over to the profiled command, which looks up the
+  // index.
+  EXPECT_EQ(Run({"FT.PROFILE", "idx", "search", "QUERY", "*"}).code(),
+            absl::StatusCode::kNotFound);
+  EXPECT_EQ(
+      Run({"FT.PROFILE", "idx", "AGGREGATE", "limited", "query", "*"}).code(),
+      absl::StatusCode::kNotFound);
+}
+
+}  // namespace
+
+}  // namespace valkey_search
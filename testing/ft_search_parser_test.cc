@@ -936,6 +936,36 @@ INSTANTIATE_TEST_SUITE_P(
                 "Error parsing value for the parameter `SLOP`",
             .search_parameters_str = "SLOP -100",
         },
+        {
+            .test_name = "fusion_requires_text_filter",
+            .success = false,
+            .params_str = " PARAMS 2",
+            .filter_str = "* =>[KNN 3 @vec $BLOB]",
+            .k = 3,
+            .expected_error_message =
+                "FUSION requires a text filter in the query.",
+            .search_parameters_str = "FUSION RRF K 30",
+        },
+        {
+            .test_name = "fusion_unknown_method",
+            .success = false,
+            .params_str = " PARAMS 2",
+            .filter_str = "* =>[KNN 3 @vec $BLOB]",
+            .k = 3,
+            .expected_error_message =
+                "Error parsing value for the parameter `FUSION`",
+            .search_parameters_str = "FUSION LINEAR",
+        },
+        {
+            .test_name = "fusion_negative_weight",
+            .success = false,
+            .params_str = " PARAMS 2",
+            .filter_str = "* =>[KNN 3 @vec $BLOB]",
+            .k = 3,
+            .expected_error_message =
+                "Error parsing value for the parameter `FUSION`",
+            .search_parameters_str = "FUSION WEIGHTS 0.5 -1",
+        },
         // SORTBY tests
         {
             .test_name = "sortby_numeric_asc",
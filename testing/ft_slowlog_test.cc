@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "src/commands/commands.h"
+#include "src/query/search.h"
+#include "src/query/slowlog.h"
+#include "src/valkey_search_options.h"
+#include "testing/common.h"
+#include "vmsdk/src/testing_infra/module.h"
+#include "vmsdk/src/valkey_module_api/valkey_module.h"
+
+namespace valkey_search {
+
+namespace {
+
+class FTSlowLogTest : public ValkeySearchTest {
+ protected:
+  void SetUp() override {
+    ValkeySearchTest::SetUp();
+    VMSDK_EXPECT_OK(options::GetSlowLogLogSlowerThan().SetValue(1000));
+    VMSDK_EXPECT_OK(options::GetSlowLogMaxLen().SetValue(3));
+    query::SlowLog::Instance().Reset();
+  }
+  void TearDown() override {
+    query::SlowLog::Instance().Reset();
+    VMSDK_EXPECT_OK(options::GetSlowLogLogSlowerThan().SetValue(
+        options::GetSlowLogLogSlowerThan().GetDefaultValue()));
+    VMSDK_EXPECT_OK(options::GetSlowLogMaxLen().SetValue(
+        options::GetSlowLogMaxLen().GetDefaultValue()));
+    ValkeySearchTest::TearDown();
+  }
+
+  void Record(absl::Duration duration, const std::string &query) {
+    query::QueryTimings timings;
+    timings.plan = "prefilter";
+    timings.results = 7;
+    timings.search_time = absl::Microseconds(400);
+    query::SlowLog::Instance().MaybeRecord(duration, kSearchCommand, "idx",
+                                           query, timings,
+                                           absl::Microseconds(20));
+  }
+
+  absl::Status Run(const std::vector<std::string> &argv) {
+    std::vector<ValkeyModuleString *> cmd_argv;
+    std::transform(argv.begin(), argv.end(), std::back_inserter(cmd_argv),
+                   [&](const std::string &val) {
+                     return TestValkeyModule_CreateStringPrintf(
+                         &fake_ctx_, "%s", val.data());
+                   });
+    auto status = FTSlowLogCmd(&fake_ctx_, cmd_argv.data(), cmd_argv.size());
+    for (auto cmd_arg : cmd_argv) {
+      TestValkeyModule_FreeString(&fake_ctx_, cmd_arg);
+    }
+    return status;
+  }
+};
+
+TEST_F(FTSlowLogTest, RecordsSlowQueries) {
+  auto &slowlog = query::SlowLog::Instance();
+  Record(absl::Microseconds(999), "fast");
+  EXPECT_EQ(slowlog.Len(), 0);
+  Record(absl::Milliseconds(5), "slow");
+  ASSERT_EQ(slowlog.Len(), 1);
+  auto entries = slowlog.Get(10);
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0]->command, kSearchCommand);
+  EXPECT_EQ(entries[0]->index_name, "idx");
+  EXPECT_EQ(entries[0]->query, "slow");
+  EXPECT_EQ(entries[0]->plan, "prefilter");
+  EXPECT_EQ(entries[0]->results, 7);
+  EXPECT_EQ(entries[0]->duration, absl::Milliseconds(5));
+  EXPECT_EQ(entries[0]->search_time, absl::Microseconds(400));
+  EXPECT_EQ(entries[0]->reply_time, absl::Microseconds(20));
+}
+
+TEST_F(FTSlowLogTest, KeepsMostRecentEntries) {
+  auto &slowlog = query::SlowLog::Instance();
+  for (int i = 0; i < 5; ++i) {
+    Record(absl::Milliseconds(2), absl::StrCat("query", i));
+  }
+  EXPECT_EQ(slowlog.Len(), 3);
+  auto entries = slowlog.Get(10);
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[0]->query, "query4");
+  EXPECT_EQ(entries[1]->query, "query3");
+  EXPECT_EQ(entries[2]->query, "query2");
+  EXPECT_GT(entries[0]->id, entries[1]->id);
+  ASSERT_EQ(slowlog.Get(1).size(), 1);
+  EXPECT_EQ(slowlog.Get(1)[0]->query, "query4");
+
+  // Shrinking the log keeps the newest entries.
+  VMSDK_EXPECT_OK(options::GetSlowLogMaxLen().SetValue(2));
+  Record(absl::Milliseconds(2), "query5");
+  entries = slowlog.Get(10);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0]->query, "query5");
+  EXPECT_EQ(entries[1]->query, "query4");
+}
+
+TEST_F(FTSlowLogTest, Disabled) {
+  VMSDK_EXPECT_OK(options::GetSlowLogLogSlowerThan().SetValue(-1));
+  EXPECT_FALSE(query::SlowLog::IsEnabled());
+  Record(absl::Seconds(1), "slow");
+  EXPECT_EQ(query::SlowLog::Instance().Len(), 0);
+}
+
+TEST_F(FTSlowLogTest, LenAndReset) {
+  Record(absl::Milliseconds(2), "slow");
+  Record(absl::Milliseconds(2), "slow");
+  VMSDK_EXPECT_OK(Run({"FT.SLOWLOG", "len"}));
+  EXPECT_EQ(fake_ctx_.reply_capture.GetReply(), ":2\r\n");
+  fake_ctx_.reply_capture.ClearReply();
+  VMSDK_EXPECT_OK(Run({"FT.SLOWLOG", "RESET"}));
+  EXPECT_EQ(fake_ctx_.reply_capture.GetReply(), "+OK\r\n");
+  EXPECT_EQ(query::SlowLog::Instance().Len(), 0);
+  fake_ctx_.reply_capture.ClearReply();
+  VMSDK_EXPECT_OK(Run({"FT.SLOWLOG", "GET"}));
+  EXPECT_EQ(fake_ctx_.reply_capture.GetReply(), "*0\r\n");
+}
+
+TEST_F(FTSlowLogTest, InvalidArguments) {
+  EXPECT_EQ(Run({"FT.SLOWLOG"}).code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.SLOWLOG", "CLEAR"}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.SLOWLOG", "LEN", "1"}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(Run({"FT.SLOWLOG", "GET", "many"}).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+
+}  // namespace valkey_search
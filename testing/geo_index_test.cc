@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/indexes/geo.h"
+#include "src/indexes/index_base.h"
+#include "src/query/predicate.h"
+#include "src/utils/geohash.h"
+#include "testing/common.h"
+#include "vmsdk/src/testing_infra/utils.h"
+
+namespace valkey_search::indexes {
+
+namespace {
+
+class GeoIndexTest : public vmsdk::ValkeyTest {
+ protected:
+  data_model::GeoIndex geo_index_proto;
+  IndexTeser<Geo, data_model::GeoIndex> index{geo_index_proto};
+  std::string attribute_id = "attribute_id";
+  std::string attribute_alias = "attribute_alias";
+};
+
+std::vector<std::string> Fetch(
+    valkey_search::indexes::EntriesFetcherBase& fetcher) {
+  std::vector<std::string> keys;
+  auto itr = fetcher.Begin();
+  while (!itr->Done()) {
+    keys.push_back(std::string(***itr));
+    itr->Next();
+  }
+  return keys;
+}
+
+TEST_F(GeoIndexTest, RadiusAddModifyRemove) {
+  // Palermo and Catania are ~166km apart.
+  EXPECT_TRUE(index.AddRecord("palermo", "13.361389,38.115556").value());
+  EXPECT_TRUE(index.AddRecord("catania", "15.087269 37.502669").value());
+  EXPECT_FALSE(index.AddRecord("invalid", "200,0").value());
+  EXPECT_EQ(index.AddRecord("palermo", "13.361389,38.115556").status().code(),
+            absl::StatusCode::kAlreadyExists);
+
+  query::GeoPredicate near_palermo(&index, attribute_alias, attribute_id,
+                                   utils::GeoPoint{13.4, 38.1}, 10000);
+  auto fetcher = index.Search(near_palermo, false);
+  EXPECT_THAT(Fetch(*fetcher), testing::UnorderedElementsAre("palermo"));
+
+  query::GeoPredicate both(&index, attribute_alias, attribute_id,
+                           utils::GeoPoint{15, 37}, 200000);
+  fetcher = index.Search(both, false);
+  EXPECT_GE(fetcher->Size(), 2);
+  EXPECT_THAT(Fetch(*fetcher),
+              testing::UnorderedElementsAre("palermo", "catania"));
+
+  fetcher = index.Search(near_palermo, true);
+  EXPECT_THAT(Fetch(*fetcher),
+              testing::UnorderedElementsAre("catania", "invalid"));
+
+  EXPECT_TRUE(index.ModifyRecord("catania", "13.37,38.12").value());
+  fetcher = index.Search(near_palermo, false);
+  EXPECT_THAT(Fetch(*fetcher),
+              testing::UnorderedElementsAre("palermo", "catania"));
+
+  EXPECT_TRUE(index.RemoveRecord("palermo").value());
+  EXPECT_FALSE(index.IsTracked("palermo"));
+  fetcher = index.Search(near_palermo, false);
+  EXPECT_THAT(Fetch(*fetcher), testing::UnorderedElementsAre("catania"));
+  EXPECT_EQ(index.ModifyRecord("palermo", "1,1").status().code(),
+            absl::StatusCode::kNotFound);
+}
+
+TEST_F(GeoIndexTest, RadiusAcrossAntimeridian) {
+  EXPECT_TRUE(index.AddRecord("east", "179.9,0").value());
+  EXPECT_TRUE(index.AddRecord("west", "-179.9,0").value());
+  EXPECT_TRUE(index.AddRecord("far", "0,0").value());
+  query::GeoPredicate predicate(&index, attribute_alias, attribute_id,
+                                utils::GeoPoint{180, 0}, 50000);
+  auto fetcher = index.Search(predicate, false);
+  EXPECT_THAT(Fetch(*fetcher), testing::UnorderedElementsAre("east", "west"));
+}
+
+TEST_F(GeoIndexTest, Polygon) {
+  EXPECT_TRUE(index.AddRecord("inside", "1,1").value());
+  EXPECT_TRUE(index.AddRecord("notch", "1.5,1.8").value());
+  EXPECT_TRUE(index.AddRecord("outside", "3,3").value());
+  // A square with a notch cut from its top edge.
+  auto polygon =
+      utils::ParseWktPolygon("POLYGON((0 0, 2 0, 2 2, 1.2 2, 1.2 1.5, 0 2))");
+  ASSERT_TRUE(polygon.ok());
+  query::GeoPredicate predicate(&index, attribute_alias, attribute_id,
+                                *polygon);
+  auto fetcher = index.Search(predicate, false);
+  EXPECT_THAT(Fetch(*fetcher), testing::UnorderedElementsAre("inside"));
+}
+
+TEST(GeoHashTest, Parse) {
+  EXPECT_TRUE(utils::ParseGeoPoint("-122.4,37.7").ok());
+  EXPECT_FALSE(utils::ParseGeoPoint("-122.4").ok());
+  EXPECT_FALSE(utils::ParseGeoPoint("0,90").ok());
+  EXPECT_FALSE(utils::ParseGeoPoint("nan,0").ok());
+  EXPECT_EQ(utils::ParseGeoUnit("KM").value(), 1000.0);
+  EXPECT_FALSE(utils::ParseGeoUnit("parsec").ok());
+  auto polygon = utils::ParseWktPolygon("POLYGON((0 0, 1 0, 1 1, 0 0))");
+  ASSERT_TRUE(polygon.ok());
+  EXPECT_EQ(polygon->size(), 3);
+  EXPECT_FALSE(utils::ParseWktPolygon("POLYGON((0 0, 1 1))").ok());
+  EXPECT_FALSE(utils::ParseWktPolygon("LINESTRING(0 0, 1 1)").ok());
+}
+
+TEST(GeoHashTest, DistanceOfAntipodalPoints) {
+  const double half_circumference = M_PI * utils::kEarthRadiusMeters;
+  EXPECT_NEAR(utils::GeoDistance({0, 0}, {180, 0}), half_circumference, 1);
+  // The haversine of these rounds to just above 1.
+  EXPECT_NEAR(utils::GeoDistance({-180, -89.6808}, {0, 89.6808}),
+              half_circumference, 1);
+}
+
+TEST(GeoHashTest, CoverContainsBox) {
+  utils::GeoBox box{-10.5, 20.25, -9.75, 21};
+  auto ranges = utils::GeoHashCoverBox(box);
+  EXPECT_LE(ranges.size(), 16);
+  for (double lon = box.min_lon; lon <= box.max_lon; lon += 0.05) {
+    for (double lat = box.min_lat; lat <= box.max_lat; lat += 0.05) {
+      auto hash = utils::GeoHashEncode(utils::GeoPoint{lon, lat});
+      bool covered = false;
+      for (const auto& [start, end] : ranges) {
+        covered |= hash >= start && hash < end;
+      }
+      EXPECT_TRUE(covered) << lon << "," << lat;
+    }
+  }
+}
+
+}  // namespace
+
+}  // namespace valkey_search::indexes
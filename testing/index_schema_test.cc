@@ -26,10 +26,13 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "src/attribute_data_type.h"
+#include "src/backfill_coordinator.h"
 #include "src/index_schema.pb.h"
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
@@ -799,6 +802,99 @@ TEST_P(IndexSchemaSubscriptionSimpleTest, KeyspaceNotificationWithNullptrTest) {
   }
 }
 
+TEST_P(IndexSchemaSubscriptionSimpleTest, SharedRecordsAcrossSchemasTest) {
+  std::vector<absl::string_view> key_prefixes = {"prefix:"};
+  std::vector<std::shared_ptr<MockIndex>> mock_indexes;
+  std::vector<std::shared_ptr<IndexSchema>> index_schemas;
+  for (auto name : {"index_schema_a", "index_schema_b"}) {
+    auto index_schema =
+        MockIndexSchema::Create(&fake_ctx_, name, key_prefixes,
+                                std::make_unique<HashAttributeDataType>(),
+                                nullptr)
+            .value();
+    auto mock_index = std::make_shared<MockIndex>();
+    VMSDK_EXPECT_OK(index_schema->AddIndex("attribute_name", "test_identifier",
+                                           mock_index));
+    EXPECT_CALL(*mock_index, IsTracked(testing::_))
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_index, AddRecord(testing::_, StrEq("test_data")))
+        .WillOnce(Return(true));
+    mock_indexes.push_back(mock_index);
+    index_schemas.push_back(index_schema);
+  }
+  EXPECT_CALL(*kMockValkeyModule, KeyType(testing::_))
+      .WillRepeatedly(Return(VALKEYMODULE_KEYTYPE_HASH));
+  // The key is opened and its field is read once for both schemas.
+  EXPECT_CALL(*kMockValkeyModule, OpenKey(&fake_ctx_, testing::_, testing::_))
+      .WillOnce(TestValkeyModule_OpenKeyDefaultImpl);
+  ValkeyModuleString *test_data =
+      TestValkeyModule_CreateStringPrintf(nullptr, "test_data");
+  EXPECT_CALL(*kMockValkeyModule, HashGet(testing::_, VALKEYMODULE_HASH_CFIELDS,
+                                          StrEq("test_identifier"),
+                                          An<ValkeyModuleString **>(),
+                                          TypedEq<void *>(nullptr)))
+      .WillOnce([test_data](ValkeyModuleKey *, int, const char *,
+                            ValkeyModuleString **value_out, void *) {
+        *value_out = test_data;
+        return VALKEYMODULE_OK;
+      });
+  auto key_valkey_str = vmsdk::MakeUniqueValkeyString("prefix:key");
+  KeyspaceEventManager::Instance().NotifySubscribers(
+      &fake_ctx_, VALKEYMODULE_NOTIFY_HASH, "hset", key_valkey_str.get());
+}
+
+TEST_P(IndexSchemaSubscriptionSimpleTest, ExpiredKeysTest) {
+  std::vector<absl::string_view> key_prefixes = {"prefix:"};
+  auto index_schema =
+      MockIndexSchema::Create(&fake_ctx_, "index_schema_name", key_prefixes,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+  auto mock_index = std::make_shared<MockIndex>();
+  VMSDK_EXPECT_OK(
+      index_schema->AddIndex("attribute_name", "test_identifier", mock_index));
+  EXPECT_CALL(*mock_index, IsTracked(testing::_))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*mock_index, AddRecord(testing::_, StrEq("test_data")))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*kMockValkeyModule, KeyType(testing::_))
+      .WillRepeatedly(Return(VALKEYMODULE_KEYTYPE_HASH));
+  EXPECT_CALL(*kMockValkeyModule, HashGet(testing::_, VALKEYMODULE_HASH_CFIELDS,
+                                          StrEq("test_identifier"),
+                                          An<ValkeyModuleString **>(),
+                                          TypedEq<void *>(nullptr)))
+      .WillRepeatedly([](ValkeyModuleKey *, int, const char *,
+                         ValkeyModuleString **value_out, void *) {
+        *value_out = TestValkeyModule_CreateStringPrintf(nullptr, "test_data");
+        return VALKEYMODULE_OK;
+      });
+  // The first key is already due, the second never expires.
+  EXPECT_CALL(*kMockValkeyModule, GetExpire(testing::_))
+      .WillOnce(Return(0))
+      .WillOnce(Return(VALKEYMODULE_NO_EXPIRE));
+  auto expiring_key = vmsdk::MakeUniqueValkeyString("prefix:expiring");
+  auto persistent_key = vmsdk::MakeUniqueValkeyString("prefix:persistent");
+  index_schema->OnKeyspaceNotification(&fake_ctx_, VALKEYMODULE_NOTIFY_HASH,
+                                       "hset", expiring_key.get());
+  index_schema->OnKeyspaceNotification(&fake_ctx_, VALKEYMODULE_NOTIFY_HASH,
+                                       "hset", persistent_key.get());
+  EXPECT_EQ(index_schema->GetExpiryTracker().Size(), 1);
+
+  std::vector<indexes::Neighbor> neighbors{
+      {StringInternStore::Intern("prefix:expiring"), 0.0f},
+      {StringInternStore::Intern("prefix:persistent"), 1.0f}};
+  index_schema->RemoveExpiredNeighbors(neighbors);
+  ASSERT_EQ(neighbors.size(), 1);
+  EXPECT_EQ(neighbors[0].external_id->Str(), "prefix:persistent");
+
+  EXPECT_CALL(*mock_index,
+              RemoveRecord(testing::_, indexes::DeletionType::kRecord))
+      .WillOnce(Return(true));
+  EXPECT_EQ(index_schema->RemoveExpiredKeys(&fake_ctx_, 10), 1);
+  EXPECT_TRUE(index_schema->GetExpiryTracker().IsEmpty());
+}
+
 TEST_P(IndexSchemaSubscriptionSimpleTest, GetKeyPrefixesTest) {
   vmsdk::ThreadPool mutations_thread_pool("writer-thread-pool-", 1);
   mutations_thread_pool.StartWorkers();
@@ -964,9 +1060,10 @@ TEST_P(IndexSchemaBackfillTest, PerformBackfillTest) {
         }
         return (++i < test_case.keys_to_return_in_scan.size()) ? 1 : 0;
       });
-  EXPECT_EQ(
-      index_schema->PerformBackfill(&parent_ctx, test_case.scan_batch_size),
-      test_case.expected_keys_scanned);
+  BackfillCoordinator coordinator;
+  EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, 0, {index_schema},
+                                        test_case.scan_batch_size),
+            test_case.expected_keys_scanned);
   if (!use_thread_pool) {
     EXPECT_EQ(index_schema->IsBackfillInProgress(),
               test_case.expected_backfill_percent != 1.0);
@@ -1005,8 +1102,10 @@ TEST_F(IndexSchemaBackfillTest, PerformBackfill_NoOngoingBackfillTest) {
                       ValkeyModuleScanCB fn,
                       void *privdata) -> int { return 0; });
 
+    BackfillCoordinator coordinator;
     for (size_t i = 0; i < 100; ++i) {
-      EXPECT_EQ(index_schema->PerformBackfill(&parent_ctx, 1024), 0);
+      EXPECT_EQ(
+          coordinator.PerformBackfill(&parent_ctx, 0, {index_schema}, 1024), 0);
     }
   }
 }
@@ -1033,6 +1132,22 @@ TEST_F(IndexSchemaBackfillTest, PerformBackfill_SwapDB) {
                             use_thread_pool ? &mutations_thread_pool : nullptr)
                             .value();
 
+    // Start the scan of the DB without finishing it.
+    auto key_r_str = vmsdk::MakeUniqueValkeyString("other:key");
+    EXPECT_CALL(*kMockValkeyModule,
+                Scan(&scan_ctx, testing::An<ValkeyModuleScanCursor *>(),
+                     testing::An<ValkeyModuleScanCB>(), testing::An<void *>()))
+        .WillOnce([&](ValkeyModuleCtx *ctx, ValkeyModuleScanCursor *cursor,
+                      ValkeyModuleScanCB fn, void *privdata) -> int {
+          fn(ctx, key_r_str.get(), nullptr, privdata);
+          return 1;
+        });
+    BackfillCoordinator coordinator;
+    EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, starting_db,
+                                          {index_schema}, 1),
+              1);
+    EXPECT_TRUE(coordinator.IsScanInProgress(starting_db));
+
     // Validate swapping changes the db in the context
     ValkeyModuleSwapDbInfo swap_db_info = {
         .dbnum_first = starting_db,
@@ -1040,13 +1155,206 @@ TEST_F(IndexSchemaBackfillTest, PerformBackfill_SwapDB) {
     };
     EXPECT_CALL(*kMockValkeyModule, SelectDb(&scan_ctx, db_to_swap))
         .WillOnce(Return(VALKEYMODULE_OK));
-    index_schema->OnSwapDB(&swap_db_info);
+    coordinator.OnSwapDB(&swap_db_info);
+    EXPECT_TRUE(coordinator.IsScanInProgress(db_to_swap));
+    EXPECT_FALSE(coordinator.IsScanInProgress(starting_db));
 
     // Validate swapping again brings the db back to the original
     EXPECT_CALL(*kMockValkeyModule, SelectDb(&scan_ctx, starting_db))
         .WillOnce(Return(VALKEYMODULE_OK));
-    index_schema->OnSwapDB(&swap_db_info);
+    coordinator.OnSwapDB(&swap_db_info);
+    EXPECT_TRUE(coordinator.IsScanInProgress(starting_db));
+  }
+}
+
+TEST_F(IndexSchemaBackfillTest, PerformBackfill_SharedScan) {
+  std::vector<absl::string_view> key_prefixes_a = {"a:", "shared:"};
+  std::vector<absl::string_view> key_prefixes_b = {"shared:"};
+  std::vector<std::string> keys = {"a:1", "shared:1", "none:1"};
+  ValkeyModuleCtx parent_ctx;
+  ValkeyModuleCtx scan_ctx;
+  EXPECT_CALL(*kMockValkeyModule, DbSize(testing::_))
+      .WillRepeatedly(Return(keys.size()));
+  EXPECT_CALL(*kMockValkeyModule, GetDetachedThreadSafeContext(&parent_ctx))
+      .WillRepeatedly(Return(&scan_ctx));
+  EXPECT_CALL(*kMockValkeyModule, GetContextFlags(&parent_ctx))
+      .WillRepeatedly(Return(0));
+  auto index_schema_a =
+      MockIndexSchema::Create(&parent_ctx, "index_schema_a", key_prefixes_a,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+  auto index_schema_b =
+      MockIndexSchema::Create(&parent_ctx, "index_schema_b", key_prefixes_b,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+
+  // Both schemas are served by a single pass over the keys, and each matching
+  // key is opened once no matter how many schemas are interested in it.
+  size_t i = 0;
+  EXPECT_CALL(*kMockValkeyModule,
+              Scan(&scan_ctx, testing::An<ValkeyModuleScanCursor *>(),
+                   testing::An<ValkeyModuleScanCB>(), testing::An<void *>()))
+      .Times(keys.size())
+      .WillRepeatedly([&](ValkeyModuleCtx *ctx, ValkeyModuleScanCursor *cursor,
+                          ValkeyModuleScanCB fn, void *privdata) -> int {
+        auto key_r_str = vmsdk::MakeUniqueValkeyString(keys[i]);
+        fn(ctx, key_r_str.get(), nullptr, privdata);
+        return (++i < keys.size()) ? 1 : 0;
+      });
+  EXPECT_CALL(*kMockValkeyModule, OpenKey(&scan_ctx, testing::_, testing::_))
+      .Times(2);
+  BackfillCoordinator coordinator;
+  EXPECT_EQ(coordinator.PerformBackfill(
+                &parent_ctx, 0, {index_schema_a, index_schema_b}, 1024),
+            keys.size());
+  for (const auto &index_schema : {index_schema_a, index_schema_b}) {
+    EXPECT_FALSE(index_schema->IsBackfillInProgress());
+    EXPECT_EQ(index_schema->GetBackfillScannedKeyCount(), keys.size());
   }
+  EXPECT_FALSE(coordinator.IsScanInProgress(0));
+}
+
+TEST_F(IndexSchemaBackfillTest, PerformBackfill_LateSchemaWaitsForNextRound) {
+  std::vector<absl::string_view> key_prefixes = {"prefix:"};
+  ValkeyModuleCtx parent_ctx;
+  ValkeyModuleCtx scan_ctx;
+  EXPECT_CALL(*kMockValkeyModule, GetDetachedThreadSafeContext(&parent_ctx))
+      .WillRepeatedly(Return(&scan_ctx));
+  EXPECT_CALL(*kMockValkeyModule, GetContextFlags(&parent_ctx))
+      .WillRepeatedly(Return(0));
+  auto early_schema =
+      MockIndexSchema::Create(&parent_ctx, "early_schema", key_prefixes,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+
+  bool more_keys = true;
+  auto key_r_str = vmsdk::MakeUniqueValkeyString("other:key");
+  EXPECT_CALL(*kMockValkeyModule,
+              Scan(&scan_ctx, testing::An<ValkeyModuleScanCursor *>(),
+                   testing::An<ValkeyModuleScanCB>(), testing::An<void *>()))
+      .WillRepeatedly([&](ValkeyModuleCtx *ctx, ValkeyModuleScanCursor *cursor,
+                          ValkeyModuleScanCB fn, void *privdata) -> int {
+        fn(ctx, key_r_str.get(), nullptr, privdata);
+        return more_keys ? 1 : 0;
+      });
+  BackfillCoordinator coordinator;
+  EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, 0, {early_schema}, 1), 1);
+
+  // A schema created once the round has visited keys must not join it.
+  auto late_schema =
+      MockIndexSchema::Create(&parent_ctx, "late_schema", key_prefixes,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+  more_keys = false;
+  EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, 0,
+                                        {early_schema, late_schema}, 1024),
+            1);
+  EXPECT_FALSE(early_schema->IsBackfillInProgress());
+  EXPECT_EQ(early_schema->GetBackfillScannedKeyCount(), 2);
+  EXPECT_TRUE(late_schema->IsBackfillInProgress());
+  EXPECT_EQ(late_schema->GetBackfillScannedKeyCount(), 0);
+
+  // The next round starts from the beginning of the keyspace for it.
+  EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, 0,
+                                        {early_schema, late_schema}, 1024),
+            1);
+  EXPECT_FALSE(late_schema->IsBackfillInProgress());
+  EXPECT_EQ(late_schema->GetBackfillScannedKeyCount(), 1);
+}
+
+TEST_F(IndexSchemaBackfillTest, PerformBackfill_OffMainThread) {
+  std::vector<absl::string_view> key_prefixes = {"prefix:"};
+  std::vector<std::string> keys = {"prefix:1", "other:1", "prefix:2"};
+  ValkeyModuleCtx parent_ctx;
+  ValkeyModuleCtx scan_ctx;
+  EXPECT_CALL(*kMockValkeyModule, DbSize(testing::_))
+      .WillRepeatedly(Return(keys.size()));
+  EXPECT_CALL(*kMockValkeyModule, GetDetachedThreadSafeContext(&parent_ctx))
+      .WillRepeatedly(Return(&scan_ctx));
+  EXPECT_CALL(*kMockValkeyModule, GetContextFlags(&parent_ctx))
+      .WillRepeatedly(Return(0));
+  auto index_schema =
+      MockIndexSchema::Create(&parent_ctx, "index_schema", key_prefixes,
+                              std::make_unique<HashAttributeDataType>(),
+                              nullptr)
+          .value();
+
+  size_t i = 0;
+  EXPECT_CALL(*kMockValkeyModule,
+              Scan(&scan_ctx, testing::An<ValkeyModuleScanCursor *>(),
+                   testing::An<ValkeyModuleScanCB>(), testing::An<void *>()))
+      .Times(keys.size())
+      .WillRepeatedly([&](ValkeyModuleCtx *ctx, ValkeyModuleScanCursor *cursor,
+                          ValkeyModuleScanCB fn, void *privdata) -> int {
+        auto key_r_str = vmsdk::MakeUniqueValkeyString(keys[i]);
+        fn(ctx, key_r_str.get(), nullptr, privdata);
+        return (++i < keys.size()) ? 1 : 0;
+      });
+  // The matching keys are only opened by the extraction thread, once it got
+  // hold of the server lock.
+  EXPECT_CALL(*kMockValkeyModule, ThreadSafeContextTryLock(&scan_ctx))
+      .WillOnce(Return(VALKEYMODULE_ERR))
+      .WillRepeatedly(Return(VALKEYMODULE_OK));
+  EXPECT_CALL(*kMockValkeyModule, ThreadSafeContextUnlock(&scan_ctx))
+      .Times(testing::AtLeast(1));
+  // The contended attempt is retried from a timer.
+  EXPECT_CALL(*kMockValkeyModule,
+              CreateTimer(&scan_ctx, 1, testing::_, testing::_))
+      .WillOnce([](ValkeyModuleCtx *ctx, mstime_t period,
+                   ValkeyModuleTimerProc callback, void *data) {
+        callback(ctx, data);
+        return 1;
+      });
+  EXPECT_CALL(*kMockValkeyModule, OpenKey(&scan_ctx, testing::_, testing::_))
+      .Times(2);
+
+  vmsdk::ThreadPool extraction_thread_pool("backfill-thread-pool-", 1);
+  extraction_thread_pool.StartWorkers();
+  VMSDK_EXPECT_OK(options::GetBackfillOffMainThreadMutable().SetValue(true));
+  {
+    BackfillCoordinator coordinator(&extraction_thread_pool);
+    EXPECT_EQ(
+        coordinator.PerformBackfill(&parent_ctx, 0, {index_schema}, 1024),
+        keys.size());
+    while (index_schema->IsBackfillInProgress()) {
+      absl::SleepFor(absl::Milliseconds(1));
+    }
+    EXPECT_EQ(index_schema->GetBackfillScannedKeyCount(), keys.size());
+    EXPECT_TRUE(coordinator.IsScanInProgress(0));
+    // The scan is released once its keys were extracted.
+    EXPECT_EQ(coordinator.PerformBackfill(&parent_ctx, 0, {index_schema}, 1024),
+              0);
+    EXPECT_FALSE(coordinator.IsScanInProgress(0));
+  }
+  VMSDK_EXPECT_OK(options::GetBackfillOffMainThreadMutable().SetValue(false));
+  extraction_thread_pool.JoinWorkers();
+}
+
+TEST(BackfillCoordinatorTest, AdaptBatchSize) {
+  constexpr absl::Duration kMaxStall = absl::Milliseconds(10);
+  // Adaptation is disabled.
+  EXPECT_EQ(BackfillCoordinator::AdaptBatchSize(
+                100, 1000, 100, absl::Seconds(1), absl::ZeroDuration()),
+            1000);
+  // A slow batch shrinks to the size that fits the stall budget.
+  EXPECT_EQ(BackfillCoordinator::AdaptBatchSize(
+                1000, 1000, 1000, absl::Milliseconds(40), kMaxStall),
+            250);
+  // ...but not below the minimum.
+  EXPECT_EQ(BackfillCoordinator::AdaptBatchSize(1000, 1000, 1000,
+                                                absl::Seconds(10), kMaxStall),
+            16);
+  // A fast batch grows, at most twofold and up to the configured size.
+  EXPECT_EQ(BackfillCoordinator::AdaptBatchSize(
+                100, 1000, 100, absl::Microseconds(10), kMaxStall),
+            200);
+  EXPECT_EQ(BackfillCoordinator::AdaptBatchSize(
+                800, 1000, 800, absl::Microseconds(10), kMaxStall),
+            1000);
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -1700,6 +2008,59 @@ TEST_F(IndexSchemaFriendTest, WeightedBuffer) {
     // Restore default
     VMSDK_EXPECT_OK(options::GetMutationWeightVector().SetValue(130));
   }
+
+  // Test 8: Measured cost replaces the static weight once enabled
+  {
+    VMSDK_EXPECT_OK(options::GetMutationWeightNsPerByte().SetValue(100));
+    auto index = index_schema->attributes_.at(attribute_identifier).GetIndex();
+    // 200ns per byte, then a sample of 1800ns per byte moves the average by
+    // 1/16 of the difference: 300ns per byte.
+    index->RecordMutationCost(absl::Nanoseconds(200 * 100), 100);
+    index->RecordMutationCost(absl::Nanoseconds(1800 * 100), 100);
+    EXPECT_DOUBLE_EQ(index->GetMutationCost(), 300);
+    std::string data(100, 'v');  // 100 bytes
+    auto mutated_attrs = CreateMutatedAttributes(attribute_identifier, data);
+    auto key8 = StringInternStore::Intern("weighted_key_8");
+    EXPECT_TRUE(index_schema->TrackMutatedRecord(
+        nullptr, key8, std::move(mutated_attrs), 0, false, false, false));
+    {
+      absl::MutexLock lock(&index_schema->mutated_records_mutex_);
+      auto itr = index_schema->tracked_mutated_records_.find(key8);
+      ASSERT_NE(itr, index_schema->tracked_mutated_records_.end());
+      // 100ns per byte weighs 100: 100 * 300 / 100 = 300
+      EXPECT_EQ(itr->second.weighted_buffer.size(), 300);
+    }
+    // A measured weight below 1 is clamped to 1 and keeps throttling.
+    VMSDK_EXPECT_OK(options::GetMutationWeightNsPerByte().SetValue(1000000));
+    std::string data_cheap(1000, 'c');
+    auto mutated_attrs_cheap =
+        CreateMutatedAttributes(attribute_identifier, data_cheap);
+    auto key_cheap = StringInternStore::Intern("weighted_key_cheap");
+    EXPECT_TRUE(index_schema->TrackMutatedRecord(
+        nullptr, key_cheap, std::move(mutated_attrs_cheap), 0, false, false,
+        false));
+    {
+      absl::MutexLock lock(&index_schema->mutated_records_mutex_);
+      auto itr = index_schema->tracked_mutated_records_.find(key_cheap);
+      ASSERT_NE(itr, index_schema->tracked_mutated_records_.end());
+      // 1000 * 1 / 100 = 10
+      EXPECT_EQ(itr->second.weighted_buffer.size(), 10);
+    }
+    // Disabling measured weights falls back to the static weight.
+    VMSDK_EXPECT_OK(options::GetMutationWeightNsPerByte().SetValue(0));
+    std::string data2(100, 'w');
+    auto mutated_attrs2 = CreateMutatedAttributes(attribute_identifier, data2);
+    auto key9 = StringInternStore::Intern("weighted_key_9");
+    EXPECT_TRUE(index_schema->TrackMutatedRecord(
+        nullptr, key9, std::move(mutated_attrs2), 0, false, false, false));
+    {
+      absl::MutexLock lock(&index_schema->mutated_records_mutex_);
+      auto itr = index_schema->tracked_mutated_records_.find(key9);
+      ASSERT_NE(itr, index_schema->tracked_mutated_records_.end());
+      // 100 * 130 / 100 = 130
+      EXPECT_EQ(itr->second.weighted_buffer.size(), 130);
+    }
+  }
 }
 
 TEST_F(IndexSchemaFriendTest, MutatedAttributesSanity) {
@@ -0,0 +1,585 @@
+"""Load generator and recall harness for vector search.
+
+Measures the recall versus latency trade-off of the HNSW parameters (M,
+EF_CONSTRUCTION and EF_RUNTIME), of filtered searches of a given selectivity
+and of the prefiltering and filter-aware search threshold ratios, against a
+running valkey-server with the module loaded, e.g.:
+
+  valkey-server --loadmodule .build-release/libsearch.so --debug-mode yes
+  python3 recall_benchmark.py --dataset=synthetic --num_vectors=100000 \\
+      --m=16,32 --ef_runtime=10,50,200 --selectivity=100,10,1 --qps=500
+
+The dataset is either synthetic clustered data, or an ANN dataset read from
+local files: fvecs (--data_path and --queries_path) or the HDF5 files of
+ann-benchmarks (--data_path, requires h5py).
+
+The vectors are loaded once, with a numeric "sel" attribute uniformly
+distributed in [0, 100), so that the filter @sel:[0 (s] selects s percent of
+the keys. They are then indexed by a FLAT index, which provides the exact
+ground truth, and by one HNSW index per (M, EF_CONSTRUCTION) pair, built one
+at a time to measure their build time.
+
+For every combination of index, EF_RUNTIME, selectivity and threshold ratios,
+queries are sent at --qps by an open-loop scheduler: query i is due at
+start + i / qps, independently of the completion of the previous queries, and
+its latency is measured from that time. So a server which falls behind is
+charged for the queueing delay instead of silently lowering the offered load.
+Latencies are kept in full, the reported percentiles are exact.
+
+Changing the prefiltering threshold ratio requires --debug-mode yes.
+
+The filter-aware HNSW traversal is compared against the plain inline filter,
+down to sub-percent selectivities, with prefiltering disabled so that the
+planner keeps to the graph:
+
+  python3 recall_benchmark.py --dataset=synthetic --num_vectors=20000 \\
+      --ef_runtime=20 --selectivity=0.1,0.5,2,10,50 \\
+      --prefiltering_threshold_ratio=0 \\
+      --filter_aware_search_threshold_ratio=0,1
+"""
+
+import itertools
+import json
+import logging
+import sys
+import threading
+import time
+from typing import Any, Dict, List, NamedTuple, Optional, Set
+
+from absl import app
+from absl import flags
+import numpy as np
+import valkey
+import valkey.exceptions
+
+import utils
+
+FLAGS = flags.FLAGS
+
+flags.DEFINE_string("host", "localhost", "Host of the valkey-server.")
+flags.DEFINE_integer("port", 6379, "Port of the valkey-server.")
+flags.DEFINE_enum(
+    "dataset", "synthetic", ["synthetic", "fvecs", "hdf5"], "Dataset to load."
+)
+flags.DEFINE_string(
+    "data_path", None, "Vectors to index, an fvecs or an HDF5 file."
+)
+flags.DEFINE_string("queries_path", None, "Query vectors, an fvecs file.")
+flags.DEFINE_integer(
+    "num_vectors", 100000, "Maximum number of vectors to index."
+)
+flags.DEFINE_integer("num_queries", 1000, "Maximum number of query vectors.")
+flags.DEFINE_integer("dim", 128, "Dimensions of the synthetic vectors.")
+flags.DEFINE_integer(
+    "num_clusters", 100, "Number of clusters of the synthetic vectors."
+)
+flags.DEFINE_float(
+    "cluster_std",
+    0.1,
+    "Standard deviation of the synthetic vectors around their cluster center.",
+)
+flags.DEFINE_integer("seed", 1234, "Seed of the synthetic data generation.")
+flags.DEFINE_enum(
+    "distance_metric",
+    None,
+    ["L2", "IP", "COSINE"],
+    "Distance metric, by default L2, or the one of the HDF5 dataset.",
+)
+flags.DEFINE_integer("k", 10, "Number of neighbors, recall@k is reported.")
+flags.DEFINE_list("m", ["16"], "M values of the HNSW indexes.")
+flags.DEFINE_list(
+    "ef_construction", ["200"], "EF_CONSTRUCTION values of the HNSW indexes."
+)
+flags.DEFINE_list("ef_runtime", ["10", "50", "200"], "EF_RUNTIME values.")
+flags.DEFINE_list(
+    "selectivity",
+    ["100"],
+    "Percentages of the keys selected by the filter, 100 for no filter.",
+)
+flags.DEFINE_list(
+    "prefiltering_threshold_ratio",
+    [],
+    "Values of search.prefiltering-threshold-ratio, by default unchanged.",
+)
+flags.DEFINE_list(
+    "filter_aware_search_threshold_ratio",
+    [],
+    "Values of search.filter-aware-search-threshold-ratio, by default"
+    " unchanged. 0 selects the inline filter, 1 the filter-aware traversal.",
+)
+flags.DEFINE_float("qps", 100, "Target rate of queries per second.")
+flags.DEFINE_float("duration_sec", 10, "Duration of each measured run.")
+flags.DEFINE_integer(
+    "concurrency", 16, "Number of connections sending the queries."
+)
+flags.DEFINE_integer("load_threads", 8, "Number of connections loading data.")
+flags.DEFINE_string("key_prefix", "recall:", "Prefix of the loaded keys.")
+flags.DEFINE_boolean(
+    "load", True, "Load the dataset, otherwise reuse the loaded keys."
+)
+flags.DEFINE_boolean(
+    "cleanup", True, "Drop the indexes and delete the keys when done."
+)
+flags.DEFINE_string("output_json", None, "Writes the results to this file.")
+
+_FLAT_INDEX = "recall_flat"
+_VECTOR_ATTRIBUTE = "vec"
+_FILTER_ATTRIBUTE = "sel"
+_LOAD_BATCH = 500
+_PREFILTERING_CONFIG = "search.prefiltering-threshold-ratio"
+_FILTER_AWARE_CONFIG = "search.filter-aware-search-threshold-ratio"
+_HDF5_METRICS = {"euclidean": "L2", "angular": "COSINE", "dot": "IP"}
+
+
+class Dataset(NamedTuple):
+    vectors: np.ndarray
+    queries: np.ndarray
+    distance_metric: str
+
+
+class IndexConfig(NamedTuple):
+    name: str
+    definition: utils.AttributeDefinition
+    m: Optional[int] = None
+    ef_construction: Optional[int] = None
+
+
+class RunResult(NamedTuple):
+    index: str
+    m: Optional[int]
+    ef_construction: Optional[int]
+    ef_runtime: Optional[int]
+    selectivity: float
+    prefiltering_threshold_ratio: Optional[str]
+    filter_aware_search_threshold_ratio: Optional[str]
+    target_qps: float
+    achieved_qps: float
+    queries: int
+    errors: int
+    recall: float
+    p50_ms: float
+    p90_ms: float
+    p99_ms: float
+    p999_ms: float
+    max_ms: float
+
+
+def read_fvecs(path: str, limit: int) -> np.ndarray:
+    """Reads an fvecs file: each vector is its int32 dimension then floats."""
+    data = np.fromfile(path, dtype=np.int32)
+    if data.size == 0:
+        raise ValueError(f"{path} is empty")
+    dim = data[0]
+    return data.reshape(-1, dim + 1)[:limit, 1:].view(np.float32)
+
+
+def load_dataset() -> Dataset:
+    if FLAGS.dataset == "fvecs":
+        if not FLAGS.data_path or not FLAGS.queries_path:
+            raise app.UsageError("fvecs needs --data_path and --queries_path")
+        return Dataset(
+            read_fvecs(FLAGS.data_path, FLAGS.num_vectors),
+            read_fvecs(FLAGS.queries_path, FLAGS.num_queries),
+            FLAGS.distance_metric or "L2",
+        )
+    if FLAGS.dataset == "hdf5":
+        if not FLAGS.data_path:
+            raise app.UsageError("hdf5 needs --data_path")
+        try:
+            import h5py  # pylint: disable=g-import-not-at-top
+        except ImportError as e:
+            raise app.UsageError("hdf5 datasets require h5py") from e
+        with h5py.File(FLAGS.data_path, "r") as f:
+            metric = _HDF5_METRICS.get(f.attrs.get("distance", "euclidean"))
+            return Dataset(
+                np.asarray(f["train"][: FLAGS.num_vectors], dtype=np.float32),
+                np.asarray(f["test"][: FLAGS.num_queries], dtype=np.float32),
+                FLAGS.distance_metric or metric or "L2",
+            )
+    # Gaussian clusters, the queries are drawn from the same distribution but
+    # are not part of the indexed vectors.
+    rng = np.random.default_rng(FLAGS.seed)
+    centers = rng.uniform(-1, 1, (FLAGS.num_clusters, FLAGS.dim))
+
+    def sample(count: int) -> np.ndarray:
+        clusters = rng.integers(0, FLAGS.num_clusters, count)
+        noise = rng.normal(0, FLAGS.cluster_std, (count, FLAGS.dim))
+        return (centers[clusters] + noise).astype(np.float32)
+
+    return Dataset(
+        sample(FLAGS.num_vectors),
+        sample(FLAGS.num_queries),
+        FLAGS.distance_metric or "L2",
+    )
+
+
+def new_client() -> valkey.Valkey:
+    return valkey.Valkey(host=FLAGS.host, port=FLAGS.port, socket_timeout=600)
+
+
+def load_vectors(vectors: np.ndarray):
+    """Loads the vectors as hashes, with their filter attribute."""
+    rng = np.random.default_rng(FLAGS.seed + 1)
+    sel = rng.uniform(0, 100, len(vectors))
+
+    def load_range(begin: int, end: int):
+        client = new_client()
+        for batch in range(begin, end, _LOAD_BATCH):
+            pipeline = client.pipeline(transaction=False)
+            for i in range(batch, min(batch + _LOAD_BATCH, end)):
+                pipeline.hset(
+                    f"{FLAGS.key_prefix}{i}",
+                    mapping={
+                        _VECTOR_ATTRIBUTE: vectors[i].tobytes(),
+                        _FILTER_ATTRIBUTE: float(sel[i]),
+                    },
+                )
+            pipeline.execute()
+
+    start = time.time()
+    step = -(-len(vectors) // FLAGS.load_threads)
+    threads = [
+        threading.Thread(
+            target=load_range, args=(i, min(i + step, len(vectors)))
+        )
+        for i in range(0, len(vectors), step)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    logging.info(
+        "Loaded %d vectors in %.1f sec", len(vectors), time.time() - start
+    )
+
+
+def ft_info(client: valkey.Valkey, index_name: str) -> Dict[str, Any]:
+    reply = client.execute_command("FT.INFO", index_name)
+    return {
+        utils.to_str(reply[i]): reply[i + 1] for i in range(0, len(reply), 2)
+    }
+
+
+def create_index(client: valkey.Valkey, config: IndexConfig, num_docs: int):
+    """Creates the index and waits for the backfill, returns its duration."""
+    args = [
+        "FT.CREATE",
+        config.name,
+        "ON",
+        "HASH",
+        "PREFIX",
+        1,
+        FLAGS.key_prefix,
+        "SCHEMA",
+        _VECTOR_ATTRIBUTE,
+        *config.definition.to_arguments(),
+        _FILTER_ATTRIBUTE,
+        *utils.NumericDefinition().to_arguments(),
+    ]
+    start = time.time()
+    client.execute_command(*args)
+    while True:
+        info = ft_info(client, config.name)
+        if (
+            utils.to_str(info["state"]) == "ready"
+            and int(info["mutation_queue_size"]) == 0
+            and int(info["num_docs"]) >= num_docs
+        ):
+            break
+        time.sleep(0.1)
+    build_sec = time.time() - start
+    logging.info("Built %s in %.1f sec", config.name, build_sec)
+    return build_sec
+
+
+def knn_command(
+    index_name: str,
+    query: bytes,
+    selectivity: float,
+    ef_runtime: Optional[int],
+) -> List[Any]:
+    knn = f"KNN {FLAGS.k} @{_VECTOR_ATTRIBUTE} $BLOB"
+    if ef_runtime is not None:
+        knn += f" EF_RUNTIME {ef_runtime}"
+    if selectivity >= 100:
+        filter_expression = "*"
+    else:
+        filter_expression = f"(@{_FILTER_ATTRIBUTE}:[0 ({selectivity}])"
+    return [
+        "FT.SEARCH",
+        index_name,
+        f"{filter_expression}=>[{knn}]",
+        "PARAMS",
+        2,
+        "BLOB",
+        query,
+        "NOCONTENT",
+        "LIMIT",
+        0,
+        FLAGS.k,
+        "DIALECT",
+        2,
+    ]
+
+
+def result_keys(reply: List[Any]) -> Set[bytes]:
+    # With NOCONTENT, the reply is the count followed by the keys.
+    return set(reply[1:])
+
+
+def ground_truth(
+    queries: List[bytes], selectivity: float
+) -> List[Set[bytes]]:
+    """Exact neighbors of each query, from the FLAT index."""
+    truth: List[Set[bytes]] = [set()] * len(queries)
+    next_query = itertools.count()
+
+    def worker():
+        client = new_client()
+        while (i := next(next_query)) < len(queries):
+            truth[i] = result_keys(
+                client.execute_command(
+                    *knn_command(_FLAT_INDEX, queries[i], selectivity, None)
+                )
+            )
+
+    threads = [
+        threading.Thread(target=worker) for _ in range(FLAGS.concurrency)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return truth
+
+
+def run_open_loop(
+    commands: List[List[Any]], truth: List[Set[bytes]]
+) -> Dict[str, Any]:
+    """Sends the commands at the target rate, cycling through them."""
+    total = max(1, int(FLAGS.qps * FLAGS.duration_sec))
+    interval = 1.0 / FLAGS.qps
+    next_query = itertools.count()
+    lock = threading.Lock()
+    latencies: List[float] = []
+    recalls: List[float] = []
+    errors = 0
+    # Leaves time for the workers to connect before the first query is due.
+    start = time.perf_counter() + 0.5
+    end = start
+
+    def worker():
+        nonlocal errors, end
+        client = new_client()
+        client.ping()
+        local_latencies = []
+        local_recalls = []
+        local_errors = 0
+        while (i := next(next_query)) < total:
+            due = start + i * interval
+            delay = due - time.perf_counter()
+            if delay > 0:
+                time.sleep(delay)
+            q = i % len(commands)
+            try:
+                reply = client.execute_command(*commands[q])
+            except valkey.exceptions.ValkeyError as e:
+                logging.debug("Query failed: %s", e)
+                local_errors += 1
+                continue
+            local_latencies.append(time.perf_counter() - due)
+            if truth[q]:
+                local_recalls.append(
+                    len(result_keys(reply) & truth[q]) / len(truth[q])
+                )
+        with lock:
+            latencies.extend(local_latencies)
+            recalls.extend(local_recalls)
+            errors += local_errors
+            end = max(end, time.perf_counter())
+
+    threads = [
+        threading.Thread(target=worker) for _ in range(FLAGS.concurrency)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    latencies_ms = np.array(latencies or [0.0]) * 1000
+    return {
+        "achieved_qps": len(latencies) / max(end - start, 1e-9),
+        "queries": len(latencies),
+        "errors": errors,
+        "recall": float(np.mean(recalls)) if recalls else 0.0,
+        "p50_ms": float(np.percentile(latencies_ms, 50)),
+        "p90_ms": float(np.percentile(latencies_ms, 90)),
+        "p99_ms": float(np.percentile(latencies_ms, 99)),
+        "p999_ms": float(np.percentile(latencies_ms, 99.9)),
+        "max_ms": float(np.max(latencies_ms)),
+    }
+
+
+def set_config(client: valkey.Valkey, name: str, value: str):
+    try:
+        client.config_set(name, value)
+    except valkey.exceptions.ResponseError as e:
+        raise app.UsageError(
+            f"Cannot set {name} to {value}, it may require the server to run"
+            f" with --debug-mode yes: {e}"
+        ) from e
+
+
+def cleanup(client: valkey.Valkey, index_names: List[str]):
+    for name in index_names:
+        try:
+            client.execute_command("FT.DROPINDEX", name)
+        except valkey.exceptions.ResponseError:
+            pass
+    for keys in _batched(
+        client.scan_iter(match=f"{FLAGS.key_prefix}*", count=1000), 1000
+    ):
+        client.unlink(*keys)
+
+
+def _batched(iterable, size: int):
+    iterator = iter(iterable)
+    while batch := list(itertools.islice(iterator, size)):
+        yield batch
+
+
+def main(argv):
+    del argv
+    logging.basicConfig(
+        handlers=[logging.StreamHandler(stream=sys.stdout)],
+        level=logging.INFO,
+        format="%(asctime)s [%(levelname)s] %(message)s",
+    )
+    dataset = load_dataset()
+    num_vectors, dim = dataset.vectors.shape
+    logging.info(
+        "Dataset: %d vectors, %d queries, %d dimensions, %s",
+        num_vectors,
+        len(dataset.queries),
+        dim,
+        dataset.distance_metric,
+    )
+    client = new_client()
+    flat = IndexConfig(
+        _FLAT_INDEX,
+        utils.FlatVectorDefinition(
+            dim, distance_metric=dataset.distance_metric
+        ),
+    )
+    hnsw_indexes = [
+        IndexConfig(
+            f"recall_hnsw_m{m}_ef{ef_construction}",
+            utils.HNSWVectorDefinition(
+                dim,
+                m=int(m),
+                distance_metric=dataset.distance_metric,
+                ef_construction=int(ef_construction),
+            ),
+            int(m),
+            int(ef_construction),
+        )
+        for m, ef_construction in itertools.product(
+            FLAGS.m, FLAGS.ef_construction
+        )
+    ]
+    index_names = [flat.name] + [index.name for index in hnsw_indexes]
+    ratios = FLAGS.prefiltering_threshold_ratio or [None]
+    filter_aware_ratios = FLAGS.filter_aware_search_threshold_ratio or [None]
+    # The values of the changed configs, restored when done.
+    original_configs: Dict[str, str] = {}
+    results: List[RunResult] = []
+    build_sec: Dict[str, float] = {}
+    try:
+        if FLAGS.load:
+            load_vectors(dataset.vectors)
+        for index in [flat] + hnsw_indexes:
+            build_sec[index.name] = create_index(client, index, num_vectors)
+        queries = [query.tobytes() for query in dataset.queries]
+        for name, values in [
+            (_PREFILTERING_CONFIG, FLAGS.prefiltering_threshold_ratio),
+            (_FILTER_AWARE_CONFIG, FLAGS.filter_aware_search_threshold_ratio),
+        ]:
+            if values:
+                original_configs[name] = client.config_get(name)[name]
+        for selectivity in [float(s) for s in FLAGS.selectivity]:
+            truth = ground_truth(queries, selectivity)
+            for index, ef_runtime, ratio, filter_aware_ratio in (
+                itertools.product(
+                    hnsw_indexes,
+                    [int(ef) for ef in FLAGS.ef_runtime],
+                    ratios,
+                    filter_aware_ratios,
+                )
+            ):
+                if ratio is not None:
+                    set_config(client, _PREFILTERING_CONFIG, ratio)
+                if filter_aware_ratio is not None:
+                    set_config(client, _FILTER_AWARE_CONFIG, filter_aware_ratio)
+                commands = [
+                    knn_command(index.name, query, selectivity, ef_runtime)
+                    for query in queries
+                ]
+                result = RunResult(
+                    index=index.name,
+                    m=index.m,
+                    ef_construction=index.ef_construction,
+                    ef_runtime=ef_runtime,
+                    selectivity=selectivity,
+                    prefiltering_threshold_ratio=ratio,
+                    filter_aware_search_threshold_ratio=filter_aware_ratio,
+                    target_qps=FLAGS.qps,
+                    **run_open_loop(commands, truth),
+                )
+                logging.info(
+                    "%s ef_runtime=%d selectivity=%g%% ratio=%s"
+                    " filter_aware_ratio=%s: recall@%d"
+                    " %.4f, %.0f qps, p50 %.2f ms, p99 %.2f ms, p99.9 %.2f"
+                    " ms, %d errors",
+                    index.name,
+                    ef_runtime,
+                    selectivity,
+                    ratio,
+                    filter_aware_ratio,
+                    FLAGS.k,
+                    result.recall,
+                    result.achieved_qps,
+                    result.p50_ms,
+                    result.p99_ms,
+                    result.p999_ms,
+                    result.errors,
+                )
+                results.append(result)
+    finally:
+        for name, value in original_configs.items():
+            set_config(client, name, value)
+        if FLAGS.cleanup:
+            cleanup(client, index_names)
+
+    if FLAGS.output_json:
+        with open(FLAGS.output_json, "w") as f:
+            json.dump(
+                {
+                    "dataset": {
+                        "name": FLAGS.dataset,
+                        "path": FLAGS.data_path,
+                        "vectors": num_vectors,
+                        "queries": len(dataset.queries),
+                        "dimensions": dim,
+                        "distance_metric": dataset.distance_metric,
+                    },
+                    "k": FLAGS.k,
+                    "build_sec": build_sec,
+                    "runs": [result._asdict() for result in results],
+                },
+                f,
+                indent=2,
+            )
+        logging.info("Results written to %s", FLAGS.output_json)
+
+
+if __name__ == "__main__":
+    app.run(main)
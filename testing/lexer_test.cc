@@ -261,4 +261,46 @@ TEST_F(LexerTest, StemMappingsNoStemmingWhenDisabled) {
   EXPECT_TRUE(stem_mappings.empty());
 }
 
+TEST_F(LexerTest, ForEachTokenViewsIntoText) {
+  // Lower case ASCII tokens are views of the input, the others are rewritten.
+  std::string text = "plain words, Mixed CASE and esc\\-aped ÉCOLE";
+  std::vector<std::string> tokens;
+  std::vector<bool> in_text;
+  auto status = lexer_->ForEachToken(
+      text, false, 0, nullptr, [&](absl::string_view token) {
+        tokens.emplace_back(token);
+        in_text.push_back(token.data() >= text.data() &&
+                          token.data() < text.data() + text.size());
+      });
+  VMSDK_EXPECT_OK(status);
+  EXPECT_EQ(tokens, std::vector<std::string>({"plain", "words", "mixed",
+                                              "case", "esc-aped", "école"}));
+  EXPECT_EQ(in_text,
+            std::vector<bool>({true, true, false, false, false, false}));
+}
+
+TEST_F(LexerTest, LongMixedCaseTokens) {
+  // Exercise both the eight byte and the trailing byte checks.
+  auto result = lexer_->Tokenize(
+      "abcdefghijklmnoP ABCDEFGHIJKLMNOPQ abcdefghijklmnop abcdefgh@XYZabcdefg "
+      "zzzzzzzzzzzzzzzzéa",
+      false, 0);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(*result, std::vector<std::string>(
+                         {"abcdefghijklmnop", "abcdefghijklmnopq",
+                          "abcdefghijklmnop", "abcdefgh", "xyzabcdefg",
+                          "zzzzzzzzzzzzzzzzéa"}));
+}
+
+TEST_F(LexerTest, StemCacheIsConsistent) {
+  // The second pass is served from the per-thread stem cache.
+  for (int pass = 0; pass < 2; ++pass) {
+    InProgressStemMap stem_mappings;
+    auto result = lexer_->Tokenize("running runs", true, 3, &stem_mappings);
+    ASSERT_TRUE(result.ok());
+    ASSERT_TRUE(stem_mappings.contains("run"));
+    EXPECT_EQ(stem_mappings["run"].size(), 2);
+  }
+}
+
 }  // namespace valkey_search::indexes::text
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/indexes/numeric_column.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace valkey_search::indexes {
+
+namespace {
+
+bool BitSet(const std::vector<uint64_t> &bitmap, uint64_t id) {
+  return bitmap[id / NumericColumn::kBitsPerWord] >>
+             (id % NumericColumn::kBitsPerWord) &
+         1;
+}
+
+TEST(NumericColumnTest, RangeBounds) {
+  NumericRange inclusive(1.0, true, 2.0, true);
+  EXPECT_TRUE(inclusive.Contains(1.0));
+  EXPECT_TRUE(inclusive.Contains(2.0));
+  EXPECT_FALSE(inclusive.Contains(2.5));
+  NumericRange exclusive(1.0, false, 2.0, false);
+  EXPECT_FALSE(exclusive.Contains(1.0));
+  EXPECT_TRUE(exclusive.Contains(1.5));
+  EXPECT_FALSE(exclusive.Contains(2.0));
+}
+
+TEST(NumericColumnTest, SetClearContains) {
+  NumericColumn column;
+  NumericRange range(0.0, true, 10.0, true);
+  EXPECT_FALSE(column.Contains(3, range));
+  column.Set(3, 5.0);
+  column.Set(200, 20.0);
+  EXPECT_TRUE(column.Contains(3, range));
+  EXPECT_FALSE(column.Contains(200, range));
+  // Ids without a value never match, even if 0.0 is in range.
+  EXPECT_FALSE(column.Contains(4, range));
+  EXPECT_FALSE(column.Contains(1000, range));
+  EXPECT_EQ(column.Size() % NumericColumn::kBitsPerWord, 0);
+  column.Clear(3);
+  EXPECT_FALSE(column.Contains(3, range));
+}
+
+TEST(NumericColumnTest, FilterIntoMatchesContains) {
+  NumericColumn column;
+  for (uint64_t id = 0; id < 300; ++id) {
+    if (id % 7 != 0) {
+      column.Set(id, static_cast<double>(id % 50));
+    }
+  }
+  NumericRange range(10.0, false, 30.0, true);
+  std::vector<uint64_t> bitmap(column.Size() / NumericColumn::kBitsPerWord + 2,
+                               ~uint64_t{0});
+  column.FilterInto(range, bitmap);
+  for (uint64_t id = 0; id < bitmap.size() * NumericColumn::kBitsPerWord;
+       ++id) {
+    EXPECT_EQ(BitSet(bitmap, id), column.Contains(id, range)) << id;
+  }
+  // A second range is intersected with the first.
+  column.FilterInto(NumericRange(20.0, true, 40.0, true), bitmap);
+  for (uint64_t id = 0; id < 300; ++id) {
+    bool expected = id % 7 != 0 && id % 50 >= 20 && id % 50 <= 30;
+    EXPECT_EQ(BitSet(bitmap, id), expected) << id;
+  }
+}
+
+TEST(NumericColumnTest, FilterIntoSkipsFreedPages) {
+  NumericColumn column;
+  column.Set(5, 1.0);
+  column.Set(NumericColumn::kIdsPerPage + 5, 1.0);
+  column.Clear(5);
+  NumericRange range(0.0, true, 2.0, true);
+  std::vector<uint64_t> bitmap(column.Size() / NumericColumn::kBitsPerWord,
+                               ~uint64_t{0});
+  column.FilterInto(range, bitmap);
+  for (uint64_t id = 0; id < column.Size(); ++id) {
+    EXPECT_EQ(BitSet(bitmap, id), id == NumericColumn::kIdsPerPage + 5) << id;
+  }
+}
+
+TEST(NumericColumnTest, ChurnOfNewIdsKeepsMemoryBounded) {
+  NumericColumn column;
+  NumericRange range(0.0, true, 100.0, true);
+  // A long-lived id and a window of live ids that keeps moving up, as when
+  // keys are deleted and re-added under ever-increasing ids.
+  column.Set(0, 1.0);
+  constexpr uint64_t kWindow = 100;
+  size_t max_bytes = 0;
+  for (uint64_t id = 1; id < 1000000; ++id) {
+    column.Set(id, 2.0);
+    if (id > kWindow) {
+      column.Clear(id - kWindow);
+    }
+    if (id == 100000) {
+      max_bytes = column.GetAllocatedBytes();
+    }
+  }
+  EXPECT_TRUE(column.Contains(0, range));
+  EXPECT_TRUE(column.Contains(999999, range));
+  EXPECT_FALSE(column.Contains(999999 - kWindow, range));
+  // Ten times more churn only grows the page directory.
+  EXPECT_LE(column.GetAllocatedBytes(),
+            max_bytes + 2 * 1000000 / NumericColumn::kIdsPerPage * 8);
+  EXPECT_LT(column.GetAllocatedBytes(), 64 * 1024);
+
+  // Clearing the highest ids trims the column.
+  for (uint64_t id = 1000000 - kWindow; id < 1000000; ++id) {
+    column.Clear(id);
+  }
+  EXPECT_EQ(column.Size(), NumericColumn::kIdsPerPage);
+}
+
+}  // namespace
+
+}  // namespace valkey_search::indexes
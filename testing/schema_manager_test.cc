@@ -20,6 +20,7 @@
 #include "src/coordinator/metadata_manager.h"
 #include "testing/common.h"
 #include "testing/coordinator/common.h"
+#include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/testing_infra/module.h"
 #include "vmsdk/src/valkey_module_api/valkey_module.h"
 
@@ -517,17 +518,24 @@ TEST_P(OnSwapDBCallbackTest, OnSwapDBCallback) {
     expected_dbnum = test_case.swap_dbnum_first;
   }
   if (test_case.is_backfill_in_progress) {
-    if (expected_dbnum == -1) {
-      EXPECT_CALL(
-          *kMockValkeyModule,
-          SelectDb(test_index_schema->backfill_job_.Get()->scan_ctx.get(),
-                   test_case.index_schema_db_num))
+    // Start the shared scan of the schema's DB without finishing it. The scan
+    // context is the fake context handed out as the detached context.
+    auto key_r_str = vmsdk::MakeUniqueValkeyString("other:key");
+    EXPECT_CALL(*kMockValkeyModule,
+                Scan(&fake_ctx_, testing::An<ValkeyModuleScanCursor *>(),
+                     testing::An<ValkeyModuleScanCB>(), testing::An<void *>()))
+        .WillOnce([&](ValkeyModuleCtx *ctx, ValkeyModuleScanCursor *cursor,
+                      ValkeyModuleScanCB fn, void *privdata) -> int {
+          fn(ctx, key_r_str.get(), nullptr, privdata);
+          return 1;
+        });
+    SchemaManager::Instance().PerformBackfill(&fake_ctx_, 1);
+    if (expected_dbnum == -1 ||
+        expected_dbnum == test_case.index_schema_db_num) {
+      EXPECT_CALL(*kMockValkeyModule, SelectDb(&fake_ctx_, testing::_))
           .Times(0);
     } else {
-      EXPECT_CALL(
-          *kMockValkeyModule,
-          SelectDb(test_index_schema->backfill_job_.Get()->scan_ctx.get(),
-                   expected_dbnum))
+      EXPECT_CALL(*kMockValkeyModule, SelectDb(&fake_ctx_, expected_dbnum))
           .WillOnce(testing::Return(1));
     }
   } else {
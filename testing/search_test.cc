@@ -34,12 +34,14 @@
 #include "src/indexes/index_base.h"
 #include "src/indexes/numeric.h"
 #include "src/indexes/tag.h"
+#include "src/indexes/text.h"
 #include "src/indexes/vector_base.h"
 #include "src/indexes/vector_flat.h"
 #include "src/indexes/vector_hnsw.h"
 #include "src/query/predicate.h"
 #include "src/utils/patricia_tree.h"
 #include "src/utils/string_interning.h"
+#include "src/valkey_search_options.h"
 #include "testing/common.h"
 #include "vmsdk/src/managed_pointers.h"
 #include "vmsdk/src/type_conversions.h"
@@ -875,6 +877,68 @@ INSTANTIATE_TEST_SUITE_P(
       return test_name;
     });
 
+class QueryProfileTest : public ValkeySearchTest {};
+
+TEST_F(QueryProfileTest, VectorQuery) {
+  UnitTestSearchParameters params;
+  params.index_schema = CreateIndexSchemaWithMultipleAttributes();
+  params.index_schema_name = kIndexSchemaName;
+  params.attribute_alias = kVectorAttributeAlias;
+  params.score_as = vmsdk::MakeUniqueValkeyString(kScoreAs);
+  params.dialect = kDialect;
+  params.k = 5;
+  params.ef = kEfRuntime;
+  std::vector<float> query_vector(kVectorDimensions, 0.0);
+  params.query = VectorToStr(query_vector);
+  params.timings.emplace();
+  params.profile = std::make_unique<query::QueryProfile>();
+  VMSDK_EXPECT_OK(Search(params, query::SearchMode::kLocal));
+  EXPECT_EQ(params.timings->plan, "vector");
+  EXPECT_EQ(params.timings->results, params.search_result.neighbors.size());
+  EXPECT_GT(params.profile->hnsw.hops, 0);
+  EXPECT_GE(params.profile->hnsw.distance_computations,
+            params.profile->hnsw.hops);
+  EXPECT_EQ(params.profile->keys_evaluated, 0);
+}
+
+TEST_F(QueryProfileTest, NonVectorQuery) {
+  UnitTestSearchParameters params;
+  params.index_schema = CreateIndexSchemaWithMultipleAttributes();
+  params.index_schema_name = kIndexSchemaName;
+  params.dialect = kDialect;
+  TextParsingOptions options{};
+  FilterParser parser(*params.index_schema, "@numeric:[1 10] @tag:{LT5}",
+                      options);
+  params.filter_parse_results = std::move(parser.Parse().value());
+  params.timings.emplace();
+  params.profile = std::make_unique<query::QueryProfile>();
+  VMSDK_EXPECT_OK(Search(params, query::SearchMode::kLocal));
+  EXPECT_EQ(params.timings->plan, "filter-evaluate");
+  EXPECT_GT(params.profile->estimated_entries, 0);
+  EXPECT_EQ(params.profile->keys_matched, 4);
+  EXPECT_GE(params.profile->keys_evaluated, params.profile->keys_matched);
+  EXPECT_EQ(params.timings->results, 4);
+  EXPECT_EQ(params.profile->hnsw.hops, 0);
+}
+
+TEST_F(QueryProfileTest, TimingsOnly) {
+  UnitTestSearchParameters params;
+  params.index_schema = CreateIndexSchemaWithMultipleAttributes();
+  params.index_schema_name = kIndexSchemaName;
+  params.attribute_alias = kVectorAttributeAlias;
+  params.score_as = vmsdk::MakeUniqueValkeyString(kScoreAs);
+  params.dialect = kDialect;
+  params.k = 5;
+  params.ef = kEfRuntime;
+  std::vector<float> query_vector(kVectorDimensions, 0.0);
+  params.query = VectorToStr(query_vector);
+  params.timings.emplace();
+  VMSDK_EXPECT_OK(Search(params, query::SearchMode::kLocal));
+  EXPECT_EQ(params.profile, nullptr);
+  EXPECT_EQ(params.timings->plan, "vector");
+  EXPECT_EQ(params.timings->results, params.search_result.neighbors.size());
+}
+
 struct IndexedContentTestCase {
   struct TestReturnAttribute {
     std::string identifier;
@@ -1355,5 +1419,95 @@ INSTANTIATE_TEST_SUITE_P(
           absl::StrCat(distance_metric, "_", std::get<1>(info.param).test_name);
       return test_name;
     });
+
+std::vector<indexes::Neighbor> MakeRanking(
+    const std::vector<std::pair<std::string, float>> &ranking) {
+  std::vector<indexes::Neighbor> neighbors;
+  for (const auto &[key, distance] : ranking) {
+    neighbors.emplace_back(StringInternStore::Intern(key), distance);
+  }
+  return neighbors;
+}
+
+std::vector<std::string> FusedKeys(
+    const std::vector<indexes::Neighbor> &neighbors) {
+  std::vector<std::string> keys;
+  for (const auto &neighbor : neighbors) {
+    keys.emplace_back(neighbor.external_id->Str());
+  }
+  return keys;
+}
+
+TEST(FuseResultsTest, ReciprocalRankFusion) {
+  query::FusionParameter fusion;
+  auto fused = query::FuseResults(
+      MakeRanking({{"a", -3}, {"b", -2}, {"c", -1}}),
+      MakeRanking({{"c", 0.1}, {"d", 0.2}, {"a", 0.3}}), fusion, 3);
+  // a and c are ranked by both legs, ties are broken by key.
+  EXPECT_THAT(FusedKeys(fused), testing::ElementsAre("a", "c", "b"));
+  EXPECT_FLOAT_EQ(fused[0].distance, -(1.0 / 61 + 1.0 / 63));
+  EXPECT_FLOAT_EQ(fused[2].distance, -1.0 / 62);
+
+  fusion.rrf_constant = 0;
+  fused = query::FuseResults(MakeRanking({{"a", -3}, {"b", -2}}),
+                             MakeRanking({{"b", 0.1}}), fusion, 10);
+  EXPECT_THAT(FusedKeys(fused), testing::ElementsAre("b", "a"));
+  EXPECT_FLOAT_EQ(fused[0].distance, -(1.0 / 2 + 1.0));
+}
+
+TEST(FuseResultsTest, WeightedFusion) {
+  query::FusionParameter fusion{.method = query::FusionMethod::kWeighted,
+                                .text_weight = 0.3,
+                                .vector_weight = 0.7};
+  auto fused = query::FuseResults(
+      MakeRanking({{"a", -3}, {"b", -2}, {"c", -1}}),
+      MakeRanking({{"c", 0.1}, {"d", 0.2}, {"a", 0.3}}), fusion, 10);
+  EXPECT_THAT(FusedKeys(fused), testing::ElementsAre("c", "d", "a", "b"));
+  EXPECT_FLOAT_EQ(fused[0].distance, -0.7);
+  EXPECT_FLOAT_EQ(fused[1].distance, -0.35);
+  EXPECT_FLOAT_EQ(fused[2].distance, -0.3);
+  EXPECT_FLOAT_EQ(fused[3].distance, -0.15);
+
+  // Only the vector leg matched.
+  fused = query::FuseResults({}, MakeRanking({{"x", 0.5}}), fusion, 10);
+  EXPECT_THAT(FusedKeys(fused), testing::ElementsAre("x"));
+  EXPECT_FLOAT_EQ(fused[0].distance, -0.7);
+}
+
+class RankTextMatchesTest : public ValkeySearchTest {};
+
+TEST_F(RankTextMatchesTest, RanksMatchesBeyondFetchLimit) {
+  auto index_schema = CreateIndexSchema(kIndexSchemaName).value();
+  EXPECT_CALL(*index_schema, GetIdentifier(::testing::_))
+      .Times(::testing::AnyNumber());
+  index_schema->CreateTextIndexSchema();
+  auto text_index_schema = index_schema->GetTextIndexSchema();
+  auto text_index = std::make_shared<indexes::Text>(
+      CreateTextIndexProto(false, true, 1.0), text_index_schema);
+  VMSDK_EXPECT_OK(index_schema->AddIndex("text", "text", text_index));
+  // Keys are fetched in key order, so the best match comes last.
+  for (int i = 0; i < 10; ++i) {
+    auto key = StringInternStore::Intern(absl::StrCat("key", i));
+    VMSDK_EXPECT_OK(text_index->AddRecord(
+        key, i == 9 ? "hello hello hello world" : "hello world"));
+    text_index_schema->CommitKeyData(key);
+  }
+  VMSDK_EXPECT_OK(options::GetMaxNonVectorSearchResultsFetched().SetValue(5));
+
+  UnitTestSearchParameters params;
+  params.index_schema = index_schema;
+  TextParsingOptions options{};
+  FilterParser parser(*index_schema, "@text:hello", options);
+  params.filter_parse_results = std::move(parser.Parse().value());
+  auto ranked = query::RankTextMatches(params, 3);
+  ASSERT_EQ(ranked.size(), 3);
+  EXPECT_EQ(ranked[0].external_id->Str(), "key9");
+  EXPECT_LT(ranked[0].distance, ranked[1].distance);
+  EXPECT_EQ(ranked[1].distance, ranked[2].distance);
+
+  VMSDK_EXPECT_OK(
+      options::GetMaxNonVectorSearchResultsFetched().SetValue(100000));
+}
+
 }  // namespace
 }  // namespace valkey_search
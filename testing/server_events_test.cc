@@ -73,6 +73,8 @@ TEST_F(ServerEventsTest, SubscribesToServerEvents) {
           testing::_, vmsdk::IsValkeyModuleEvent(ValkeyModuleEvent_Shutdown),
           testing::_))
       .WillOnce(testing::Return(1));
+  EXPECT_CALL(*kMockValkeyModule, RegisterDefragFunc(testing::_, testing::_))
+      .WillOnce(testing::Return(VALKEYMODULE_OK));
   SubscribeToServerEvents();
 }
 
@@ -434,6 +434,77 @@ TEST_F(TagIndexTest, ParseSearchTagsWhitespaceOnly) {
   EXPECT_TRUE(result.value().empty());
 }
 
+class TagWildcardIndexTest : public TagIndexTest {
+ public:
+  void SetUp() override {
+    vmsdk::ValkeyTest::SetUp();
+    data_model::TagIndex tag_index_proto;
+    tag_index_proto.set_separator(",");
+    tag_index_proto.set_case_sensitive(false);
+    tag_index_proto.set_with_suffix_trie(true);
+    index = std::make_unique<IndexTeser<Tag, data_model::TagIndex>>(
+        tag_index_proto);
+    EXPECT_TRUE(index->AddRecord("doc1", "alice@example.com,sku-123").value());
+    EXPECT_TRUE(index->AddRecord("doc2", "Bob@Example.com,sku-124").value());
+    EXPECT_TRUE(index->AddRecord("doc3", "carol@test.org,abc-sku-9").value());
+  }
+  std::vector<std::string> Search(absl::string_view filter_tag_string,
+                                  bool negate = false) {
+    auto parsed_tags = FilterParser::ParseQueryTags(filter_tag_string).value();
+    query::TagPredicate predicate(index.get(), alias, identifier,
+                                  filter_tag_string, parsed_tags);
+    return Fetch(*index->Search(predicate, negate));
+  }
+};
+
+TEST_F(TagWildcardIndexTest, SuffixSearch) {
+  EXPECT_THAT(Search("*@example.com"),
+              testing::UnorderedElementsAre("doc1", "doc2"));
+  EXPECT_THAT(Search("*.ORG"), testing::UnorderedElementsAre("doc3"));
+  EXPECT_THAT(Search("*.net"), testing::IsEmpty());
+}
+
+TEST_F(TagWildcardIndexTest, InfixAndWildcardSearch) {
+  EXPECT_THAT(Search("*sku-12*"),
+              testing::UnorderedElementsAre("doc1", "doc2"));
+  EXPECT_THAT(Search("*sku*"),
+              testing::UnorderedElementsAre("doc1", "doc2", "doc3"));
+  EXPECT_THAT(Search("a*@*.com"), testing::UnorderedElementsAre("doc1"));
+  EXPECT_THAT(Search("*xyz*"), testing::IsEmpty());
+  EXPECT_THAT(Search("*sku-12*|*.org"),
+              testing::UnorderedElementsAre("doc1", "doc2", "doc3"));
+}
+
+TEST_F(TagWildcardIndexTest, RemovedTagsStopMatching) {
+  EXPECT_TRUE(index->ModifyRecord("doc1", "alice@example.net").value());
+  EXPECT_THAT(Search("*@example.com"), testing::UnorderedElementsAre("doc2"));
+  EXPECT_THAT(Search("*@example.net"), testing::UnorderedElementsAre("doc1"));
+  EXPECT_TRUE(index->RemoveRecord("doc2").value());
+  EXPECT_THAT(Search("*@example.com"), testing::IsEmpty());
+  EXPECT_THAT(Search("*sku*"), testing::UnorderedElementsAre("doc3"));
+}
+
+TEST_F(TagIndexTest, WildcardSearchNeedsSuffixTrie) {
+  EXPECT_TRUE(index->AddRecord("doc1", "alice@example.com").value());
+  std::string filter_tag_string = "*@example.com";
+  auto parsed_tags = FilterParser::ParseQueryTags(filter_tag_string).value();
+  query::TagPredicate predicate(index.get(), alias, identifier,
+                                filter_tag_string, parsed_tags);
+  EXPECT_THAT(Fetch(*index->Search(predicate, false)), testing::IsEmpty());
+}
+
+TEST_F(TagIndexTest, ParseSearchTagsWildcardPatterns) {
+  EXPECT_TRUE(indexes::Tag::ParseSearchTags("*@example.com", '|').ok());
+  EXPECT_TRUE(indexes::Tag::ParseSearchTags("*sku*", '|').ok());
+  EXPECT_EQ(indexes::Tag::ParseSearchTags("*a*", '|').status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(indexes::Tag::ParseSearchTags("a**b", '|').status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_TRUE(Tag::MatchTagPattern("Alice@Example.com", "*@example.*", false));
+  EXPECT_FALSE(Tag::MatchTagPattern("Alice@Example.com", "*@example.*", true));
+  EXPECT_FALSE(Tag::MatchTagPattern("sku-1", "*sku-12*", true));
+}
+
 }  // namespace
 
 }  // namespace valkey_search::indexes
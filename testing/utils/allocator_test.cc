@@ -7,8 +7,11 @@
 
 #include "src/utils/allocator.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
@@ -214,6 +217,72 @@ TEST_P(AllocatorTest, FixedSizeAllocatorMultipleChunksWithFreeEntries) {
   }
 }
 
+TEST_P(AllocatorTest, CompactionEvacuatesSparseChunk) {
+  auto memory_alignment = GetParam();
+  const size_t size = 128;
+  auto allocator =
+      CREATE_UNIQUE_PTR(FixedSizeAllocator, size, memory_alignment);
+  const auto entries_fit_in_chunk = EntriesFitInChunk(size, kChunkBufferPages);
+  std::vector<char *> buffers;
+  for (size_t i = 0; i < 2 * entries_fit_in_chunk; ++i) {
+    buffers.push_back(allocator->Allocate(size));
+    memset(buffers.back(), static_cast<char>(i), size);
+  }
+  // Nothing to gain while every chunk is full.
+  EXPECT_TRUE(allocator->BeginCompaction().empty());
+
+  // Leave 2 buffers in the first chunk and free a few in the second.
+  std::vector<char *> live;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (i < entries_fit_in_chunk ? i != 1 && i != entries_fit_in_chunk / 2
+                                 : i % 100 == 0) {
+      Allocator::Free(buffers[i]);
+    } else {
+      live.push_back(buffers[i]);
+    }
+  }
+  EXPECT_EQ(allocator->ChunkCount(), 2);
+  auto chunk = allocator->BeginCompaction();
+  ASSERT_FALSE(chunk.empty());
+  EXPECT_EQ(chunk.size(), entries_fit_in_chunk * size);
+  auto in_chunk = [&chunk](const char *ptr) {
+    return ptr >= chunk.data() && ptr < chunk.data() + chunk.size();
+  };
+  EXPECT_EQ(std::count_if(live.begin(), live.end(), in_chunk), 2);
+
+  // Refusing a move frees the new buffer.
+  size_t position = 0;
+  allocator->Compact(position, 1, [](const char *, char *) { return false; });
+  EXPECT_GT(position, 0);
+  EXPECT_EQ(allocator->ActiveAllocations(), live.size());
+
+  // Compaction resumes from the position, a batch at a time.
+  std::vector<std::pair<const char *, char *>> moved;
+  auto relocate = [&](const char *from, char *to) {
+    EXPECT_FALSE(in_chunk(to));
+    memcpy(to, from, size);
+    moved.emplace_back(from, to);
+    return true;
+  };
+  position = 0;
+  allocator->Compact(position, 1, relocate);
+  EXPECT_EQ(moved.size(), 1);
+  while (!allocator->Compact(position, 1, relocate)) {
+  }
+  EXPECT_EQ(moved.size(), 2);
+  for (auto &[from, to] : moved) {
+    EXPECT_EQ(memcmp(from, to, size), 0);
+    Allocator::Free(const_cast<char *>(from));
+    std::replace(live.begin(), live.end(), const_cast<char *>(from), to);
+  }
+  EXPECT_EQ(allocator->ChunkCount(), 1);
+  EXPECT_TRUE(allocator->BeginCompaction().empty());
+  for (auto buffer : live) {
+    Allocator::Free(buffer);
+  }
+  EXPECT_EQ(allocator->ChunkCount(), 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(AllocatorTests, AllocatorTest,
                          ::testing::Values(true, false),
                          [](const testing::TestParamInfo<bool> &info) {
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/utils/counted_btree.h"
+
+#include <cstddef>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace valkey_search::utils {
+
+namespace {
+
+// Small node capacities so that splits, merges and borrows are exercised with
+// a handful of entries.
+using SmallTree = CountedBTree<double, int, std::identity, 4, 4>;
+
+std::vector<std::pair<double, int>> Collect(SmallTree::ConstIterator begin,
+                                            SmallTree::ConstIterator end) {
+  std::vector<std::pair<double, int>> result;
+  for (auto it = begin; it != end; ++it) {
+    result.emplace_back(it->key, it->value);
+  }
+  return result;
+}
+
+TEST(CountedBTreeTest, Empty) {
+  SmallTree tree;
+  EXPECT_EQ(tree.Size(), 0);
+  EXPECT_TRUE(tree.begin() == tree.end());
+  EXPECT_EQ(tree.Count(0.0, 10.0, true, true), 0);
+  EXPECT_TRUE(tree.LowerBound(1.0) == tree.end());
+  EXPECT_FALSE(tree.Erase(1.0, 1));
+}
+
+TEST(CountedBTreeTest, SimpleAddRemove) {
+  SmallTree tree;
+  EXPECT_TRUE(tree.Insert(1.0, 1));
+  EXPECT_TRUE(tree.Insert(0.0, 2));
+  EXPECT_TRUE(tree.Insert(2.0, 3));
+  EXPECT_FALSE(tree.Insert(2.0, 3));
+  EXPECT_EQ(tree.Size(), 3);
+  EXPECT_EQ(tree.Count(0.0, 2.0, false, false), 1);
+  EXPECT_EQ(tree.Count(0.0, 2.0, true, true), 3);
+  EXPECT_EQ(tree.Count(0.0, 2.0, true, false), 2);
+  EXPECT_EQ(tree.Count(2.0, 0.0, true, true), 0);
+  EXPECT_TRUE(tree.Erase(1.0, 1));
+  EXPECT_FALSE(tree.Erase(1.0, 1));
+  EXPECT_EQ(tree.Count(0.0, 2.0, false, false), 0);
+  EXPECT_EQ(tree.Count(0.0, 2.0, true, true), 2);
+  EXPECT_EQ(Collect(tree.begin(), tree.end()),
+            (std::vector<std::pair<double, int>>{{0.0, 2}, {2.0, 3}}));
+}
+
+TEST(CountedBTreeTest, DuplicateKeys) {
+  SmallTree tree;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(tree.Insert(i % 3, i));
+  }
+  EXPECT_EQ(tree.Count(1.0, 1.0, true, true), 33);
+  EXPECT_EQ(tree.CountLess(1.0, false), 34);
+  EXPECT_EQ(tree.CountLess(1.0, true), 67);
+  auto range = Collect(tree.LowerBound(1.0), tree.UpperBound(1.0));
+  ASSERT_EQ(range.size(), 33);
+  for (size_t i = 0; i < range.size(); ++i) {
+    EXPECT_EQ(range[i].first, 1.0);
+    EXPECT_EQ(range[i].second, 1 + 3 * i);
+  }
+  for (int i = 1; i < 100; i += 3) {
+    EXPECT_TRUE(tree.Erase(1.0, i));
+  }
+  EXPECT_EQ(tree.Count(1.0, 1.0, true, true), 0);
+  EXPECT_TRUE(tree.LowerBound(1.0) == tree.UpperBound(1.0));
+  EXPECT_EQ(tree.Size(), 67);
+}
+
+TEST(CountedBTreeTest, RandomizedAgainstStdSet) {
+  SmallTree tree;
+  std::set<std::pair<double, int>> expected;
+  std::mt19937 rng(42);
+  for (int i = 0; i < 20000; ++i) {
+    double key = rng() % 50;
+    int value = rng() % 200;
+    if (rng() % 3) {
+      EXPECT_EQ(tree.Insert(key, value), expected.insert({key, value}).second);
+    } else {
+      EXPECT_EQ(tree.Erase(key, value), expected.erase({key, value}) == 1);
+    }
+    ASSERT_EQ(tree.Size(), expected.size());
+    if (i % 1000 != 0) {
+      continue;
+    }
+    std::vector<std::pair<double, int>> expected_entries(expected.begin(),
+                                                         expected.end());
+    EXPECT_EQ(Collect(tree.begin(), tree.end()), expected_entries);
+    for (double start = -1; start < 52; start += 2.5) {
+      for (double end = start; end < 52; end += 5.5) {
+        size_t count = 0;
+        for (const auto& [key, _] : expected) {
+          count += key >= start && key < end;
+        }
+        EXPECT_EQ(tree.Count(start, end, true, false), count);
+        EXPECT_EQ(Collect(tree.LowerBound(start), tree.LowerBound(end)).size(),
+                  count);
+      }
+    }
+  }
+  for (const auto& [key, value] : expected) {
+    EXPECT_TRUE(tree.Erase(key, value));
+  }
+  EXPECT_EQ(tree.Size(), 0);
+  EXPECT_TRUE(tree.begin() == tree.end());
+}
+
+}  // namespace
+
+}  // namespace valkey_search::utils
@@ -184,5 +184,50 @@ TEST_F(PatriciaTreeSetTest, TriePathIterator) {
   }
   EXPECT_EQ(got, expected);
 }
+
+TEST_F(PatriciaTreeSetTest, ValueSetGrowsAndShrinks) {
+  constexpr int kValues = 3 * PatriciaValueSet<int>::kMaxSmallValues;
+  for (int i = 0; i < kValues; ++i) {
+    tree_->AddKeyValue("key", i);
+  }
+  std::unordered_set<int> expected;
+  for (int i = 0; i < kValues; ++i) {
+    expected.insert(i);
+  }
+  auto set = tree_->GetValue("key", true);
+  ASSERT_NE(set, nullptr);
+  EXPECT_EQ(set->size(), kValues);
+  EXPECT_EQ(std::unordered_set<int>(set->begin(), set->end()), expected);
+  for (int i = 0; i < kValues - 1; ++i) {
+    EXPECT_TRUE(tree_->Remove("key", i));
+    EXPECT_FALSE(tree_->Remove("key", i));
+  }
+  EXPECT_THAT(*tree_->GetValue("key", true),
+              testing::UnorderedElementsAre(kValues - 1));
+  EXPECT_TRUE(tree_->Remove("key", kValues - 1));
+  EXPECT_EQ(tree_->GetValue("key", true), nullptr);
+  EXPECT_EQ(tree_->GetQualifiedElementsCount("", false), 0);
+}
+
+TEST_F(PatriciaTreeSetTest, RemoveKeepsTreeCompressed) {
+  tree_->AddKeyValue("apple", 1);
+  tree_->AddKeyValue("app", 2);
+  tree_->AddKeyValue("apricot", 3);
+  EXPECT_TRUE(tree_->Remove("app", 2));
+  EXPECT_TRUE(tree_->Remove("apricot", 3));
+  // "ap" -> "p" -> "le" collapses back into a single "apple" edge.
+  EXPECT_EQ(tree_->GetValue("app", true), nullptr);
+  EXPECT_THAT(*tree_->GetValue("APPLE", true),
+              testing::UnorderedElementsAre(1));
+  EXPECT_EQ(tree_->GetQualifiedElementsCount("ap", false), 1);
+  tree_->AddKeyValue("apricot", 3);
+  EXPECT_EQ(tree_->GetQualifiedElementsCount("ap", false), 2);
+  EXPECT_EQ(tree_->GetQualifiedElementsCount("app", false), 1);
+  std::unordered_set<int> got;
+  for (auto itr = tree_->PrefixMatcher("a"); !itr.Done(); itr.Next()) {
+    got.insert(itr.Value()->value->begin(), itr.Value()->value->end());
+  }
+  EXPECT_EQ(got, (std::unordered_set<int>{1, 3}));
+}
 }  // namespace
 }  // namespace valkey_search
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "src/utils/segmented_array.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace valkey_search::utils {
+
+namespace {
+
+TEST(SegmentedArrayTest, GetUnsetReturnsDefault) {
+  SegmentedArray<const int*> array;
+  EXPECT_EQ(array.Get(0), nullptr);
+  EXPECT_EQ(array.Get(uint64_t{1} << 40), nullptr);
+  EXPECT_EQ(array.GetAllocatedBytes(), 0);
+}
+
+TEST(SegmentedArrayTest, SetAndGetAcrossSegments) {
+  SegmentedArray<uint64_t, 2> array;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    array.Set(i, i + 1);
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(array.Get(i), i + 1);
+  }
+  EXPECT_EQ(array.Get(1000), 0);
+  array.Set(7, 0);
+  EXPECT_EQ(array.Get(7), 0);
+  EXPECT_EQ(array.Get(8), 9);
+}
+
+TEST(SegmentedArrayTest, SparseIdsOnlyAllocateTheirSegments) {
+  SegmentedArray<uint64_t, 4> array;
+  array.Set(100000, 1);
+  EXPECT_EQ(array.Get(100000), 1);
+  EXPECT_LT(array.GetAllocatedBytes(), 100000 * sizeof(uint64_t));
+}
+
+TEST(SegmentedArrayTest, ClearedPagesAreFreed) {
+  SegmentedArray<uint64_t, 4> array;
+  array.Set(3, 1);
+  const size_t one_page = array.GetAllocatedBytes();
+  array.Set(5, 1);
+  EXPECT_EQ(array.GetAllocatedBytes(), one_page);
+  array.Set(3, 0);
+  EXPECT_EQ(array.Get(5), 1);
+  EXPECT_EQ(array.GetAllocatedBytes(), one_page);
+  array.Set(5, 0);
+  EXPECT_EQ(array.Get(5), 0);
+  EXPECT_LT(array.GetAllocatedBytes(), one_page);
+}
+
+TEST(SegmentedArrayTest, ChurnOfNewIdsKeepsMemoryBounded) {
+  SegmentedArray<uint64_t> array;
+  // A few long-lived ids and a window of live ids that keeps moving up, as
+  // when keys are deleted and re-added under ever-increasing ids.
+  for (uint64_t id = 0; id < 4; ++id) {
+    array.Set(id, id + 1);
+  }
+  constexpr uint64_t kWindow = 100;
+  size_t max_bytes = 0;
+  for (uint64_t id = 4; id < 1000000; ++id) {
+    array.Set(id, id + 1);
+    if (id >= 4 + kWindow) {
+      array.Set(id - kWindow, 0);
+    }
+    if (id == 100000) {
+      max_bytes = array.GetAllocatedBytes();
+    }
+  }
+  EXPECT_EQ(array.Get(0), 1);
+  EXPECT_EQ(array.Get(999999), 1000000);
+  EXPECT_EQ(array.Get(999999 - kWindow), 0);
+  // Ten times more churn only adds directory entries, one per 1024 ids.
+  EXPECT_LE(array.GetAllocatedBytes(), max_bytes + 1000000 / 1024 * 16);
+  EXPECT_LT(array.GetAllocatedBytes(), 64 * 1024);
+}
+
+TEST(SegmentedArrayTest, ReadersObservePublishedValues) {
+  constexpr uint64_t kCount = 1 << 16;
+  std::vector<uint64_t> values(kCount);
+  SegmentedArray<const uint64_t*, 4> array;
+  std::atomic<uint64_t> published{0};
+  std::vector<std::thread> writers;
+  for (int w = 0; w < 4; ++w) {
+    writers.emplace_back([&, w] {
+      for (uint64_t i = w; i < kCount; i += 4) {
+        values[i] = i;
+        array.Set(i, &values[i]);
+        published.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  std::thread reader([&] {
+    while (published.load(std::memory_order_relaxed) < kCount) {
+      for (uint64_t i = 0; i < kCount; i += 97) {
+        if (const uint64_t* value = array.Get(i)) {
+          ASSERT_EQ(*value, i);
+        }
+      }
+    }
+  });
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  reader.join();
+  for (uint64_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(array.Get(i), &values[i]);
+  }
+}
+
+}  // namespace
+
+}  // namespace valkey_search::utils
@@ -178,6 +178,42 @@ TEST_F(StringInterningMultithreadTest, ConcurrentInterning) {
 
   EXPECT_EQ(StringInternStore::Instance().UniqueStrings(), 0);
 }
+
+TEST_F(StringInterningMultithreadTest, ConcurrentInterningDistinctStrings) {
+  const int kNumThreads = 16;
+  const int kNumIterations = 20000;
+  const int kNumStrings = 257;
+  std::vector<InternedStringPtr> held;
+  for (int i = 0; i < kNumStrings; i += 2) {
+    held.push_back(StringInternStore::Intern("str_" + std::to_string(i)));
+  }
+
+  auto intern_function = [&](int thread_id) {
+    for (int i = 0; i < kNumIterations; ++i) {
+      auto str = "str_" + std::to_string((i + thread_id) % kNumStrings);
+      auto interned_str = StringInternStore::Intern(str);
+      auto interned_str_2 = StringInternStore::Intern(str);
+      EXPECT_EQ(interned_str, interned_str_2);
+      EXPECT_EQ(interned_str->Str(), str);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(kNumThreads);
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(intern_function, i);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(StringInternStore::Instance().UniqueStrings(), held.size());
+  for (const auto& str : held) {
+    EXPECT_EQ(str.RefCount(), 1);
+  }
+  held.clear();
+  EXPECT_EQ(StringInternStore::Instance().UniqueStrings(), 0);
+}
 }  // namespace
 
 }  // namespace valkey_search
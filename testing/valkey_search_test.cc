@@ -504,6 +504,8 @@ TEST_F(ValkeySearchTest, Info) {
       "hnsw_search_exceptions_count: 6\nhnsw_create_exceptions_count: 7\n"
       "latency\nhnsw_vector_index_search_latency_usec: "
       "'p50=100139.007,p99=200278.015,p99.9=200278.015'\n"
+      "hnsw_vector_index_search_latency_window_usec: "
+      "'p50=100139.007,p99=200278.015,p99.9=200278.015'\n"
       "coordinator\ncoordinator_server_listening_port: 0\n"
       "coordinator_server_get_global_metadata_success_count: "
       "26\ncoordinator_server_get_global_metadata_failure_count: 25\n"
@@ -240,7 +240,7 @@ TEST_P(VectorExternalizerTest, LRUTest) {
   EXPECT_CALL(*kMockValkeyModule,
               OpenKey(VectorExternalizer::Instance().GetCtx(),
                       testing::An<ValkeyModuleString *>(), VALKEYMODULE_WRITE))
-      .Times(vectors.size())
+      .Times(2 * vectors.size())
       .WillRepeatedly(
           [&](ValkeyModuleCtx *ctx, ValkeyModuleString *key, int flags) {
             auto res = TestValkeyModule_OpenKeyDefaultImpl(ctx, key, flags);
@@ -251,7 +251,7 @@ TEST_P(VectorExternalizerTest, LRUTest) {
       registration;
   EXPECT_CALL(*kMockValkeyModule,
               HashExternalize(testing::_, testing::_, testing::_, testing::_))
-      .Times(vectors.size())
+      .Times(2 * vectors.size())
       .WillRepeatedly([&](ValkeyModuleKey *key, ValkeyModuleString *field,
                           ValkeyModuleHashExternCB fn, void *privdata) {
         auto field_str = vmsdk::ToStringView(field);
@@ -260,6 +260,8 @@ TEST_P(VectorExternalizerTest, LRUTest) {
         registration.insert({keys[key], std::make_pair(fn, privdata)});
         return VALKEYMODULE_OK;
       });
+  // Every update overwrote the externalized field, so each half-set update
+  // is externalized again.
   std::vector<std::vector<float>> generated_vectors;
   generated_vectors.reserve(vectors.size());
   for (size_t j = 0; j < vectors.size(); ++j) {
@@ -316,6 +318,59 @@ TEST_P(VectorExternalizerTest, OpenKeyFailure) {
   VerifyStats(stats);
 }
 
+TEST_F(VectorExternalizerTest, UpdatesStayExternalized) {
+  auto &vector_externalizer = VectorExternalizer::Instance();
+  EXPECT_CALL(*kMockValkeyModule,
+              OpenKey(VectorExternalizer::Instance().GetCtx(),
+                      testing::An<ValkeyModuleString *>(), VALKEYMODULE_WRITE))
+      .Times(3)
+      .WillRepeatedly(TestValkeyModule_OpenKeyDefaultImpl);
+  absl::flat_hash_map<std::string, std::pair<ValkeyModuleHashExternCB, void *>>
+      registration;
+  EXPECT_CALL(*kMockValkeyModule,
+              HashExternalize(testing::_, testing::_, testing::_, testing::_))
+      .Times(3)
+      .WillRepeatedly([&](ValkeyModuleKey *key, ValkeyModuleString *field,
+                          ValkeyModuleHashExternCB fn, void *privdata) {
+        registration[vmsdk::ToStringView(field)] = std::make_pair(fn, privdata);
+        return VALKEYMODULE_OK;
+      });
+  auto interned_key = StringInternStore::Intern("key");
+  auto externalize = [&](absl::string_view attribute_identifier, size_t i) {
+    EXPECT_TRUE(vector_externalizer.Externalize(
+        interned_key, attribute_identifier,
+        data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH,
+        StringInternStore::Intern(VectorToStr(vectors[i]), allocator.get()),
+        std::nullopt));
+  };
+  auto verify = [&](absl::string_view attribute_identifier, size_t i) {
+    auto &[fn, privdata] = registration[attribute_identifier];
+    size_t len;
+    auto vector = fn(privdata, &len);
+    EXPECT_EQ(absl::string_view(vector, len), VectorToStr(vectors[i]));
+  };
+  externalize("attribute_identifier_1", 0);
+  vector_externalizer.ProcessEngineUpdateQueue();
+  // Adding more attributes of the same key must not move registered entries.
+  externalize("attribute_identifier_2", 1);
+  vector_externalizer.ProcessEngineUpdateQueue();
+  verify("attribute_identifier_1", 0);
+  verify("attribute_identifier_2", 1);
+  // The client overwrote the field, which has to be externalized again.
+  externalize("attribute_identifier_1", 2);
+  vector_externalizer.ProcessEngineUpdateQueue();
+  verify("attribute_identifier_1", 2);
+  EXPECT_EQ(vector_externalizer.GetStats().entry_cnt, 2);
+
+  vector_externalizer.Remove(
+      interned_key, "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  vector_externalizer.Remove(
+      interned_key, "attribute_identifier_2",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  EXPECT_EQ(vector_externalizer.GetStats().entry_cnt, 0);
+}
+
 TEST_F(VectorExternalizerTest, ModuleApiNotAvailable) {
   auto &vector_externalizer = VectorExternalizer::Instance();
   EXPECT_CALL(*kMockValkeyModule, GetApi(testing::_, testing::_))
@@ -5,6 +5,7 @@
  *
  */
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
@@ -17,6 +18,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
@@ -29,9 +31,11 @@
 #include "src/indexes/vector_base.h"
 #include "src/indexes/vector_flat.h"
 #include "src/indexes/vector_hnsw.h"
+#include "src/metrics.h"
 #include "src/utils/cancel.h"
 #include "src/utils/string_interning.h"
 #include "src/valkey_search_options.h"
+#include "src/vector_externalizer.h"
 #include "testing/common.h"
 #include "third_party/hnswlib/space_ip.h"
 #include "third_party/hnswlib/space_l2.h"
@@ -363,6 +367,126 @@ TEST_F(VectorIndexTest, ResizeFlat) ABSL_NO_THREAD_SAFETY_ANALYSIS {
   }
 }
 
+TEST_F(VectorIndexTest, CompactMemoryFlat) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto index = VectorFlat<float>::Create(
+      CreateFlatVectorIndexProto(kDimensions, data_model::DISTANCE_METRIC_L2,
+                                 kInitialCap, kBlockSize),
+      "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  VMSDK_EXPECT_OK(index);
+  auto vectors = DeterministicallyGenerateVectors(1000, kDimensions, 10.0);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    VerifyAdd(index->get(), vectors, i, ExpectedResults::kSuccess);
+  }
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    if (i % 10 != 0) {
+      VMSDK_EXPECT_OK(
+          index.value()->RemoveRecord(IndexToKey(i), DeletionType::kNone));
+    }
+  }
+  const auto moved_before = Metrics::GetStats().defrag_vectors_moved_cnt;
+  // A budget of a single batch per increment, compaction resumes from where
+  // the previous increment stopped.
+  int checks = 0;
+  DefragContext ctx([&checks] { return ++checks % 2 == 0; },
+                    [](void*) -> void* { return nullptr; });
+  for (int i = 0; i < 200; ++i) {
+    index.value()->CompactMemory(ctx);
+  }
+  EXPECT_GT(Metrics::GetStats().defrag_vectors_moved_cnt, moved_before);
+  for (size_t i = 0; i < vectors.size(); i += 10) {
+    auto value = index.value()->GetValue(IndexToKey(i));
+    VMSDK_EXPECT_OK(value);
+    EXPECT_EQ(absl::string_view(value->data(), value->size()),
+              VectorToStr(vectors[i]));
+  }
+  auto res = index.value()->Search(VectorToStr(vectors[500]), 1, CancelNever());
+  VMSDK_EXPECT_OK(res);
+  ASSERT_EQ(res->size(), 1);
+  EXPECT_EQ(res->front().external_id, IndexToKey(500));
+  EXPECT_NEAR(res->front().distance, 0.0f, 0.0001);
+}
+
+TEST_F(VectorIndexTest, CompactMemoryFlatExternalized)
+ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto index = VectorFlat<float>::Create(
+      CreateFlatVectorIndexProto(kDimensions, data_model::DISTANCE_METRIC_L2,
+                                 kInitialCap, kBlockSize),
+      "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  VMSDK_EXPECT_OK(index);
+  auto vectors = DeterministicallyGenerateVectors(1000, kDimensions, 10.0);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    VerifyAdd(index->get(), vectors, i, ExpectedResults::kSuccess);
+  }
+  std::vector<void*> registrations;
+  EXPECT_CALL(*kMockValkeyModule,
+              HashExternalize(testing::_, testing::_, testing::_, testing::_))
+      .WillRepeatedly([&](ValkeyModuleKey* key, ValkeyModuleString* field,
+                          ValkeyModuleHashExternCB fn, void* privdata) {
+        registrations.push_back(privdata);
+        return VALKEYMODULE_OK;
+      });
+  // The externalizer shares the vectors of the keys left, with references of
+  // its own.
+  absl::flat_hash_set<std::string> expected;
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    if (i % 10 != 0) {
+      VMSDK_EXPECT_OK(
+          index.value()->RemoveRecord(IndexToKey(i), DeletionType::kNone));
+      continue;
+    }
+    expected.insert(std::string(VectorToStr(vectors[i])));
+    EXPECT_TRUE(VectorExternalizer::Instance().Externalize(
+        IndexToKey(i), "attribute_identifier_1",
+        data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH,
+        StringInternStore::Intern(VectorToStr(vectors[i])), std::nullopt));
+  }
+  VectorExternalizer::Instance().ProcessEngineUpdateQueue();
+  ASSERT_EQ(registrations.size(), expected.size());
+  const auto moved_before = Metrics::GetStats().defrag_vectors_moved_cnt;
+  DefragContext ctx([] { return false; },
+                    [](void*) -> void* { return nullptr; });
+  for (int i = 0; i < 200; ++i) {
+    index.value()->CompactMemory(ctx);
+  }
+  EXPECT_GT(Metrics::GetStats().defrag_vectors_moved_cnt, moved_before);
+  // The engine reads the moved vectors through the externalizer entries.
+  absl::flat_hash_set<std::string> externalized;
+  for (auto privdata : registrations) {
+    size_t len;
+    char* vector = ExternalizeCB(privdata, &len);
+    externalized.insert(std::string(vector, len));
+  }
+  EXPECT_EQ(externalized, expected);
+}
+
+TEST_F(VectorIndexTest, IdMapMemoryBoundedUnderChurn)
+ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  auto index = VectorFlat<float>::Create(
+      CreateFlatVectorIndexProto(kDimensions, data_model::DISTANCE_METRIC_L2,
+                                 kInitialCap, kBlockSize),
+      "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  VMSDK_EXPECT_OK(index);
+  auto vectors = DeterministicallyGenerateVectors(10, kDimensions, 10.0);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    VerifyAdd(index->get(), vectors, i, ExpectedResults::kSuccess);
+  }
+  const size_t initial_usage = index.value()->GetIdMapMemoryUsage();
+  EXPECT_GT(initial_usage, 0);
+  // Every re-add takes a new internal id.
+  for (int round = 0; round < 1000; ++round) {
+    for (size_t i = 0; i < vectors.size(); ++i) {
+      VMSDK_EXPECT_OK(
+          index.value()->RemoveRecord(IndexToKey(i), DeletionType::kNone));
+      VerifyAdd(index->get(), vectors, i, ExpectedResults::kSuccess);
+    }
+  }
+  // 10000 ids were issued, but the live ids span at most two pages.
+  EXPECT_LE(index.value()->GetIdMapMemoryUsage(), 2 * initial_usage);
+}
+
 float CalcRecall(VectorFlat<float>* flat_index, VectorHNSW<float>* hnsw_index,
                  uint64_t k, int dimensions, std::optional<size_t> ef_runtime) {
   auto search_vectors = DeterministicallyGenerateVectors(50, dimensions, 1.5);
@@ -420,6 +544,191 @@ TEST_F(VectorIndexTest, EfRuntimeRecall) {
   }
 }
 
+class ModuloFilter : public hnswlib::BaseFilterFunctor {
+ public:
+  explicit ModuloFilter(uint64_t modulo) : modulo_(modulo) {}
+  bool operator()(hnswlib::labeltype id) override { return id % modulo_ == 0; }
+
+ private:
+  uint64_t modulo_;
+};
+
+TEST_F(VectorIndexTest, FilterAwareRecall) {
+  const int initial_cap = 2000;
+  auto index_hnsw = VectorHNSW<float>::Create(
+      CreateHNSWVectorIndexProto(kDimensions, data_model::DISTANCE_METRIC_L2,
+                                 initial_cap, kM, kEFConstruction, kEFRuntime),
+      "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  auto index_flat = VectorFlat<float>::Create(
+      CreateFlatVectorIndexProto(kDimensions, data_model::DISTANCE_METRIC_L2,
+                                 initial_cap, kBlockSize),
+      "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  auto vectors = DeterministicallyGenerateVectors(1000, kDimensions, 2.2);
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    VerifyAdd(index_hnsw->get(), vectors, i, ExpectedResults::kSuccess);
+    VerifyAdd(index_flat->get(), vectors, i, ExpectedResults::kSuccess);
+  }
+  const uint64_t k = 10;
+  const uint64_t modulo = 20;
+  auto search_vectors = DeterministicallyGenerateVectors(50, kDimensions, 1.5);
+  int cnt = 0;
+  for (const auto& search_vector : search_vectors) {
+    absl::string_view vector = VectorToStr(search_vector);
+    auto res_hnsw = index_hnsw.value()->Search(
+        vector, k, CancelNever(), std::make_unique<ModuloFilter>(modulo),
+        std::nullopt, false, 1.0 / modulo);
+    auto res_flat = index_flat.value()->Search(
+        vector, k, CancelNever(), std::make_unique<ModuloFilter>(modulo));
+    VMSDK_EXPECT_OK(res_hnsw);
+    EXPECT_EQ(res_hnsw->size(), k);
+    for (auto& label : *res_hnsw) {
+      for (auto& real_label : *res_flat) {
+        if (label.external_id == real_label.external_id) {
+          ++cnt;
+          break;
+        }
+      }
+    }
+  }
+  EXPECT_GE(((float)cnt) / (k * search_vectors.size()), 0.9f);
+}
+
+// Brute force MaxSim distance: the sum over the query vectors of the squared
+// L2 distance to the closest document vector.
+float MaxSimL2(const std::vector<std::vector<float>>& query,
+               const std::vector<std::vector<float>>& doc) {
+  float distance = 0;
+  for (const auto& q : query) {
+    float closest = std::numeric_limits<float>::max();
+    for (const auto& d : doc) {
+      float dist = 0;
+      for (size_t i = 0; i < q.size(); ++i) {
+        dist += (q[i] - d[i]) * (q[i] - d[i]);
+      }
+      closest = std::min(closest, dist);
+    }
+    distance += closest;
+  }
+  return distance;
+}
+
+std::vector<float> Concat(const std::vector<std::vector<float>>& vectors) {
+  std::vector<float> ret;
+  for (const auto& v : vectors) {
+    ret.insert(ret.end(), v.begin(), v.end());
+  }
+  return ret;
+}
+
+TEST_F(VectorIndexTest, MultiVectorMaxSim) {
+  const int dimensions = 16;
+  auto proto = CreateHNSWVectorIndexProto(
+      dimensions, data_model::DISTANCE_METRIC_L2, 100, kM, 100, 50);
+  proto.set_multi_vector(true);
+  auto index = VectorHNSW<float>::Create(
+      proto, "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_HASH);
+  VMSDK_EXPECT_OK(index);
+  EXPECT_TRUE(index.value()->IsMultiVector());
+  EXPECT_TRUE(index.value()->ToProto()->vector_index().multi_vector());
+
+  const int num_docs = 300;
+  auto vectors = DeterministicallyGenerateVectors(num_docs * 8, dimensions, 2);
+  std::vector<std::vector<std::vector<float>>> docs(num_docs);
+  for (int i = 0; i < num_docs; ++i) {
+    for (int j = 0; j < 2 + i % 7; ++j) {
+      docs[i].push_back(vectors[i * 8 + j]);
+    }
+    auto record = Concat(docs[i]);
+    VMSDK_EXPECT_OK(
+        index.value()->AddRecord(IndexToKey(i), VectorToStr(record)));
+  }
+  EXPECT_EQ(index.value()->GetTrackedKeyCount(), num_docs);
+  // A record must be a whole number of vectors.
+  std::vector<float> partial(dimensions + 1, 1.0);
+  VerifyResult(
+      index.value()->AddRecord(IndexToKey(num_docs), VectorToStr(partial)),
+      ExpectedResults::kSkipped);
+
+  // Shrinking a record drops its trailing vectors.
+  docs[0].resize(1);
+  auto modified = Concat(docs[0]);
+  VerifyResult(
+      index.value()->ModifyRecord(IndexToKey(0), VectorToStr(modified)),
+      ExpectedResults::kSuccess);
+  auto value = index.value()->GetValue(IndexToKey(0));
+  VMSDK_EXPECT_OK(value);
+  EXPECT_EQ(absl::string_view(value->data(), value->size()),
+            VectorToStr(modified));
+
+  const uint64_t k = 10;
+  auto queries = DeterministicallyGenerateVectors(20 * 3, dimensions, 2);
+  int cnt = 0;
+  for (int q = 0; q < 20; ++q) {
+    std::vector<std::vector<float>> query(queries.begin() + q * 3,
+                                          queries.begin() + q * 3 + 3);
+    std::vector<std::pair<float, int>> expected;
+    for (int i = 0; i < num_docs; ++i) {
+      expected.emplace_back(MaxSimL2(query, docs[i]), i);
+    }
+    std::sort(expected.begin(), expected.end());
+    auto flat_query = Concat(query);
+    auto results = index.value()->Search(VectorToStr(flat_query), k,
+                                         CancelNever());
+    VMSDK_EXPECT_OK(results);
+    ASSERT_EQ(results->size(), k);
+    EXPECT_NEAR((*results)[0].distance, expected[0].first, 1e-3);
+    for (const auto& neighbor : *results) {
+      for (size_t i = 0; i < k; ++i) {
+        if (neighbor.external_id == IndexToKey(expected[i].second)) {
+          ++cnt;
+          break;
+        }
+      }
+    }
+    // Filters apply to whole records.
+    auto filtered = index.value()->Search(VectorToStr(flat_query), k,
+                                          CancelNever(),
+                                          std::make_unique<ModuloFilter>(2));
+    VMSDK_EXPECT_OK(filtered);
+    for (const auto& neighbor : *filtered) {
+      int i = std::stoi(std::string(neighbor.external_id->Str()));
+      EXPECT_EQ(i % 2, 0);
+    }
+  }
+  EXPECT_GE(((float)cnt) / (k * 20), 0.9f);
+
+  VerifyResult(index.value()->RemoveRecord(IndexToKey(0)),
+               ExpectedResults::kSuccess);
+  auto query = Concat(docs[0]);
+  auto results = index.value()->Search(VectorToStr(query), k, CancelNever());
+  VMSDK_EXPECT_OK(results);
+  for (const auto& neighbor : *results) {
+    EXPECT_NE(neighbor.external_id, IndexToKey(0));
+  }
+}
+
+TEST_F(VectorIndexTest, MultiVectorNormalizeStringRecord) {
+  auto proto =
+      CreateHNSWVectorIndexProto(2, data_model::DISTANCE_METRIC_L2, kInitialCap,
+                                 kM, kEFConstruction, kEFRuntime);
+  proto.set_multi_vector(true);
+  auto index = VectorHNSW<float>::Create(
+      proto, "attribute_identifier_1",
+      data_model::AttributeDataType::ATTRIBUTE_DATA_TYPE_JSON);
+  auto norm_record = index.value()->NormalizeStringRecord(
+      vmsdk::MakeUniqueValkeyString("[[0.1, 0.2], [0.3,0.4],[0.5,0.6]]"));
+  ASSERT_TRUE(norm_record.get());
+  auto norm_record_str = vmsdk::ToStringView(norm_record.get());
+  ASSERT_EQ(norm_record_str.size(), 6 * sizeof(float));
+  const float expected[] = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6};
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_FLOAT_EQ(((const float*)norm_record_str.data())[i], expected[i]);
+  }
+}
+
 TEST_F(VectorIndexTest, SaveAndLoadHnsw) {
   for (auto& distance_metric :
        {data_model::DISTANCE_METRIC_COSINE, data_model::DISTANCE_METRIC_L2}) {
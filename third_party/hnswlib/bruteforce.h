@@ -89,6 +89,21 @@ class BruteforceSearch : public AlgorithmInterface<dist_t> {
       return *(char **)(*data_)[found->second];
     }
 
+    // Points the element of label at `to` if its data is at `from`. Searches
+    // read the data pointer without synchronization, the caller must keep
+    // them out.
+    void relocateData(labeltype label, const char *from, char *to) {
+        std::unique_lock<std::mutex> lock(index_lock);
+        auto found = dict_external_to_internal.find(label);
+        if (found == dict_external_to_internal.end()) {
+            return;
+        }
+        auto data_ptr = (char **)((*data_)[found->second]);
+        if (*data_ptr == from) {
+            *data_ptr = to;
+        }
+    }
+
     void removePoint(labeltype cur_external) {
         std::unique_lock<std::mutex> lock(index_lock);
 
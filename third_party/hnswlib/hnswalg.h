@@ -233,6 +233,44 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     return *data_ptr;
   }
 
+  // Points the element of label at `to` if its data is at `from`. Searches
+  // and insertions read the data pointer without synchronization, the caller
+  // must keep both out.
+  void relocateData(labeltype label, const char *from, char *to) {
+    std::unique_lock<std::mutex> lock_table(label_lookup_lock);
+    auto search = label_lookup_.find(label);
+    if (search == label_lookup_.end()) {
+      return;
+    }
+    auto data_ptr = (char **)(getDataPtrByInternalId(search->second));
+    if (*data_ptr == from) {
+      *data_ptr = to;
+    }
+  }
+
+  // Reallocates the upper level link lists of up to max_elements elements,
+  // starting at element cursor, through move, which returns the new address
+  // or nullptr if the allocation wasn't moved. Returns the element to resume
+  // from, or 0 once every element was visited.
+  template <typename Fn>
+  size_t defragLinkLists(size_t cursor, size_t max_elements, Fn &&move) {
+    size_t end = std::min<size_t>(cur_element_count_, cursor + max_elements);
+    for (; cursor < end; cursor++) {
+      if (element_levels_[cursor] == 0) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(link_list_locks_[cursor]);
+      auto link_list = reinterpret_cast<char **>((*linkLists_)[cursor]);
+      if (*link_list == nullptr) {
+        continue;
+      }
+      if (char *moved = move(*link_list)) {
+        *link_list = moved;
+      }
+    }
+    return cursor < cur_element_count_ ? cursor : 0;
+  }
+
   int getRandomLevel(double reverse_size) {
     std::uniform_real_distribution<double> distribution(0.0, 1.0);
     double r = -log(distribution(level_generator_)) * reverse_size;
@@ -339,6 +377,140 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
     return top_candidates;
   }
 
+  // VALKEYSEARCH BEGIN
+  //
+  // Filter-aware variant of searchBaseLayerST for restrictive filters, in the
+  // spirit of ACORN-1. Only nodes that pass the filter are scored and queued,
+  // so the distance computations are spent on the predicate subgraph. When a
+  // neighbor fails the filter, its own neighbors are considered in its place
+  // (two-hop expansion), which keeps the traversal connected when the passing
+  // nodes are sparse in the graph. Expanding a node stops once maxM0_ passing
+  // nodes are gathered. If neither hop yields a passing node while the result
+  // set is still short, the failing neighbors are queued as routing nodes so
+  // that the search can walk out of a region without matches.
+  //
+  std::priority_queue<std::pair<dist_t, tableint>,
+                      std::vector<std::pair<dist_t, tableint>>, CompareByFirst>
+  searchBaseLayerFilteredST(tableint ep_id, const void *data_point, size_t ef,
+                            BaseFilterFunctor *isIdAllowed,
+                            BaseCancellationFunctor *isCancelled,
+                            SearchStats *stats = nullptr) const {
+    VisitedList *vl = visited_list_pool_->getFreeVisitedList();
+    vl_type *visited_array = vl->mass;
+    vl_type visited_array_tag = vl->curV;
+    VisitedList *rejected_vl = visited_list_pool_->getFreeVisitedList();
+    vl_type *rejected_array = rejected_vl->mass;
+    vl_type rejected_array_tag = rejected_vl->curV;
+
+    std::priority_queue<std::pair<dist_t, tableint>,
+                        std::vector<std::pair<dist_t, tableint>>,
+                        CompareByFirst>
+        top_candidates;
+    std::priority_queue<std::pair<dist_t, tableint>,
+                        std::vector<std::pair<dist_t, tableint>>,
+                        CompareByFirst>
+        candidate_set;
+    auto is_allowed = [&](tableint id) {
+      return !isMarkedDeleted(id) && (*isIdAllowed)(getExternalLabel(id));
+    };
+
+    dist_t lowerBound = std::numeric_limits<dist_t>::max();
+    dist_t ep_dist =
+        fstdistfunc_(data_point, getDataByInternalId(ep_id), dist_func_param_);
+    if (is_allowed(ep_id)) {
+      top_candidates.emplace(ep_dist, ep_id);
+      lowerBound = ep_dist;
+    }
+    candidate_set.emplace(-ep_dist, ep_id);
+    visited_array[ep_id] = visited_array_tag;
+
+    std::vector<tableint> passing;
+    std::vector<tableint> failing;
+    passing.reserve(maxM0_);
+    failing.reserve(maxM0_);
+    while (!candidate_set.empty()) {
+      std::pair<dist_t, tableint> current_node_pair = candidate_set.top();
+      dist_t candidate_dist = -current_node_pair.first;
+      if ((isCancelled && isCancelled->isCancelled()) ||
+          (candidate_dist > lowerBound && top_candidates.size() == ef)) {
+        break;
+      }
+      candidate_set.pop();
+
+      // Direct neighbors first, then the neighbors of the failing ones, so
+      // that the closest part of the graph is preferred when the cap is hit.
+      passing.clear();
+      failing.clear();
+      linklistsizeint *ll = get_linklist0(current_node_pair.second);
+      size_t size = getListCount(ll);
+      tableint *neighbors = (tableint *)(ll + 1);
+      for (size_t j = 0; j < size && passing.size() < maxM0_; j++) {
+        tableint neighbor = neighbors[j];
+        if (visited_array[neighbor] == visited_array_tag) {
+          continue;
+        }
+        visited_array[neighbor] = visited_array_tag;
+        if (rejected_array[neighbor] != rejected_array_tag &&
+            is_allowed(neighbor)) {
+          passing.push_back(neighbor);
+        } else {
+          failing.push_back(neighbor);
+        }
+      }
+      for (size_t j = 0; j < failing.size() && passing.size() < maxM0_; j++) {
+        linklistsizeint *hop_ll = get_linklist0(failing[j]);
+        size_t hop_size = getListCount(hop_ll);
+        tableint *hop_neighbors = (tableint *)(hop_ll + 1);
+        for (size_t h = 0; h < hop_size && passing.size() < maxM0_; h++) {
+          tableint hop_neighbor = hop_neighbors[h];
+          if (visited_array[hop_neighbor] == visited_array_tag ||
+              rejected_array[hop_neighbor] == rejected_array_tag) {
+            continue;
+          }
+          if (is_allowed(hop_neighbor)) {
+            visited_array[hop_neighbor] = visited_array_tag;
+            passing.push_back(hop_neighbor);
+          } else {
+            // Left unvisited so it can still route as a direct neighbor, but
+            // the filter is not evaluated for it again.
+            rejected_array[hop_neighbor] = rejected_array_tag;
+          }
+        }
+      }
+
+      if (stats) {
+        stats->hops++;
+        stats->distance_computations += passing.size();
+      }
+      for (tableint id : passing) {
+        dist_t dist = fstdistfunc_(data_point, getDataByInternalId(id),
+                                   dist_func_param_);
+        if (top_candidates.size() < ef || lowerBound > dist) {
+          candidate_set.emplace(-dist, id);
+          top_candidates.emplace(dist, id);
+          if (top_candidates.size() > ef) {
+            top_candidates.pop();
+          }
+          lowerBound = top_candidates.top().first;
+        }
+      }
+      if (passing.empty() && top_candidates.size() < ef) {
+        if (stats) {
+          stats->distance_computations += failing.size();
+        }
+        for (tableint id : failing) {
+          dist_t dist = fstdistfunc_(data_point, getDataByInternalId(id),
+                                     dist_func_param_);
+          candidate_set.emplace(-dist, id);
+        }
+      }
+    }
+    visited_list_pool_->releaseVisitedList(rejected_vl);
+    visited_list_pool_->releaseVisitedList(vl);
+    return top_candidates;
+  }
+  // VALKEYSEARCH END
+
   // bare_bone_search means there is no check for deletions and stop condition
   // is ignored in return of extra performance
   template <bool bare_bone_search = true, bool collect_metrics = false>
@@ -348,7 +520,8 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
       tableint ep_id, const void *data_point, size_t ef,
       BaseFilterFunctor *isIdAllowed = nullptr,
       BaseCancellationFunctor *isCancelled = nullptr,  // VALKEYSEARCH
-      BaseSearchStopCondition<dist_t> *stop_condition = nullptr) const {
+      BaseSearchStopCondition<dist_t> *stop_condition = nullptr,
+      SearchStats *stats = nullptr) const { // VALKEYSEARCH
     VisitedList *vl = visited_list_pool_->getFreeVisitedList();
     vl_type *visited_array = vl->mass;
     vl_type visited_array_tag = vl->curV;
@@ -414,6 +587,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
       if (collect_metrics) {
         metric_hops++;
         metric_distance_computations += size;
+        if (stats) { // VALKEYSEARCH
+          stats->hops++; // VALKEYSEARCH
+          stats->distance_computations += size; // VALKEYSEARCH
+        } // VALKEYSEARCH
       }
 
 #ifdef USE_PREFETCH
@@ -1411,7 +1588,9 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
   std::priority_queue<std::pair<dist_t, labeltype>> searchKnn(
       const void *query_data, size_t k, std::optional<size_t> ef_runtime,
       BaseFilterFunctor *isIdAllowed = nullptr,
-      BaseCancellationFunctor *isCancelled = nullptr // VALKEYSEARCH
+      BaseCancellationFunctor *isCancelled = nullptr, // VALKEYSEARCH
+      bool filter_aware = false, // VALKEYSEARCH
+      SearchStats *stats = nullptr // VALKEYSEARCH
     ) const {
     std::priority_queue<std::pair<dist_t, labeltype>> result;
     if (cur_element_count_ == 0) return result;
@@ -1430,6 +1609,10 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
         int size = getListCount(data);
         metric_hops++;
         metric_distance_computations += size;
+        if (stats) { // VALKEYSEARCH
+          stats->hops++; // VALKEYSEARCH
+          stats->distance_computations += size; // VALKEYSEARCH
+        } // VALKEYSEARCH
 
         tableint *datal = (tableint *)(data + 1);
         for (int i = 0; i < size; i++) {
@@ -1453,6 +1636,21 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                         CompareByFirst>
         top_candidates;
     bool bare_bone_search = !num_deleted_ && !isIdAllowed && !isCancelled; // VALKEYSEARCH
+    if (filter_aware && isIdAllowed) { // VALKEYSEARCH
+      top_candidates = searchBaseLayerFilteredST( // VALKEYSEARCH
+          currObj, query_data, std::max(ef_runtime.value_or(ef_), k), // VALKEYSEARCH
+          isIdAllowed, isCancelled, stats); // VALKEYSEARCH
+    } else // VALKEYSEARCH
+    if (stats) { // VALKEYSEARCH
+      // The default instantiations compile the counters out. // VALKEYSEARCH
+      top_candidates = bare_bone_search // VALKEYSEARCH
+          ? searchBaseLayerST<true, true>( // VALKEYSEARCH
+                currObj, query_data, std::max(ef_runtime.value_or(ef_), k), // VALKEYSEARCH
+                isIdAllowed, isCancelled, nullptr, stats) // VALKEYSEARCH
+          : searchBaseLayerST<false, true>( // VALKEYSEARCH
+                currObj, query_data, std::max(ef_runtime.value_or(ef_), k), // VALKEYSEARCH
+                isIdAllowed, isCancelled, nullptr, stats); // VALKEYSEARCH
+    } else // VALKEYSEARCH
     if (bare_bone_search) {
       top_candidates = searchBaseLayerST<true>(
           currObj, query_data, std::max(ef_runtime.value_or(ef_), k),
@@ -1477,7 +1675,8 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
 
   std::vector<std::pair<dist_t, labeltype>> searchStopConditionClosest(
       const void *query_data, BaseSearchStopCondition<dist_t> &stop_condition,
-      BaseFilterFunctor *isIdAllowed = nullptr) const {
+      BaseFilterFunctor *isIdAllowed = nullptr,
+      BaseCancellationFunctor *isCancelled = nullptr) const { // VALKEYSEARCH
     std::vector<std::pair<dist_t, labeltype>> result;
     if (cur_element_count_ == 0) return result;
 
@@ -1518,12 +1717,14 @@ class HierarchicalNSW : public AlgorithmInterface<dist_t> {
                         CompareByFirst>
         top_candidates;
     top_candidates = searchBaseLayerST<false>(currObj, query_data, 0,
-                                              isIdAllowed, nullptr, &stop_condition);
+                                              isIdAllowed, isCancelled, &stop_condition); // VALKEYSEARCH
 
     size_t sz = top_candidates.size();
     result.resize(sz);
     while (!top_candidates.empty()) {
-      result[--sz] = top_candidates.top();
+      // VALKEYSEARCH: report labels rather than internal ids.
+      result[--sz] = {top_candidates.top().first,
+                      getExternalLabel(top_candidates.top().second)};
       top_candidates.pop();
     }
 
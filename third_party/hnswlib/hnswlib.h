@@ -151,6 +151,14 @@ class BaseCancellationFunctor {
   virtual bool isCancelled() { return false; }
   virtual ~BaseCancellationFunctor(){};
 };
+
+//
+// Traversal counters of a single search, filled in when passed to searchKnn
+//
+struct SearchStats {
+  size_t hops{0};
+  size_t distance_computations{0};
+};
 // VALKEYSEARCH END
 
 template <typename dist_t>
@@ -3,6 +3,7 @@
 #include "space_ip.h"
 #include <assert.h>
 #include <unordered_map>
+#include <unordered_set>  // VALKEYSEARCH
 
 #ifdef VMSDK_ENABLE_MEMORY_ALLOCATION_OVERRIDES
   #include "vmsdk/src/memory_allocation_overrides.h" // IWYU pragma: keep
@@ -231,6 +232,78 @@ class MultiVectorSearchStopCondition : public BaseSearchStopCondition<dist_t> {
 };
 
 
+// VALKEYSEARCH BEGIN
+// Collects the points of the ef_collection closest documents, where the
+// document of a point is its label shifted right by label_bits, so the
+// document id doesn't have to be stored next to each vector.
+template<typename dist_t>
+class MultiVectorLabelSearchStopCondition : public BaseSearchStopCondition<dist_t> {
+    int label_bits_;
+    size_t curr_num_docs_;
+    size_t num_docs_to_search_;
+    size_t ef_collection_;
+    std::unordered_map<labeltype, size_t> doc_counter_;
+
+ public:
+    MultiVectorLabelSearchStopCondition(
+        int label_bits,
+        size_t num_docs_to_search,
+        size_t ef_collection = 10)
+        : label_bits_(label_bits) {
+            curr_num_docs_ = 0;
+            num_docs_to_search_ = num_docs_to_search;
+            ef_collection_ = std::max(ef_collection, num_docs_to_search);
+        }
+
+    labeltype get_doc_id(labeltype label) const {
+        return label >> label_bits_;
+    }
+
+    void add_point_to_result(labeltype label, const void *datapoint, dist_t dist) override {
+        if (doc_counter_[get_doc_id(label)]++ == 0) {
+            curr_num_docs_ += 1;
+        }
+    }
+
+    void remove_point_from_result(labeltype label, const void *datapoint, dist_t dist) override {
+        auto it = doc_counter_.find(get_doc_id(label));
+        if (--it->second == 0) {
+            doc_counter_.erase(it);
+            curr_num_docs_ -= 1;
+        }
+    }
+
+    bool should_stop_search(dist_t candidate_dist, dist_t lowerBound) override {
+        return candidate_dist > lowerBound && curr_num_docs_ == ef_collection_;
+    }
+
+    bool should_consider_candidate(dist_t candidate_dist, dist_t lowerBound) override {
+        return curr_num_docs_ < ef_collection_ || lowerBound > candidate_dist;
+    }
+
+    bool should_remove_extra() override {
+        return curr_num_docs_ > ef_collection_;
+    }
+
+    // Keeps the closest points up to the num_docs_to_search-th document.
+    // Candidates are sorted by distance, so this is a prefix.
+    void filter_results(std::vector<std::pair<dist_t, labeltype >> &candidates) override {
+        std::unordered_set<labeltype> docs;
+        size_t keep = 0;
+        for (; keep < candidates.size(); ++keep) {
+            docs.insert(get_doc_id(candidates[keep].second));
+            if (docs.size() > num_docs_to_search_) {
+                break;
+            }
+        }
+        candidates.resize(keep);
+    }
+
+    ~MultiVectorLabelSearchStopCondition() {}
+};
+// VALKEYSEARCH END
+
+
 template<typename dist_t>
 class EpsilonSearchStopCondition : public BaseSearchStopCondition<dist_t> {
     float epsilon_;
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "vmsdk/src/latency_sampler.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace vmsdk {
+
+namespace {
+
+// All the live samplers, for CollectAll.
+struct Registry {
+  absl::Mutex mutex;
+  absl::flat_hash_set<LatencySampler *> samplers ABSL_GUARDED_BY(mutex);
+  absl::Time last_collect ABSL_GUARDED_BY(mutex){absl::InfinitePast()};
+};
+
+Registry &GetRegistry() {
+  static auto *registry = new Registry();
+  return *registry;
+}
+
+constexpr absl::Duration kCollectInterval = absl::Seconds(1);
+
+}  // namespace
+
+LatencySampler::LatencySampler(int64_t min_value, int64_t max_value,
+                               int precision, absl::Duration sample_unit,
+                               absl::Duration reporting_unit)
+    : min_value_(min_value),
+      max_value_(max_value),
+      precision_(precision),
+      sample_unit_(sample_unit),
+      reporting_unit_(reporting_unit) {
+  auto &registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.samplers.insert(this);
+}
+
+LatencySampler::~LatencySampler() {
+  {
+    auto &registry = GetRegistry();
+    absl::MutexLock lock(&registry.mutex);
+    registry.samplers.erase(this);
+  }
+  if (!initialized_.load(std::memory_order_acquire)) {
+    return;
+  }
+  absl::MutexLock lock(&reader_lock_);
+  hdr_interval_recorder_destroy(&recorder_);
+  for (auto *histogram : {cumulative_, window_, previous_window_, interval_}) {
+    if (histogram) {
+      hdr_close(histogram);
+    }
+  }
+}
+
+void LatencySampler::Init() {
+  CHECK_EQ(hdr_interval_recorder_init_all(&recorder_, min_value_, max_value_,
+                                          precision_),
+           0);
+  {
+    absl::MutexLock lock(&reader_lock_);
+    CHECK_EQ(hdr_init(min_value_, max_value_, precision_, &cumulative_), 0);
+    CHECK_EQ(hdr_init(min_value_, max_value_, precision_, &window_), 0);
+    window_start_ = absl::Now();
+  }
+  initialized_.store(true, std::memory_order_release);
+}
+
+void LatencySampler::Collect(absl::Time now) {
+  interval_ = hdr_interval_recorder_sample_and_recycle(&recorder_, interval_);
+  hdr_add(cumulative_, interval_);
+  hdr_add(window_, interval_);
+  if (now - window_start_ < kWindow) {
+    return;
+  }
+  if (previous_window_ == nullptr) {
+    CHECK_EQ(hdr_init(min_value_, max_value_, precision_, &previous_window_),
+             0);
+  }
+  std::swap(window_, previous_window_);
+  hdr_reset(window_);
+  window_start_ = now;
+}
+
+std::string LatencySampler::FormatStats(const hdr_histogram *histogram) const {
+  double p50 = 0;
+  double p99 = 0;
+  double p999 = 0;
+  if (histogram != nullptr && histogram->total_count > 0) {
+    double sample_to_reporting_unit =
+        absl::ToDoubleMicroseconds(sample_unit_) /
+        absl::ToDoubleMicroseconds(reporting_unit_);
+    p50 = hdr_value_at_percentile(histogram, 50) * sample_to_reporting_unit;
+    p99 = hdr_value_at_percentile(histogram, 99) * sample_to_reporting_unit;
+    p999 = hdr_value_at_percentile(histogram, 99.9) * sample_to_reporting_unit;
+  }
+  return absl::StrFormat("p50=%.3f,p99=%.3f,p99.9=%.3f", p50, p99, p999);
+}
+
+std::string LatencySampler::GetStatsString() {
+  if (!HasSamples()) {
+    return FormatStats(nullptr);
+  }
+  absl::MutexLock lock(&reader_lock_);
+  Collect(absl::Now());
+  return FormatStats(cumulative_);
+}
+
+std::string LatencySampler::GetWindowedStatsString() {
+  if (!HasSamples()) {
+    return FormatStats(nullptr);
+  }
+  absl::MutexLock lock(&reader_lock_);
+  Collect(absl::Now());
+  return FormatStats(previous_window_ ? previous_window_ : window_);
+}
+
+void LatencySampler::CollectAll() {
+  auto &registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  auto now = absl::Now();
+  if (now - registry.last_collect < kCollectInterval) {
+    return;
+  }
+  registry.last_collect = now;
+  for (auto *sampler : registry.samplers) {
+    if (!sampler->HasSamples()) {
+      continue;
+    }
+    absl::MutexLock sampler_lock(&sampler->reader_lock_);
+    sampler->Collect(now);
+  }
+}
+
+}  // namespace vmsdk
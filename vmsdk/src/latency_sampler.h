@@ -8,15 +8,17 @@
 #ifndef VMSDK_SRC_LATENCY_SAMPLER_H_
 #define VMSDK_SRC_LATENCY_SAMPLER_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
 
+#include "absl/base/call_once.h"
 #include "absl/base/thread_annotations.h"
-#include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "third_party/hdrhistogram_c/src/hdr_histogram.h"
+#include "third_party/hdrhistogram_c/src/hdr_interval_recorder.h"
 #include "vmsdk/src/utils.h"
 
 namespace vmsdk {
@@ -24,26 +26,25 @@ namespace vmsdk {
 // LatencySampler provides a mechanism for tracking latency samples in a
 // histogram. It is lazily allocated so it will not take any memory unless
 // samples are added.
+//
+// Samples are recorded through an HDR interval recorder, whose writers only
+// update atomics, so every operation can be recorded from any thread without
+// contending on a lock. The recorded samples are moved into the cumulative
+// histogram and the current window by Collect, which runs when the statistics
+// are read and periodically through CollectAll.
 class LatencySampler {
  public:
+  // The length of the window of the windowed statistics.
+  static constexpr absl::Duration kWindow = absl::Seconds(60);
+
   LatencySampler(int64_t min_value, int64_t max_value, int precision)
-      : min_value_(min_value),
-        max_value_(max_value),
-        precision_(precision),
-        sample_unit_(absl::Nanoseconds(1)),
-        reporting_unit_(absl::Microseconds(1)) {}
+      : LatencySampler(min_value, max_value, precision, absl::Nanoseconds(1),
+                       absl::Microseconds(1)) {}
   LatencySampler(int64_t min_value, int64_t max_value, int precision,
-                 absl::Duration sample_unit, absl::Duration reporting_unit)
-      : min_value_(min_value),
-        max_value_(max_value),
-        precision_(precision),
-        sample_unit_(sample_unit),
-        reporting_unit_(reporting_unit) {}
-  ~LatencySampler() {
-    if (initialized_) {
-      hdr_close(histogram_);
-    }
-  }
+                 absl::Duration sample_unit, absl::Duration reporting_unit);
+  ~LatencySampler();
+  LatencySampler(const LatencySampler &) = delete;
+  LatencySampler &operator=(const LatencySampler &) = delete;
 
   void SubmitSample(std::unique_ptr<vmsdk::StopWatch> sample) {
     if (!sample) {
@@ -52,44 +53,46 @@ class LatencySampler {
     SubmitSample(sample->Duration());
   }
   void SubmitSample(absl::Duration latency) {
-    absl::MutexLock lock(&histogram_lock_);
-    if (!initialized_) {
-      hdr_init(min_value_, max_value_, precision_, &histogram_);
-      initialized_ = true;
-    }
-    hdr_record_value(histogram_, absl::ToInt64Nanoseconds(latency) /
-                                     absl::ToInt64Nanoseconds(sample_unit_));
+    absl::call_once(init_once_, &LatencySampler::Init, this);
+    hdr_interval_recorder_record_value_atomic(
+        &recorder_, absl::ToInt64Nanoseconds(latency) /
+                        absl::ToInt64Nanoseconds(sample_unit_));
   }
-  bool HasSamples() {
-    absl::MutexLock lock(&histogram_lock_);
-    return initialized_;
-  }
-  std::string GetStatsString() {
-    absl::MutexLock lock(&histogram_lock_);
-    double p50 = 0;
-    double p99 = 0;
-    double p999 = 0;
-    if (initialized_) {
-      double sample_to_reporting_unit =
-          absl::ToDoubleMicroseconds(sample_unit_) /
-          absl::ToDoubleMicroseconds(reporting_unit_);
-      p50 = hdr_value_at_percentile(histogram_, 50) * sample_to_reporting_unit;
-      p99 = hdr_value_at_percentile(histogram_, 99) * sample_to_reporting_unit;
-      p999 =
-          hdr_value_at_percentile(histogram_, 99.9) * sample_to_reporting_unit;
-    }
-    return absl::StrFormat("p50=%.3f,p99=%.3f,p99.9=%.3f", p50, p99, p999);
+  bool HasSamples() const {
+    return initialized_.load(std::memory_order_acquire);
   }
+  // Percentiles of all the samples.
+  std::string GetStatsString() ABSL_LOCKS_EXCLUDED(reader_lock_);
+  // Percentiles of the samples of the last completed window, or of the
+  // current window until the first one completes.
+  std::string GetWindowedStatsString() ABSL_LOCKS_EXCLUDED(reader_lock_);
+
+  // Collects the recorded samples of all the samplers, at most once a second.
+  // Called periodically so that the windows hold the samples recorded during
+  // them, whether or not the statistics are read.
+  static void CollectAll();
 
  private:
-  mutable absl::Mutex histogram_lock_;
+  void Init();
+  void Collect(absl::Time now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(reader_lock_);
+  std::string FormatStats(const hdr_histogram *histogram) const;
+
   int64_t min_value_;
   int64_t max_value_;
   int precision_;
   absl::Duration sample_unit_;
   absl::Duration reporting_unit_;
-  bool initialized_ ABSL_GUARDED_BY(histogram_lock_) = false;
-  hdr_histogram *histogram_ ABSL_GUARDED_BY(histogram_lock_);
+  absl::once_flag init_once_;
+  std::atomic<bool> initialized_{false};
+  hdr_interval_recorder recorder_;
+
+  mutable absl::Mutex reader_lock_;
+  hdr_histogram *cumulative_ ABSL_GUARDED_BY(reader_lock_){nullptr};
+  hdr_histogram *window_ ABSL_GUARDED_BY(reader_lock_){nullptr};
+  hdr_histogram *previous_window_ ABSL_GUARDED_BY(reader_lock_){nullptr};
+  // The interval histogram handed back to the recorder on the next Collect.
+  hdr_histogram *interval_ ABSL_GUARDED_BY(reader_lock_){nullptr};
+  absl::Time window_start_ ABSL_GUARDED_BY(reader_lock_);
 };
 
 #define SAMPLE_EVERY_N(interval)                   \
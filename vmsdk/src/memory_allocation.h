@@ -22,6 +22,10 @@ int64_t GetMemoryDelta();
 
 void SetMemoryDelta(int64_t delta);
 
+// Whether ptr was allocated through the Valkey allocator, which is required to
+// hand it to the Valkey defragmentation API.
+bool IsValkeyAllocated(void *ptr);
+
 }  // namespace vmsdk
 
 #endif  // VMSDK_SRC_MEMORY_ALLOCATION_H_
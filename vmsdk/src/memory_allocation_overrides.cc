@@ -169,6 +169,15 @@ void UseValkeyAlloc() {
   use_valkey_module_alloc_switch.store(true, std::memory_order_relaxed);
 }
 
+bool IsValkeyAllocated(void* ptr) {
+#ifdef SAN_BUILD
+  return false;
+#else
+  return IsUsingValkeyAlloc() &&
+         !SystemAllocTracker::GetInstance().IsTracked(ptr);
+#endif  // SAN_BUILD
+}
+
 void ResetValkeyAlloc() {
   absl::WriterMutexLock switch_allocator_lock(&switch_allocator_mutex_);
   use_valkey_module_alloc_switch.store(false, std::memory_order_relaxed);
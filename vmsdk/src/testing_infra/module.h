@@ -142,6 +142,8 @@ class MockValkeyModule {
   MOCK_METHOD(int, SubscribeToServerEvent,
               (ValkeyModuleCtx * ctx, ValkeyModuleEvent event,
                ValkeyModuleEventCallback cb));
+  MOCK_METHOD(int, RegisterDefragFunc,
+              (ValkeyModuleCtx * ctx, ValkeyModuleDefragFunc func));
   MOCK_METHOD(int, Scan,
               (ValkeyModuleCtx * ctx, ValkeyModuleScanCursor *cursor,
                ValkeyModuleScanCB fn, void *privdata));
@@ -154,6 +156,8 @@ class MockValkeyModule {
   MOCK_METHOD(ValkeyModuleCtx *, GetThreadSafeContext,
               (ValkeyModuleBlockedClient * bc));
   MOCK_METHOD(void, FreeThreadSafeContext, (ValkeyModuleCtx * ctx));
+  MOCK_METHOD(int, ThreadSafeContextTryLock, (ValkeyModuleCtx * ctx));
+  MOCK_METHOD(void, ThreadSafeContextUnlock, (ValkeyModuleCtx * ctx));
   MOCK_METHOD(int, SelectDb, (ValkeyModuleCtx * ctx, int newid));
   MOCK_METHOD(int, GetSelectedDb, (ValkeyModuleCtx * ctx));
   MOCK_METHOD(void *, ModuleTypeGetValue, (ValkeyModuleKey * key));
@@ -901,6 +905,11 @@ inline int TestValkeyModule_SubscribeToServerEvent(
   return kMockValkeyModule->SubscribeToServerEvent(ctx, event, cb);
 }
 
+inline int TestValkeyModule_RegisterDefragFunc(ValkeyModuleCtx *ctx,
+                                               ValkeyModuleDefragFunc func) {
+  return kMockValkeyModule->RegisterDefragFunc(ctx, func);
+}
+
 inline int TestValkeyModule_Scan(ValkeyModuleCtx *ctx,
                                  ValkeyModuleScanCursor *cursor,
                                  ValkeyModuleScanCB fn, void *privdata) {
@@ -945,6 +954,14 @@ inline void TestValkeyModule_FreeThreadSafeContext(ValkeyModuleCtx *ctx) {
   return kMockValkeyModule->FreeThreadSafeContext(ctx);
 }
 
+inline int TestValkeyModule_ThreadSafeContextTryLock(ValkeyModuleCtx *ctx) {
+  return kMockValkeyModule->ThreadSafeContextTryLock(ctx);
+}
+
+inline void TestValkeyModule_ThreadSafeContextUnlock(ValkeyModuleCtx *ctx) {
+  kMockValkeyModule->ThreadSafeContextUnlock(ctx);
+}
+
 inline int TestValkeyModule_SelectDb(ValkeyModuleCtx *ctx, int newid) {
   return kMockValkeyModule->SelectDb(ctx, newid);
 }
@@ -1547,6 +1564,7 @@ inline void TestValkeyModule_Init() {
   ValkeyModule_ReplyWithError = &TestValkeyModule_ReplyWithError;
   ValkeyModule_SubscribeToServerEvent =
       &TestValkeyModule_SubscribeToServerEvent;
+  ValkeyModule_RegisterDefragFunc = &TestValkeyModule_RegisterDefragFunc;
   ValkeyModule_Scan = &TestValkeyModule_Scan;
   ValkeyModule_ReplicateVerbatim = &TestValkeyModule_ReplicateVerbatim;
   ValkeyModule_Replicate = &TestValkeyModule_Replicate;
@@ -1555,6 +1573,10 @@ inline void TestValkeyModule_Init() {
       &TestValkeyModule_GetDetachedThreadSafeContext;
   ValkeyModule_GetThreadSafeContext = &TestValkeyModule_GetThreadSafeContext;
   ValkeyModule_FreeThreadSafeContext = &TestValkeyModule_FreeThreadSafeContext;
+  ValkeyModule_ThreadSafeContextTryLock =
+      &TestValkeyModule_ThreadSafeContextTryLock;
+  ValkeyModule_ThreadSafeContextUnlock =
+      &TestValkeyModule_ThreadSafeContextUnlock;
   ValkeyModule_SelectDb = &TestValkeyModule_SelectDb;
   ValkeyModule_GetSelectedDb = &TestValkeyModule_GetSelectedDb;
   ValkeyModule_ModuleTypeGetValue = &TestValkeyModule_ModuleTypeGetValue;
@@ -1642,6 +1664,8 @@ inline void TestValkeyModule_Init() {
       .WillByDefault(TestValkeyModule_OpenKeyDefaultImpl);
   ON_CALL(*kMockValkeyModule, CloseKey(testing::_))
       .WillByDefault(TestValkeyModule_CloseKeyDefaultImpl);
+  ON_CALL(*kMockValkeyModule, ThreadSafeContextTryLock(testing::_))
+      .WillByDefault(testing::Return(VALKEYMODULE_OK));
   ON_CALL(*kMockValkeyModule,
           ModuleTypeSetValue(testing::_, testing::_, testing::_))
       .WillByDefault(TestValkeyModule_ModuleTypeSetValueDefaultImpl);
@@ -1685,6 +1709,8 @@ inline void TestValkeyModule_Init() {
         static auto ok_reply = CreateValkeyModuleCallReply(std::string("OK"));
         return ok_reply.get();
       });
+  ON_CALL(*kMockValkeyModule, GetExpire(testing::_))
+      .WillByDefault(testing::Return(VALKEYMODULE_NO_EXPIRE));
   ON_CALL(*kMockValkeyModule, Milliseconds()).WillByDefault([]() -> long long {
     static long long fake_time = 0;
     return ++fake_time;
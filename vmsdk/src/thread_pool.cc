@@ -22,6 +22,7 @@
 #include "absl/status/status.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "status/status_macros.h"
 #include "vmsdk/src/module_config.h"
 
@@ -330,10 +331,12 @@ int ThreadPool::GetHighPriorityWeight() const {
 
 void ThreadPool::AddWaitTimeSample(
     std::chrono::steady_clock::time_point enqueue_time) {
-  double wait_time_ms = std::chrono::duration_cast<std::chrono::microseconds>(
-                            std::chrono::steady_clock::now() - enqueue_time)
-                            .count() /
-                        1000.0;
+  auto wait_time = std::chrono::steady_clock::now() - enqueue_time;
+  queue_wait_latency_.SubmitSample(absl::FromChrono(wait_time));
+  double wait_time_ms =
+      std::chrono::duration_cast<std::chrono::microseconds>(wait_time)
+          .count() /
+      1000.0;
 
   double old_sample = (current_sample_count_ >= sample_queue_size_)
                           ? wait_time_samples_[sample_index_]
@@ -24,7 +24,9 @@
 #include "absl/status/status.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "gtest/gtest_prod.h"
+#include "vmsdk/src/latency_sampler.h"
 #include "vmsdk/src/thread_monitoring.h"
 #include "vmsdk/src/thread_safe_vector.h"
 
@@ -120,6 +122,9 @@ class ThreadPool {
   // Get recent average queue wait time in milliseconds (last N samples)
   absl::StatusOr<double> GetRecentQueueWaitTime();
 
+  // Distribution of the time the tasks waited in the queue
+  LatencySampler& GetQueueWaitLatency() { return queue_wait_latency_; }
+
   void WorkerThread(std::shared_ptr<Thread> thread)
       ABSL_LOCKS_EXCLUDED(queue_mutex_);
 
@@ -191,6 +196,8 @@ class ThreadPool {
   size_t sample_index_ ABSL_GUARDED_BY(queue_mutex_){0};
   size_t current_sample_count_ ABSL_GUARDED_BY(queue_mutex_){0};
   std::atomic<double> recent_avg_wait_time_{0.0};
+  LatencySampler queue_wait_latency_{
+      1, absl::ToInt64Nanoseconds(absl::Seconds(60)), 2};
 
   FRIEND_TEST(ThreadPoolTest, DynamicSizing);
 };
@@ -85,6 +85,29 @@ void TimeSlicedMRMWMutex::Lock(Mode target_mode, bool& may_prolong,
   ++active_lock_count_;
 }
 
+bool TimeSlicedMRMWMutex::TryLock(Mode target_mode) {
+  absl::MutexLock lock(&mutex_);
+  if (switch_wait_mode_.has_value()) {
+    return false;
+  }
+  if (current_mode_ != target_mode) {
+    if (active_lock_count_ > 0 || reader_waiters_ > 0 || writer_waiters_ > 0) {
+      return false;
+    }
+    // Nobody to wait for, switch right away.
+    current_mode_ = target_mode;
+    stop_watch_.Reset();
+    ++switches_;
+  } else if (HasTimeQuotaExceeded() &&
+             GetWaiters(GetInverseMode(target_mode)) > 0) {
+    // Don't prolong the active mode past its quota.
+    return false;
+  }
+  last_lock_acquired_.Reset();
+  ++active_lock_count_;
+  return true;
+}
+
 void TimeSlicedMRMWMutex::Unlock(bool may_prolong, bool ignore_time_quota) {
   absl::MutexLock lock(&mutex_);
   CHECK_GT(active_lock_count_, 0L);
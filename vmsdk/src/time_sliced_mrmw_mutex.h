@@ -64,6 +64,13 @@ class ABSL_LOCKABLE TimeSlicedMRMWMutex {
   void WriterLock(bool& may_prolong, bool ignore_time_quota)
       ABSL_SHARED_LOCK_FUNCTION() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Acquires the lock in target_mode only if that doesn't require waiting:
+  // the mutex is already in target_mode without a pending switch, or nobody
+  // holds or waits for it. For callers that must not block, such as the main
+  // thread. Released with Unlock(false, false).
+  bool TryLock(Mode target_mode) ABSL_SHARED_TRYLOCK_FUNCTION(true)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   void Unlock(bool may_prolong, bool ignore_time_quota) ABSL_UNLOCK_FUNCTION();
   void IncMayProlongCount() ABSL_LOCKS_EXCLUDED(mutex_);
 
@@ -197,5 +204,42 @@ class ABSL_SCOPED_LOCKABLE WriterMutexLock {
   vmsdk::StopWatch timer_;
 };
 
+// Scoped TimeSlicedMRMWMutex::TryLock, owns_lock() tells whether the lock was
+// acquired.
+class ABSL_SCOPED_LOCKABLE TryMutexLock {
+ public:
+  TryMutexLock(TimeSlicedMRMWMutex* mutex, TimeSlicedMRMWMutex::Mode mode)
+      ABSL_SHARED_TRYLOCK_FUNCTION(true, mutex)
+      : mutex_(mutex), mode_(mode), locked_(mutex->TryLock(mode)) {
+    if (locked_) {
+      ++(mode_ == TimeSlicedMRMWMutex::Mode::kLockRead
+             ? global_stats.read_periods
+             : global_stats.write_periods);
+    }
+  }
+
+  TryMutexLock(const TryMutexLock&) = delete;
+  TryMutexLock(TryMutexLock&&) = delete;
+  TryMutexLock& operator=(const TryMutexLock&) = delete;
+  TryMutexLock& operator=(TryMutexLock&&) = delete;
+  bool owns_lock() const { return locked_; }
+  ~TryMutexLock() ABSL_UNLOCK_FUNCTION() {
+    if (!locked_) {
+      return;
+    }
+    mutex_->Unlock(false, false);
+    (mode_ == TimeSlicedMRMWMutex::Mode::kLockRead
+         ? global_stats.read_time_microseconds
+         : global_stats.write_time_microseconds) +=
+        absl::ToInt64Microseconds(timer_.Duration());
+  }
+
+ private:
+  TimeSlicedMRMWMutex* const mutex_;
+  const TimeSlicedMRMWMutex::Mode mode_;
+  const bool locked_;
+  vmsdk::StopWatch timer_;
+};
+
 }  // namespace vmsdk
 #endif  // VMSDK_SRC_MRMW_MUTEX_H_
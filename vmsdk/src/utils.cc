@@ -70,6 +70,25 @@ void TrackCurrentAsMainThread() {
 
 bool IsMainThread() { return is_main_thread; }
 
+ThreadSafeContextTryLockGuard::ThreadSafeContextTryLockGuard(
+    ValkeyModuleCtx *ctx)
+    : ctx_(ctx) {
+  if (ValkeyModule_ThreadSafeContextTryLock(ctx_) != VALKEYMODULE_OK) {
+    return;
+  }
+  owns_lock_ = true;
+  was_main_thread_ = is_main_thread;
+  is_main_thread = true;
+}
+
+ThreadSafeContextTryLockGuard::~ThreadSafeContextTryLockGuard() {
+  if (!owns_lock_) {
+    return;
+  }
+  is_main_thread = was_main_thread_;
+  ValkeyModule_ThreadSafeContextUnlock(ctx_);
+}
+
 static std::atomic<bool> shutting_down{false};
 
 void MarkAsShuttingDown() { shutting_down.store(true); }
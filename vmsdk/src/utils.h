@@ -55,6 +55,26 @@ void TrackCurrentAsMainThread();
 bool IsMainThread();
 inline void VerifyMainThread() { CHECK(IsMainThread()); }
 
+// Attempts to take the module lock of a thread safe context without blocking.
+// While the lock is held the main thread is not executing, so the calling
+// thread is treated as the main thread for the lifetime of the guard and may
+// access main thread state.
+class ThreadSafeContextTryLockGuard {
+ public:
+  explicit ThreadSafeContextTryLockGuard(ValkeyModuleCtx *ctx);
+  ~ThreadSafeContextTryLockGuard();
+  ThreadSafeContextTryLockGuard(const ThreadSafeContextTryLockGuard &) =
+      delete;
+  ThreadSafeContextTryLockGuard &operator=(
+      const ThreadSafeContextTryLockGuard &) = delete;
+  bool OwnsLock() const { return owns_lock_; }
+
+ private:
+  ValkeyModuleCtx *ctx_;
+  bool owns_lock_{false};
+  bool was_main_thread_{false};
+};
+
 void MarkAsShuttingDown();
 bool IsShuttingDown();
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025, valkey-search contributors
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD 3-Clause
+ *
+ */
+
+#include "vmsdk/src/latency_sampler.h"
+
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+
+namespace vmsdk {
+
+namespace {
+
+constexpr int64_t kMaxValue = 1000000000;
+
+TEST(LatencySamplerTest, NoSamples) {
+  LatencySampler sampler(1, kMaxValue, 2);
+  EXPECT_FALSE(sampler.HasSamples());
+  EXPECT_EQ(sampler.GetStatsString(), "p50=0.000,p99=0.000,p99.9=0.000");
+  EXPECT_EQ(sampler.GetWindowedStatsString(),
+            "p50=0.000,p99=0.000,p99.9=0.000");
+  sampler.SubmitSample(std::unique_ptr<StopWatch>());
+  EXPECT_FALSE(sampler.HasSamples());
+}
+
+TEST(LatencySamplerTest, CumulativeAndWindowed) {
+  LatencySampler sampler(1, kMaxValue, 2);
+  sampler.SubmitSample(absl::Microseconds(100));
+  sampler.SubmitSample(absl::Microseconds(200));
+  EXPECT_TRUE(sampler.HasSamples());
+  // The first window has not completed yet, so both cover the same samples.
+  EXPECT_EQ(sampler.GetStatsString(),
+            "p50=100.351,p99=200.703,p99.9=200.703");
+  EXPECT_EQ(sampler.GetWindowedStatsString(), sampler.GetStatsString());
+  // Samples recorded after a collection are added to the earlier ones.
+  sampler.SubmitSample(absl::Microseconds(300));
+  EXPECT_EQ(sampler.GetStatsString(),
+            "p50=200.703,p99=301.055,p99.9=301.055");
+}
+
+TEST(LatencySamplerTest, ConcurrentSamples) {
+  LatencySampler sampler(1, kMaxValue, 2);
+  constexpr int kThreads = 8;
+  constexpr int kSamplesPerThread = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&sampler]() {
+      for (int j = 0; j < kSamplesPerThread; ++j) {
+        sampler.SubmitSample(absl::Microseconds(10));
+        LatencySampler::CollectAll();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(sampler.GetStatsString(), "p50=10.047,p99=10.047,p99.9=10.047");
+}
+
+}  // namespace
+
+}  // namespace vmsdk
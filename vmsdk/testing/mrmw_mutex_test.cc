@@ -306,6 +306,33 @@ TEST_F(MRMWMutexTest, SkipWait) {
   blocking_refcount.Wait();
 }
 
+TEST_F(MRMWMutexTest, TryLock) {
+  MRMWMutexOptions options;
+  options.read_quota_duration = absl::Minutes(100);
+  options.read_switch_grace_period = absl::Minutes(10);
+  options.write_quota_duration = absl::Minutes(500);
+  options.write_switch_grace_period = absl::Minutes(50);
+  TimeSlicedMRMWMutex mrmw_mutex(options);
+  {
+    ReaderMutexLock lock(&mrmw_mutex);
+    TryMutexLock try_write(&mrmw_mutex,
+                           TimeSlicedMRMWMutex::Mode::kLockWrite);
+    EXPECT_FALSE(try_write.owns_lock());
+    TryMutexLock try_read(&mrmw_mutex, TimeSlicedMRMWMutex::Mode::kLockRead);
+    EXPECT_TRUE(try_read.owns_lock());
+  }
+  // Nobody holds the lock, the switch doesn't wait for the grace period.
+  {
+    TryMutexLock try_write(&mrmw_mutex,
+                           TimeSlicedMRMWMutex::Mode::kLockWrite);
+    EXPECT_TRUE(try_write.owns_lock());
+    TryMutexLock try_read(&mrmw_mutex, TimeSlicedMRMWMutex::Mode::kLockRead);
+    EXPECT_FALSE(try_read.owns_lock());
+  }
+  TryMutexLock try_read(&mrmw_mutex, TimeSlicedMRMWMutex::Mode::kLockRead);
+  EXPECT_TRUE(try_read.owns_lock());
+}
+
 TEST_F(MRMWMutexTest, ReaderLockMetrics) {
   MRMWMutexOptions options;
   options.read_quota_duration = absl::Seconds(1000);